@@ -16,8 +16,8 @@ EUREKA_MSVC_WARNING_POP
 
 namespace eureka
 {
-    static constexpr std::chrono::nanoseconds EXPECTERD_FRAME_DURATION = 16ms;
-    static constexpr std::chrono::nanoseconds POLLING_TIME = EXPECTERD_FRAME_DURATION - 4ms;
+    static constexpr std::chrono::nanoseconds FRAME_SAFETY_MARGIN = 1ms;   // kept free of polling ahead of the predicted frame start
+    static constexpr double                   FRAME_COST_SMOOTHING = 1.0 / 8.0;
 
     App::App()
     {
@@ -33,18 +33,35 @@ namespace eureka
     void App::Run()
     {
         Initialize();
-   
-        auto lastFrameTimepoint = std::chrono::high_resolution_clock::now();
-        auto pollingDeadline = lastFrameTimepoint + POLLING_TIME;
+
+        //
+        // the time between frames goes to polling, up to the point where the next frame has to start to make the
+        // vblank after the one the last frame was queued for, that frame's cost is learned from RunOne
+        //
+        auto frameCost = std::chrono::nanoseconds(4ms);
+        auto pollingDeadline = std::chrono::steady_clock::now();
 
         while (!_window->ShouldClose())
         {
             PROFILE_CATEGORIZED_SCOPE("App::RunOne", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_SYSTEM);
             PollSystemEvents(pollingDeadline);
+
+            auto frameStart = std::chrono::steady_clock::now();
             _renderingSystem->RunOne();
+            auto presented = std::chrono::steady_clock::now();
 
-            lastFrameTimepoint = std::chrono::high_resolution_clock::now();
-            pollingDeadline = lastFrameTimepoint + POLLING_TIME;
+            if (_framePacer.RecordPresent(presented.time_since_epoch()))
+            {
+                PROFILE_CATEGORIZED_SCOPE("Late frame", eureka::profiling::Color::Red, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+            }
+
+            // the fence, acquire and present waits shrink when the polling deadline moves later, they are not cost
+            auto cost = std::chrono::duration_cast<std::chrono::nanoseconds>(presented - frameStart) - _renderingSystem->LastFrameWait();
+            frameCost += std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>((cost - frameCost).count()) * FRAME_COST_SMOOTHING));
+
+            auto vsync = _framePacer.PredictAfterPresent(presented.time_since_epoch());
+            pollingDeadline = std::chrono::steady_clock::time_point(
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(vsync.frame_target - frameCost - FRAME_SAFETY_MARGIN));
         }
    
 
@@ -90,6 +107,11 @@ namespace eureka
 
     void App::Shutdown()
     {
+        auto pacing = _framePacer.Counters();
+        SPDLOG_INFO("frame pacing: {} frames, {} late, {} dropped, interval {}us",
+            pacing.frames, pacing.late_frames, pacing.dropped_frames,
+            std::chrono::duration_cast<std::chrono::microseconds>(pacing.interval).count());
+
         _renderingSystem->Deinitialize();
 
         _remoteUI->UpdateMemo(_memo.liveslam);
@@ -101,13 +123,14 @@ namespace eureka
         to_json_file(_memo, appMemoFile);
     }
 
-    void App::PollSystemEvents(std::chrono::high_resolution_clock::time_point deadline)
+    void App::PollSystemEvents(std::chrono::steady_clock::time_point deadline)
     {
         PROFILE_CATEGORIZED_SCOPE("PollSystemEvents", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_SYSTEM);
 
-        auto now = std::chrono::high_resolution_clock::now();
+        auto now = std::chrono::steady_clock::now();
 
-        while (now < deadline)
+        // at least one pass, a frame running late still handles its events
+        do
         {
       
             auto leftover = deadline - now;
@@ -124,8 +147,8 @@ namespace eureka
             _renderingSystem->PollTasks();
             _window->PollEvents();
 
-            now = std::chrono::high_resolution_clock::now();
-        }
+            now = std::chrono::steady_clock::now();
+        } while (now < deadline);
  
 
 
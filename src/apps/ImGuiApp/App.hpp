@@ -1,4 +1,5 @@
 #include "IOCContainer.hpp"
+#include <FramePacer.hpp>
 
 namespace eureka
 {
@@ -27,12 +28,13 @@ namespace eureka
         AppMemo      _memo;
         IOCContainer _container;
         std::shared_ptr<graphics::RenderingSystem> _renderingSystem;
+        graphics::FramePacer                       _framePacer;  // steady clock
 
 
     private:
         void Initialize();
         void Shutdown();
-        void PollSystemEvents(std::chrono::high_resolution_clock::time_point deadline);
+        void PollSystemEvents(std::chrono::steady_clock::time_point deadline);
 
 
         std::shared_ptr<Window>                    _window;
@@ -1,14 +1,19 @@
 #include "IOCContainer.hpp"
 
 #include "../Eureka.Graphics/ImguiIntegration.hpp"
+#include "../Eureka.Graphics/MemoryDefragmenter.hpp"
 #include "../Eureka.Graphics/OneShotCopySubmission.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
 #include "../Eureka.Graphics/RenderingSystem.hpp"
 #include "../Eureka.Graphics/SubmissionThreadExecutionContext.hpp"
-#include "../Eureka.Vulkan/BufferMemoryPool.hpp"
+#include "../Eureka.Graphics/TransferWorker.hpp"
+#include "../Eureka.Vulkan/StagingRing.hpp"
+#include "../Eureka.Vulkan/MemoryBudget.hpp"
 
 #include "../Eureka.Windowing/Window.hpp"
 
 #include "../Eureka.Graphics/ImGuiViewPass.hpp"
+#include "../Eureka.Graphics/PoseGraphViewPass.hpp"
 #include "../Eureka.Graphics/TargetPass.hpp"
 //#include "../Eureka.Graphics/CameraPass.hpp"
 
@@ -136,24 +141,35 @@ namespace eureka
         _imguiIntegration->BindToGLFWWindow(_window->GetWindowHandle());
         auto frameContext = std::make_shared<vulkan::FrameContext>(_device, _copyQueue, _graphicsQueue);
 
+        // uploads are recorded off the rendering thread when the copy queue can be submitted to independently
+        std::shared_ptr<graphics::TransferWorker> transferWorker;
+        if (_copyQueue.Get() != _graphicsQueue.Get())
+        {
+            transferWorker = std::make_shared<graphics::TransferWorker>(
+                _device, _copyQueue, _graphicsQueue, _concurrencyRuntime.make_manual_executor());
+        }
+
         _oneShotSubmissionHandler = std::make_shared<graphics::OneShotSubmissionHandler>(
-            _device, _copyQueue, _graphicsQueue, frameContext, _submissionThreadExecutionContext);
+            _device, _copyQueue, _graphicsQueue, frameContext, _submissionThreadExecutionContext, std::move(transferWorker));
 
-        auto uploadPool = std::make_shared<vulkan::BufferMemoryPool>(
-            _resourceAllocator,
-            1024 * 1024 * 8,
-            VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,
-            VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+        auto stagingRing = std::make_shared<vulkan::StagingRing>(_resourceAllocator);
+        auto memoryBudget = std::make_shared<vulkan::MemoryBudgetTracker>(_resourceAllocator);
 
-        );
+        _asyncDataLoader = std::make_shared<graphics::AsyncDataLoader>(_oneShotSubmissionHandler, stagingRing, memoryBudget);
 
-        _asyncDataLoader = std::make_shared<graphics::AsyncDataLoader>(_oneShotSubmissionHandler, uploadPool);
+        // debug builds pick up shaders rebuilt while the app runs
+        vulkan::ShaderCacheConfig shaderCacheConfig{};
+        if constexpr (IS_DEBUG_BUILD)
+        {
+            shaderCacheConfig.watch_directory = EUREKA_COMPILED_SHADERS_DIRECTORY;
+        }
 
-        auto shaderCache = std::make_shared<vulkan::ShaderCache>(_device);
+        auto shaderCache = std::make_shared<vulkan::ShaderCache>(_device, shaderCacheConfig);
         auto layoutCache = std::make_shared<vulkan::DescriptorSetLayoutCache>(_device);
         auto descriptorAllocator = std::make_shared<vulkan::FreeableDescriptorSetAllocator>(_device);
 
+        _pipelinePrecompiler = graphics::MakePersistentPipelinePrecompiler(_device, shaderCache, layoutCache, _concurrencyRuntime.thread_pool_executor());
+
         graphics::GlobalInheritedData globalInheritedData {
             .device = _device,
             .resource_allocator = _resourceAllocator,
@@ -161,17 +177,21 @@ namespace eureka
             .layout_cache = layoutCache,
             .descriptor_allocator = descriptorAllocator,
             .async_data_loader = _asyncDataLoader,
+            .pipeline_precompiler = _pipelinePrecompiler,
         };
 
         auto colorPass =
-            std::make_shared<graphics::SwapChainDepthColorPass>(globalInheritedData, _graphicsQueue, _swapChain);
-
-        //_pipelineCache = std::make_shared<PipelineCache>(_device, _setLayoutCache, colorPass->GetRenderPass());
+            std::make_shared<graphics::SwapChainDepthColorPass>(globalInheritedData, _graphicsQueue, _swapChain, _concurrencyRuntime.thread_pool_executor());
 
         _remoteUI = std::make_shared<ui::RemoteLiveSlamUI>(std::move(appMemo.liveslam), _remoteHandler);
 
+        // recorded below the imgui pass, the map plot is drawn over it
+        auto poseGraphPass = std::make_shared<graphics::PoseGraphViewPass>(globalInheritedData, frameContext);
+        _remoteUI->AttachPoseGraphRenderer(poseGraphPass);
+
         auto imguiPass = std::make_shared<graphics::ImGuiViewPass>(globalInheritedData, _remoteUI);
 
+        colorPass->AddViewPass(poseGraphPass);
         colorPass->AddViewPass(imguiPass);
 
         _renderingSystem = std::make_shared<graphics::RenderingSystem>(_device,
@@ -180,7 +200,11 @@ namespace eureka
                                                                        frameContext,
                                                                        colorPass,
                                                                        _submissionThreadExecutionContext,
-                                                                       _oneShotSubmissionHandler);
+                                                                       _oneShotSubmissionHandler,
+                                                                       _pipelinePrecompiler,
+                                                                       memoryBudget,
+                                                                       std::make_shared<graphics::MemoryDefragmenter>(
+                                                                           _device, _resourceAllocator, frameContext, _oneShotSubmissionHandler));
 
         _renderingSystem->Initialize();
     }
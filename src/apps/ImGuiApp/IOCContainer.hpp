@@ -11,7 +11,6 @@ namespace eureka::vulkan
     class Instance;
     class Device;
     class SwapChain;
-    class PipelineCache;
     class DescriptorSetLayoutCache;
     class ResourceAllocator;
 }
@@ -22,6 +21,7 @@ namespace eureka::graphics
     class RenderingSystem;
     class SubmissionThreadExecutionContext;
     class OneShotSubmissionHandler;
+    class PipelinePrecompiler;
     class ImGuiIntegration;
     class RenderDocIntegration;
 }
@@ -73,7 +73,7 @@ namespace eureka
         std::shared_ptr<Window>                             _window;
         std::shared_ptr<vulkan::SwapChain>                          _swapChain;
 
-        //std::shared_ptr<vulkan::PipelineCache>                      _pipelineCache; // TODO per TargetPass
+        std::shared_ptr<graphics::PipelinePrecompiler>              _pipelinePrecompiler;
         std::shared_ptr<vulkan::DescriptorSetLayoutCache>           _setLayoutCache;
         std::shared_ptr<rpc::RemoteLiveSlamClient>               _remoteHandler;
         std::shared_ptr<ui::RemoteLiveSlamUI>                   _remoteUI;
@@ -12,6 +12,7 @@
 #include "../Eureka.Vulkan/FrameContext.hpp" 
 //#include "../Eureka.Vulkan/RenderTarget.hpp"  
 #include "../Eureka.Graphics/TargetPass.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
 #include "../Eureka.Flutter/VulkanCompositor.hpp"
 #include "../Eureka.Flutter/VulkanDesktopEmbedder.hpp"
 
@@ -65,6 +66,7 @@ int main(int argc, char* argv[])
 
 
         eureka::GLFWRuntime glfw;
+        concurrencpp::runtime runtime; // pipeline compilation and view pass recording pool, outlives the embedder
 
 
         auto instance = vk::MakeDefaultInstance();
@@ -84,6 +86,7 @@ int main(int argc, char* argv[])
         auto shaderCache = std::make_shared<eureka::vulkan::ShaderCache>(device);
         auto layoutCache = std::make_shared<eureka::vulkan::DescriptorSetLayoutCache>(device);
         auto descriptorAllocator = std::make_shared<eureka::vulkan::FreeableDescriptorSetAllocator>(device);
+        auto pipelinePrecompiler = eureka::graphics::MakePersistentPipelinePrecompiler(device, shaderCache, layoutCache, runtime.thread_pool_executor());
 
         eureka::graphics::GlobalInheritedData globalInheritedData{
             .device = device,
@@ -92,11 +95,12 @@ int main(int argc, char* argv[])
             .layout_cache = layoutCache,
             .descriptor_allocator = descriptorAllocator,
             .async_data_loader = nullptr,
+            .pipeline_precompiler = pipelinePrecompiler,
         };
 
 
 
-        auto depthColorTarget = std::make_shared<eureka::graphics::SwapChainDepthColorPass>(globalInheritedData, graphicsQueue, swapChain);
+        auto depthColorTarget = std::make_shared<eureka::graphics::SwapChainDepthColorPass>(globalInheritedData, graphicsQueue, swapChain, runtime.thread_pool_executor());
         auto frameContext = std::make_shared<vk::FrameContext>(device, copyQueue, graphicsQueue);
 
 
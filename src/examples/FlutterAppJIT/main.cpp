@@ -12,6 +12,7 @@
 #include "../Eureka.Vulkan/FrameContext.hpp" 
 //#include "../Eureka.Vulkan/RenderTarget.hpp"  
 #include "../Eureka.Graphics/TargetPass.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
 #include "../Eureka.Flutter/VulkanCompositor.hpp"
 #include "../Eureka.Flutter/VulkanDesktopEmbedder.hpp"
 namespace vk = eureka::vulkan;
@@ -65,6 +66,7 @@ int main(int argc, char* argv[])
 
 
         eureka::GLFWRuntime glfw{};
+        concurrencpp::runtime runtime; // pipeline compilation and view pass recording pool, outlives the embedder
 
 
         auto instance = vk::MakeDefaultInstance(/*vk::Version{ 1,2,0 }*/);
@@ -83,6 +85,7 @@ int main(int argc, char* argv[])
         auto shaderCache = std::make_shared<eureka::vulkan::ShaderCache>(device);
         auto layoutCache = std::make_shared<eureka::vulkan::DescriptorSetLayoutCache>(device);
         auto descriptorAllocator = std::make_shared<eureka::vulkan::FreeableDescriptorSetAllocator>(device);
+        auto pipelinePrecompiler = eureka::graphics::MakePersistentPipelinePrecompiler(device, shaderCache, layoutCache, runtime.thread_pool_executor());
 
         eureka::graphics::GlobalInheritedData globalInheritedData{
             .device = device,
@@ -91,11 +94,12 @@ int main(int argc, char* argv[])
             .layout_cache = layoutCache,
             .descriptor_allocator = descriptorAllocator,
             .async_data_loader = nullptr,
+            .pipeline_precompiler = pipelinePrecompiler,
         };
 
 
 
-        auto depthColorTarget = std::make_shared<eureka::graphics::SwapChainDepthColorPass>(globalInheritedData, graphicsQueue, swapChain);
+        auto depthColorTarget = std::make_shared<eureka::graphics::SwapChainDepthColorPass>(globalInheritedData, graphicsQueue, swapChain, runtime.thread_pool_executor());
         auto frameContext = std::make_shared<vk::FrameContext>(device, copyQueue, graphicsQueue);
 
 
@@ -103,6 +107,7 @@ int main(int argc, char* argv[])
         {
             .asset_dir = FLUTTER_EXAMPLE_DBG_PROJECT_ASSETS_PATH,
             .icudtl_path = FLUTTER_EXAMPLE_DBG_PROJECT_ICUDTL_PATH,
+            .threading = fl::EmbedderThreading::eDedicatedRasterThread,
         };
 
         auto flutterCompositor = std::make_shared<fl::VulkanCompositor>(instance, globalInheritedData, frameContext, depthColorTarget);
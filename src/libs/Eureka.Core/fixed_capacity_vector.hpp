@@ -1,46 +1,428 @@
 #pragma once
-#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace eureka
 {
-    template<typename T, typename _Alloc = std::allocator<T>>
-    class fixed_capacity_vector final : private std::vector<T, _Alloc>
+    namespace detail
     {
-        using base_t = std::vector<T, _Alloc>;
-    public:
-        using base_t::at;
-        using base_t::operator[];
-        using base_t::begin;
-        using base_t::end;
-        using base_t::data;
-        fixed_capacity_vector() = default;
-        fixed_capacity_vector(std::size_t capacity) 
-            : base_t(capacity)
-        {
-            base_t::resize(0);
+        template<typename T>
+        inline constexpr bool fixed_capacity_trivial_v =
+            std::is_trivially_default_constructible_v<T> &&
+            std::is_trivially_destructible_v<T> &&
+            std::is_trivially_copyable_v<T>;
+
+        template<typename T, std::size_t Capacity, bool Trivial = fixed_capacity_trivial_v<T>>
+        struct fixed_capacity_storage
+        {
+            //
+            // trivial types live in a plain array so the container is usable in constant expressions.
+            // the array is left uninitialized at runtime, elements past size() are never read.
+            //
+            T _items[Capacity];
+
+            constexpr fixed_capacity_storage() noexcept
+            {
+                if (std::is_constant_evaluated())
+                {
+                    for (auto& item : _items)
+                    {
+                        item = T{};
+                    }
+                }
+            }
+
+            constexpr T* ptr() noexcept { return _items; }
+            constexpr const T* ptr() const noexcept { return _items; }
         };
-        fixed_capacity_vector(fixed_capacity_vector&& that) = default;
-        fixed_capacity_vector& operator=(fixed_capacity_vector&& rhs) = default;
-        fixed_capacity_vector(base_t&& that) : base_t(std::move(that)) {};
-        fixed_capacity_vector& operator=(base_t&& rhs)
+
+        template<typename T, std::size_t Capacity>
+        struct fixed_capacity_storage<T, Capacity, false>
+        {
+            //
+            // non trivial types are constructed in place into raw aligned storage
+            //
+            alignas(T) std::byte _bytes[sizeof(T) * Capacity];
+
+            fixed_capacity_storage() noexcept {}
+
+            T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(_bytes)); }
+            const T* ptr() const noexcept { return std::launder(reinterpret_cast<const T*>(_bytes)); }
+        };
+    }
+
+    template<typename T, std::size_t Capacity>
+    class fixed_capacity_vector
+    {
+        /*
+        fixed_capacity_vector - a static_vector like container
+        - elements are stored inside the object, it never touches the heap
+        - exceeding the capacity is a programming error (asserted), use full() / try_emplace_back() when the input is unbounded
+        - trivially copyable types are copied and shifted with memcpy / memmove
+        - trivial types are usable in constant expressions
+        */
+        static_assert(Capacity > 0, "fixed_capacity_vector must have a non zero capacity");
+        static_assert(!std::is_reference_v<T>);
+
+        static constexpr bool TRIVIAL = detail::fixed_capacity_trivial_v<T>;
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        detail::fixed_capacity_storage<T, Capacity> _storage;
+        size_type                                   _size{ 0 };
+
+        constexpr void copy_construct_from(const T* src, size_type count)
+        {
+            assert(count <= Capacity);
+            if constexpr (TRIVIAL)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    if (count)
+                    {
+                        std::memcpy(_storage.ptr(), src, count * sizeof(T));
+                    }
+                    _size = count;
+                    return;
+                }
+            }
+            for (; _size < count; ++_size)
+            {
+                std::construct_at(_storage.ptr() + _size, src[_size]);
+            }
+        }
+
+        constexpr void move_construct_from(T* src, size_type count)
+        {
+            if constexpr (TRIVIAL)
+            {
+                copy_construct_from(src, count);
+            }
+            else
+            {
+                assert(count <= Capacity);
+                for (; _size < count; ++_size)
+                {
+                    std::construct_at(_storage.ptr() + _size, std::move(src[_size]));
+                }
+            }
+        }
+
+        constexpr void destroy_from(size_type first)
+        {
+            if constexpr (!TRIVIAL)
+            {
+                std::destroy(_storage.ptr() + first, _storage.ptr() + _size);
+            }
+            _size = first;
+        }
+
+        constexpr void shift_right(size_type idx, size_type count)
+        {
+            // opens a gap of 'count' uninitialized (for non trivial types) slots at idx
+            if constexpr (TRIVIAL)
+            {
+                if (!std::is_constant_evaluated())
+                {
+                    std::memmove(_storage.ptr() + idx + count, _storage.ptr() + idx, (_size - idx) * sizeof(T));
+                    return;
+                }
+                std::copy_backward(_storage.ptr() + idx, _storage.ptr() + _size, _storage.ptr() + _size + count);
+            }
+            else
+            {
+                auto p = _storage.ptr();
+                for (auto i = _size; i > idx; --i)
+                {
+                    std::construct_at(p + i - 1 + count, std::move(p[i - 1]));
+                    std::destroy_at(p + i - 1);
+                }
+            }
+        }
+
+    public:
+        constexpr fixed_capacity_vector() noexcept = default;
+
+        constexpr explicit fixed_capacity_vector(size_type count)
+        {
+            resize(count);
+        }
+
+        constexpr fixed_capacity_vector(size_type count, const T& value)
+        {
+            resize(count, value);
+        }
+
+        constexpr fixed_capacity_vector(std::initializer_list<T> init)
+        {
+            copy_construct_from(init.begin(), init.size());
+        }
+
+        template<std::input_iterator InputIt>
+        constexpr fixed_capacity_vector(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+            {
+                emplace_back(*first);
+            }
+        }
+
+        constexpr fixed_capacity_vector(const fixed_capacity_vector& that)
+        {
+            copy_construct_from(that.data(), that.size());
+        }
+
+        constexpr fixed_capacity_vector(fixed_capacity_vector&& that) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            move_construct_from(that.data(), that.size());
+            that.clear();
+        }
+
+        constexpr fixed_capacity_vector& operator=(const fixed_capacity_vector& rhs)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                copy_construct_from(rhs.data(), rhs.size());
+            }
+            return *this;
+        }
+
+        constexpr fixed_capacity_vector& operator=(fixed_capacity_vector&& rhs) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if (this != &rhs)
+            {
+                clear();
+                move_construct_from(rhs.data(), rhs.size());
+                rhs.clear();
+            }
+            return *this;
+        }
+
+        constexpr ~fixed_capacity_vector() requires TRIVIAL = default;
+        constexpr ~fixed_capacity_vector()
+        {
+            clear();
+        }
+
+        //
+        // capacity
+        //
+        [[nodiscard]] constexpr bool empty() const noexcept { return _size == 0; }
+        [[nodiscard]] constexpr bool full() const noexcept { return _size == Capacity; }
+        [[nodiscard]] constexpr size_type size() const noexcept { return _size; }
+        [[nodiscard]] static constexpr size_type capacity() noexcept { return Capacity; }
+        [[nodiscard]] static constexpr size_type max_size() noexcept { return Capacity; }
+
+        //
+        // element access
+        //
+        [[nodiscard]] constexpr T* data() noexcept { return _storage.ptr(); }
+        [[nodiscard]] constexpr const T* data() const noexcept { return _storage.ptr(); }
+
+        [[nodiscard]] constexpr T& operator[](size_type idx) noexcept
+        {
+            assert(idx < _size);
+            return data()[idx];
+        }
+        [[nodiscard]] constexpr const T& operator[](size_type idx) const noexcept
+        {
+            assert(idx < _size);
+            return data()[idx];
+        }
+
+        [[nodiscard]] constexpr T& at(size_type idx)
+        {
+            if (idx >= _size) throw std::out_of_range("fixed_capacity_vector::at");
+            return data()[idx];
+        }
+        [[nodiscard]] constexpr const T& at(size_type idx) const
+        {
+            if (idx >= _size) throw std::out_of_range("fixed_capacity_vector::at");
+            return data()[idx];
+        }
+
+        [[nodiscard]] constexpr T& front() noexcept { return (*this)[0]; }
+        [[nodiscard]] constexpr const T& front() const noexcept { return (*this)[0]; }
+        [[nodiscard]] constexpr T& back() noexcept { return (*this)[_size - 1]; }
+        [[nodiscard]] constexpr const T& back() const noexcept { return (*this)[_size - 1]; }
+
+        //
+        // iterators
+        //
+        [[nodiscard]] constexpr iterator begin() noexcept { return data(); }
+        [[nodiscard]] constexpr const_iterator begin() const noexcept { return data(); }
+        [[nodiscard]] constexpr const_iterator cbegin() const noexcept { return data(); }
+        [[nodiscard]] constexpr iterator end() noexcept { return data() + _size; }
+        [[nodiscard]] constexpr const_iterator end() const noexcept { return data() + _size; }
+        [[nodiscard]] constexpr const_iterator cend() const noexcept { return data() + _size; }
+        [[nodiscard]] constexpr reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+        [[nodiscard]] constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+        [[nodiscard]] constexpr reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+        [[nodiscard]] constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+        //
+        // modifiers
+        //
+        template <typename... Args>
+        constexpr T& emplace_back(Args&&... args)
+        {
+            assert(_size < Capacity);
+            auto ptr = std::construct_at(data() + _size, std::forward<Args>(args)...);
+            ++_size;
+            return *ptr;
+        }
+
+        template <typename... Args>
+        constexpr T* try_emplace_back(Args&&... args)
         {
-            return base_t::operator=(std::move(rhs));
+            // returns nullptr instead of overflowing
+            if (full())
+            {
+                return nullptr;
+            }
+            return &emplace_back(std::forward<Args>(args)...);
         }
 
-        void resize(std::size_t size)
+        constexpr void push_back(const T& value) { emplace_back(value); }
+        constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        constexpr void pop_back() noexcept
         {
-            assert(size <= base_t::capacity());
-            base_t::resize(size);
+            assert(_size > 0);
+            destroy_from(_size - 1);
         }
-        template <class... _Valty>
-        T& emplace_back(_Valty&&... _Val)
+
+        constexpr void clear() noexcept
         {
-            assert(base_t::size() < base_t::capacity());
-       
-            return base_t::emplace_back(std::forward<_Valty>(_Val)...);
+            destroy_from(0);
+        }
+
+        constexpr void resize(size_type count)
+        {
+            assert(count <= Capacity);
+            if (count < _size)
+            {
+                destroy_from(count);
+            }
+            else
+            {
+                for (; _size < count; ++_size)
+                {
+                    std::construct_at(data() + _size);
+                }
+            }
+        }
+
+        constexpr void resize(size_type count, const T& value)
+        {
+            assert(count <= Capacity);
+            if (count < _size)
+            {
+                destroy_from(count);
+            }
+            else
+            {
+                for (; _size < count; ++_size)
+                {
+                    std::construct_at(data() + _size, value);
+                }
+            }
+        }
+
+        template <typename... Args>
+        constexpr iterator emplace(const_iterator pos, Args&&... args)
+        {
+            assert(_size < Capacity);
+            auto idx = static_cast<size_type>(pos - cbegin());
+            assert(idx <= _size);
+            if (idx == _size)
+            {
+                emplace_back(std::forward<Args>(args)...);
+                return begin() + idx;
+            }
+
+            T value(std::forward<Args>(args)...); // args may alias an element that is about to be shifted
+            shift_right(idx, 1);
+            if constexpr (TRIVIAL)
+            {
+                data()[idx] = value;
+            }
+            else
+            {
+                std::construct_at(data() + idx, std::move(value));
+            }
+            ++_size;
+            return begin() + idx;
+        }
+
+        constexpr iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+        constexpr iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+
+        constexpr iterator erase(const_iterator first, const_iterator last)
+        {
+            auto firstIdx = static_cast<size_type>(first - cbegin());
+            auto lastIdx = static_cast<size_type>(last - cbegin());
+            assert(firstIdx <= lastIdx && lastIdx <= _size);
+
+            if (firstIdx != lastIdx)
+            {
+                auto p = data();
+                if constexpr (TRIVIAL)
+                {
+                    if (!std::is_constant_evaluated())
+                    {
+                        std::memmove(p + firstIdx, p + lastIdx, (_size - lastIdx) * sizeof(T));
+                        _size -= (lastIdx - firstIdx);
+                        return begin() + firstIdx;
+                    }
+                }
+                std::move(p + lastIdx, p + _size, p + firstIdx);
+                destroy_from(_size - (lastIdx - firstIdx));
+            }
+            return begin() + firstIdx;
+        }
+
+        constexpr iterator erase(const_iterator pos)
+        {
+            return erase(pos, pos + 1);
+        }
+
+        friend constexpr bool operator==(const fixed_capacity_vector& lhs, const fixed_capacity_vector& rhs)
+        {
+            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
         }
-        ~fixed_capacity_vector() = default;
     };
 
+    template<typename T, std::size_t Capacity>
+    constexpr auto erase_if(fixed_capacity_vector<T, Capacity>& vec, auto pred)
+    {
+        auto itr = std::remove_if(vec.begin(), vec.end(), pred);
+        auto count = static_cast<std::size_t>(vec.end() - itr);
+        vec.erase(itr, vec.end());
+        return count;
+    }
+
 }
 
@@ -1,7 +1,36 @@
+#pragma once
 #include <concurrencpp/concurrencpp.h>
+#include <exception>
+#include <vector>
 
 namespace eureka
 {
     template<typename T> using promise_t = concurrencpp::result_promise<T>;
     template<typename T> using future_t = concurrencpp::result<T>;
-}
\ No newline at end of file
+    template<typename T> using shared_future_t = concurrencpp::shared_result<T>;
+
+    // awaits every future before rethrowing the first failure, for tasks that reference the awaiting frame
+    inline future_t<void> await_all(std::vector<future_t<void>> futures)
+    {
+        std::exception_ptr error;
+        for (auto& future : futures)
+        {
+            try
+            {
+                co_await future;
+            }
+            catch (...)
+            {
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,204 @@
+#include "mapped_file.hpp"
+#include "basic_errors.hpp"
+#include <algorithm>
+#include <utility>
+
+// NOLINTBEGIN
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+namespace eureka::os
+{
+    mapped_file::mapped_file(const std::filesystem::path& path)
+    {
+        _file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (_file == INVALID_HANDLE_VALUE)
+        {
+            _file = nullptr;
+            throw file_not_found_error(path);
+        }
+
+        LARGE_INTEGER fileSize{};
+        if (!::GetFileSizeEx(_file, &fileSize))
+        {
+            close();
+            throw file_load_error(path);
+        }
+
+        _size = static_cast<std::size_t>(fileSize.QuadPart);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        _mapping = ::CreateFileMappingW(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        _data = _mapping ? static_cast<const uint8_t*>(::MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+        if (!_data)
+        {
+            close();
+            throw file_load_error(path);
+        }
+    }
+
+    void mapped_file::close() noexcept
+    {
+        if (_data)
+        {
+            ::UnmapViewOfFile(_data);
+        }
+        if (_mapping)
+        {
+            ::CloseHandle(_mapping);
+        }
+        if (_file)
+        {
+            ::CloseHandle(_file);
+        }
+        _data = nullptr;
+        _size = 0;
+        _mapping = nullptr;
+        _file = nullptr;
+    }
+
+    mapped_file::mapped_file(mapped_file&& that) noexcept
+        :
+        _data(std::exchange(that._data, nullptr)),
+        _size(std::exchange(that._size, 0)),
+        _file(std::exchange(that._file, nullptr)),
+        _mapping(std::exchange(that._mapping, nullptr))
+    {
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            close();
+            _data = std::exchange(rhs._data, nullptr);
+            _size = std::exchange(rhs._size, 0);
+            _file = std::exchange(rhs._file, nullptr);
+            _mapping = std::exchange(rhs._mapping, nullptr);
+        }
+        return *this;
+    }
+
+    void mapped_file::prefetch(std::size_t offset, std::size_t size) const noexcept
+    {
+        if (offset >= _size)
+        {
+            return;
+        }
+
+        WIN32_MEMORY_RANGE_ENTRY range
+        {
+            .VirtualAddress = const_cast<uint8_t*>(_data + offset),
+            .NumberOfBytes = std::min(size, _size - offset)
+        };
+        ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+    }
+}
+
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace eureka::os
+{
+    mapped_file::mapped_file(const std::filesystem::path& path)
+    {
+        _fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (_fd < 0)
+        {
+            throw file_not_found_error(path);
+        }
+
+        struct stat st{};
+        if (::fstat(_fd, &st) != 0)
+        {
+            close();
+            throw file_load_error(path);
+        }
+
+        _size = static_cast<std::size_t>(st.st_size);
+        if (_size == 0)
+        {
+            return;
+        }
+
+        auto* mapping = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, _fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            _size = 0;
+            close();
+            throw file_load_error(path);
+        }
+
+        _data = static_cast<const uint8_t*>(mapping);
+        // glTF buffers are mostly read front to back, let the kernel read ahead aggressively
+        ::madvise(mapping, _size, MADV_SEQUENTIAL);
+    }
+
+    void mapped_file::close() noexcept
+    {
+        if (_data)
+        {
+            ::munmap(const_cast<uint8_t*>(_data), _size);
+        }
+        if (_fd >= 0)
+        {
+            ::close(_fd);
+        }
+        _data = nullptr;
+        _size = 0;
+        _fd = -1;
+    }
+
+    mapped_file::mapped_file(mapped_file&& that) noexcept
+        :
+        _data(std::exchange(that._data, nullptr)),
+        _size(std::exchange(that._size, 0)),
+        _fd(std::exchange(that._fd, -1))
+    {
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            close();
+            _data = std::exchange(rhs._data, nullptr);
+            _size = std::exchange(rhs._size, 0);
+            _fd = std::exchange(rhs._fd, -1);
+        }
+        return *this;
+    }
+
+    void mapped_file::prefetch(std::size_t offset, std::size_t size) const noexcept
+    {
+        if (offset >= _size)
+        {
+            return;
+        }
+
+        // madvise wants a page aligned start
+        auto pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        auto alignedOffset = offset & ~(pageSize - 1);
+        auto length = std::min(size, _size - offset) + (offset - alignedOffset);
+        ::madvise(const_cast<uint8_t*>(_data + alignedOffset), length, MADV_WILLNEED);
+    }
+}
+#endif
+
+namespace eureka::os
+{
+    mapped_file::~mapped_file()
+    {
+        close();
+    }
+}
+// NOLINTEND
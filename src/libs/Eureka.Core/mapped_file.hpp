@@ -0,0 +1,43 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace eureka::os
+{
+    //
+    // mapped_file - read only mapping of a whole file
+    // the pages are faulted in on first access and shared with the page cache, nothing is copied to the heap
+    // spans into bytes() stay valid as long as the mapping is alive, moving the object keeps them valid
+    //
+    class mapped_file
+    {
+        const uint8_t* _data{ nullptr };
+        std::size_t    _size{ 0 };
+#ifdef _WIN32
+        void*          _file{ nullptr };
+        void*          _mapping{ nullptr };
+#else
+        int            _fd{ -1 };
+#endif
+        void close() noexcept;
+    public:
+        mapped_file() = default;
+        // throws file_not_found_error / file_load_error
+        explicit mapped_file(const std::filesystem::path& path);
+        ~mapped_file();
+        mapped_file(mapped_file&& that) noexcept;
+        mapped_file& operator=(mapped_file&& rhs) noexcept;
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        // hints the kernel to read the range ahead, returns immediately
+        void prefetch(std::size_t offset, std::size_t size) const noexcept;
+
+        std::span<const uint8_t> bytes() const noexcept { return { _data, _size }; }
+        const uint8_t* data() const noexcept { return _data; }
+        std::size_t size() const noexcept { return _size; }
+        bool empty() const noexcept { return _size == 0; }
+    };
+}
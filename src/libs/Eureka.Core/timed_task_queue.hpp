@@ -0,0 +1,241 @@
+#pragma once
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <condition_variable>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eureka
+{
+    template<typename Task, std::size_t InboxCapacity = 256>
+    class timed_task_queue
+    {
+        /*
+        timed_task_queue - tasks posted from any thread, run on a single consumer thread once their deadline passed
+        - posting is lock free and allocation free: a bounded mpsc ring, when the ring is full the post falls back to
+          a mutex guarded overflow vector
+        - the consumer moves the posts into a binary heap ordered by (deadline, post sequence), tasks with equal
+          deadlines run in posting order, the next task is always the heap top
+        - the heap vector keeps its capacity, in steady state no operation allocates
+        - a sleeping consumer is woken by the first post only, posts to a busy consumer never touch the sleep mutex
+          or enter the kernel (the condition variable waits on a futex / WaitOnAddress, timed semaphore waits poll
+          with a backoff on some standard libraries and add milliseconds of wake latency)
+        */
+        static_assert(InboxCapacity >= 2 && (InboxCapacity & (InboxCapacity - 1)) == 0, "inbox capacity must be a power of two");
+        static_assert(std::is_default_constructible_v<Task> && std::is_nothrow_move_assignable_v<Task>);
+
+        static constexpr std::size_t INBOX_MASK = InboxCapacity - 1;
+
+        struct entry
+        {
+            Task     task{};
+            uint64_t deadline{ 0 };
+            uint64_t sequence{ 0 };
+        };
+
+        // heap comparator, the earliest deadline and then the earliest post on top
+        struct later
+        {
+            bool operator()(const entry& lhs, const entry& rhs) const noexcept
+            {
+                return lhs.deadline != rhs.deadline ? lhs.deadline > rhs.deadline : lhs.sequence > rhs.sequence;
+            }
+        };
+
+        struct slot
+        {
+            std::atomic<std::size_t> turn{ 0 };   // == position: free for the producer, == position + 1: published
+            entry                    value;
+        };
+
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        std::array<slot, InboxCapacity>          _inbox;
+        alignas(CACHE_LINE) std::atomic<std::size_t> _enqueuePosition{ 0 };
+        alignas(CACHE_LINE) std::atomic<uint64_t>    _sequence{ 0 };
+        alignas(CACHE_LINE) std::atomic_bool         _sleeping{ false };
+        std::mutex                                   _sleepMtx;
+        std::condition_variable                      _wake;
+
+        std::mutex                               _overflowMtx;
+        std::vector<entry>                       _overflow;
+        std::atomic_bool                         _hasOverflow{ false };
+
+        // consumer only
+        alignas(CACHE_LINE) std::size_t          _dequeuePosition{ 0 };
+        std::vector<entry>                       _heap;
+        std::vector<entry>                       _overflowDrain;
+        uint64_t                                 _overflowPosts{ 0 };
+
+        bool try_push_inbox(entry& e) noexcept
+        {
+            auto position = _enqueuePosition.load(std::memory_order_relaxed);
+            while (true)
+            {
+                auto& s = _inbox[position & INBOX_MASK];
+                auto turn = s.turn.load(std::memory_order_acquire);
+                auto diff = static_cast<std::ptrdiff_t>(turn) - static_cast<std::ptrdiff_t>(position);
+
+                if (diff == 0)
+                {
+                    if (_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        s.value = std::move(e);
+                        // seq_cst pairs with the consumer's sleeping store / inbox check
+                        s.turn.store(position + 1, std::memory_order_seq_cst);
+                        return true;
+                    }
+                }
+                else if (diff < 0)
+                {
+                    return false; // the consumer is a full ring behind
+                }
+                else
+                {
+                    position = _enqueuePosition.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool inbox_pending() const noexcept
+        {
+            const auto& s = _inbox[_dequeuePosition & INBOX_MASK];
+            return s.turn.load(std::memory_order_seq_cst) == _dequeuePosition + 1 || _hasOverflow.load(std::memory_order_seq_cst);
+        }
+
+        void push_heap(entry&& e)
+        {
+            _heap.emplace_back(std::move(e));
+            std::push_heap(_heap.begin(), _heap.end(), later{});
+        }
+
+        void drain_inbox()
+        {
+            while (true)
+            {
+                auto& s = _inbox[_dequeuePosition & INBOX_MASK];
+                if (s.turn.load(std::memory_order_acquire) != _dequeuePosition + 1)
+                {
+                    break;
+                }
+
+                push_heap(std::move(s.value));
+                s.turn.store(_dequeuePosition + InboxCapacity, std::memory_order_release);
+                ++_dequeuePosition;
+            }
+
+            if (_hasOverflow.load(std::memory_order_acquire))
+            {
+                {
+                    std::scoped_lock lk(_overflowMtx);
+                    std::swap(_overflow, _overflowDrain);
+                    _hasOverflow.store(false, std::memory_order_relaxed);
+                }
+
+                _overflowPosts += _overflowDrain.size();
+                for (auto& e : _overflowDrain)
+                {
+                    push_heap(std::move(e));
+                }
+                _overflowDrain.clear();
+            }
+        }
+
+    public:
+        timed_task_queue()
+        {
+            for (auto i = 0u; i < InboxCapacity; ++i)
+            {
+                _inbox[i].turn.store(i, std::memory_order_relaxed);
+            }
+            _heap.reserve(InboxCapacity);
+        }
+
+        timed_task_queue(const timed_task_queue&) = delete;
+        timed_task_queue& operator=(const timed_task_queue&) = delete;
+
+        //
+        // any thread
+        //
+
+        void post(Task task, uint64_t deadline)
+        {
+            entry e{ .task = std::move(task), .deadline = deadline, .sequence = _sequence.fetch_add(1, std::memory_order_relaxed) };
+
+            if (!try_push_inbox(e))
+            {
+                std::scoped_lock lk(_overflowMtx);
+                _overflow.emplace_back(std::move(e));
+                _hasOverflow.store(true, std::memory_order_seq_cst);
+            }
+
+            // a single post per sleep notifies, the lock orders it after the consumer's check or inside its wait
+            if (_sleeping.load(std::memory_order_seq_cst) && _sleeping.exchange(false, std::memory_order_seq_cst))
+            {
+                std::scoped_lock lk(_sleepMtx);
+                _wake.notify_one();
+            }
+        }
+
+        //
+        // consumer thread
+        //
+
+        // the earliest task whose deadline is <= now, posts made up to this call included
+        std::optional<Task> pop_ready(uint64_t now)
+        {
+            drain_inbox();
+
+            if (_heap.empty() || _heap.front().deadline > now)
+            {
+                return std::nullopt;
+            }
+
+            std::pop_heap(_heap.begin(), _heap.end(), later{});
+            auto task = std::move(_heap.back().task);
+            _heap.pop_back();
+            return task;
+        }
+
+        std::optional<uint64_t> next_deadline()
+        {
+            drain_inbox();
+            return _heap.empty() ? std::nullopt : std::optional<uint64_t>(_heap.front().deadline);
+        }
+
+        // sleeps until a post or wakeAt, returns false on timeout
+        template<typename Clock, typename Duration>
+        bool wait_until(std::chrono::time_point<Clock, Duration> wakeAt)
+        {
+            std::unique_lock lk(_sleepMtx);
+            _sleeping.store(true, std::memory_order_seq_cst);
+
+            auto woken = _wake.wait_until(lk, wakeAt, [this]
+                {
+                    if (inbox_pending())
+                    {
+                        return true;
+                    }
+                    // a post to a later slot can take the wakeup while the slot we read next is claimed but not
+                    // published yet, arm again so that publish wakes us, and look once more in case it already did
+                    _sleeping.store(true, std::memory_order_seq_cst);
+                    return inbox_pending();
+                });
+
+            _sleeping.store(false, std::memory_order_relaxed);
+            return woken;
+        }
+
+        std::size_t scheduled() const noexcept { return _heap.size(); }
+        uint64_t overflow_posts() const noexcept { return _overflowPosts; }
+    };
+}
@@ -0,0 +1,88 @@
+#include "BackingStoreCache.hpp"
+#include <algorithm>
+
+namespace eureka::flutter
+{
+    BackingStoreCache::BackingStoreCache(
+        HeapBudgetQuery heapBudget,
+        uint32_t maxFramesInFlight,
+        BackingStoreCacheConfig config
+    ) :
+        _heapBudget(std::move(heapBudget)),
+        _maxFramesInFlight(maxFramesInFlight),
+        _config(config)
+    {
+    }
+
+    std::unique_ptr<BackingStoreData> BackingStoreCache::TryAcquire(const BackingStoreKey& key)
+    {
+        // newest first, the oldest stores are the ones trimming takes
+        for (auto it = _free.rbegin(); it != _free.rend(); ++it)
+        {
+            if (it->data->key == key && Fenced(*it))
+            {
+                auto data = std::move(it->data);
+                _freeBytes -= data->byte_size;
+                _free.erase(std::next(it).base());
+                ++_counters.reused;
+                return data;
+            }
+        }
+        return nullptr;
+    }
+
+    void BackingStoreCache::Release(std::unique_ptr<BackingStoreData> data)
+    {
+        _freeBytes += data->byte_size;
+        _free.emplace_back(FreeStore
+            {
+                .data = std::move(data),
+                .released_at_frame = _frames
+            });
+    }
+
+    void BackingStoreCache::EndFrame()
+    {
+        ++_frames;
+
+        if (_free.empty())
+        {
+            return;
+        }
+
+        uint64_t excessBytes = _freeBytes > _config.max_free_bytes ? _freeBytes - _config.max_free_bytes : 0;
+
+        auto heap = _heapBudget();
+        auto softLimit = static_cast<uint64_t>(static_cast<double>(heap.budget) * _config.trim_pressure);
+        if (heap.usage > softLimit)
+        {
+            excessBytes = std::max(excessBytes, heap.usage - softLimit);
+        }
+
+        // release order is both the fence order and the lru order, the first store that is kept ends the trim
+        auto trimmed = 0u;
+        for (const auto& store : _free)
+        {
+            auto idle = _frames - store.released_at_frame >= _config.max_idle_frames;
+            if (!Fenced(store) || (!idle && excessBytes == 0))
+            {
+                break;
+            }
+
+            excessBytes -= std::min(excessBytes, store.data->byte_size);
+            _freeBytes -= store.data->byte_size;
+            ++trimmed;
+        }
+
+        _free.erase(_free.begin(), _free.begin() + trimmed);
+        _counters.trimmed += trimmed;
+    }
+
+    BackingStoreCacheCounters BackingStoreCache::Counters() const
+    {
+        auto counters = _counters;
+        counters.free_stores = _free.size();
+        counters.free_bytes = _freeBytes;
+        return counters;
+    }
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "../Eureka.Vulkan/Image.hpp"
+#include "../Eureka.Vulkan/Descriptor.hpp"
+#include <flutter/flutter_embedder.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace eureka::flutter
+{
+    class VulkanCompositor;
+
+    struct BackingStoreKey
+    {
+        uint32_t width{ 0 };
+        uint32_t height{ 0 };
+        VkFormat format{ VK_FORMAT_UNDEFINED };
+
+        bool operator==(const BackingStoreKey&) const = default;
+    };
+
+    struct BackingStoreData
+    {
+        VulkanCompositor*      self; // owner, perhaps should be void*
+        BackingStoreKey               key;
+        uint64_t                      byte_size;
+        vulkan::PoolAllocatedImage2D  image;
+        vulkan::FreeableDescriptorSet descriptor_set; // TODO maybe simply linear allocation
+        FlutterVulkanImage            flutter_image;
+    };
+
+    struct BackingStoreCacheConfig
+    {
+        uint64_t max_free_bytes{ 256ull * 1024 * 1024 };  // free stores past that are trimmed, least recently used first
+        uint64_t max_idle_frames{ 600 };                  // a free store unused for that many frames is trimmed
+        float    trim_pressure{ 0.85f };                  // heap usage / budget past which free stores are trimmed
+    };
+
+    // the heap the stores are allocated from, ResourceAllocator::HeapBudgets()[heap index] outside of tests
+    using HeapBudgetQuery = std::function<vulkan::HeapBudget()>;
+
+    struct BackingStoreCacheCounters
+    {
+        uint64_t created{ 0 };     // image + descriptor set creations, a miss
+        uint64_t reused{ 0 };
+        uint64_t trimmed{ 0 };
+        uint64_t free_stores{ 0 };
+        uint64_t free_bytes{ 0 };
+    };
+
+    //
+    // BackingStoreCache
+    // free list of ready to use backing stores (image, descriptor set and FlutterVulkanImage) keyed by size and
+    // format, flutter churns backing stores on every resize and layer tree change
+    // a released store can be sampled by the frames in flight, it is handed out again (or trimmed) only once the
+    // frame it was released after completed - MaxFramesInFlight presented frames later
+    // trimming goes least recently released first, on idle age, on the free bytes cap and on heap pressure
+    // raster thread only
+    //
+    class BackingStoreCache
+    {
+        struct FreeStore
+        {
+            std::unique_ptr<BackingStoreData> data;
+            uint64_t                          released_at_frame;
+        };
+
+        HeapBudgetQuery                            _heapBudget;
+        uint32_t                                   _maxFramesInFlight;
+        BackingStoreCacheConfig                    _config;
+
+        std::vector<FreeStore>                     _free;          // in release order
+        uint64_t                                   _freeBytes{ 0 };
+        uint64_t                                   _frames{ 0 };
+        BackingStoreCacheCounters                  _counters;
+
+        bool Fenced(const FreeStore& store) const
+        {
+            return _frames - store.released_at_frame >= _maxFramesInFlight;
+        }
+    public:
+        BackingStoreCache(
+            HeapBudgetQuery heapBudget,
+            uint32_t maxFramesInFlight,
+            BackingStoreCacheConfig config = {}
+        );
+        BackingStoreCache(const BackingStoreCache&) = delete;
+        BackingStoreCache& operator=(const BackingStoreCache&) = delete;
+
+        // the most recently released store with the key that no frame in flight uses, nullptr on a miss
+        std::unique_ptr<BackingStoreData> TryAcquire(const BackingStoreKey& key);
+        void RecordCreated() { ++_counters.created; }
+        void Release(std::unique_ptr<BackingStoreData> data);
+
+        // once per presented frame, after its submit
+        void EndFrame();
+
+        BackingStoreCacheCounters Counters() const;
+    };
+}
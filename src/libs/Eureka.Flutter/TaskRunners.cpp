@@ -2,6 +2,8 @@
 #include "FlutterUtils.hpp"
 #include <debugger_trace.hpp>
 #include <profiling.hpp>
+#include <thread_name.hpp>
+#include <latch>
 
 namespace eureka::flutter
 {
@@ -27,57 +29,86 @@ namespace eureka::flutter
     void TaskRunner::RunReadyTasksFor(std::chrono::milliseconds duration)
     {
         PROFILE_CATEGORIZED_SCOPE("RunReadyTasksFor", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_SYSTEM);
-        auto now = std::chrono::high_resolution_clock::now();
-        auto until = now + duration;
+        auto until = std::chrono::steady_clock::now() + duration;
 
-        while (now < until)
+        while (true)
         {
-            std::unique_lock lk(_mtx);
-            auto currentTime = FlutterEngineGetCurrentTime();
-            bool haveReadyTasks = !_pending.empty() && _pending.begin()->target_time_nanos <= currentTime;
+            while (auto task = _pending.pop_ready(FlutterEngineGetCurrentTime()))
+            {
+                PROFILE_CATEGORIZED_SCOPE("FlutterEngineRunTask", profiling::Color::Green, profiling::PROFILING_CATEGORY_SYSTEM);
+                FLUTTER_CHECK(FlutterEngineRunTask(_engine, &*task));
+            }
 
-            //auto status = std::cv_status::no_timeout;
+            auto now = std::chrono::steady_clock::now();
+            if (now >= until)
+            {
+                break;
+            }
 
-            if (!haveReadyTasks /*&& status != std::cv_status::timeout*/)
+            // sleep until a post or the next target time, whichever comes first
+            auto wakeAt = until;
+            if (auto nextTarget = _pending.next_deadline())
             {
-               /* status =*/ _cv.wait_until(lk, until);
+                auto currentTime = FlutterEngineGetCurrentTime();
+                auto delay = std::chrono::nanoseconds(*nextTarget > currentTime ? *nextTarget - currentTime : 0);
+                wakeAt = std::min(until, now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
             }
 
-            auto itr = _pending.begin();
-            auto eitr = _pending.end();
+            _pending.wait_until(wakeAt);
+        }
+    }
+
+    void TaskRunner::PostTask(FlutterTask task, uint64_t targetTimeNanos)
+    {
+        _pending.post(task, targetTimeNanos);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        TaskRunnerThread
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    // bounds how long Stop() waits for the runner to notice
+    static constexpr std::chrono::milliseconds TASK_RUNNER_THREAD_SLICE = std::chrono::milliseconds(16);
 
-            while (itr != eitr)
+    TaskRunnerThread::TaskRunnerThread(const char* threadName) :
+        _runner(std::thread::id{})
+    {
+        std::latch started(1);
+
+        _thread = jthread(
+            [this, threadName, &started]
             {
-                currentTime = FlutterEngineGetCurrentTime();
-                auto [task, targetTime] = *itr;
+                eureka::os::set_current_thread_name(threadName);
+                _runner.SetExecutionThread(std::this_thread::get_id());
+                started.count_down();
 
-                if (targetTime <= currentTime)
+                try
                 {
-                    _pending.erase(itr++);
-                    lk.unlock();
-
-                    PROFILE_CATEGORIZED_SCOPE("FlutterEngineRunTask", profiling::Color::Green, profiling::PROFILING_CATEGORY_SYSTEM);
-                    //DEBUGGER_TRACE("run task start");
-                    FLUTTER_CHECK(FlutterEngineRunTask(_engine, &task));
-                    //DEBUGGER_TRACE("run task end");
-                    lk.lock();
+                    while (!_stop.load(std::memory_order_relaxed))
+                    {
+                        _runner.RunReadyTasksFor(TASK_RUNNER_THREAD_SLICE);
+                    }
                 }
-                else
+                catch (const std::exception& err)
                 {
-                    // tasks are sorted by target time
-                    break;
+                    DEBUGGER_TRACE("task runner thread error {}", err.what());
                 }
-            }
+            });
 
-            now = std::chrono::high_resolution_clock::now();
-        }
- 
+        // the execution thread id is published before the description reaches the engine
+        started.wait();
     }
 
-    void TaskRunner::PostTask(FlutterTask task, uint64_t targetTimeNanos)
+    TaskRunnerThread::~TaskRunnerThread()
+    {
+        Stop();
+    }
+
+    void TaskRunnerThread::Stop()
     {
-        std::scoped_lock lk(_mtx);
-        _pending.emplace(PendingTask{ task, targetTimeNanos });
-        _cv.notify_one();
+        _stop = true;
+        _thread = jthread();
     }
-}
\ No newline at end of file
+}
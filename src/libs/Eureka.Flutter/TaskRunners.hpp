@@ -1,33 +1,25 @@
 #pragma once
-//#include <boost/container/flat_set.hpp>
-#include <set>
+#include <timed_task_queue.hpp>
+#include <jthread.hpp>
 #include <flutter/flutter_embedder.h>
-#include <mutex>
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 namespace eureka::flutter
 {
-
-    struct PendingTask
-    {
-        FlutterTask task;
-        uint64_t    target_time_nanos;
-    };
-
-    inline bool operator<(const PendingTask& lhs, const PendingTask& rhs)
-    {
-        return lhs.target_time_nanos < rhs.target_time_nanos;
-    }
-
+    //
+    // TaskRunner
+    // flutter posts from any thread, the tasks run on the execution thread once their target time passed, tasks
+    // posted for the same target time run in posting order
+    //
     class TaskRunner
     {
     protected:
-        std::mutex                              _mtx;
-        std::condition_variable                 _cv;
         FlutterEngine                           _engine;
         FlutterTaskRunnerDescription            _description;
         std::thread::id                         _executionId;
-        std::set<PendingTask>                   _pending;
+        timed_task_queue<FlutterTask>           _pending;
 
         static bool IsTaskRunOnCurrentThreadStatic(void* userData)
         {
@@ -53,10 +45,33 @@ namespace eureka::flutter
     public:
         TaskRunner(std::thread::id executionId);
 
+        // before the engine is initialized, flutter queries the affinity from its own threads
+        void SetExecutionThread(std::thread::id executionId) { _executionId = executionId; }
         void SetEngineHandle(FlutterEngine engine);
         const FlutterTaskRunnerDescription& GetDescription() const;
 
         void RunReadyTasksFor(std::chrono::milliseconds duration);
     };
 
-} // namespace eureka::flutter
\ No newline at end of file
+    //
+    // TaskRunnerThread
+    // a task runner that owns its execution thread, the thread runs ready tasks until Stop()
+    // the engine has to be shut down before the thread stops, engine shutdown waits on tasks it posts here
+    //
+    class TaskRunnerThread
+    {
+        TaskRunner        _runner;
+        std::atomic_bool  _stop{ false };
+        jthread           _thread;
+    public:
+        explicit TaskRunnerThread(const char* threadName);
+        ~TaskRunnerThread();
+        TaskRunnerThread(const TaskRunnerThread&) = delete;
+        TaskRunnerThread& operator=(const TaskRunnerThread&) = delete;
+
+        void Stop();
+
+        TaskRunner& Runner() { return _runner; }
+    };
+
+} // namespace eureka::flutter
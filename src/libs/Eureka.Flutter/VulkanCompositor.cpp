@@ -1,6 +1,6 @@
 #include "VulkanCompositor.hpp"
 #include "FlutterUtils.hpp"
-#include "../Eureka.Vulkan/PipelinePresets.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
 #include <profiling.hpp>
 
 namespace eureka::flutter
@@ -30,23 +30,19 @@ namespace eureka::flutter
     {
         _targetInheritedData = std::move(inheritedData);
 
-        vulkan::PipelineLayoutCreationPreset imguiPipelineLayoutPreset(vulkan::PipelinePresetType::eTexturedRegion,
-                                                                       *_globalInheritedData.layout_cache);
-        _pipelineLayout = std::make_shared<vulkan::PipelineLayout>(_globalInheritedData.device,
-                                                                   imguiPipelineLayoutPreset.GetCreateInfo());
-        vulkan::PipelineCreationPreset imguiPipelinePreset(vulkan::PipelinePresetType::eTexturedRegion,
-                                                           *_globalInheritedData.shader_cache,
-                                                           _pipelineLayout->Get(),
-                                                           _targetInheritedData.render_pass->Get());
-
-        _pipeline = vulkan::Pipeline(_globalInheritedData.device,
-                                     _pipelineLayout,
-                                     _targetInheritedData.render_pass,
-                                     imguiPipelinePreset.GetCreateInfo());
+        _pipeline = graphics::RequestPresetPipeline(_globalInheritedData,
+                                                    vulkan::PipelinePresetType::eTexturedRegion,
+                                                    _targetInheritedData.render_pass);
     }
     void FlutterLayersViewPass::RecordDraw(const graphics::RecordParameters& params)
     {
-        params.command_buffer.BindGraphicsPipeline(_pipeline.Get());
+        if(!_pipeline.Ready())
+        {
+            return;
+        }
+        const auto& presetPipeline = _pipeline.Get();
+
+        params.command_buffer.BindGraphicsPipeline(presetPipeline.pipeline.Get());
 
         VkViewport viewport {
             .x = 0.0f, .y = 0.0f, .width = (float)_w, .height = (float)_h, .minDepth = 0.0f, .maxDepth = 1.0f};
@@ -62,7 +58,7 @@ namespace eureka::flutter
                 auto backingStore = pLayer->backing_store;
                 auto backingStoreData = static_cast<BackingStoreData*>(backingStore->vulkan.user_data);
                 params.command_buffer.Bind(VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                           _pipelineLayout->Get(),
+                                           presetPipeline.layout->Get(),
                                            backingStoreData->descriptor_set.Get(),
                                            0u);
 
@@ -78,7 +74,7 @@ namespace eureka::flutter
                 };
 
                 params.command_buffer.PushConstants(
-                    _pipelineLayout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstanst);
+                    presetPipeline.layout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstanst);
 
                 VkRect2D scissorRect;
                 scissorRect.offset.x = (int32_t)layerOffset.x;
@@ -112,9 +108,15 @@ namespace eureka::flutter
         _targetPass(std::move(targetPass)), // TODO should be the other way around
         _backingStorePool(std::make_shared<vulkan::ImageMemoryPool>(
             _globalInheritedData.resource_allocator,
-            BACKING_STORE_IMAGE_POOL_DEFAULT_SIZE,
+            vulkan::PoolBlocksConfig{ .block_byte_size = BACKING_STORE_IMAGE_POOL_DEFAULT_SIZE },
             VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,
-            vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResourceRenderTargetTransferSrcDst))
+            vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResourceRenderTargetTransferSrcDst)),
+        _backingStoreCache(
+            [allocator = _globalInheritedData.resource_allocator, heapIndex = _backingStorePool->Allocation().heap_index]
+            {
+                return allocator->HeapBudgets()[heapIndex];
+            },
+            _frameContext->MaxFramesInFlight())
     {
         _flutterRendererConfig.type = FlutterRendererType::kVulkan;
         _flutterRendererConfig.vulkan.struct_size = sizeof(FlutterVulkanRendererConfig);
@@ -166,6 +168,7 @@ namespace eureka::flutter
     {
         PROFILE_CATEGORIZED_SCOPE(
             "CreateBackingStore", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+        AssertRasterThread();
         _renderDoc.StartCapture(_globalInheritedData.device->GetDevice());
         //DEBUGGER_TRACE("CreateBackingStore {} {}", config->size.width, config->size.height);
         VkExtent2D extent {
@@ -173,20 +176,47 @@ namespace eureka::flutter
             .height = static_cast<uint32_t>(config->size.height),
         };
 
+        BackingStoreKey key {.width = extent.width, .height = extent.height, .format = VK_FORMAT_R8G8B8A8_UNORM};
+
+        // a recycled store comes with its image, descriptor set and flutter image ready
+        auto bkData = _backingStoreCache.TryAcquire(key);
+        if(!bkData)
+        {
+            bkData = CreateBackingStoreData(key);
+            _backingStoreCache.RecordCreated();
+        }
+
+        backingStoreOut->struct_size = sizeof(FlutterBackingStore);
+        backingStoreOut->user_data = nullptr; // we currently do nothing in collect backing store
+        backingStoreOut->type = FlutterBackingStoreType::kFlutterBackingStoreTypeVulkan;
+        backingStoreOut->vulkan.struct_size = sizeof(FlutterVulkanBackingStore);
+        backingStoreOut->vulkan.image = &bkData->flutter_image;
+        backingStoreOut->vulkan.user_data = bkData.release();
+        backingStoreOut->vulkan.destruction_callback = DestroyVulkanBackingStoreStatic;
+
+        return true;
+    }
+
+    std::unique_ptr<BackingStoreData> VulkanCompositor::CreateBackingStoreData(const BackingStoreKey& key)
+    {
+        VkExtent2D extent {.width = key.width, .height = key.height};
+
         vulkan::Image2DProperties imageProps {
             .extent = extent,
             .preset = vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResourceRenderTargetTransferSrcDst,
         };
         //auto allocation = _backingStorePool->AllocateImage(extent);
 
-        BackingStoreData* bkData = new BackingStoreData {
+        auto bkData = std::make_unique<BackingStoreData>(BackingStoreData {
             .self = this,
+            .key = key,
+            .byte_size = static_cast<uint64_t>(key.width) * key.height * 4, // R8G8B8A8
             .image = vulkan::PoolAllocatedImage2D(_globalInheritedData.device, _backingStorePool, imageProps),
             .descriptor_set = vulkan::FreeableDescriptorSet(
                 _globalInheritedData.device,
                 _globalInheritedData.descriptor_allocator,
                 _globalInheritedData.layout_cache->GetLayoutHandle(vulkan::DescriptorSet0PresetType::eSingleTexture)),
-        };
+        });
 
         std::array<VkDescriptorImageInfo, 1> imageInfo {
             VkDescriptorImageInfo {.sampler = _backingStoreSampler.Get(),
@@ -198,18 +228,10 @@ namespace eureka::flutter
         bkData->flutter_image = FlutterVulkanImage {
             .struct_size = sizeof(FlutterVulkanImage),
             .image = reinterpret_cast<FlutterVulkanImageHandle>(bkData->image.Get()),
-            .format = VK_FORMAT_R8G8B8A8_UNORM,
+            .format = key.format,
         };
 
-        backingStoreOut->struct_size = sizeof(FlutterBackingStore);
-        backingStoreOut->user_data = nullptr; // we currently do nothing in collect backing store
-        backingStoreOut->type = FlutterBackingStoreType::kFlutterBackingStoreTypeVulkan;
-        backingStoreOut->vulkan.struct_size = sizeof(FlutterVulkanBackingStore);
-        backingStoreOut->vulkan.image = &bkData->flutter_image;
-        backingStoreOut->vulkan.user_data = bkData;
-        backingStoreOut->vulkan.destruction_callback = DestroyVulkanBackingStoreStatic;
-
-        return true;
+        return bkData;
     }
 
     bool VulkanCompositor::CollectBackingStore(const FlutterBackingStore* /*backingStore*/)
@@ -227,10 +249,10 @@ namespace eureka::flutter
         PROFILE_CATEGORIZED_SCOPE("DestroyVulkanBackingStore",
                                   eureka::profiling::Color::Green,
                                   eureka::profiling::PROFILING_CATEGORY_RENDERING);
+        AssertRasterThread();
         //DEBUGGER_TRACE("DestroyVulkanBackingStore");
-        // TODO, HACKISH to prevent destroting in flight descriptor, maybe pass this to "collect" list that will be released later
-        _frameContext->SyncCurrentFrame();
-        delete data;
+        // the frames in flight may still sample it, the cache holds it until they completed
+        _backingStoreCache.Release(std::unique_ptr<BackingStoreData>(data));
     }
 
     void VulkanCompositor::EnqueueImageBarriers(const FlutterLayer**              layers,
@@ -311,6 +333,9 @@ namespace eureka::flutter
     {
         PROFILE_CATEGORIZED_SCOPE(
             "PresentLayers", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+        AssertRasterThread();
+        std::scoped_lock presentationLock(_presentationMtx);
+
         // These should occur outside of this function in any case
         _frameContext->BeginFrame(); // synchronizes
         _targetPass->Prepare();
@@ -333,7 +358,7 @@ namespace eureka::flutter
 
         _layersViewPass->SetUpcomingDrawLayers(upcomingLayers);
 
-        _targetPass->RecordDraw({mainCommandBuffer}); // will call flutter layers view with associated layers
+        _targetPass->RecordDraw({.command_buffer = mainCommandBuffer, .frame_context = _frameContext.get()}); // will call flutter layers view with associated layers
 
         mainCommandBuffer.End();
 
@@ -367,12 +392,29 @@ namespace eureka::flutter
         _targetPass->PostSubmit(doneSemaphore);
         //_graphicsQueue->waitIdle();
         _frameContext->EndFrame();
+        _backingStoreCache.EndFrame();
 
-        _lastPresentationTimepoint = CurrentTimeNanoseconds();
+        auto presentationTimepoint = CurrentTimeNanoseconds();
+        if (_framePacer.RecordPresent(presentationTimepoint))
+        {
+            // an empty slice, late frames stand out in the rendering track of the trace
+            PROFILE_CATEGORIZED_SCOPE("Flutter late frame", eureka::profiling::Color::Red, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+        }
+        _lastPresentationTimepoint = presentationTimepoint;
 
         return true;
     }
 
+    void VulkanCompositor::AssertRasterThread()
+    {
+        // the raster task runner is bound to a single thread, the first callback tells which
+        if (_rasterThread == std::thread::id{})
+        {
+            _rasterThread = std::this_thread::get_id();
+        }
+        assert(_rasterThread == std::this_thread::get_id());
+    }
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //
     //                                static callbacks boilerplate
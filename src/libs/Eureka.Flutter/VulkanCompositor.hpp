@@ -5,28 +5,22 @@
 #include "../Eureka.Vulkan/ImageMemoryPool.hpp"
 #include "../Eureka.Vulkan/SwapChain.hpp"
 #include "../Eureka.Vulkan/Descriptor.hpp"
-#include "../Eureka.Vulkan/Pipeline.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
+#include "../Eureka.Graphics/FramePacer.hpp"
+#include "BackingStoreCache.hpp"
 #include <RenderDocIntegration.hpp> // TODO remove
 #include <flutter/flutter_embedder.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 namespace eureka::flutter
 {
-    class VulkanCompositor;
-
-    struct BackingStoreData
-    {
-        VulkanCompositor*      self; // owner, perhaps should be void*
-        vulkan::PoolAllocatedImage2D  image;
-        vulkan::FreeableDescriptorSet descriptor_set; // TODO maybe simply linear allocation
-        FlutterVulkanImage            flutter_image;
-    };
-
     class FlutterLayersViewPass : public graphics::IViewPass
     {
         graphics::TargetInheritedData _targetInheritedData;
 
-        std::shared_ptr<vulkan::PipelineLayout> _pipelineLayout;
-        vulkan::Pipeline                        _pipeline;
+        graphics::PendingPresetPipeline         _pipeline;
 
 
         dspan<const FlutterLayer*>                    _upcomingDrawLayers;
@@ -49,6 +43,11 @@ namespace eureka::flutter
 
         void RecordDraw(const graphics::RecordParameters& params) override;
 
+        graphics::ViewPassThreading Threading() const override
+        {
+            return graphics::ViewPassThreading{ .parallel_prepare = true, .secondary_recording = true };
+        }
+
         virtual void HandleResize(uint32_t w, uint32_t h) override 
         {
             _w = w;
@@ -58,6 +57,12 @@ namespace eureka::flutter
 
     };
 
+    //
+    // VulkanCompositor
+    // the flutter callbacks (backing stores, present) all run on the raster task runner thread, which may or
+    // may not be the platform thread, the presentation lock keeps the swap chain resizes of the window thread
+    // out of PresentLayers
+    //
     class VulkanCompositor
     {
         std::shared_ptr<vulkan::Instance> _instance;
@@ -74,8 +79,14 @@ namespace eureka::flutter
         RenderDocIntegration                     _renderDoc;
         std::shared_ptr<vulkan::ImageMemoryPool> _backingStorePool;
         vulkan::Sampler                          _backingStoreSampler;
+        BackingStoreCache                        _backingStoreCache; // after the pool, the free stores go first
+
+        std::atomic<std::chrono::nanoseconds>    _lastPresentationTimepoint;  // readable from any thread
+        std::mutex                               _presentationMtx;
+        std::thread::id                          _rasterThread;
+        graphics::FramePacer                     _framePacer;                 // flutter engine time
 
-        std::chrono::nanoseconds                 _lastPresentationTimepoint;
+        void AssertRasterThread();
     public:
         VulkanCompositor(
             std::shared_ptr<vulkan::Instance>              instance,
@@ -89,7 +100,12 @@ namespace eureka::flutter
         //
         const FlutterRendererConfig& GetFlutterRendererConfig() const;
         const FlutterCompositor&     GetFlutterCompositor() const;
-        std::chrono::nanoseconds GetLastPresntationTimepoint() const { return _lastPresentationTimepoint; }
+        std::chrono::nanoseconds GetLastPresntationTimepoint() const { return _lastPresentationTimepoint.load(); }
+        [[nodiscard]] std::unique_lock<std::mutex> LockPresentation() { return std::unique_lock(_presentationMtx); }
+        // vblanks predicted from the presents, any thread
+        graphics::VsyncPrediction PredictVsync(std::chrono::nanoseconds timepoint) const { return _framePacer.Predict(timepoint); }
+        graphics::FramePacerCounters FramePacing() const { return _framePacer.Counters(); }
+        BackingStoreCacheCounters BackingStoreCounters() const { return _backingStoreCache.Counters(); }
     private:
         //
         // Flutter callbacks (members)
@@ -97,6 +113,7 @@ namespace eureka::flutter
 
         void EnqueueImageBarriers(const FlutterLayer** layers, size_t layersCount, vulkan::LinearCommandBufferHandle commandBuffer);
         bool CreateBackingStore(const FlutterBackingStoreConfig* config, FlutterBackingStore* backingStoreOut);
+        std::unique_ptr<BackingStoreData> CreateBackingStoreData(const BackingStoreKey& key);
         bool CollectBackingStore(const FlutterBackingStore* backingStore);
         void DestroyVulkanBackingStore(BackingStoreData* data);
         bool PresentLayers(const FlutterLayer** layers, size_t layersCount);
@@ -12,13 +12,17 @@ namespace eureka::flutter
         _aotData(nullptr, FlutterEngineCollectAOTData),
         _compositor(std::move(compositor)),
         _window(std::move(window)),
-        _combinedTaskRunner(std::this_thread::get_id())
+        _platformTaskRunner(std::this_thread::get_id())
     {
+        if (_config.threading == EmbedderThreading::eDedicatedRasterThread)
+        {
+            _rasterTaskRunner = std::make_unique<TaskRunnerThread>("eureka flutter raster thread");
+        }
 
         _taskRunners.thread_priority_setter = [](FlutterThreadPriority) -> void { return; };
         _taskRunners.struct_size = sizeof(FlutterCustomTaskRunners);
-        _taskRunners.platform_task_runner = &_combinedTaskRunner.GetDescription();
-        _taskRunners.render_task_runner = &_combinedTaskRunner.GetDescription();
+        _taskRunners.platform_task_runner = &_platformTaskRunner.GetDescription();
+        _taskRunners.render_task_runner = _rasterTaskRunner ? &_rasterTaskRunner->Runner().GetDescription() : &_platformTaskRunner.GetDescription();
 
         auto        assets_path_str = _config.asset_dir.string();
         auto        icu_data_path_str = _config.icudtl_path.string();
@@ -61,8 +65,11 @@ namespace eureka::flutter
             throw std::runtime_error("failed to initialize flutter application");
         }
 
-        //_platformTasksRunner.SetEngineHandle(_flutterEngine);
-        _combinedTaskRunner.SetEngineHandle(_flutterEngine);
+        _platformTaskRunner.SetEngineHandle(_flutterEngine);
+        if (_rasterTaskRunner)
+        {
+            _rasterTaskRunner->Runner().SetEngineHandle(_flutterEngine);
+        }
 
         _winSize = _window->ConnectResizeSlot([this](uint32_t w, uint32_t h) {
             FlutterWindowMetricsEvent event = {};
@@ -122,6 +129,7 @@ namespace eureka::flutter
     {
         if (_flutterEngine)
         {
+            // the raster thread keeps running, shutdown waits on the tasks it posts there
             FlutterEngineResult result = FlutterEngineShutdown(_flutterEngine);
 
             if (result != FlutterEngineResult::kSuccess)
@@ -129,6 +137,16 @@ namespace eureka::flutter
                 DEBUGGER_TRACE("failed to run flutter application");
             }
         }
+
+        if (_rasterTaskRunner)
+        {
+            _rasterTaskRunner->Stop();
+        }
+
+        auto pacing = _compositor->FramePacing();
+        DEBUGGER_TRACE("flutter frame pacing: {} frames, {} late, {} dropped, interval {}us",
+            pacing.frames, pacing.late_frames, pacing.dropped_frames,
+            std::chrono::duration_cast<std::chrono::microseconds>(pacing.interval).count());
     }
 
     void VulkanDesktopEmbedder::Run()
@@ -147,8 +165,12 @@ namespace eureka::flutter
         static constexpr uint64_t MILLI = std::chrono::duration_cast<std::chrono::nanoseconds>(1ms).count();
         while(!_window->ShouldClose())
         {
-            _window->PollEvents();
-            _combinedTaskRunner.RunReadyTasksFor(1ms);
+            {
+                // resizes recreate the swap chain and targets the raster thread presents to
+                auto presentationLock = _compositor->LockPresentation();
+                _window->PollEvents();
+            }
+            _platformTaskRunner.RunReadyTasksFor(1ms);
 
             HandleNotifyOnNextVSyncRequest();
 
@@ -189,31 +211,21 @@ namespace eureka::flutter
             lk.unlock();
 
 
-            auto lastVsync = _compositor->GetLastPresntationTimepoint();
-            auto nextVsync = lastVsync + FRAME_INTERVAL_60_FPS_NS;
-
-            if (request.request_timepoint < lastVsync)
+            // the first vblank after the request, a request that waited past its target gets the next one
+            auto now = CurrentTimeNanoseconds();
+            auto vsync = _compositor->PredictVsync(request.request_timepoint);
+            if (vsync.frame_target <= now)
             {
-                // at the time of the request, last vsync did not yet occur. we should release flutter wait immediatly
-
-                FLUTTER_CHECK(FlutterEngineOnVsync(
-                    _flutterEngine,
-                    request.baton,
-                    lastVsync.count(), // engine will not wait since this already happend
-                    nextVsync.count()
-                ));
-            }
-            else
-            {
-                // the request happened after last vsync, flutter should wait for next vsync
-                FLUTTER_CHECK(FlutterEngineOnVsync(
-                    _flutterEngine,
-                    request.baton,
-                    nextVsync.count(), // engine will not wait to next vsync
-                    (nextVsync + FRAME_INTERVAL_60_FPS_NS).count()
-                ));
+                vsync = _compositor->PredictVsync(now);
             }
 
+            FLUTTER_CHECK(FlutterEngineOnVsync(
+                _flutterEngine,
+                request.baton,
+                static_cast<uint64_t>(vsync.frame_start.count()),
+                static_cast<uint64_t>(vsync.frame_target.count())
+            ));
+
             PROFILE_CATEGORIZED_SCOPE("FlutterEngineOnVsync",
                 eureka::profiling::Color::Green,
                 eureka::profiling::PROFILING_CATEGORY_SYSTEM);
@@ -17,11 +17,18 @@ namespace eureka::flutter
 
     using UniqueAotDataPtr = std::unique_ptr<_FlutterEngineAOTData, FlutterEngineCollectAOTDataFnPtr>;
 
+    enum class EmbedderThreading
+    {
+        eSingleThread,          // platform and raster tasks share the window thread
+        eDedicatedRasterThread  // platform tasks on the window thread, raster tasks (and presentation) on their own thread
+    };
+
     struct EmbedderConfig
     {
         std::filesystem::path asset_dir;
         std::filesystem::path icudtl_path;
         std::filesystem::path aot_path;
+        EmbedderThreading     threading{ EmbedderThreading::eSingleThread };
     };
 
     struct FlutterNotifyVsyncRequest
@@ -43,7 +50,8 @@ namespace eureka::flutter
         std::mutex                                _mtx;
         std::shared_ptr<VulkanCompositor>         _compositor;
         std::shared_ptr<Window>                   _window;
-        TaskRunner                                _combinedTaskRunner;
+        TaskRunner                                _platformTaskRunner; // also runs the raster tasks in single thread mode
+        std::unique_ptr<TaskRunnerThread>         _rasterTaskRunner;
         FlutterCustomTaskRunners                  _taskRunners;
         FlutterEngine                             _flutterEngine {nullptr};
         std::deque<FlutterNotifyVsyncRequest>     _pendingVsyncNotifyRequests;
@@ -1,252 +1,507 @@
 #include "AsyncDataLoader.hpp"
 #include "OneShotCopySubmission.hpp"
-#include "../Eureka.Vulkan/StageZone.hpp"
+#include "TransferWorker.hpp"
+#include "../Eureka.Vulkan/Buffer.hpp"
+#include "../Eureka.Vulkan/StagingRing.hpp"
+#include "../Eureka.Vulkan/MemoryBudget.hpp"
 #include "../Eureka.Vulkan/Commands.hpp"
 #include <profiling.hpp>
 #include <debugger_trace.hpp>
+#include <algorithm>
 
 namespace eureka::graphics
 {
-
-    AsyncDataLoader::AsyncDataLoader(
-        std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler, 
-        std::shared_ptr<vulkan::BufferMemoryPool> uploadPool
-    ) :
-        _oneShotSubmissionHandler(std::move(oneShotSubmissionHandler)),
-        _uploadPool(std::move(uploadPool))
+    namespace
     {
+        uint64_t AlignStageOffset(uint64_t value)
+        {
+            return (value + vulkan::STAGING_RING_DEFAULT_ALIGNMENT - 1) & ~(vulkan::STAGING_RING_DEFAULT_ALIGNMENT - 1);
+        }
 
-    }
+        //
+        // UploadStage
+        // stage memory of a single upload call, a staging ring region or a dedicated stage buffer
+        // the memory is released when the stage is destroyed, keep it until the upload submission completed
+        //
+        class UploadStage
+        {
+            std::optional<vulkan::StagingRegion>            _region;
+            std::optional<vulkan::HostWriteCombinedBuffer>  _dedicated;
+        public:
+            explicit UploadStage(vulkan::StagingRegion region)
+                : _region(std::move(region))
+            {
+            }
 
-    AsyncDataLoader::~AsyncDataLoader()
-    {
+            UploadStage(std::shared_ptr<vulkan::ResourceAllocator> allocator, uint64_t byteSize)
+            {
+                _dedicated.emplace(std::move(allocator), byteSize);
+            }
 
-    }
+            VkBuffer Buffer() const
+            {
+                return _region ? _region->Buffer() : _dedicated->Buffer();
+            }
 
-    future_t<void> AsyncDataLoader::UploadImageAsync(const vulkan::ImageStageUploadDesc& transferDesc)
-    {
-        //auto uploadCommandsSequence =
-        //    CreateImageUploadCommandSequence(
-        //        _oneShotSubmissionHandler->CopyQueue(),
-        //        _oneShotSubmissionHandler->GraphicsQueue(),
-        //        transferDesc
-        //    );
-        auto uploadCommandsSequence2 =
-            CreateImageUploadCommandSequence2(
-                _oneShotSubmissionHandler->CopyQueue(),
-                _oneShotSubmissionHandler->GraphicsQueue(),
-                transferDesc
-            );
-
-        vulkan::PoolSequentialStageZone stageBuffer(_uploadPool, transferDesc.unpinned_src_span.size_bytes());
-
-        stageBuffer.Assign(transferDesc.unpinned_src_span);
-  
-        co_await _oneShotSubmissionHandler->ResumeOnRecordingContext();
+            // offset of the stage inside Buffer()
+            uint64_t Offset() const
+            {
+                return _region ? _region->Offset() : 0;
+            }
 
-        auto [uploadCommandBuffer, uploadCommandsDoneSemaphore] = _oneShotSubmissionHandler->NewOneShotCopyCommandBuffer();
+            void Assign(dcspan<uint8_t> s, uint64_t byteOffset)
+            {
+                if (_region)
+                {
+                    _region->Assign(s, byteOffset);
+                }
+                else
+                {
+                    _dedicated->Assign(s, byteOffset);
+                }
+            }
 
+            void Flush()
+            {
+                if (_region)
+                {
+                    _region->Flush();
+                }
+                else
+                {
+                    _dedicated->FlushCachesBeforeDeviceRead();
+                }
+            }
+        };
+
+        //
+        // the ring when it can hold the batch right now, otherwise a dedicated stage buffer
+        // nullopt when the ring is full and a dedicated stage would take the host heap past its budget, the batch
+        // should wait for ring space - a batch larger than the ring allows gets a dedicated stage regardless
+        //
+        std::optional<UploadStage> TryMakeUploadStage(vulkan::StagingRing& ring, vulkan::MemoryBudgetTracker* memoryBudget, uint64_t byteSize)
         {
-            PROFILE_CATEGORIZED_SCOPE("UploadImageAsync commands", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
-            vulkan::ScopedCommands commands(uploadCommandBuffer);
+            if (byteSize <= ring.MaxAllocationSize())
+            {
+                if (auto region = ring.TryAllocate(byteSize))
+                {
+                    return UploadStage(std::move(*region));
+                }
+
+                if (memoryBudget && !memoryBudget->FitsBudget(vulkan::BufferAllocationPreset::eHostWriteCombinedBufferAsTransferSrc, byteSize))
+                {
+                    return std::nullopt;
+                }
+            }
 
-            VkDependencyInfo dependencyInfo{};
-            dependencyInfo.sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            dependencyInfo.imageMemoryBarrierCount = 1;
-            dependencyInfo.pImageMemoryBarriers = &uploadCommandsSequence2.copy_queue_pre_transfer_barrier;
+            return UploadStage(ring.Allocator(), byteSize);
+        }
 
-            uploadCommandBuffer.PipelineBarrier(dependencyInfo);
-            
-            VkCopyBufferToImageInfo2 copyBufferToImageInfo
+        //
+        // stage contents kept in system memory while the batch waits for ring space
+        //
+        class HostStage
+        {
+            std::vector<uint8_t> _bytes;
+        public:
+            explicit HostStage(uint64_t byteSize)
+                : _bytes(byteSize)
             {
-                .sType = VkStructureType::VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
-                .srcBuffer = stageBuffer.Buffer(),
-                .dstImage = transferDesc.destination_image,
-                .dstImageLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .regionCount = 1,
-                .pRegions = &uploadCommandsSequence2.copy_queue_transfer
-
-            };
+            }
 
-            uploadCommandBuffer.CopyBufferToImage(copyBufferToImageInfo);
+            void Assign(dcspan<uint8_t> s, uint64_t byteOffset)
+            {
+                assert(byteOffset + s.size_bytes() <= _bytes.size());
+                std::memcpy(_bytes.data() + byteOffset, s.data(), s.size_bytes());
+            }
 
-            dependencyInfo.imageMemoryBarrierCount = 1;
-            dependencyInfo.pImageMemoryBarriers = &uploadCommandsSequence2.copy_queue_release;
+            dcspan<uint8_t> Bytes() const
+            {
+                return _bytes;
+            }
+        };
 
-            uploadCommandBuffer.PipelineBarrier(dependencyInfo);
+        template<typename Stage>
+        void WriteStage(Stage& stage, dcspan<vulkan::ImageStageUploadDesc> imageUploads, dcspan<vulkan::BufferDataUploadTransferDesc> bufferUploads)
+        {
+            for (const auto& imageUpload : imageUploads)
+            {
+                stage.Assign(imageUpload.unpinned_src_span, imageUpload.stage_zone_offset);
+            }
+            for (const auto& bufferUpload : bufferUploads)
+            {
+                auto offset = bufferUpload.stage_zone_offset;
+                for (const auto& srcSpan : bufferUpload.unpinned_src_spans)
+                {
+                    stage.Assign(srcSpan, offset);
+                    offset += srcSpan.size_bytes();
+                }
+                assert(offset - bufferUpload.stage_zone_offset == bufferUpload.bytes);
+            }
         }
 
+        //
+        // UploadBatch
+        // the upload sequences of a batch split per phase, so every phase is a single barrier / copy batch
+        //
+        struct UploadBatch
+        {
+            std::vector<VkImageMemoryBarrier2>   image_pre_transfer;
+            std::vector<VkBufferImageCopy2>      image_copies;
+            std::vector<VkImage>                 image_destinations;
+            std::vector<VkImageMemoryBarrier2>   image_release;
+            std::vector<VkImageMemoryBarrier2>   image_acquire;
+
+            std::vector<VkBufferCopy2>           buffer_copies;
+            std::vector<VkBuffer>                buffer_destinations;
+            std::vector<VkBufferMemoryBarrier2>  buffer_release;
+            std::vector<VkBufferMemoryBarrier2>  buffer_acquire;
+
+            // images that generate their mip chain on the graphics queue
+            std::vector<vulkan::GraphicsQueueMipGenerationSequence2> image_mips;
+            std::vector<VkImage>                 image_mip_destinations;
+            uint32_t                             max_generated_levels{ 0 };
+        };
+
+        UploadBatch MakeUploadBatch(
+            const vulkan::Queue& copyQueue,
+            const vulkan::Queue& graphicsQueue,
+            dcspan<vulkan::ImageStageUploadDesc> imageUploads,
+            dcspan<vulkan::BufferDataUploadTransferDesc> bufferUploads
+        )
+        {
+            UploadBatch batch;
+            batch.image_pre_transfer.reserve(imageUploads.size());
+            batch.image_copies.reserve(imageUploads.size());
+            batch.image_destinations.reserve(imageUploads.size());
+            batch.image_release.reserve(imageUploads.size());
+            batch.image_acquire.reserve(imageUploads.size());
+            batch.buffer_copies.reserve(bufferUploads.size());
+            batch.buffer_destinations.reserve(bufferUploads.size());
+            batch.buffer_release.reserve(bufferUploads.size());
+            batch.buffer_acquire.reserve(bufferUploads.size());
+
+            for (const auto& imageUpload : imageUploads)
+            {
+                auto sequence = vulkan::CreateImageUploadCommandSequence2(copyQueue, graphicsQueue, imageUpload);
+                batch.image_pre_transfer.emplace_back(sequence.copy_queue_pre_transfer_barrier);
+                batch.image_copies.emplace_back(sequence.copy_queue_transfer);
+                batch.image_destinations.emplace_back(imageUpload.destination_image);
+                batch.image_release.emplace_back(sequence.copy_queue_release);
+                batch.image_acquire.emplace_back(sequence.graphics_queue_acquire);
+
+                if (imageUpload.generate_mip_levels)
+                {
+                    batch.image_mips.emplace_back(vulkan::CreateMipGenerationCommandSequence2(imageUpload));
+                    batch.image_mip_destinations.emplace_back(imageUpload.destination_image);
+                    batch.max_generated_levels = std::max(batch.max_generated_levels, imageUpload.generate_mip_levels);
+                }
+            }
 
-        co_await _oneShotSubmissionHandler->AppendCopyCommandSubmission(uploadCommandBuffer, uploadCommandsDoneSemaphore);
+            for (const auto& bufferUpload : bufferUploads)
+            {
+                auto sequence = vulkan::CreateBufferUploadCommandSequence2(copyQueue, graphicsQueue, bufferUpload);
+                batch.buffer_copies.emplace_back(sequence.copy_queue_transfer);
+                batch.buffer_destinations.emplace_back(bufferUpload.dst_buffer);
+                batch.buffer_release.emplace_back(sequence.copy_queue_release);
+                batch.buffer_acquire.emplace_back(sequence.graphics_queue_acquire);
+            }
 
-        auto graphicsQueue = _oneShotSubmissionHandler->GraphicsQueue();
+            return batch;
+        }
 
-        if (graphicsQueue.Family() != _oneShotSubmissionHandler->CopyQueue().Family())
+        void RecordCopyCommands(vulkan::LinearCommandBufferHandle& commandBuffer, VkBuffer stageBuffer, const UploadBatch& batch)
         {
-            VkDependencyInfo dependencyInfo{};
-            dependencyInfo.sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
-            dependencyInfo.imageMemoryBarrierCount = 1;
-            dependencyInfo.pImageMemoryBarriers = &uploadCommandsSequence2.graphics_queue_acquire;
+            PROFILE_CATEGORIZED_SCOPE("Upload batch copy commands", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+            vulkan::ScopedCommands commands(commandBuffer);
 
-            auto [graphicsCommandBuffer, graphicsCommandsDoneSemaphore] = _oneShotSubmissionHandler->NewOneShotGraphicsCommandBuffer();
+            if (!batch.image_pre_transfer.empty())
+            {
+                VkDependencyInfo preTransfer
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .imageMemoryBarrierCount = static_cast<uint32_t>(batch.image_pre_transfer.size()),
+                    .pImageMemoryBarriers = batch.image_pre_transfer.data()
+                };
+                commandBuffer.PipelineBarrier(preTransfer);
+            }
 
-            //DEBUGGER_TRACE("ZZZ graphicsCommandBuffer = {:#x}", (uint64_t)((VkCommandBuffer)graphicsCommandBuffer));
+            for (auto i = 0u; i < batch.image_copies.size(); ++i)
             {
-                vulkan::ScopedCommands sc(graphicsCommandBuffer);
+                VkCopyBufferToImageInfo2 copyBufferToImageInfo
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_COPY_BUFFER_TO_IMAGE_INFO_2,
+                    .srcBuffer = stageBuffer,
+                    .dstImage = batch.image_destinations[i],
+                    .dstImageLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .regionCount = 1,
+                    .pRegions = &batch.image_copies[i]
+                };
+                commandBuffer.CopyBufferToImage(copyBufferToImageInfo);
+            }
+
+            for (auto i = 0u; i < batch.buffer_copies.size(); ++i)
+            {
+                VkCopyBufferInfo2 copyBufferInfo
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2,
+                    .srcBuffer = stageBuffer,
+                    .dstBuffer = batch.buffer_destinations[i],
+                    .regionCount = 1,
+                    .pRegions = &batch.buffer_copies[i]
+                };
+                commandBuffer.CopyBuffer(copyBufferInfo);
+            }
 
-                graphicsCommandBuffer.PipelineBarrier(dependencyInfo);
+            VkDependencyInfo release
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount = static_cast<uint32_t>(batch.buffer_release.size()),
+                .pBufferMemoryBarriers = batch.buffer_release.data(),
+                .imageMemoryBarrierCount = static_cast<uint32_t>(batch.image_release.size()),
+                .pImageMemoryBarriers = batch.image_release.data()
+            };
+            commandBuffer.PipelineBarrier(release);
+        }
 
+        //
+        // graphics queue part of the batch, the acquire when the queue families differ and the mip generation
+        // the blits of all images run level by level, one barrier batch between the levels
+        //
+        void RecordGraphicsCommands(vulkan::LinearCommandBufferHandle& commandBuffer, const UploadBatch& batch, bool acquire)
+        {
+            PROFILE_CATEGORIZED_SCOPE("Upload batch graphics commands", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+            vulkan::ScopedCommands commands(commandBuffer);
+
+            std::vector<VkImageMemoryBarrier2> imageBarriers;
+            if (acquire)
+            {
+                imageBarriers = batch.image_acquire;
+            }
+            for (const auto& mips : batch.image_mips)
+            {
+                imageBarriers.emplace_back(mips.pre_blit_barrier);
             }
 
+            VkDependencyInfo acquireAndPreBlit
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .bufferMemoryBarrierCount = acquire ? static_cast<uint32_t>(batch.buffer_acquire.size()) : 0,
+                .pBufferMemoryBarriers = batch.buffer_acquire.data(),
+                .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+                .pImageMemoryBarriers = imageBarriers.data()
+            };
+            commandBuffer.PipelineBarrier(acquireAndPreBlit);
 
-            // we need to synchronize the previous queue submit with this one. 
-            // 1. the first submit must also attach a signal semaphore (created with its command buffer)
-            // 2. the second submit must attach it as a wait semaphore
-            // 3. perhaps we should work with timeline semaphores only since it will allow us 
-            // to use the semaphore even before we submit it.
-            // https://www.khronos.org/blog/vulkan-timeline-semaphores
+            if (batch.image_mips.empty())
+            {
+                return;
+            }
 
-            std::array< OneShotSubmissionWait, 1> waitList
+            for (auto level = 0u; level < batch.max_generated_levels; ++level)
             {
-                OneShotSubmissionWait
+                imageBarriers.clear();
+                for (auto i = 0u; i < batch.image_mips.size(); ++i)
                 {
-                    .semaphore = uploadCommandsDoneSemaphore,
-                    .stages = VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT
+                    const auto& mips = batch.image_mips[i];
+                    if (level >= mips.blits.size())
+                    {
+                        continue;
+                    }
+
+                    VkBlitImageInfo2 blitImageInfo
+                    {
+                        .sType = VkStructureType::VK_STRUCTURE_TYPE_BLIT_IMAGE_INFO_2,
+                        .srcImage = batch.image_mip_destinations[i],
+                        .srcImageLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                        .dstImage = batch.image_mip_destinations[i],
+                        .dstImageLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        .regionCount = 1,
+                        .pRegions = &mips.blits[level],
+                        .filter = VkFilter::VK_FILTER_LINEAR
+                    };
+                    commandBuffer.BlitImage(blitImageInfo);
+                    imageBarriers.emplace_back(mips.blit_done_barriers[level]);
                 }
-            };
 
-            co_await _oneShotSubmissionHandler->AppendGraphicsSubmission(graphicsCommandBuffer, graphicsCommandsDoneSemaphore, waitList);
+                VkDependencyInfo blitDone
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+                    .pImageMemoryBarriers = imageBarriers.data()
+                };
+                commandBuffer.PipelineBarrier(blitDone);
+            }
+
+            imageBarriers.clear();
+            for (const auto& mips : batch.image_mips)
+            {
+                imageBarriers.emplace_back(mips.shader_read_barrier);
+            }
 
-            //DEBUGGER_TRACE("ZZZ ZONE Graphics Acquire");
+            VkDependencyInfo shaderRead
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size()),
+                .pImageMemoryBarriers = imageBarriers.data()
+            };
+            commandBuffer.PipelineBarrier(shaderRead);
         }
 
-        
+        // the blits wait on the copy as well as the first sampling
+        VkPipelineStageFlags2 GraphicsWaitStages(const UploadBatch& batch)
+        {
+            return batch.image_mips.empty() ? VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT : VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT;
+        }
+    }
 
+    AsyncDataLoader::AsyncDataLoader(
+        std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler,
+        std::shared_ptr<vulkan::StagingRing> stagingRing,
+        std::shared_ptr<vulkan::MemoryBudgetTracker> memoryBudget
+    ) :
+        _oneShotSubmissionHandler(std::move(oneShotSubmissionHandler)),
+        _stagingRing(std::move(stagingRing)),
+        _memoryBudget(std::move(memoryBudget))
+    {
 
-        co_return;
     }
 
+    AsyncDataLoader::~AsyncDataLoader()
+    {
 
-    //future_t<void> AsyncDataLoader::UploadImagesAndBufferAsync(std::vector<ImageStageUploadDesc> imageTransferDesc, uint64_t totalImageMemory, BufferDataUploadTransferDesc bufferTransferDesc)
-    //{
-    //    //
-    //    // stage buffer allocation
-    //    //
+    }
 
-    //    auto stageBuffer = co_await _uploadPool->EnqueueAllocation(bufferTransferDesc.bytes + totalImageMemory);
+    future_t<void> AsyncDataLoader::UploadImageAsync(const vulkan::ImageStageUploadDesc& transferDesc)
+    {
+        return UploadImagesAndBuffersAsync({ transferDesc }, {});
+    }
 
-    //    PoolSequentialStageZone stageZone(std::move(stageBuffer));
+    future_t<void> AsyncDataLoader::UploadImagesAndBuffersAsync(
+        std::vector<vulkan::ImageStageUploadDesc> imageUploads,
+        std::vector<vulkan::BufferDataUploadTransferDesc> bufferUploads
+    )
+    {
+        if (imageUploads.empty() && bufferUploads.empty())
+        {
+            co_return;
+        }
 
+        //
+        // stage layout, images then buffers, every upload aligned for the copy commands
+        //
+        uint64_t stageBytes = 0;
+        for (auto& imageUpload : imageUploads)
+        {
+            imageUpload.stage_zone_offset = stageBytes;
+            stageBytes = AlignStageOffset(stageBytes + imageUpload.unpinned_src_span.size_bytes());
+        }
+        for (auto& bufferUpload : bufferUploads)
+        {
+            bufferUpload.stage_zone_offset = stageBytes;
+            stageBytes = AlignStageOffset(stageBytes + bufferUpload.bytes);
+        }
 
-    //    //
-    //    // write to stage buffer
-    //    //
-    //    for (const auto& imageUploadDesc : imageTransferDesc)
-    //    {
-    //        stageZone.Assign(imageUploadDesc.unpinned_src_span);
-    //    }
+        //
+        // write to the stage, the source spans are not touched after this point
+        //
+        auto stage = TryMakeUploadStage(*_stagingRing, _memoryBudget.get(), stageBytes);
+        if (stage)
+        {
+            WriteStage(*stage, imageUploads, bufferUploads);
+        }
+        else
+        {
+            PROFILE_CATEGORIZED_SCOPE("Upload deferred on memory budget", eureka::profiling::Color::Red, eureka::profiling::PROFILING_CATEGORY_RENDERING);
 
-    //    for (const auto& srcSpan : bufferTransferDesc.unpinned_src_spans)
-    //    {
-    //        stageZone.Assign(srcSpan);
-    //    }
+            HostStage hostStage(stageBytes);
+            WriteStage(hostStage, imageUploads, bufferUploads);
+            _memoryBudget->RecordDeferred();
 
+            stage.emplace(co_await _stagingRing->AllocateAsync(stageBytes));
+            stage->Assign(hostStage.Bytes(), 0);
+        }
 
-    //    co_await _oneShotSubmissionHandler->ResumeOnRecordingContext();
-    //    
-    //    auto [uploadCommandBuffer, uploadDoneSemaphore] = _oneShotSubmissionHandler->NewOneShotCopyCommandBuffer();
+        for (auto& imageUpload : imageUploads)
+        {
+            imageUpload.stage_zone_offset += stage->Offset();
+        }
+        for (auto& bufferUpload : bufferUploads)
+        {
+            bufferUpload.stage_zone_offset += stage->Offset();
+        }
+        stage->Flush();
 
-    //    RecordUploadCommands(uploadCommandBuffer, imageTransferDesc, bufferTransferDesc, stageZone);
+        auto& copyQueue = _oneShotSubmissionHandler->CopyQueue();
+        auto& graphicsQueue = _oneShotSubmissionHandler->GraphicsQueue();
+        auto batch = MakeUploadBatch(copyQueue, graphicsQueue, imageUploads, bufferUploads);
+        auto acquire = graphicsQueue.Family() != copyQueue.Family();
 
-    //    co_await _oneShotSubmissionHandler->AppendCopyCommandSubmission(uploadCommandBuffer, uploadDoneSemaphore);
+        if (auto transferWorker = _oneShotSubmissionHandler->GetTransferWorker())
+        {
+            co_await transferWorker->ResumeOnTransferThread();
 
+            auto [uploadCommandBuffer, uploadCommandsDoneSemaphore] = transferWorker->NewCopyCommandBuffer();
 
-    //    co_return;
-    //}
+            RecordCopyCommands(uploadCommandBuffer, stage->Buffer(), batch);
 
-    void AsyncDataLoader::RecordUploadCommands(
-        vulkan::LinearCommandBufferHandle uploadCommandBuffer,
-        dynamic_span<vulkan::ImageStageUploadDesc> imageUploads,
-        const vulkan::BufferDataUploadTransferDesc& bufferUpload,
-        const vulkan::PoolSequentialStageZone& stageZone
-    )
-    {
-        PROFILE_CATEGORIZED_SCOPE("Asset Loading Command Recording", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
-        DEBUGGER_TRACE("rendering thread fun - recording one shot copy");
+            auto copySubmission = transferWorker->AppendCopyCommandSubmission(uploadCommandBuffer, uploadCommandsDoneSemaphore);
 
-       
+            if (acquire || !batch.image_mips.empty())
+            {
+                // the acquire waits on the copy on the device, no need to wait for the copy completion here
+                co_await _oneShotSubmissionHandler->ResumeOnRecordingContext();
 
-        auto& copyQueue = _oneShotSubmissionHandler->CopyQueue();
-        auto& graphicsQueue = _oneShotSubmissionHandler->GraphicsQueue();
+                auto [graphicsCommandBuffer, graphicsCommandsDoneSemaphore] = _oneShotSubmissionHandler->NewOneShotGraphicsCommandBuffer();
 
-        {
-            vulkan::ScopedCommands commands(uploadCommandBuffer);
+                RecordGraphicsCommands(graphicsCommandBuffer, batch, acquire);
 
-            svec10<VkImageMemoryBarrier> preTransferImageMemoryBarriers;
-            svec10<VkImageMemoryBarrier> postTransferImageMemoryBarriers;
-            svec10<VkBufferImageCopy> bufferImageCopies;
+                std::array<OneShotSubmissionWait, 1> waitList
+                {
+                    OneShotSubmissionWait
+                    {
+                        .semaphore = copySubmission.timeline,
+                        .value = copySubmission.value,
+                        .stages = GraphicsWaitStages(batch)
+                    }
+                };
+
+                co_await _oneShotSubmissionHandler->AppendGraphicsSubmission(graphicsCommandBuffer, graphicsCommandsDoneSemaphore, waitList);
+            }
 
-            for (const auto& imageUploadDesc : imageUploads)
-            {
-                auto [preTransferBarrier, bufferImageCopy, copyRelease, graphicsAcquire]
-                    = CreateImageUploadCommandSequence(copyQueue, graphicsQueue, imageUploadDesc);
+            // the stage is released once the copy retired on the transfer thread
+            co_await std::move(copySubmission.done);
+            co_return;
+        }
 
-                preTransferImageMemoryBarriers.emplace_back(preTransferBarrier);
-                bufferImageCopies.emplace_back(bufferImageCopy);
-                postTransferImageMemoryBarriers.emplace_back(copyRelease);
-            }
+        co_await _oneShotSubmissionHandler->ResumeOnRecordingContext();
 
-            uploadCommandBuffer.PipelineBarrier(
-                VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TRANSFER_BIT,
-                0,
-                0, nullptr, 0, nullptr,
-                static_cast<uint32_t>(preTransferImageMemoryBarriers.size()),
-                preTransferImageMemoryBarriers.data()
-            );
+        auto [uploadCommandBuffer, uploadCommandsDoneSemaphore] = _oneShotSubmissionHandler->NewOneShotCopyCommandBuffer();
 
-            for (auto i = 0u; i < imageUploads.size(); ++i)
-            {
-                uploadCommandBuffer.CopyBufferToImage(
-                    stageZone.Buffer(),
-                    imageUploads[i].destination_image,
-                    VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    1u,
-                    &bufferImageCopies[i]
-                );
-            }
-            VkBufferCopy bufferCopy{ .srcOffset = bufferUpload.stage_zone_offset, .dstOffset = bufferUpload.dst_offset, .size = bufferUpload.bytes };
-            
-            uploadCommandBuffer.CopyBuffer(
-                stageZone.Buffer(),
-                bufferUpload.dst_buffer,
-                1u,
-                &bufferCopy
-            );
+        RecordCopyCommands(uploadCommandBuffer, stage->Buffer(), batch);
+
+        co_await _oneShotSubmissionHandler->AppendCopyCommandSubmission(uploadCommandBuffer, uploadCommandsDoneSemaphore);
+
+        if (acquire || !batch.image_mips.empty())
+        {
+            auto [graphicsCommandBuffer, graphicsCommandsDoneSemaphore] = _oneShotSubmissionHandler->NewOneShotGraphicsCommandBuffer();
+
+            RecordGraphicsCommands(graphicsCommandBuffer, batch, acquire);
 
-            VkBufferMemoryBarrier bufferMemoryBarrier
+            std::array< OneShotSubmissionWait, 1> waitList
             {
-                 .srcAccessMask = VkAccessFlagBits::VK_ACCESS_TRANSFER_WRITE_BIT,
-                 .dstAccessMask = VkAccessFlagBits::VK_ACCESS_SHADER_READ_BIT,
-                 .srcQueueFamilyIndex = copyQueue.Family(),
-                 .dstQueueFamilyIndex = graphicsQueue.Family(),
-                 .buffer = bufferUpload.dst_buffer,
-                 .offset = 0,
-                 .size = bufferUpload.bytes
+                OneShotSubmissionWait
+                {
+                    .semaphore = uploadCommandsDoneSemaphore.Get(),
+                    .value = uploadCommandsDoneSemaphore.Value(),
+                    .stages = GraphicsWaitStages(batch)
+                }
             };
 
-            uploadCommandBuffer.PipelineBarrier(
-                VkPipelineStageFlagBits::VK_PIPELINE_STAGE_TRANSFER_BIT,
-                VkPipelineStageFlagBits::VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
-                0,
-                0, nullptr, 1u, &bufferMemoryBarrier,
-                static_cast<uint32_t>(postTransferImageMemoryBarriers.size()),
-                postTransferImageMemoryBarriers.data()
-            );
-
+            co_await _oneShotSubmissionHandler->AppendGraphicsSubmission(graphicsCommandBuffer, graphicsCommandsDoneSemaphore, waitList);
         }
 
+        co_return;
     }
 
 }
-
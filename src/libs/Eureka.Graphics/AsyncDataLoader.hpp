@@ -6,8 +6,8 @@
 
 namespace eureka::vulkan
 {
-    class PoolSequentialStageZone;
-    class BufferMemoryPool;
+    class StagingRing;
+    class MemoryBudgetTracker;
 }
 
 namespace eureka::graphics
@@ -19,26 +19,29 @@ namespace eureka::graphics
     {
     private:
         std::shared_ptr<OneShotSubmissionHandler>  _oneShotSubmissionHandler;
-        std::shared_ptr<vulkan::BufferMemoryPool>  _uploadPool;
+        std::shared_ptr<vulkan::StagingRing>       _stagingRing;
+        std::shared_ptr<vulkan::MemoryBudgetTracker> _memoryBudget;
     public:
         AsyncDataLoader(
             std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler,
-            std::shared_ptr<vulkan::BufferMemoryPool> uploadPool
+            std::shared_ptr<vulkan::StagingRing> stagingRing,
+            std::shared_ptr<vulkan::MemoryBudgetTracker> memoryBudget = nullptr // optional, defers uploads instead of allocating stage memory past the budget
         );
         ~AsyncDataLoader();
         future_t<void> UploadImageAsync(const vulkan::ImageStageUploadDesc& transferDesc);
-        //future_t<void> UploadImagesAndBufferAsync(
-        //    std::vector<vulkan::ImageStageUploadDesc> imageTransferDesc,
-        //    uint64_t totalImageMemory,
-        //    vulkan::BufferDataUploadTransferDesc bufferTransferDesc
-        //);
 
-    private:
-        void RecordUploadCommands(
-            vulkan::LinearCommandBufferHandle uploadCommandBuffer,
-            dynamic_span<vulkan::ImageStageUploadDesc> imageUploads,
-            const vulkan::BufferDataUploadTransferDesc& bufferUpload,
-            const vulkan::PoolSequentialStageZone& stageZone
+        //
+        // uploads the whole batch with a single stage allocation, one copy submission (one barrier batch per phase)
+        // and, when the queue families differ or an image generates its mips, one graphics queue submission for the
+        // acquire and the mip blits
+        // the stage_zone_offset of every description is assigned here, the source spans are copied before the
+        // first suspension and do not have to outlive the call
+        // a batch that finds the ring full while the host heap is near its budget waits for ring space instead of
+        // allocating a dedicated stage, the sources are kept in system memory meanwhile
+        //
+        future_t<void> UploadImagesAndBuffersAsync(
+            std::vector<vulkan::ImageStageUploadDesc> imageUploads,
+            std::vector<vulkan::BufferDataUploadTransferDesc> bufferUploads
         );
     };
 
@@ -0,0 +1,103 @@
+#include "FramePacer.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace eureka::graphics
+{
+    FramePacer::FramePacer(FramePacerConfig config) :
+        _config(config),
+        _interval(static_cast<double>(config.nominal_interval.count()))
+    {
+    }
+
+    uint32_t FramePacer::RecordPresent(std::chrono::nanoseconds presentTimepoint)
+    {
+        std::scoped_lock lk(_mtx);
+
+        auto elapsed = static_cast<double>((presentTimepoint - _lastPresent).count());
+        auto vblanks = std::max(1.0, std::round(elapsed / _interval));
+        auto first = _counters.frames == 0;
+
+        _lastPresent = presentTimepoint;
+        ++_counters.frames;
+
+        if (first || vblanks > _config.idle_intervals)
+        {
+            // nothing to learn from a pause, the phase restarts at this present
+            _counters.idle_gaps += first ? 0 : 1;
+            _anchor = presentTimepoint;
+            return 0;
+        }
+
+        auto sample = std::clamp(
+            elapsed / vblanks,
+            static_cast<double>(_config.min_interval.count()),
+            static_cast<double>(_config.max_interval.count())
+        );
+        _interval += (sample - _interval) * _config.interval_smoothing;
+
+        // the vblank this present landed on, as predicted from the previous one
+        auto predicted = _anchor + std::chrono::nanoseconds(static_cast<int64_t>(std::round(vblanks * _interval)));
+        auto phaseError = presentTimepoint - predicted;
+        _anchor = predicted + std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(phaseError.count()) * _config.phase_smoothing));
+
+        ++_pacedPresents;
+        _totalPhaseError += std::chrono::abs(phaseError);
+
+        auto missed = static_cast<uint32_t>(vblanks) - 1;
+        if (missed)
+        {
+            ++_counters.late_frames;
+            _counters.dropped_frames += missed;
+        }
+        return missed;
+    }
+
+    VsyncPrediction FramePacer::Predict(std::chrono::nanoseconds timepoint) const
+    {
+        std::scoped_lock lk(_mtx);
+        return PredictLocked(timepoint);
+    }
+
+    VsyncPrediction FramePacer::PredictAfterPresent(std::chrono::nanoseconds presentTimepoint) const
+    {
+        std::scoped_lock lk(_mtx);
+
+        // a present timestamp right after its vblank would round up to the following one, half an interval back
+        // lands on the presented vblank for jitter of either sign
+        auto halfInterval = std::chrono::nanoseconds(static_cast<int64_t>(_interval / 2));
+        return PredictLocked(presentTimepoint - halfInterval);
+    }
+
+    VsyncPrediction FramePacer::PredictLocked(std::chrono::nanoseconds timepoint) const
+    {
+        auto interval = std::chrono::nanoseconds(static_cast<int64_t>(_interval));
+
+        if (_counters.frames == 0)
+        {
+            return VsyncPrediction{ .frame_start = timepoint, .frame_target = timepoint + interval };
+        }
+
+        auto sinceAnchor = static_cast<double>((timepoint - _anchor).count());
+        auto vblanks = std::ceil(sinceAnchor / _interval);
+        auto frameStart = _anchor + std::chrono::nanoseconds(static_cast<int64_t>(vblanks * _interval));
+
+        return VsyncPrediction{ .frame_start = frameStart, .frame_target = frameStart + interval };
+    }
+
+    std::chrono::nanoseconds FramePacer::Interval() const
+    {
+        std::scoped_lock lk(_mtx);
+        return std::chrono::nanoseconds(static_cast<int64_t>(_interval));
+    }
+
+    FramePacerCounters FramePacer::Counters() const
+    {
+        std::scoped_lock lk(_mtx);
+
+        auto counters = _counters;
+        counters.interval = std::chrono::nanoseconds(static_cast<int64_t>(_interval));
+        counters.avg_phase_error = _pacedPresents ? _totalPhaseError / static_cast<int64_t>(_pacedPresents) : std::chrono::nanoseconds(0);
+        return counters;
+    }
+}
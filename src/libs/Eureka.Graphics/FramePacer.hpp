@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <mutex>
+
+namespace eureka::graphics
+{
+    struct FramePacerConfig
+    {
+        std::chrono::nanoseconds nominal_interval{ std::chrono::nanoseconds(std::chrono::seconds(1)) / 60 }; // until presents teach otherwise
+        std::chrono::nanoseconds min_interval{ std::chrono::milliseconds(2) };    // 500Hz
+        std::chrono::nanoseconds max_interval{ std::chrono::milliseconds(50) };   // 20Hz
+        double                   interval_smoothing{ 1.0 / 16.0 };  // weight of a new interval sample
+        double                   phase_smoothing{ 0.25 };           // weight of a new vblank phase sample
+        uint32_t                 idle_intervals{ 6 };               // a gap of more vblanks than that is an idle pause, not dropped frames
+    };
+
+    struct FramePacerCounters
+    {
+        uint64_t                 frames{ 0 };
+        uint64_t                 late_frames{ 0 };      // presents that missed at least one vblank
+        uint64_t                 dropped_frames{ 0 };   // vblanks missed between consecutive presents
+        uint64_t                 idle_gaps{ 0 };
+        std::chrono::nanoseconds interval{ 0 };         // learned present interval
+        std::chrono::nanoseconds avg_phase_error{ 0 };  // |present - predicted vblank|, jitter of the timestamps
+    };
+
+    struct VsyncPrediction
+    {
+        std::chrono::nanoseconds frame_start;   // vblank the next frame starts at
+        std::chrono::nanoseconds frame_target;  // vblank it should be presented at
+    };
+
+    //
+    // FramePacer
+    // learns the present interval and the vblank phase from presentation timestamps and predicts the next vblanks
+    // without display timing extensions the timestamp is taken once the present returned, with a fifo swap chain
+    // that is locked to the vblank cadence up to scheduling jitter, the phase is filtered to absorb it
+    // an interval of n vblanks is n - 1 dropped frames, as long as n stays under idle_intervals
+    //
+    // timepoints are nanoseconds of any monotonic clock, the same one for every call
+    // thread safe, presents are usually recorded on the rendering thread and predictions made elsewhere
+    //
+    class FramePacer
+    {
+        FramePacerConfig         _config;
+        mutable std::mutex       _mtx;
+        double                   _interval;            // nanoseconds
+        std::chrono::nanoseconds _anchor{ 0 };         // filtered timepoint of the last presented vblank
+        std::chrono::nanoseconds _lastPresent{ 0 };
+        FramePacerCounters       _counters;
+        std::chrono::nanoseconds _totalPhaseError{ 0 };
+        uint64_t                 _pacedPresents{ 0 };
+
+        VsyncPrediction PredictLocked(std::chrono::nanoseconds timepoint) const;
+    public:
+        explicit FramePacer(FramePacerConfig config = {});
+
+        // returns the vblanks the present missed
+        uint32_t RecordPresent(std::chrono::nanoseconds presentTimepoint);
+
+        // the first vblank at or after the timepoint and the one after it
+        VsyncPrediction Predict(std::chrono::nanoseconds timepoint) const;
+        // the vblank a present landed on and the one after it, the timestamp may be on either side of its vblank
+        VsyncPrediction PredictAfterPresent(std::chrono::nanoseconds presentTimepoint) const;
+        std::chrono::nanoseconds Interval() const;
+
+        FramePacerCounters Counters() const;
+    };
+}
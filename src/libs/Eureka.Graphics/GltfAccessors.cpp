@@ -0,0 +1,318 @@
+#include "GltfAccessors.hpp"
+#include <basic_errors.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define EUREKA_GLTF_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace eureka::graphics
+{
+    uint32_t GltfComponentByteSize(GltfComponentType type)
+    {
+        switch (type)
+        {
+        case GltfComponentType::eByte:
+        case GltfComponentType::eUnsignedByte:
+            return 1;
+        case GltfComponentType::eShort:
+        case GltfComponentType::eUnsignedShort:
+            return 2;
+        case GltfComponentType::eUnsignedInt:
+        case GltfComponentType::eFloat:
+            return 4;
+        }
+        throw file_load_error("unknown gltf component type");
+    }
+
+    namespace
+    {
+        template<typename T>
+        T Load(const uint8_t* p)
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            return value;
+        }
+
+        float ReadComponent(const uint8_t* p, GltfComponentType type, bool normalized)
+        {
+            // normalization as specified by glTF 2.0 3.11, signed values clamp at -1
+            switch (type)
+            {
+            case GltfComponentType::eFloat:
+                return Load<float>(p);
+            case GltfComponentType::eUnsignedByte:
+                return normalized ? Load<uint8_t>(p) / 255.0f : Load<uint8_t>(p);
+            case GltfComponentType::eByte:
+                return normalized ? std::max(Load<int8_t>(p) / 127.0f, -1.0f) : Load<int8_t>(p);
+            case GltfComponentType::eUnsignedShort:
+                return normalized ? Load<uint16_t>(p) / 65535.0f : Load<uint16_t>(p);
+            case GltfComponentType::eShort:
+                return normalized ? std::max(Load<int16_t>(p) / 32767.0f, -1.0f) : Load<int16_t>(p);
+            case GltfComponentType::eUnsignedInt:
+                return static_cast<float>(Load<uint32_t>(p));
+            }
+            return 0.0f;
+        }
+
+        uint32_t ReadIndex(const uint8_t* p, GltfComponentType type)
+        {
+            switch (type)
+            {
+            case GltfComponentType::eUnsignedByte:
+                return Load<uint8_t>(p);
+            case GltfComponentType::eUnsignedShort:
+                return Load<uint16_t>(p);
+            case GltfComponentType::eUnsignedInt:
+                return Load<uint32_t>(p);
+            default:
+                throw file_load_error("unsupported gltf index component type");
+            }
+        }
+
+        void ConvertElement(const uint8_t* src, const GltfAccessorView& accessor, uint32_t copyComponents, float* dst)
+        {
+            auto componentSize = GltfComponentByteSize(accessor.component_type);
+            for (auto c = 0u; c < copyComponents; ++c)
+            {
+                dst[c] = ReadComponent(src + c * componentSize, accessor.component_type, accessor.normalized);
+            }
+        }
+
+#ifdef EUREKA_GLTF_SSE2
+        //
+        // strided float3 / float4 gather, every element but the last is moved with a single 16 byte load and store
+        // the load may read the first component of the next element and the store may spill into the next
+        // destination element (overwritten by the following iteration), the last element goes the scalar way
+        //
+        uint64_t GatherFloatsSSE(const GltfAccessorView& accessor, uint32_t dstComponents, uint32_t copyComponents, float* dst)
+        {
+            if (accessor.count < 2 || accessor.stride < 12 || copyComponents < 3 || dstComponents < 3 || dstComponents > 4)
+            {
+                return 0;
+            }
+
+            const auto mask = copyComponents == 3 ? _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1)) : _mm_castsi128_ps(_mm_set1_epi32(-1));
+            const auto* src = accessor.data;
+            auto count = accessor.count - 1;
+
+            for (uint64_t i = 0; i < count; ++i)
+            {
+                auto v = _mm_and_ps(_mm_loadu_ps(reinterpret_cast<const float*>(src + i * accessor.stride)), mask);
+                _mm_storeu_ps(dst + i * dstComponents, v);
+            }
+            return count;
+        }
+
+        //
+        // packed normalized / integer 8 and 16 bit components, converted as a flat array of values
+        //
+        uint64_t ConvertPackedIntegersSSE(const GltfAccessorView& accessor, uint64_t values, float* dst)
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto* src = accessor.data;
+            uint64_t i = 0;
+
+            auto store = [&](__m128i ints, float* out, float scale, bool clamp)
+            {
+                auto f = _mm_cvtepi32_ps(ints);
+                if (accessor.normalized)
+                {
+                    f = _mm_mul_ps(f, _mm_set1_ps(scale));
+                    if (clamp)
+                    {
+                        f = _mm_max_ps(f, _mm_set1_ps(-1.0f));
+                    }
+                }
+                _mm_storeu_ps(out, f);
+            };
+
+            switch (accessor.component_type)
+            {
+            case GltfComponentType::eUnsignedShort:
+            case GltfComponentType::eShort:
+            {
+                bool isSigned = accessor.component_type == GltfComponentType::eShort;
+                float scale = isSigned ? 1.0f / 32767.0f : 1.0f / 65535.0f;
+                for (; i + 8 <= values; i += 8)
+                {
+                    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+                    auto lo = isSigned ? _mm_srai_epi32(_mm_unpacklo_epi16(zero, v), 16) : _mm_unpacklo_epi16(v, zero);
+                    auto hi = isSigned ? _mm_srai_epi32(_mm_unpackhi_epi16(zero, v), 16) : _mm_unpackhi_epi16(v, zero);
+                    store(lo, dst + i, scale, isSigned);
+                    store(hi, dst + i + 4, scale, isSigned);
+                }
+                break;
+            }
+            case GltfComponentType::eUnsignedByte:
+            case GltfComponentType::eByte:
+            {
+                bool isSigned = accessor.component_type == GltfComponentType::eByte;
+                float scale = isSigned ? 1.0f / 127.0f : 1.0f / 255.0f;
+                for (; i + 16 <= values; i += 16)
+                {
+                    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    auto lo16 = isSigned ? _mm_srai_epi16(_mm_unpacklo_epi8(zero, v), 8) : _mm_unpacklo_epi8(v, zero);
+                    auto hi16 = isSigned ? _mm_srai_epi16(_mm_unpackhi_epi8(zero, v), 8) : _mm_unpackhi_epi8(v, zero);
+                    // the 16 bit lanes are sign extended already, widening them signed is exact for both
+                    store(_mm_srai_epi32(_mm_unpacklo_epi16(zero, lo16), 16), dst + i, scale, isSigned);
+                    store(_mm_srai_epi32(_mm_unpackhi_epi16(zero, lo16), 16), dst + i + 4, scale, isSigned);
+                    store(_mm_srai_epi32(_mm_unpacklo_epi16(zero, hi16), 16), dst + i + 8, scale, isSigned);
+                    store(_mm_srai_epi32(_mm_unpackhi_epi16(zero, hi16), 16), dst + i + 12, scale, isSigned);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            return i;
+        }
+
+        uint64_t WidenIndicesSSE(const GltfAccessorView& accessor, uint32_t* dst)
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto* src = accessor.data;
+            uint64_t i = 0;
+
+            if (accessor.component_type == GltfComponentType::eUnsignedShort)
+            {
+                for (; i + 8 <= accessor.count; i += 8)
+                {
+                    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(v, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(v, zero));
+                }
+            }
+            else if (accessor.component_type == GltfComponentType::eUnsignedByte)
+            {
+                for (; i + 16 <= accessor.count; i += 16)
+                {
+                    auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+                    auto lo = _mm_unpacklo_epi8(v, zero);
+                    auto hi = _mm_unpackhi_epi8(v, zero);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(lo, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(lo, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(hi, zero));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(hi, zero));
+                }
+            }
+            return i;
+        }
+#endif
+
+        void ReadDenseFloats(const GltfAccessorView& accessor, uint32_t dstComponents, float* dst)
+        {
+            auto copyComponents = std::min(accessor.components, dstComponents);
+
+            if (!accessor.data || copyComponents < dstComponents)
+            {
+                std::fill_n(dst, accessor.count * dstComponents, 0.0f);
+                if (!accessor.data)
+                {
+                    return;
+                }
+            }
+
+            bool isFloat = accessor.component_type == GltfComponentType::eFloat;
+            bool packed = accessor.stride == accessor.ElementByteSize();
+
+            if (isFloat && packed && accessor.components == dstComponents)
+            {
+                std::memcpy(dst, accessor.data, accessor.count * dstComponents * sizeof(float));
+                return;
+            }
+
+            uint64_t first = 0;
+#ifdef EUREKA_GLTF_SSE2
+            if (isFloat)
+            {
+                first = GatherFloatsSSE(accessor, dstComponents, copyComponents, dst);
+            }
+            else if (packed && accessor.components == dstComponents && accessor.component_type != GltfComponentType::eUnsignedInt)
+            {
+                auto values = accessor.count * dstComponents;
+                auto converted = ConvertPackedIntegersSSE(accessor, values, dst);
+                for (auto v = converted; v < values; ++v)
+                {
+                    dst[v] = ReadComponent(accessor.data + v * GltfComponentByteSize(accessor.component_type), accessor.component_type, accessor.normalized);
+                }
+                return;
+            }
+#endif
+            for (auto i = first; i < accessor.count; ++i)
+            {
+                ConvertElement(accessor.data + i * accessor.stride, accessor, copyComponents, dst + i * dstComponents);
+            }
+        }
+    }
+
+    void ReadGltfAccessorFloats(const GltfAccessorView& accessor, uint32_t dstComponents, dspan<float> dst)
+    {
+        assert(dst.size() == accessor.count * dstComponents);
+
+        ReadDenseFloats(accessor, dstComponents, dst.data());
+
+        auto copyComponents = std::min(accessor.components, dstComponents);
+        auto indexSize = accessor.sparse_count ? GltfComponentByteSize(accessor.sparse_index_type) : 0;
+        auto elementSize = accessor.ElementByteSize();
+
+        for (uint64_t k = 0; k < accessor.sparse_count; ++k)
+        {
+            auto index = ReadIndex(accessor.sparse_indices + k * indexSize, accessor.sparse_index_type);
+            if (index >= accessor.count)
+            {
+                throw file_load_error("gltf sparse accessor index out of range");
+            }
+            ConvertElement(accessor.sparse_values + k * elementSize, accessor, copyComponents, dst.data() + uint64_t(index) * dstComponents);
+        }
+    }
+
+    void ReadGltfAccessorIndices(const GltfAccessorView& accessor, dspan<uint32_t> dst)
+    {
+        assert(dst.size() == accessor.count);
+
+        if (accessor.components != 1)
+        {
+            throw file_load_error("gltf index accessor is not scalar");
+        }
+
+        if (!accessor.data)
+        {
+            std::fill(dst.begin(), dst.end(), 0u);
+        }
+        else if (accessor.component_type == GltfComponentType::eUnsignedInt && accessor.IsPacked())
+        {
+            std::memcpy(dst.data(), accessor.data, accessor.count * sizeof(uint32_t));
+        }
+        else
+        {
+            uint64_t first = 0;
+#ifdef EUREKA_GLTF_SSE2
+            if (accessor.stride == GltfComponentByteSize(accessor.component_type))
+            {
+                first = WidenIndicesSSE(accessor, dst.data());
+            }
+#endif
+            for (auto i = first; i < accessor.count; ++i)
+            {
+                dst[i] = ReadIndex(accessor.data + i * accessor.stride, accessor.component_type);
+            }
+        }
+
+        auto indexSize = accessor.sparse_count ? GltfComponentByteSize(accessor.sparse_index_type) : 0;
+        auto valueSize = GltfComponentByteSize(accessor.component_type);
+        for (uint64_t k = 0; k < accessor.sparse_count; ++k)
+        {
+            auto index = ReadIndex(accessor.sparse_indices + k * indexSize, accessor.sparse_index_type);
+            if (index >= accessor.count)
+            {
+                throw file_load_error("gltf sparse accessor index out of range");
+            }
+            dst[index] = ReadIndex(accessor.sparse_values + k * valueSize, accessor.component_type);
+        }
+    }
+}
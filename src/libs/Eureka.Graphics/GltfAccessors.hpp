@@ -0,0 +1,69 @@
+#pragma once
+#include <containers_aliases.hpp>
+#include <cstdint>
+
+namespace eureka::graphics
+{
+    // glTF 2.0 accessor component types, the values are the GL enums used by the format
+    enum class GltfComponentType : uint32_t
+    {
+        eByte = 5120,
+        eUnsignedByte = 5121,
+        eShort = 5122,
+        eUnsignedShort = 5123,
+        eUnsignedInt = 5125,
+        eFloat = 5126
+    };
+
+    uint32_t GltfComponentByteSize(GltfComponentType type);
+
+    //
+    // GltfAccessorView
+    // an accessor resolved against its buffer view, data points into the mapped buffer
+    // data is null for accessors without a buffer view, their dense elements are zeros (sparse only accessors)
+    //
+    struct GltfAccessorView
+    {
+        const uint8_t*    data{ nullptr };
+        uint64_t          count{ 0 };
+        uint32_t          stride{ 0 };              // bytes between elements, the packed element size when the view has no byteStride
+        GltfComponentType component_type{ GltfComponentType::eFloat };
+        uint32_t          components{ 1 };
+        bool              normalized{ false };
+
+        // sparse substitution, indices ascending, values tightly packed with the accessor's component type
+        uint64_t          sparse_count{ 0 };
+        const uint8_t*    sparse_indices{ nullptr };
+        GltfComponentType sparse_index_type{ GltfComponentType::eUnsignedInt };
+        const uint8_t*    sparse_values{ nullptr };
+
+        uint32_t ElementByteSize() const
+        {
+            return components * GltfComponentByteSize(component_type);
+        }
+
+        // the accessor's bytes can be used as is by a tightly packed consumer of the same type
+        bool IsPacked() const
+        {
+            return data && sparse_count == 0 && stride == ElementByteSize();
+        }
+
+        dcspan<uint8_t> PackedBytes() const
+        {
+            return { data, count * ElementByteSize() };
+        }
+    };
+
+    //
+    // converts an accessor to tightly packed floats, dst holds count * dstComponents values
+    // integer components are normalized to [0, 1] / [-1, 1] when the accessor is normalized, converted as is otherwise
+    // components the accessor doesn't have are zero filled, extra accessor components are dropped
+    // interleaved and sparse accessors are supported, the common layouts take SSE paths
+    //
+    void ReadGltfAccessorFloats(const GltfAccessorView& accessor, uint32_t dstComponents, dspan<float> dst);
+
+    //
+    // converts an index accessor (uint8 / uint16 / uint32 scalars) to uint32 indices, dst holds count values
+    //
+    void ReadGltfAccessorIndices(const GltfAccessorView& accessor, dspan<uint32_t> dst);
+}
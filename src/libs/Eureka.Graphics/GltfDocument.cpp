@@ -0,0 +1,527 @@
+#include "GltfDocument.hpp"
+#include <basic_errors.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstring>
+#include <optional>
+
+namespace eureka::graphics
+{
+    namespace
+    {
+        constexpr uint32_t GLB_MAGIC = 0x46546C67;       // "glTF"
+        constexpr uint32_t GLB_CHUNK_JSON = 0x4E4F534A;  // "JSON"
+        constexpr uint32_t GLB_CHUNK_BIN = 0x004E4942;   // "BIN\0"
+        constexpr uint32_t GLB_HEADER_SIZE = 12;
+        constexpr uint32_t GLB_CHUNK_HEADER_SIZE = 8;
+
+        uint32_t LoadU32(const uint8_t* p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t TypeComponents(const std::string& type)
+        {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2") return 2;
+            if (type == "VEC3") return 3;
+            if (type == "VEC4") return 4;
+            if (type == "MAT2") return 4;
+            if (type == "MAT3") return 9;
+            if (type == "MAT4") return 16;
+            throw file_load_error("unknown gltf accessor type " + type);
+        }
+
+        int32_t OptionalIndex(const nlohmann::json& object, const char* key)
+        {
+            auto it = object.find(key);
+            return it == object.end() ? -1 : it->get<int32_t>();
+        }
+
+        std::string DecodePercentEscapes(const std::string& uri)
+        {
+            std::string decoded;
+            decoded.reserve(uri.size());
+            for (std::size_t i = 0; i < uri.size(); ++i)
+            {
+                if (uri[i] == '%' && i + 2 < uri.size())
+                {
+                    decoded.push_back(static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16)));
+                    i += 2;
+                }
+                else
+                {
+                    decoded.push_back(uri[i]);
+                }
+            }
+            return decoded;
+        }
+
+        std::vector<uint8_t> DecodeBase64(std::string_view text)
+        {
+            auto value = [](char c) -> int
+            {
+                if (c >= 'A' && c <= 'Z') return c - 'A';
+                if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+                if (c >= '0' && c <= '9') return c - '0' + 52;
+                if (c == '+' || c == '-') return 62;
+                if (c == '/' || c == '_') return 63;
+                return -1;
+            };
+
+            std::vector<uint8_t> bytes;
+            bytes.reserve(text.size() / 4 * 3);
+
+            uint32_t accumulator = 0;
+            int bits = 0;
+            for (auto c : text)
+            {
+                auto v = value(c);
+                if (v < 0)
+                {
+                    continue; // padding / whitespace
+                }
+                accumulator = (accumulator << 6) | static_cast<uint32_t>(v);
+                bits += 6;
+                if (bits >= 8)
+                {
+                    bits -= 8;
+                    bytes.push_back(static_cast<uint8_t>(accumulator >> bits));
+                }
+            }
+            return bytes;
+        }
+
+        std::optional<std::string_view> DataUriPayload(const std::string& uri)
+        {
+            if (!uri.starts_with("data:"))
+            {
+                return std::nullopt;
+            }
+
+            auto comma = uri.find(',');
+            if (comma == std::string::npos || uri.rfind(";base64", comma) == std::string::npos)
+            {
+                throw file_load_error("unsupported gltf data uri");
+            }
+            return std::string_view(uri).substr(comma + 1);
+        }
+    }
+
+    GltfDocument::GltfDocument(const std::filesystem::path& path)
+        :
+        _file(path),
+        _sourcePaths{ path }
+    {
+        auto bytes = _file.bytes();
+        auto baseDirectory = path.parent_path();
+
+        if (bytes.size() >= GLB_HEADER_SIZE && LoadU32(bytes.data()) == GLB_MAGIC)
+        {
+            // header, a json chunk and an optional bin chunk, chunks are 4 byte aligned
+            auto length = std::min<uint64_t>(LoadU32(bytes.data() + 8), bytes.size());
+            dcspan<uint8_t> json;
+            dcspan<uint8_t> bin;
+
+            uint64_t offset = GLB_HEADER_SIZE;
+            while (offset + GLB_CHUNK_HEADER_SIZE <= length)
+            {
+                auto chunkLength = LoadU32(bytes.data() + offset);
+                auto chunkType = LoadU32(bytes.data() + offset + 4);
+                auto chunkStart = offset + GLB_CHUNK_HEADER_SIZE;
+                if (chunkStart + chunkLength > length)
+                {
+                    throw file_load_error("truncated glb chunk in " + path.string());
+                }
+
+                auto chunk = bytes.subspan(chunkStart, chunkLength);
+                if (chunkType == GLB_CHUNK_JSON && json.empty())
+                {
+                    json = chunk;
+                }
+                else if (chunkType == GLB_CHUNK_BIN && bin.empty())
+                {
+                    bin = chunk;
+                }
+                offset = chunkStart + ((chunkLength + 3) & ~3u);
+            }
+
+            if (json.empty())
+            {
+                throw file_load_error("glb without a json chunk " + path.string());
+            }
+            Parse(json, bin, baseDirectory);
+        }
+        else
+        {
+            Parse(bytes, {}, baseDirectory);
+        }
+    }
+
+    dcspan<uint8_t> GltfDocument::MapExternalFile(const std::filesystem::path& baseDirectory, const std::string& uri)
+    {
+        // uris are utf8
+        auto decoded = DecodePercentEscapes(uri);
+        auto path = baseDirectory / std::filesystem::path(std::u8string(decoded.begin(), decoded.end()));
+        auto& file = _externalFiles.emplace_back(path);
+        _sourcePaths.emplace_back(std::move(path));
+        return file.bytes();
+    }
+
+    void GltfDocument::Parse(dcspan<uint8_t> jsonBytes, dcspan<uint8_t> binChunk, const std::filesystem::path& baseDirectory)
+    {
+        nlohmann::json json;
+        try
+        {
+            json = nlohmann::json::parse(jsonBytes.begin(), jsonBytes.end());
+        }
+        catch (const nlohmann::json::exception& err)
+        {
+            throw file_load_error(std::string("bad gltf json: ") + err.what());
+        }
+
+        auto array = [&](const char* key) -> const nlohmann::json&
+        {
+            static const nlohmann::json empty = nlohmann::json::array();
+            auto it = json.find(key);
+            return it == json.end() ? empty : *it;
+        };
+
+        try
+        {
+            //
+            // buffers, the glb bin chunk, data uris or external files
+            //
+            for (const auto& buffer : array("buffers"))
+            {
+                auto byteLength = buffer.at("byteLength").get<uint64_t>();
+                auto uri = buffer.value("uri", std::string());
+                dcspan<uint8_t> bytes;
+
+                if (uri.empty())
+                {
+                    if (!_buffers.empty() || binChunk.empty())
+                    {
+                        throw file_load_error("gltf buffer without uri outside of a glb bin chunk");
+                    }
+                    bytes = binChunk;
+                    _bufferFiles.emplace_back(-1);
+                }
+                else if (auto payload = DataUriPayload(uri))
+                {
+                    bytes = _embeddedBuffers.emplace_back(DecodeBase64(*payload));
+                    _bufferFiles.emplace_back(-2);
+                }
+                else
+                {
+                    bytes = MapExternalFile(baseDirectory, uri);
+                    _bufferFiles.emplace_back(static_cast<int32_t>(_externalFiles.size() - 1));
+                }
+
+                // the bin chunk may be padded past byteLength
+                if (bytes.size() < byteLength)
+                {
+                    throw file_load_error("gltf buffer shorter than its byteLength");
+                }
+                _buffers.emplace_back(bytes.first(byteLength));
+            }
+
+            for (const auto& view : array("bufferViews"))
+            {
+                auto& bufferView = _bufferViews.emplace_back(GltfBufferView
+                    {
+                        .buffer = view.at("buffer").get<uint32_t>(),
+                        .byte_offset = view.value("byteOffset", uint64_t(0)),
+                        .byte_length = view.at("byteLength").get<uint64_t>(),
+                        .byte_stride = view.value("byteStride", 0u)
+                    });
+
+                if (bufferView.buffer >= _buffers.size() || bufferView.byte_offset + bufferView.byte_length > _buffers[bufferView.buffer].size())
+                {
+                    throw file_load_error("gltf buffer view out of its buffer");
+                }
+            }
+
+            for (const auto& accessor : array("accessors"))
+            {
+                auto& parsed = _accessors.emplace_back(GltfAccessor
+                    {
+                        .buffer_view = OptionalIndex(accessor, "bufferView"),
+                        .byte_offset = accessor.value("byteOffset", uint64_t(0)),
+                        .count = accessor.at("count").get<uint64_t>(),
+                        .component_type = static_cast<GltfComponentType>(accessor.at("componentType").get<uint32_t>()),
+                        .components = TypeComponents(accessor.at("type").get<std::string>()),
+                        .normalized = accessor.value("normalized", false),
+                        .sparse = {}
+                    });
+
+                if (auto sparse = accessor.find("sparse"); sparse != accessor.end())
+                {
+                    const auto& indices = sparse->at("indices");
+                    const auto& values = sparse->at("values");
+                    parsed.sparse = GltfSparse
+                    {
+                        .count = sparse->at("count").get<uint64_t>(),
+                        .indices_view = indices.at("bufferView").get<uint32_t>(),
+                        .indices_offset = indices.value("byteOffset", uint64_t(0)),
+                        .index_type = static_cast<GltfComponentType>(indices.at("componentType").get<uint32_t>()),
+                        .values_view = values.at("bufferView").get<uint32_t>(),
+                        .values_offset = values.value("byteOffset", uint64_t(0))
+                    };
+                }
+            }
+
+            for (const auto& mesh : array("meshes"))
+            {
+                auto& parsed = _meshes.emplace_back();
+                for (const auto& primitive : mesh.at("primitives"))
+                {
+                    if (primitive.value("mode", 4) != 4)
+                    {
+                        throw file_load_error("only triangle list gltf primitives are supported");
+                    }
+
+                    const auto& attributes = primitive.at("attributes");
+                    parsed.primitives.emplace_back(GltfPrimitive
+                        {
+                            .indices = OptionalIndex(primitive, "indices"),
+                            .position = OptionalIndex(attributes, "POSITION"),
+                            .normal = OptionalIndex(attributes, "NORMAL"),
+                            .texcoord = OptionalIndex(attributes, "TEXCOORD_0"),
+                            .tangent = OptionalIndex(attributes, "TANGENT"),
+                            .material = OptionalIndex(primitive, "material")
+                        });
+                }
+            }
+
+            for (const auto& node : array("nodes"))
+            {
+                _nodes.emplace_back(GltfNode
+                    {
+                        .mesh = OptionalIndex(node, "mesh"),
+                        .children = node.value("children", std::vector<uint32_t>())
+                    });
+            }
+
+            for (const auto& image : array("images"))
+            {
+                auto& parsed = _images.emplace_back(GltfImage
+                    {
+                        .buffer_view = OptionalIndex(image, "bufferView"),
+                        .uri = image.value("uri", std::string()),
+                        .mime_type = image.value("mimeType", std::string())
+                    });
+
+                if (parsed.buffer_view >= 0)
+                {
+                    _imageFiles.emplace_back();
+                }
+                else if (auto payload = DataUriPayload(parsed.uri))
+                {
+                    _imageFiles.emplace_back(_embeddedBuffers.emplace_back(DecodeBase64(*payload)));
+                }
+                else
+                {
+                    _imageFiles.emplace_back(MapExternalFile(baseDirectory, parsed.uri));
+                }
+            }
+
+            // a KHR_texture_basisu source takes precedence, the plain source is the fallback for loaders without ktx2
+            // an image only ever used as that fallback is not decoded at all
+            std::vector<int32_t> textureSources;
+            std::vector<bool> sampled(_images.size(), false);
+            std::vector<bool> replaced(_images.size(), false);
+            for (const auto& texture : array("textures"))
+            {
+                auto source = OptionalIndex(texture, "source");
+                if (auto extensions = texture.find("extensions"); extensions != texture.end())
+                {
+                    auto basisu = extensions->find("KHR_texture_basisu");
+                    if (basisu != extensions->end() && OptionalIndex(*basisu, "source") >= 0)
+                    {
+                        if (source >= 0 && static_cast<std::size_t>(source) < replaced.size())
+                        {
+                            replaced[source] = true;
+                        }
+                        source = OptionalIndex(*basisu, "source");
+                    }
+                }
+                if (source >= 0 && static_cast<std::size_t>(source) < sampled.size())
+                {
+                    sampled[source] = true;
+                }
+                textureSources.emplace_back(source);
+            }
+            for (auto i = 0u; i < _images.size(); ++i)
+            {
+                _images[i].basisu_fallback = replaced[i] && !sampled[i];
+            }
+
+            auto textureImage = [&](const nlohmann::json& object, const char* key) -> int32_t
+            {
+                auto it = object.find(key);
+                if (it == object.end())
+                {
+                    return -1;
+                }
+                return textureSources.at(it->at("index").get<uint32_t>());
+            };
+
+            for (const auto& material : array("materials"))
+            {
+                auto& parsed = _materials.emplace_back();
+                parsed.normal_image = textureImage(material, "normalTexture");
+                if (auto pbr = material.find("pbrMetallicRoughness"); pbr != material.end())
+                {
+                    parsed.base_color_image = textureImage(*pbr, "baseColorTexture");
+                    parsed.metallic_roughness_image = textureImage(*pbr, "metallicRoughnessTexture");
+                }
+            }
+
+            const auto& scenes = array("scenes");
+            if (!scenes.empty())
+            {
+                auto scene = json.value("scene", 0u);
+                _sceneNodes = scenes.at(scene).value("nodes", std::vector<uint32_t>());
+            }
+        }
+        catch (const nlohmann::json::exception& err)
+        {
+            throw file_load_error(std::string("malformed gltf: ") + err.what());
+        }
+    }
+
+    dcspan<uint8_t> GltfDocument::BufferViewBytes(uint32_t bufferView) const
+    {
+        const auto& view = _bufferViews.at(bufferView);
+        return _buffers[view.buffer].subspan(view.byte_offset, view.byte_length);
+    }
+
+    GltfAccessorView GltfDocument::ResolveAccessor(uint32_t accessor) const
+    {
+        if (accessor >= _accessors.size())
+        {
+            throw file_load_error("gltf accessor index out of range");
+        }
+
+        const auto& desc = _accessors[accessor];
+        GltfAccessorView view
+        {
+            .count = desc.count,
+            .component_type = desc.component_type,
+            .components = desc.components,
+            .normalized = desc.normalized
+        };
+        auto elementSize = view.ElementByteSize();
+        view.stride = elementSize;
+
+        if (desc.buffer_view >= 0)
+        {
+            auto bytes = BufferViewBytes(static_cast<uint32_t>(desc.buffer_view));
+            auto stride = _bufferViews[desc.buffer_view].byte_stride;
+            view.stride = stride ? stride : elementSize;
+
+            if (desc.count && desc.byte_offset + (desc.count - 1) * view.stride + elementSize > bytes.size())
+            {
+                throw file_load_error("gltf accessor out of its buffer view");
+            }
+            view.data = bytes.data() + desc.byte_offset;
+        }
+
+        if (desc.sparse.count)
+        {
+            auto indices = BufferViewBytes(desc.sparse.indices_view);
+            auto values = BufferViewBytes(desc.sparse.values_view);
+            if (desc.sparse.indices_offset + desc.sparse.count * GltfComponentByteSize(desc.sparse.index_type) > indices.size() ||
+                desc.sparse.values_offset + desc.sparse.count * elementSize > values.size())
+            {
+                throw file_load_error("gltf sparse accessor out of its buffer views");
+            }
+
+            view.sparse_count = desc.sparse.count;
+            view.sparse_indices = indices.data() + desc.sparse.indices_offset;
+            view.sparse_index_type = desc.sparse.index_type;
+            view.sparse_values = values.data() + desc.sparse.values_offset;
+        }
+
+        return view;
+    }
+
+    dcspan<uint8_t> GltfDocument::ImageBytes(uint32_t image) const
+    {
+        const auto& desc = _images.at(image);
+        return desc.buffer_view >= 0 ? BufferViewBytes(static_cast<uint32_t>(desc.buffer_view)) : _imageFiles[image];
+    }
+
+    std::vector<uint32_t> GltfDocument::SceneMeshes() const
+    {
+        std::vector<uint32_t> meshes;
+        std::vector<bool> visited(_nodes.size(), false);
+        std::vector<bool> listed(_meshes.size(), false);
+        std::vector<uint32_t> stack(_sceneNodes.rbegin(), _sceneNodes.rend());
+
+        while (!stack.empty())
+        {
+            auto node = stack.back();
+            stack.pop_back();
+            if (node >= _nodes.size() || visited[node])
+            {
+                continue;
+            }
+            visited[node] = true;
+
+            auto mesh = _nodes[node].mesh;
+            if (mesh >= 0 && static_cast<uint32_t>(mesh) < _meshes.size() && !listed[mesh])
+            {
+                listed[mesh] = true;
+                meshes.emplace_back(static_cast<uint32_t>(mesh));
+            }
+            stack.insert(stack.end(), _nodes[node].children.rbegin(), _nodes[node].children.rend());
+        }
+        return meshes;
+    }
+
+    void GltfDocument::PrefetchAccessor(uint32_t accessor) const
+    {
+        const auto& desc = _accessors.at(accessor);
+        if (desc.buffer_view < 0)
+        {
+            return;
+        }
+
+        const auto& view = _bufferViews[desc.buffer_view];
+        auto fileIndex = _bufferFiles[view.buffer];
+        if (fileIndex == -2)
+        {
+            return;
+        }
+
+        const auto& file = fileIndex == -1 ? _file : _externalFiles[fileIndex];
+        auto offset = static_cast<std::size_t>(_buffers[view.buffer].data() - file.data()) + view.byte_offset;
+        file.prefetch(offset, view.byte_length);
+    }
+
+    uint64_t GltfDocument::MappedBytes() const
+    {
+        uint64_t bytes = _file.size();
+        for (const auto& file : _externalFiles)
+        {
+            bytes += file.size();
+        }
+        return bytes;
+    }
+
+    std::vector<GltfSourceFile> GltfDocument::SourceFiles() const
+    {
+        std::vector<GltfSourceFile> files;
+        files.reserve(_sourcePaths.size());
+        files.emplace_back(GltfSourceFile{ .path = _sourcePaths.front(), .bytes = _file.bytes() });
+        for (auto i = 0u; i < _externalFiles.size(); ++i)
+        {
+            files.emplace_back(GltfSourceFile{ .path = _sourcePaths[i + 1], .bytes = _externalFiles[i].bytes() });
+        }
+        return files;
+    }
+}
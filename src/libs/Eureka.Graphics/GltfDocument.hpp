@@ -0,0 +1,138 @@
+#pragma once
+#include "GltfAccessors.hpp"
+#include <mapped_file.hpp>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace eureka::graphics
+{
+    struct GltfBufferView
+    {
+        uint32_t buffer{ 0 };
+        uint64_t byte_offset{ 0 };
+        uint64_t byte_length{ 0 };
+        uint32_t byte_stride{ 0 };                  // 0 - tightly packed
+    };
+
+    struct GltfSparse
+    {
+        uint64_t          count{ 0 };
+        uint32_t          indices_view{ 0 };
+        uint64_t          indices_offset{ 0 };
+        GltfComponentType index_type{ GltfComponentType::eUnsignedInt };
+        uint32_t          values_view{ 0 };
+        uint64_t          values_offset{ 0 };
+    };
+
+    struct GltfAccessor
+    {
+        int32_t           buffer_view{ -1 };
+        uint64_t          byte_offset{ 0 };
+        uint64_t          count{ 0 };
+        GltfComponentType component_type{ GltfComponentType::eFloat };
+        uint32_t          components{ 1 };
+        bool              normalized{ false };
+        GltfSparse        sparse;
+    };
+
+    struct GltfPrimitive
+    {
+        int32_t indices{ -1 };
+        int32_t position{ -1 };
+        int32_t normal{ -1 };
+        int32_t texcoord{ -1 };
+        int32_t tangent{ -1 };
+        int32_t material{ -1 };
+    };
+
+    struct GltfMesh
+    {
+        std::vector<GltfPrimitive> primitives;
+    };
+
+    struct GltfNode
+    {
+        int32_t               mesh{ -1 };
+        std::vector<uint32_t> children;
+    };
+
+    struct GltfImage
+    {
+        int32_t     buffer_view{ -1 };
+        std::string uri;
+        std::string mime_type;
+        bool        basisu_fallback{ false };       // only the plain source of KHR_texture_basisu textures, never sampled
+    };
+
+    struct GltfMaterial
+    {
+        int32_t base_color_image{ -1 };             // textures resolved to their source image
+        int32_t normal_image{ -1 };
+        int32_t metallic_roughness_image{ -1 };
+    };
+
+    struct GltfSourceFile
+    {
+        std::filesystem::path path;
+        dcspan<uint8_t>       bytes;
+    };
+
+    //
+    // GltfDocument
+    // a .gltf / .glb file and the binary buffers it references, memory mapped
+    // construction maps the files and parses the json, no buffer or image byte is read until it's accessed
+    // the document is immutable afterwards, the accessors can be resolved and read from any thread
+    //
+    class GltfDocument
+    {
+        os::mapped_file                     _file;
+        std::vector<os::mapped_file>        _externalFiles;       // .bin buffers and image files
+        std::vector<std::filesystem::path>  _sourcePaths;         // the document, then _externalFiles
+        std::vector<std::vector<uint8_t>>   _embeddedBuffers;     // base64 data uris, decoded
+        std::vector<dcspan<uint8_t>>        _buffers;
+        std::vector<int32_t>                _bufferFiles;         // per buffer, -1 the document, -2 embedded, index into _externalFiles otherwise
+        std::vector<dcspan<uint8_t>>        _imageFiles;          // per image, empty for buffer view images
+
+        std::vector<GltfBufferView>         _bufferViews;
+        std::vector<GltfAccessor>           _accessors;
+        std::vector<GltfMesh>               _meshes;
+        std::vector<GltfNode>               _nodes;
+        std::vector<GltfImage>              _images;
+        std::vector<GltfMaterial>           _materials;
+        std::vector<uint32_t>               _sceneNodes;          // roots of the default scene
+
+        void Parse(dcspan<uint8_t> json, dcspan<uint8_t> binChunk, const std::filesystem::path& baseDirectory);
+        dcspan<uint8_t> MapExternalFile(const std::filesystem::path& baseDirectory, const std::string& uri);
+        dcspan<uint8_t> BufferViewBytes(uint32_t bufferView) const;
+    public:
+        // throws file_not_found_error / file_load_error
+        explicit GltfDocument(const std::filesystem::path& path);
+        GltfDocument(GltfDocument&&) noexcept = default;
+        GltfDocument& operator=(GltfDocument&&) noexcept = default;
+
+        // bounds checked against the buffer view and the buffer, throws file_load_error
+        GltfAccessorView ResolveAccessor(uint32_t accessor) const;
+
+        // encoded image file bytes (png / jpeg / ktx2 ...)
+        dcspan<uint8_t> ImageBytes(uint32_t image) const;
+
+        // meshes reachable from the default scene, each listed once
+        std::vector<uint32_t> SceneMeshes() const;
+
+        // hints the kernel to read the buffer views an accessor touches ahead of the conversion
+        void PrefetchAccessor(uint32_t accessor) const;
+
+        const std::vector<GltfAccessor>& Accessors() const { return _accessors; }
+        const std::vector<GltfMesh>& Meshes() const { return _meshes; }
+        const std::vector<GltfNode>& Nodes() const { return _nodes; }
+        const std::vector<GltfImage>& Images() const { return _images; }
+        const std::vector<GltfMaterial>& Materials() const { return _materials; }
+
+        // bytes mapped for the document, its buffers and its image files
+        uint64_t MappedBytes() const;
+
+        // the document and the files it references, in mapping order
+        std::vector<GltfSourceFile> SourceFiles() const;
+    };
+}
@@ -0,0 +1,135 @@
+#include "GltfGeometry.hpp"
+#include <basic_errors.hpp>
+#include <numeric>
+
+namespace eureka::graphics
+{
+    namespace
+    {
+        dcspan<uint8_t> FloatStream(
+            const GltfDocument& document,
+            int32_t accessor,
+            uint64_t vertexCount,
+            uint32_t components,
+            GeometryStreamStorage& storage,
+            std::atomic_uint64_t& zeroCopyBytes
+        )
+        {
+            if (accessor < 0)
+            {
+                auto zeros = storage.Allocate<float>(vertexCount * components);
+                std::fill(zeros.begin(), zeros.end(), 0.0f);
+                return { reinterpret_cast<const uint8_t*>(zeros.data()), zeros.size_bytes() };
+            }
+
+            auto view = document.ResolveAccessor(static_cast<uint32_t>(accessor));
+            if (view.count != vertexCount)
+            {
+                throw file_load_error("gltf primitive attributes differ in count");
+            }
+
+            if (view.IsPacked() && view.component_type == GltfComponentType::eFloat && view.components == components)
+            {
+                zeroCopyBytes.fetch_add(view.PackedBytes().size(), std::memory_order_relaxed);
+                return view.PackedBytes();
+            }
+
+            auto floats = storage.Allocate<float>(vertexCount * components);
+            ReadGltfAccessorFloats(view, components, floats);
+            return { reinterpret_cast<const uint8_t*>(floats.data()), floats.size_bytes() };
+        }
+
+        dcspan<uint8_t> IndexStream(
+            const GltfDocument& document,
+            int32_t accessor,
+            uint64_t vertexCount,
+            GeometryStreamStorage& storage,
+            std::atomic_uint64_t& zeroCopyBytes
+        )
+        {
+            if (accessor < 0)
+            {
+                auto indices = storage.Allocate<uint32_t>(vertexCount);
+                std::iota(indices.begin(), indices.end(), 0u);
+                return { reinterpret_cast<const uint8_t*>(indices.data()), indices.size_bytes() };
+            }
+
+            auto view = document.ResolveAccessor(static_cast<uint32_t>(accessor));
+            if (view.IsPacked() && view.component_type == GltfComponentType::eUnsignedInt)
+            {
+                zeroCopyBytes.fetch_add(view.PackedBytes().size(), std::memory_order_relaxed);
+                return view.PackedBytes();
+            }
+
+            auto indices = storage.Allocate<uint32_t>(view.count);
+            ReadGltfAccessorIndices(view, indices);
+            return { reinterpret_cast<const uint8_t*>(indices.data()), indices.size_bytes() };
+        }
+    }
+
+    GltfGeometryLayout LayoutSceneGeometry(const GltfDocument& document)
+    {
+        GltfGeometryLayout layout;
+        const auto& accessors = document.Accessors();
+
+        for (auto mesh : document.SceneMeshes())
+        {
+            for (const auto& primitive : document.Meshes()[mesh].primitives)
+            {
+                if (primitive.position < 0)
+                {
+                    throw file_load_error("gltf primitive without positions");
+                }
+
+                auto vertexCount = accessors.at(primitive.position).count;
+                auto indexCount = primitive.indices >= 0 ? accessors.at(primitive.indices).count : vertexCount;
+
+                LoadedPrimitive loaded
+                {
+                    .index_offset = layout.bytes,
+                    .index_count = static_cast<uint32_t>(indexCount),
+                    .vertex_count = static_cast<uint32_t>(vertexCount),
+                    .material = primitive.material
+                };
+                loaded.position_offset = loaded.index_offset + indexCount * sizeof(uint32_t);
+                loaded.normal_offset = loaded.position_offset + vertexCount * POSITION_COMPONENTS * sizeof(float);
+                loaded.uv_offset = loaded.normal_offset + vertexCount * NORMAL_COMPONENTS * sizeof(float);
+                loaded.tangent_offset = loaded.uv_offset + vertexCount * UV_COMPONENTS * sizeof(float);
+                layout.bytes += PrimitiveGeometryBytes(loaded);
+
+                layout.primitives.emplace_back(loaded);
+                layout.sources.emplace_back(primitive);
+            }
+        }
+        return layout;
+    }
+
+    std::array<dcspan<uint8_t>, 5> ConvertPrimitiveStreams(
+        const GltfDocument& document,
+        const GltfPrimitive& source,
+        const LoadedPrimitive& target,
+        GeometryStreamStorage& storage,
+        std::atomic_uint64_t& zeroCopyBytes
+    )
+    {
+        return
+        {
+            IndexStream(document, source.indices, target.vertex_count, storage, zeroCopyBytes),
+            FloatStream(document, source.position, target.vertex_count, POSITION_COMPONENTS, storage, zeroCopyBytes),
+            FloatStream(document, source.normal, target.vertex_count, NORMAL_COMPONENTS, storage, zeroCopyBytes),
+            FloatStream(document, source.texcoord, target.vertex_count, UV_COMPONENTS, storage, zeroCopyBytes),
+            FloatStream(document, source.tangent, target.vertex_count, TANGENT_COMPONENTS, storage, zeroCopyBytes)
+        };
+    }
+
+    void PrefetchPrimitive(const GltfDocument& document, const GltfPrimitive& source)
+    {
+        for (auto accessor : { source.indices, source.position, source.normal, source.texcoord, source.tangent })
+        {
+            if (accessor >= 0)
+            {
+                document.PrefetchAccessor(static_cast<uint32_t>(accessor));
+            }
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "GltfDocument.hpp"
+#include <array>
+#include <atomic>
+
+namespace eureka::graphics
+{
+    inline constexpr uint32_t POSITION_COMPONENTS = 3;
+    inline constexpr uint32_t NORMAL_COMPONENTS = 3;
+    inline constexpr uint32_t UV_COMPONENTS = 2;
+    inline constexpr uint32_t TANGENT_COMPONENTS = 4;
+    inline constexpr uint64_t PRIMITIVE_VERTEX_BYTES = (POSITION_COMPONENTS + NORMAL_COMPONENTS + UV_COMPONENTS + TANGENT_COMPONENTS) * sizeof(float);
+
+    //
+    // a primitive's streams inside the model geometry buffer, deinterleaved
+    // uint32 indices, float3 positions, float3 normals, float2 uvs, float4 tangents
+    // missing attributes are zero filled, missing indices are generated
+    //
+    struct LoadedPrimitive
+    {
+        uint64_t index_offset{ 0 };
+        uint32_t index_count{ 0 };
+        uint64_t position_offset{ 0 };
+        uint64_t normal_offset{ 0 };
+        uint64_t uv_offset{ 0 };
+        uint64_t tangent_offset{ 0 };
+        uint32_t vertex_count{ 0 };
+        int32_t  material{ -1 };
+    };
+
+    inline uint64_t PrimitiveGeometryBytes(const LoadedPrimitive& primitive)
+    {
+        return primitive.index_count * sizeof(uint32_t) + primitive.vertex_count * PRIMITIVE_VERTEX_BYTES;
+    }
+
+    //
+    // the geometry of the default scene, primitives back to back, streams back to back inside a primitive
+    // sources[i] is the document primitive of primitives[i]
+    //
+    struct GltfGeometryLayout
+    {
+        std::vector<GltfPrimitive>   sources;
+        std::vector<LoadedPrimitive> primitives;
+        uint64_t                     bytes{ 0 };
+    };
+
+    // throws file_load_error for primitives without positions
+    GltfGeometryLayout LayoutSceneGeometry(const GltfDocument& document);
+
+    //
+    // converted streams, the spans returned by ConvertPrimitiveStreams point either here or into the document mapping
+    //
+    class GeometryStreamStorage
+    {
+        std::vector<std::vector<uint8_t>> _streams;
+    public:
+        template<typename T>
+        dspan<T> Allocate(uint64_t count)
+        {
+            auto& bytes = _streams.emplace_back(count * sizeof(T));
+            return { reinterpret_cast<T*>(bytes.data()), count };
+        }
+    };
+
+    //
+    // a primitive's streams in layout order, streams that already have the target layout are returned as is
+    // zeroCopyBytes counts the bytes of those
+    //
+    std::array<dcspan<uint8_t>, 5> ConvertPrimitiveStreams(
+        const GltfDocument& document,
+        const GltfPrimitive& source,
+        const LoadedPrimitive& target,
+        GeometryStreamStorage& storage,
+        std::atomic_uint64_t& zeroCopyBytes
+    );
+
+    // hints the kernel to read a primitive's accessors ahead of the conversion
+    void PrefetchPrimitive(const GltfDocument& document, const GltfPrimitive& source);
+}
@@ -8,9 +8,16 @@
 #include "../Eureka.Vulkan/DescriptorLayoutCache.hpp"
 
 #include "AsyncDataLoader.hpp"
+#include "GraphicsDefaults.hpp"
+
+namespace eureka::vulkan
+{
+    class FrameContext;
+}
 
 namespace eureka::graphics
 {
+    class PipelinePrecompiler;
 
     struct GlobalInheritedData
     {
@@ -21,6 +28,7 @@ namespace eureka::graphics
         std::shared_ptr<vulkan::DescriptorSetLayoutCache>       layout_cache;
         std::shared_ptr<vulkan::FreeableDescriptorSetAllocator> descriptor_allocator;
         std::shared_ptr<AsyncDataLoader>                        async_data_loader;
+        std::shared_ptr<PipelinePrecompiler>                    pipeline_precompiler; // optional, preset pipelines are compiled inline without it
     };
 
     class RenderTarget;
@@ -28,6 +36,7 @@ namespace eureka::graphics
     struct RecordParameters
     {
         vulkan::LinearCommandBufferHandle command_buffer;
+        vulkan::FrameContext*             frame_context{ nullptr }; // source of secondary command buffers, optional
     };
 
     class IPass
@@ -56,6 +65,13 @@ namespace eureka::graphics
         std::shared_ptr<vulkan::RenderPass> render_pass;
     };
 
+    // what a view pass allows its target pass to run off the calling thread
+    struct ViewPassThreading
+    {
+        bool parallel_prepare{ false };    // Prepare() may run on a worker thread, concurrently with the other view passes
+        bool secondary_recording{ false }; // RecordDraw() may record a secondary command buffer on a worker thread
+    };
+
     class IViewPass : public IPass
     {
         /*
@@ -70,6 +86,12 @@ namespace eureka::graphics
         virtual ~IViewPass() {}
         virtual void BindToTargetPass(TargetInheritedData targetInheritedData) = 0;
         virtual void HandleResize(uint32_t w, uint32_t h) = 0;
+
+        //
+        // a view pass may be recorded into a secondary command buffer that continues the target's render pass,
+        // RecordDraw must then not rely on state set by the target pass
+        //
+        virtual ViewPassThreading Threading() const { return {}; }
     };
 
 
@@ -4,8 +4,7 @@
 #include <profiling.hpp>
 #include <imgui_internal.h>
 #include "AsyncDataLoader.hpp"
-#include "../Eureka.Vulkan/Pipeline.hpp"
-#include "../Eureka.Vulkan/PipelinePresets.hpp"
+#include "PipelinePrecompiler.hpp"
 
 
 namespace eureka::graphics
@@ -16,7 +15,10 @@ namespace eureka::graphics
     //static_assert(offsetof(ImDrawVert, uv) == offsetof(ImGuiVertex, uv));
     //static_assert(offsetof(ImDrawVert, col) == offsetof(ImGuiVertex, color));
 
-    inline constexpr uint64_t EUREKA_MAX_IMGUI_VERTEX_INDEX_BYTES = 4 * 1024 * 1024;
+    // the ring grows past this when a frame needs more, dense implot views are the usual culprits
+    inline constexpr uint64_t EUREKA_INITIAL_IMGUI_FRAME_GEOMETRY_BYTES = 1024 * 1024;
+
+    inline constexpr VkIndexType IMGUI_INDEX_TYPE = sizeof(ImDrawIdx) == 2 ? VkIndexType::VK_INDEX_TYPE_UINT16 : VkIndexType::VK_INDEX_TYPE_UINT32;
 
 
 
@@ -76,14 +78,8 @@ namespace eureka::graphics
         //
         // vulkan stuff
         //
-        vulkan::PipelineLayoutCreationPreset imguiPipelineLayoutPreset(vulkan::PipelinePresetType::eImGui, *_globalInheritedData.layout_cache);
-        _pipelineLayout = std::make_shared<vulkan::PipelineLayout>(_globalInheritedData.device, imguiPipelineLayoutPreset.GetCreateInfo());
-        vulkan::PipelineCreationPreset imguiPipelinePreset(
-            vulkan::PipelinePresetType::eImGui, *_globalInheritedData.shader_cache, _pipelineLayout->Get(), _targetInheritedData.render_pass->Get());
-        
-        _pipeline = vulkan::Pipeline(_globalInheritedData.device, _pipelineLayout, _targetInheritedData.render_pass, imguiPipelinePreset.GetCreateInfo());
-
-        _vertexIndexBuffer = vulkan::HostVisibleVertexAndIndexTransferableDeviceBuffer(_globalInheritedData.resource_allocator, EUREKA_MAX_IMGUI_VERTEX_INDEX_BYTES);
+        // usually compiled in the background since startup, the draws are skipped until it is ready
+        _pipeline = RequestPresetPipeline(_globalInheritedData, vulkan::PipelinePresetType::eImGui, _targetInheritedData.render_pass);
 
 
         // Create font texture
@@ -162,7 +158,7 @@ namespace eureka::graphics
 
     }
 
-    void ImGuiViewPass::SyncBuffers()
+    std::optional<vulkan::FrameGeometryAllocation> ImGuiViewPass::SyncBuffers(vulkan::FrameContext& frameContext)
     {
         PROFILE_CATEGORIZED_SCOPE("imgui vertex update", eureka::profiling::Color::Brown, eureka::profiling::PROFILING_CATEGORY_RENDERING);
 
@@ -170,55 +166,55 @@ namespace eureka::graphics
 
         if (!imDrawData)
         {
-            return;
+            return std::nullopt;
         }
         VkDeviceSize vertexBufferSize = imDrawData->TotalVtxCount * sizeof(ImDrawVert);
         VkDeviceSize indexBufferSize = imDrawData->TotalIdxCount * sizeof(ImDrawIdx);
 
-        auto totalSize = vertexBufferSize + indexBufferSize;
-
-        if (totalSize > _vertexIndexBuffer.ByteSize())
+        if ((vertexBufferSize == 0) || (indexBufferSize == 0))
         {
-            //DEBUGGER_TRACE("IMGUI rendering failed, vertex buffer not large enough. required size = {} available size = {}", totalSize, _vertexIndexBuffer.ByteSize());
-            return;
+            return std::nullopt;
         }
 
-        if ((vertexBufferSize == 0) || (indexBufferSize == 0))
+        if (!_geometryRing)
         {
-            return;
+            _geometryRing.emplace(
+                _globalInheritedData.resource_allocator,
+                frameContext.MaxFramesInFlight(),
+                vulkan::FrameGeometryRingConfig{ .initial_frame_byte_size = EUREKA_INITIAL_IMGUI_FRAME_GEOMETRY_BYTES }
+            );
         }
 
-        auto deviceMappedPtr = _vertexIndexBuffer.Ptr<uint8_t>();
+        // the frame's previous geometry was consumed by the submissions the frame context waited for
+        _geometryRing->BeginFrame(frameContext.FrameIndex());
+
+        // vertex bytes are a multiple of 4, the indices that follow stay aligned to their size
+        auto allocation = _geometryRing->Allocate(vertexBufferSize + indexBufferSize);
 
-        _vertexBufferOffset = 0;
+        auto vertexPtr = allocation.Ptr();
+        auto indexPtr = vertexPtr + vertexBufferSize;
 
         for (auto i = 0; i < imDrawData->CmdListsCount; ++i)
         {
             const ImDrawList* cmd_list = imDrawData->CmdLists[i];
-            auto bytes = cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
-            std::memcpy(deviceMappedPtr, cmd_list->IdxBuffer.Data, bytes);
-            deviceMappedPtr += bytes;
-            _vertexBufferOffset += bytes;
-        }
 
-        auto alignmentRemainder = _vertexBufferOffset % sizeof(ImDrawVert);
-        deviceMappedPtr += alignmentRemainder;
-        _vertexBufferOffset += alignmentRemainder;
+            auto vertexBytes = cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+            std::memcpy(vertexPtr, cmd_list->VtxBuffer.Data, vertexBytes);
+            vertexPtr += vertexBytes;
 
-        for (auto i = 0; i < imDrawData->CmdListsCount; ++i)
-        {
-            const ImDrawList* cmd_list = imDrawData->CmdLists[i];
-            auto bytes = cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
-            std::memcpy(deviceMappedPtr, cmd_list->VtxBuffer.Data, bytes);
-            deviceMappedPtr += bytes;
+            auto indexBytes = cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+            std::memcpy(indexPtr, cmd_list->IdxBuffer.Data, indexBytes);
+            indexPtr += indexBytes;
         }
 
-        _vertexIndexBuffer.FlushCachesBeforeDeviceRead();
+        _geometryRing->Flush(allocation);
+
+        return allocation;
     }
 
-    void ImGuiViewPass::RecordDrawCommands(vulkan::LinearCommandBufferHandle commandBuffer)
+    void ImGuiViewPass::RecordDrawCommands(vulkan::LinearCommandBufferHandle commandBuffer, vulkan::FrameContext& frameContext)
     {
-        if (!_active) return;
+        if (!_active || !_pipeline.Ready()) return;
         ImDrawData* imDrawData = ImGui::GetDrawData();
         if (!imDrawData) return;
 
@@ -242,12 +238,17 @@ namespace eureka::graphics
 
 
         if (viewport.width <= 0.0f || viewport.height <= 0.0f) return;
-        commandBuffer.BindGraphicsPipeline(_pipeline.Get());
+
+        auto geometry = SyncBuffers(frameContext);
+        if (!geometry) return;
+
+        const auto& presetPipeline = _pipeline.Get();
+        commandBuffer.BindGraphicsPipeline(presetPipeline.pipeline.Get());
         commandBuffer.SetViewport(viewport);
 
         commandBuffer.Bind(
             VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS,
-            _pipelineLayout->Get(),
+            presetPipeline.layout->Get(),
             _descriptorSet.Get(),
             0u
         );
@@ -259,7 +260,7 @@ namespace eureka::graphics
             .translate = Eigen::Vector2f(-1.0f, -1.0f)
         };
 
-        commandBuffer.PushConstants(_pipelineLayout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstanst);
+        commandBuffer.PushConstants(presetPipeline.layout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstanst);
 
 
         // Render commands
@@ -269,14 +270,16 @@ namespace eureka::graphics
 
         if (imDrawData->CmdListsCount > 0)
         {
-            commandBuffer.BindIndexBuffer(
-                _vertexIndexBuffer.Buffer(),
-                VkIndexType::VK_INDEX_TYPE_UINT16
+            // a single bind for the whole frame, the draws address their list through the global offsets
+            commandBuffer.BindVertexBuffer(
+                geometry->Buffer(),
+                geometry->offset
             );
 
-            commandBuffer.BindVertexBuffer(
-                 _vertexIndexBuffer.Buffer(),
-                 _vertexBufferOffset
+            commandBuffer.BindIndexBuffer(
+                geometry->Buffer(),
+                IMGUI_INDEX_TYPE,
+                geometry->offset + imDrawData->TotalVtxCount * sizeof(ImDrawVert)
             );
 
             for (auto i = 0; i < imDrawData->CmdListsCount; ++i)
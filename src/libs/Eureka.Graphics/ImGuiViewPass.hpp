@@ -5,6 +5,8 @@
 #include "../Eureka.Vulkan/Image.hpp"
 #include "../Eureka.Vulkan/Descriptor.hpp"
 #include "../Eureka.Vulkan/Pipeline.hpp"
+#include "../Eureka.Vulkan/FrameGeometryRing.hpp"
+#include "../Eureka.Vulkan/FrameContext.hpp"
 
 
 //#include "UploadRingBuffer.hpp"
@@ -13,8 +15,11 @@
 #include "Window.hpp"
 //#include "Descriptors.hpp"
 #include "IPass.hpp"
+#include "PipelinePrecompiler.hpp"
 
 #include <IImGuiLayout.hpp>
+#include <assert.hpp>
+#include <optional>
 
 namespace eureka::graphics
 {
@@ -26,19 +31,17 @@ namespace eureka::graphics
     {
         TargetInheritedData                                        _targetInheritedData;
         // vulkan resources:
-        std::shared_ptr<vulkan::PipelineLayout>                    _pipelineLayout;
-        vulkan::Pipeline                                           _pipeline;
+        PendingPresetPipeline                                      _pipeline;
         vulkan::FreeableDescriptorSet                              _descriptorSet;
         vulkan::AllocatedImage2D                                            _fontImage;
         vulkan::Sampler                                            _fontSampler;
-        vulkan::HostVisibleVertexAndIndexTransferableDeviceBuffer  _vertexIndexBuffer;
+        std::optional<vulkan::FrameGeometryRing>                   _geometryRing; // created with the first recorded frame
 
 
         //std::shared_ptr<ImGuiPipeline>       _pipeline;
         bool _active{ false };
         bool _validSize{ false };
         bool _initialized{ false };
-        uint64_t _vertexBufferOffset{ 0 };
 
         future_t<void> Setup();
 
@@ -55,20 +58,27 @@ namespace eureka::graphics
             return _active;
         }
         void Layout();
-        void SyncBuffers();
-        void RecordDrawCommands(vulkan::LinearCommandBufferHandle commandBuffer);
+        // writes the draw lists straight into the frame's sub range of the geometry ring, vertices then indices
+        std::optional<vulkan::FrameGeometryAllocation> SyncBuffers(vulkan::FrameContext& frameContext);
+        void RecordDrawCommands(vulkan::LinearCommandBufferHandle commandBuffer, vulkan::FrameContext& frameContext);
         void BindToTargetPass(TargetInheritedData inheritedData) override;
         void HandleResize(uint32_t w, uint32_t h) override;
 
         void Prepare() override
         {
             Layout();
-            SyncBuffers();
         }
 
         void RecordDraw(const RecordParameters& params) override
         {
-            RecordDrawCommands(params.command_buffer);
+            assert(params.frame_context);
+            RecordDrawCommands(params.command_buffer, *params.frame_context);
+        }
+
+        // the layout polls glfw, which is bound to the main thread, the draw data is only read while recording
+        ViewPassThreading Threading() const override
+        {
+            return ViewPassThreading{ .parallel_prepare = false, .secondary_recording = true };
         }
 
     };
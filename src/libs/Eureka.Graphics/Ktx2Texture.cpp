@@ -0,0 +1,200 @@
+#include "Ktx2Texture.hpp"
+#include <basic_errors.hpp>
+#include <profiling.hpp>
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <ktx.h>
+
+namespace eureka::graphics
+{
+    namespace
+    {
+        constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        constexpr uint64_t KTX2_WIDTH_OFFSET = 20;
+        constexpr uint64_t KTX2_HEIGHT_OFFSET = 24;
+
+        // srgb payloads are sampled as unorm like the rgba8 path, the shaders do the conversion
+        std::optional<vulkan::Image2DAllocationPreset> PresetForKtxFormat(uint32_t vkFormat)
+        {
+            switch (static_cast<VkFormat>(vkFormat))
+            {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+                return vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResource;
+            case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+                return vulkan::Image2DAllocationPreset::eBC1RgbaUnormSampledShaderResource;
+            case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+                return vulkan::Image2DAllocationPreset::eBC1RgbUnormSampledShaderResource;
+            case VK_FORMAT_BC3_UNORM_BLOCK:
+            case VK_FORMAT_BC3_SRGB_BLOCK:
+                return vulkan::Image2DAllocationPreset::eBC3UnormSampledShaderResource;
+            case VK_FORMAT_BC5_UNORM_BLOCK:
+                return vulkan::Image2DAllocationPreset::eBC5UnormSampledShaderResource;
+            case VK_FORMAT_BC7_UNORM_BLOCK:
+            case VK_FORMAT_BC7_SRGB_BLOCK:
+                return vulkan::Image2DAllocationPreset::eBC7UnormSampledShaderResource;
+            case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+            case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+                return vulkan::Image2DAllocationPreset::eASTC4x4UnormSampledShaderResource;
+            default:
+                return std::nullopt;
+            }
+        }
+
+        bool IsPresetSupported(vulkan::Image2DAllocationPreset preset, const TextureFormatSupport& support)
+        {
+            switch (preset)
+            {
+            case vulkan::Image2DAllocationPreset::eBC1RgbaUnormSampledShaderResource:
+            case vulkan::Image2DAllocationPreset::eBC1RgbUnormSampledShaderResource:
+                return support.bc1;
+            case vulkan::Image2DAllocationPreset::eBC3UnormSampledShaderResource:
+                return support.bc3;
+            case vulkan::Image2DAllocationPreset::eBC5UnormSampledShaderResource:
+                return support.bc5;
+            case vulkan::Image2DAllocationPreset::eBC7UnormSampledShaderResource:
+                return support.bc7;
+            case vulkan::Image2DAllocationPreset::eASTC4x4UnormSampledShaderResource:
+                return support.astc_4x4;
+            default:
+                return true;
+            }
+        }
+
+        ktx_transcode_fmt_e ChooseTranscodeFormat(uint32_t components, const TextureFormatSupport& support)
+        {
+            if (support.bc7)
+            {
+                return KTX_TTF_BC7_RGBA;
+            }
+            if (support.astc_4x4)
+            {
+                return KTX_TTF_ASTC_4x4_RGBA;
+            }
+            if (components == 2 && support.bc5)
+            {
+                return KTX_TTF_BC5_RG;
+            }
+            if (components <= 3 && support.bc1)
+            {
+                return KTX_TTF_BC1_RGB;
+            }
+            if (support.bc3)
+            {
+                return KTX_TTF_BC3_RGBA;
+            }
+            return KTX_TTF_RGBA32;
+        }
+
+        void ThrowOnKtxError(KTX_error_code result, const char* operation)
+        {
+            if (result != KTX_SUCCESS)
+            {
+                throw file_load_error(std::string(operation) + ": " + ktxErrorString(result));
+            }
+        }
+    }
+
+    TextureFormatSupport QueryTextureFormatSupport(const vulkan::Device& device)
+    {
+        const auto& features = device.GetEnabledFeatures();
+        auto supported = [&](VkBool32 feature, VkFormat format)
+        {
+            return feature && device.IsSampledImageFormatSupported(format);
+        };
+
+        return TextureFormatSupport
+        {
+            .bc1 = supported(features.textureCompressionBC, VK_FORMAT_BC1_RGBA_UNORM_BLOCK),
+            .bc3 = supported(features.textureCompressionBC, VK_FORMAT_BC3_UNORM_BLOCK),
+            .bc5 = supported(features.textureCompressionBC, VK_FORMAT_BC5_UNORM_BLOCK),
+            .bc7 = supported(features.textureCompressionBC, VK_FORMAT_BC7_UNORM_BLOCK),
+            .astc_4x4 = supported(features.textureCompressionASTC_LDR, VK_FORMAT_ASTC_4x4_UNORM_BLOCK)
+        };
+    }
+
+    bool IsKtx2(dcspan<uint8_t> bytes)
+    {
+        return bytes.size() >= sizeof(KTX2_IDENTIFIER) && std::memcmp(bytes.data(), KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+    }
+
+    VkExtent2D Ktx2Extent(dcspan<uint8_t> bytes)
+    {
+        if (!IsKtx2(bytes) || bytes.size() < KTX2_HEIGHT_OFFSET + sizeof(uint32_t))
+        {
+            throw file_load_error("truncated ktx2 texture");
+        }
+
+        VkExtent2D extent{};
+        std::memcpy(&extent.width, bytes.data() + KTX2_WIDTH_OFFSET, sizeof(uint32_t));
+        std::memcpy(&extent.height, bytes.data() + KTX2_HEIGHT_OFFSET, sizeof(uint32_t));
+        return extent;
+    }
+
+    void Ktx2Texture::KtxDeleter::operator()(ktxTexture2* texture) const
+    {
+        ktxTexture2_Destroy(texture);
+    }
+
+    Ktx2Texture::Ktx2Texture(dcspan<uint8_t> bytes, const TextureFormatSupport& support)
+    {
+        ktxTexture2* texture = nullptr;
+        ThrowOnKtxError(
+            ktxTexture2_CreateFromMemory(bytes.data(), bytes.size(), KTX_TEXTURE_CREATE_LOAD_IMAGE_DATA_BIT, &texture),
+            "failed reading ktx2 texture");
+        _texture.reset(texture);
+
+        if (texture->numDimensions != 2 || texture->isCubemap || texture->isArray)
+        {
+            throw file_load_error("only 2D ktx2 textures are supported");
+        }
+
+        if (ktxTexture2_NeedsTranscoding(texture))
+        {
+            PROFILE_CATEGORIZED_SCOPE("Transcode basis texture", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_LOAD);
+
+            auto format = ChooseTranscodeFormat(ktxTexture2_GetNumComponents(texture), support);
+            ThrowOnKtxError(ktxTexture2_TranscodeBasis(texture, format, 0), "failed transcoding basis texture");
+        }
+
+        auto preset = PresetForKtxFormat(texture->vkFormat);
+        if (!preset || !IsPresetSupported(*preset, support))
+        {
+            throw file_load_error("unsupported ktx2 texture format " + std::to_string(texture->vkFormat));
+        }
+        _preset = *preset;
+
+        auto data = ktxTexture_GetData(ktxTexture(texture));
+        for (auto level = 0u; level < texture->numLevels; ++level)
+        {
+            ktx_size_t offset = 0;
+            ThrowOnKtxError(ktxTexture_GetImageOffset(ktxTexture(texture), level, 0, 0, &offset), "malformed ktx2 texture");
+
+            VkExtent2D extent
+            {
+                .width = std::max(texture->baseWidth >> level, 1u),
+                .height = std::max(texture->baseHeight >> level, 1u)
+            };
+            auto levelBytes = vulkan::GetImageLevelBytes(Format(), extent);
+            if (offset + levelBytes > ktxTexture_GetDataSize(ktxTexture(texture)))
+            {
+                throw file_load_error("malformed ktx2 texture");
+            }
+
+            _levels.emplace_back(TranscodedLevel{ .bytes = dcspan<uint8_t>(data + offset, levelBytes), .extent = extent });
+        }
+    }
+
+    uint64_t Ktx2Texture::Bytes() const
+    {
+        uint64_t bytes = 0;
+        for (const auto& level : _levels)
+        {
+            bytes += level.bytes.size();
+        }
+        return bytes;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "../Eureka.Vulkan/ResourceAllocator.hpp"
+#include <containers_aliases.hpp>
+#include <memory>
+#include <vector>
+
+struct ktxTexture2;
+
+namespace eureka::graphics
+{
+    // the block compressed formats the device can sample, queried once per loader
+    struct TextureFormatSupport
+    {
+        bool bc1{ false };
+        bool bc3{ false };
+        bool bc5{ false };
+        bool bc7{ false };
+        bool astc_4x4{ false };
+    };
+
+    TextureFormatSupport QueryTextureFormatSupport(const vulkan::Device& device);
+
+    // the bytes start with the KTX2 identifier (glTF KHR_texture_basisu images, .ktx2 files)
+    bool IsKtx2(dcspan<uint8_t> bytes);
+
+    // base level extent from the KTX2 header, throws file_load_error when truncated
+    VkExtent2D Ktx2Extent(dcspan<uint8_t> bytes);
+
+    struct TranscodedLevel
+    {
+        dcspan<uint8_t> bytes;      // tightly packed texel blocks
+        VkExtent2D      extent;
+    };
+
+    //
+    // Ktx2Texture
+    // a KTX2 texture ready for upload, every level in the preset's format
+    // Basis Universal payloads (ETC1S / UASTC) are transcoded on construction to the best format the device supports:
+    // BC7, ASTC 4x4, BC5 for two channel textures, BC3, BC1 for opaque textures, RGBA8 when nothing else is there
+    // textures that are already block compressed or RGBA8 are used as is
+    // the pipeline samples every texture as unorm, srgb payloads get the unorm preset of their format
+    //
+    class Ktx2Texture
+    {
+        struct KtxDeleter
+        {
+            void operator()(ktxTexture2* texture) const;
+        };
+
+        std::unique_ptr<ktxTexture2, KtxDeleter> _texture;
+        vulkan::Image2DAllocationPreset          _preset{ vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResource };
+        std::vector<TranscodedLevel>             _levels;
+    public:
+        // throws file_load_error for malformed containers, cube maps, arrays, 3D textures and formats the device can't sample
+        Ktx2Texture(dcspan<uint8_t> bytes, const TextureFormatSupport& support);
+
+        vulkan::Image2DAllocationPreset Preset() const { return _preset; }
+        VkFormat Format() const { return vulkan::GetImagePresetFormat(_preset); }
+        VkExtent2D Extent() const { return _levels.front().extent; }
+        const std::vector<TranscodedLevel>& Levels() const { return _levels; }
+        uint64_t Bytes() const;
+    };
+}
@@ -0,0 +1,166 @@
+#include "MemoryDefragmenter.hpp"
+#include <profiling.hpp>
+#include <debugger_trace.hpp>
+
+namespace eureka::graphics
+{
+    MemoryDefragmenter::MemoryDefragmenter(
+        std::shared_ptr<vulkan::Device> device,
+        std::shared_ptr<vulkan::ResourceAllocator> allocator,
+        std::shared_ptr<vulkan::FrameContext> frameContext,
+        std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler,
+        MemoryDefragmenterConfig config
+    ) :
+        _allocator(allocator),
+        _frameContext(std::move(frameContext)),
+        _oneShotSubmissionHandler(std::move(oneShotSubmissionHandler)),
+        _config(config),
+        _defragmenter(std::move(device), std::move(allocator), vulkan::DefragmentationLimits
+            {
+                .max_bytes_per_pass = config.max_bytes_per_pass,
+                .max_allocations_per_pass = config.max_moves_per_pass
+            })
+    {
+        assert(_config.check_interval_frames > 0);
+    }
+
+    void MemoryDefragmenter::AddPool(const vulkan::PoolAllocation& pool)
+    {
+        _pools.emplace_back(pool.pool);
+    }
+
+    void MemoryDefragmenter::RequestRun()
+    {
+        _runRequested = true;
+    }
+
+    MemoryDefragmenter::Fragmentation MemoryDefragmenter::Measure(std::size_t target) const
+    {
+        Fragmentation fragmentation{};
+        if (target == 0)
+        {
+            // the custom pools are part of the heap statistics too, their free space is rarely what triggers a run
+            for (const auto& heap : _allocator->HeapBudgets())
+            {
+                if (heap.device_local)
+                {
+                    fragmentation.block_bytes += heap.block_bytes;
+                    fragmentation.free_bytes += heap.block_bytes - heap.allocation_bytes;
+                }
+            }
+        }
+        else
+        {
+            auto statistics = _allocator->GetPoolStatistics(vulkan::PoolAllocation{ .pool = _pools[target - 1] });
+            fragmentation.block_bytes = statistics.block_bytes;
+            fragmentation.free_bytes = statistics.block_bytes - statistics.allocation_bytes;
+        }
+        return fragmentation;
+    }
+
+    bool MemoryDefragmenter::TryBeginRun()
+    {
+        if (!_runRequested && _counters.frames % _config.check_interval_frames != 0)
+        {
+            return false;
+        }
+        ++_counters.checks;
+
+        // round robin over the targets, a target that doesn't need a run passes the turn on
+        auto targets = _pools.size() + 1;
+        for (auto i = 0u; i < targets; ++i)
+        {
+            auto target = (_target + i) % targets;
+            auto fragmentation = Measure(target);
+
+            if (!_runRequested &&
+                (fragmentation.free_bytes < _config.min_free_bytes || fragmentation.FreeRatio() < _config.min_free_ratio))
+            {
+                continue;
+            }
+
+            if (!_defragmenter.Begin(target == 0 ? nullptr : _pools[target - 1]))
+            {
+                continue;
+            }
+
+            _target = target;
+            _runRequested = false;
+            _counters.free_bytes_before = fragmentation.free_bytes;
+            _counters.free_ratio_before = fragmentation.FreeRatio();
+            return true;
+        }
+
+        _runRequested = false;
+        return false;
+    }
+
+    void MemoryDefragmenter::RecordPass()
+    {
+        if (!_defragmenter.BeginPass())
+        {
+            FinishRun();
+            return;
+        }
+
+        auto [commandBuffer, doneSemaphore] = _oneShotSubmissionHandler->NewOneShotGraphicsCommandBuffer();
+        {
+            vulkan::ScopedCommands commands(commandBuffer);
+            _defragmenter.RecordPass(commandBuffer);
+        }
+
+        // the owners switched to the new handles already, the copy has to be on the queue before the next frame
+        _passCopied = _oneShotSubmissionHandler->AppendGraphicsSubmission(commandBuffer, doneSemaphore);
+        _oneShotSubmissionHandler->FlushPendingGraphics();
+        _passRetireFrame = _counters.frames + _frameContext->MaxFramesInFlight();
+    }
+
+    void MemoryDefragmenter::FinishRun()
+    {
+        auto fragmentation = Measure(_target);
+        _counters.free_bytes_after = fragmentation.free_bytes;
+        _counters.free_ratio_after = fragmentation.FreeRatio();
+        _counters.moves = _defragmenter.Counters();
+        _target = (_target + 1) % (_pools.size() + 1);
+
+        DEBUGGER_TRACE("defragmentation moved {} bytes, freed {} bytes / {} blocks, free space {} -> {}",
+            _counters.moves.last_run.bytes_moved,
+            _counters.moves.last_run.bytes_freed,
+            _counters.moves.last_run.blocks_freed,
+            _counters.free_bytes_before,
+            _counters.free_bytes_after);
+    }
+
+    void MemoryDefragmenter::RunOne()
+    {
+        assert(tls_is_rendering_thread);
+        PROFILE_CATEGORIZED_SCOPE("Defragmentation", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+
+        ++_counters.frames;
+
+        if (_defragmenter.PassOpen())
+        {
+            // the frames recorded with the old handles were submitted before the copy, the frame context waited
+            // for them once MaxFramesInFlight frames went by
+            if (_counters.frames < _passRetireFrame || _passCopied.status() == concurrencpp::result_status::idle)
+            {
+                return;
+            }
+            _passCopied.get();
+            _passCopied = {};
+
+            if (_defragmenter.EndPass())
+            {
+                FinishRun();
+                return;
+            }
+        }
+        else if (!_defragmenter.Running() && !TryBeginRun())
+        {
+            return;
+        }
+
+        RecordPass();
+        _counters.moves = _defragmenter.Counters();
+    }
+}
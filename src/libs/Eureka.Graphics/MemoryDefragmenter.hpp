@@ -0,0 +1,97 @@
+#pragma once
+#include "../Eureka.Vulkan/Defragmenter.hpp"
+#include "../Eureka.Vulkan/FrameContext.hpp"
+#include "OneShotCopySubmission.hpp"
+#include <future.hpp>
+
+namespace eureka::graphics
+{
+    struct MemoryDefragmenterConfig
+    {
+        uint64_t max_bytes_per_pass{ 16ull * 1024 * 1024 };  // copy work recorded between two frames
+        uint32_t max_moves_per_pass{ 64 };
+        float    min_free_ratio{ 0.25f };                      // a run starts once that fraction of the blocks is free space
+        uint64_t min_free_bytes{ 32ull * 1024 * 1024 };        // and there is at least that much of it
+        uint32_t check_interval_frames{ 300 };
+    };
+
+    struct MemoryDefragmenterCounters
+    {
+        vulkan::DefragmenterCounters moves;
+        uint64_t                     frames{ 0 };
+        uint64_t                     checks{ 0 };
+        uint64_t                     free_bytes_before{ 0 };   // free space in the blocks of the last run's target
+        uint64_t                     free_bytes_after{ 0 };
+        float                        free_ratio_before{ 0.0f };
+        float                        free_ratio_after{ 0.0f };
+    };
+
+    //
+    // MemoryDefragmenter
+    // runs vulkan::Defragmenter a bounded pass per frame, so long sessions with allocate / free churn give back the
+    // device memory blocks the holes are spread over
+    // the default pools are checked every check_interval_frames, plus the pools added with AddPool, one target
+    // per run
+    //
+    // a pass is copied on the graphics queue - the resources are exclusive to the graphics family and the copies
+    // have to be ordered before the next frame that uses the new handles, the copy queue would need ownership
+    // transfers both ways for every move
+    // the old handles and memory are released MaxFramesInFlight frames later, once no frame uses them
+    //
+    // rendering thread only, RunOne runs between frames
+    //
+    class MemoryDefragmenter
+    {
+        struct Fragmentation
+        {
+            uint64_t block_bytes{ 0 };
+            uint64_t free_bytes{ 0 };
+
+            float FreeRatio() const
+            {
+                return block_bytes ? static_cast<float>(free_bytes) / static_cast<float>(block_bytes) : 0.0f;
+            }
+        };
+
+        std::shared_ptr<vulkan::ResourceAllocator>  _allocator;
+        std::shared_ptr<vulkan::FrameContext>       _frameContext;
+        std::shared_ptr<OneShotSubmissionHandler>   _oneShotSubmissionHandler;
+        MemoryDefragmenterConfig                    _config;
+        vulkan::Defragmenter                        _defragmenter;
+
+        std::vector<VmaPool>                        _pools;           // target i + 1, target 0 is the default pools
+        std::size_t                                 _target{ 0 };
+        bool                                        _runRequested{ false };
+
+        future_t<void>                              _passCopied;
+        uint64_t                                    _passRetireFrame{ 0 };
+        MemoryDefragmenterCounters                  _counters;
+
+        Fragmentation Measure(std::size_t target) const;
+        bool TryBeginRun();
+        void RecordPass();
+        void FinishRun();
+    public:
+        MemoryDefragmenter(
+            std::shared_ptr<vulkan::Device> device,
+            std::shared_ptr<vulkan::ResourceAllocator> allocator,
+            std::shared_ptr<vulkan::FrameContext> frameContext,
+            std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler,
+            MemoryDefragmenterConfig config = {}
+        );
+        MemoryDefragmenter(const MemoryDefragmenter&) = delete;
+        MemoryDefragmenter& operator=(const MemoryDefragmenter&) = delete;
+
+        // the pool has to outlive the defragmenter, linear pools are skipped
+        void AddPool(const vulkan::PoolAllocation& pool);
+
+        // the next frame starts a run regardless of the thresholds
+        void RequestRun();
+
+        // after the frame submit, before the next frame records
+        void RunOne();
+
+        bool Running() const { return _defragmenter.Running(); }
+        MemoryDefragmenterCounters Counters() const { return _counters; }
+    };
+}
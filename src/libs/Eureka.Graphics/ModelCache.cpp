@@ -0,0 +1,834 @@
+#include "ModelCache.hpp"
+#include "Ktx2Texture.hpp"
+#include <basic_errors.hpp>
+#include <profiling.hpp>
+#include <debugger_trace.hpp>
+#include <compiler.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <random>
+
+EUREKA_MSVC_WARNING_PUSH
+EUREKA_MSVC_WARNING_DISABLE(4996)
+#include <stb_image.h>
+EUREKA_MSVC_WARNING_POP
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define EUREKA_MODEL_CACHE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace eureka::graphics
+{
+    static_assert(sizeof(ModelCacheHeader) == 112);
+    static_assert(sizeof(ModelCacheSource) == 24);
+    static_assert(sizeof(ModelCachePrimitive) == 56);
+    static_assert(sizeof(ModelCacheImage) == 24);
+    static_assert(sizeof(ModelCacheMip) == 24);
+    static_assert(sizeof(GltfMaterial) == 12 && std::is_trivially_copyable_v<GltfMaterial>);
+    static_assert(std::endian::native == std::endian::little);
+
+    namespace
+    {
+        constexpr uint64_t TABLE_ALIGNMENT = 8;
+        constexpr uint64_t BLOB_ALIGNMENT = 4096;
+        constexpr uint64_t MIP_ALIGNMENT = 16;
+        constexpr uint64_t COOK_BATCH_BYTES = 16 * 1024 * 1024;
+
+        constexpr uint64_t HASH_PRIME1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t HASH_PRIME2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t HASH_PRIME3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t HASH_PRIME4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t HASH_PRIME5 = 0x27D4EB2F165667C5ull;
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        void ThrowOnCancelled(const eureka::stop_token& cancel)
+        {
+            if (cancel.stop_requested())
+            {
+                throw operation_cancelled("model cache cooking cancelled");
+            }
+        }
+
+        template<typename T>
+        T LoadUnaligned(const uint8_t* p)
+        {
+            T value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint64_t HashRound(uint64_t accumulator, uint64_t input)
+        {
+            accumulator += input * HASH_PRIME2;
+            accumulator = std::rotl(accumulator, 31);
+            return accumulator * HASH_PRIME1;
+        }
+
+        uint64_t HashMerge(uint64_t accumulator, uint64_t value)
+        {
+            accumulator ^= HashRound(0, value);
+            return accumulator * HASH_PRIME1 + HASH_PRIME4;
+        }
+
+        int64_t WriteTimeTicks(const std::filesystem::file_time_type& time)
+        {
+            return static_cast<int64_t>(time.time_since_epoch().count());
+        }
+
+        // processes cooking the same model, or the same process cooking it twice, each write their own file
+        std::filesystem::path CookingPath(const std::filesystem::path& cachePath)
+        {
+            static const uint64_t processToken = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+            static std::atomic_uint64_t cooks{ 0 };
+
+            auto path = cachePath;
+            path += std::format(".{:016x}-{}.cooking", processToken, cooks.fetch_add(1, std::memory_order_relaxed));
+            return path;
+        }
+
+        //
+        // the file being cooked, written at known offsets by the cooking tasks
+        //
+        class CookTarget
+        {
+            std::fstream _file;
+            std::mutex   _mutex;
+        public:
+            explicit CookTarget(const std::filesystem::path& path, uint64_t byteSize)
+            {
+                {
+                    std::ofstream create(path, std::ios::binary | std::ios::out | std::ios::trunc);
+                }
+                std::filesystem::resize_file(path, byteSize);
+                _file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+                if (!_file)
+                {
+                    throw std::runtime_error("failed opening model cache " + path.string());
+                }
+            }
+
+            void Write(uint64_t offset, dcspan<dcspan<uint8_t>> spans)
+            {
+                std::scoped_lock lock(_mutex);
+                _file.seekp(static_cast<std::streamoff>(offset));
+                for (auto span : spans)
+                {
+                    _file.write(reinterpret_cast<const char*>(span.data()), static_cast<std::streamsize>(span.size()));
+                }
+                if (!_file)
+                {
+                    throw std::runtime_error("failed writing model cache");
+                }
+            }
+
+            template<typename T>
+            void WriteTable(uint64_t offset, const std::vector<T>& table)
+            {
+                std::array<dcspan<uint8_t>, 1> span{ dcspan<uint8_t>(reinterpret_cast<const uint8_t*>(table.data()), table.size() * sizeof(T)) };
+                Write(offset, span);
+            }
+
+            void Close()
+            {
+                _file.close();
+                if (_file.fail())
+                {
+                    throw std::runtime_error("failed closing model cache");
+                }
+            }
+        };
+
+        future_t<void> CookGeometryBatchAsync(
+            const GltfDocument& document,
+            dcspan<GltfPrimitive> sources,
+            dcspan<LoadedPrimitive> targets,
+            uint64_t fileOffset,
+            CookTarget& target,
+            PoolExecutor poolExecutor,
+            eureka::stop_token cancel
+        )
+        {
+            co_await concurrencpp::resume_on(*poolExecutor);
+            ThrowOnCancelled(cancel);
+
+            PROFILE_CATEGORIZED_SCOPE("Cook gltf primitives", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_LOAD);
+
+            GeometryStreamStorage storage;
+            std::atomic_uint64_t zeroCopyBytes{ 0 };
+            std::vector<dcspan<uint8_t>> streams;
+            streams.reserve(sources.size() * 5);
+
+            for (auto i = 0u; i < sources.size(); ++i)
+            {
+                auto primitiveStreams = ConvertPrimitiveStreams(document, sources[i], targets[i], storage, zeroCopyBytes);
+                streams.insert(streams.end(), primitiveStreams.begin(), primitiveStreams.end());
+            }
+
+            target.Write(fileOffset, streams);
+        }
+
+        future_t<void> CookImageAsync(
+            const GltfDocument& document,
+            uint32_t image,
+            const ModelCacheImage& entry,
+            dcspan<ModelCacheMip> mips,
+            CookTarget& target,
+            PoolExecutor poolExecutor,
+            eureka::stop_token cancel
+        )
+        {
+            co_await concurrencpp::resume_on(*poolExecutor);
+            ThrowOnCancelled(cancel);
+
+            PROFILE_CATEGORIZED_SCOPE("Cook gltf image", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_LOAD);
+
+            auto encoded = document.ImageBytes(image);
+            if (entry.encoding == ModelCacheImageEncoding::eKtx2)
+            {
+                std::array<dcspan<uint8_t>, 1> container{ encoded };
+                target.Write(mips.front().offset, container);
+                co_return;
+            }
+
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> texels(
+                stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha),
+                &stbi_image_free);
+
+            if (!texels || static_cast<uint32_t>(width) != entry.width || static_cast<uint32_t>(height) != entry.height)
+            {
+                throw file_load_error(std::string("failed decoding gltf image: ") + (texels ? "size mismatch" : stbi_failure_reason()));
+            }
+
+            std::array<dcspan<uint8_t>, 1> level{ dcspan<uint8_t>(texels.get(), mips.front().bytes) };
+            target.Write(mips.front().offset, level);
+
+            // every level is filtered from the previous one
+            std::vector<uint8_t> previous(texels.get(), texels.get() + mips.front().bytes);
+            texels.reset();
+            std::vector<uint8_t> current;
+            for (auto i = 1u; i < mips.size(); ++i)
+            {
+                current.resize(mips[i].bytes);
+                DownsampleRGBA8(previous, mips[i - 1].width, mips[i - 1].height, current);
+
+                level[0] = current;
+                target.Write(mips[i].offset, level);
+                std::swap(previous, current);
+            }
+        }
+
+#ifdef EUREKA_MODEL_CACHE_SSE2
+        //
+        // two destination texels per iteration from four source columns of both rows, the row sums and the column
+        // sums are done in 16 bit lanes so the rounding matches the scalar filter exactly
+        // returns the number of destination texels written, the clamped edge column is left to the scalar loop
+        //
+        uint32_t DownsampleRowRGBA8SSE(const uint8_t* row0, const uint8_t* row1, uint32_t width, uint8_t* out)
+        {
+            const auto zero = _mm_setzero_si128();
+            const auto round = _mm_set1_epi16(2);
+            const auto count = width / 4 * 2;
+
+            for (auto x = 0u; x < count; x += 2)
+            {
+                auto top = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                auto bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+
+                // columns 0, 1 and columns 2, 3 summed over both rows
+                auto left = _mm_add_epi16(_mm_unpacklo_epi8(top, zero), _mm_unpacklo_epi8(bottom, zero));
+                auto right = _mm_add_epi16(_mm_unpackhi_epi8(top, zero), _mm_unpackhi_epi8(bottom, zero));
+                left = _mm_add_epi16(left, _mm_srli_si128(left, 8));
+                right = _mm_add_epi16(right, _mm_srli_si128(right, 8));
+
+                auto sum = _mm_unpacklo_epi64(left, right);
+                auto texels = _mm_srli_epi16(_mm_add_epi16(sum, round), 2);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + x * 4), _mm_packus_epi16(texels, texels));
+            }
+
+            return count;
+        }
+#endif
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        ModelCacheFile
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    ModelCacheFile::ModelCacheFile(const std::filesystem::path& path)
+        :
+        _file(path)
+    {
+        auto fileBytes = _file.size();
+        if (fileBytes < sizeof(ModelCacheHeader))
+        {
+            throw file_load_error("truncated model cache " + path.string());
+        }
+
+        std::memcpy(&_header, _file.data(), sizeof(_header));
+        if (_header.magic != MODEL_CACHE_MAGIC || _header.version != MODEL_CACHE_VERSION)
+        {
+            throw file_load_error("model cache of another version " + path.string());
+        }
+
+        auto checkRange = [&](uint64_t offset, uint64_t bytes)
+        {
+            if (offset > fileBytes || bytes > fileBytes - offset)
+            {
+                throw file_load_error("malformed model cache " + path.string());
+            }
+        };
+
+        checkRange(0, _header.file_bytes);
+        checkRange(_header.sources_offset, _header.source_count * sizeof(ModelCacheSource));
+        checkRange(_header.paths_offset, _header.path_bytes);
+        checkRange(_header.primitives_offset, _header.primitive_count * sizeof(ModelCachePrimitive));
+        checkRange(_header.materials_offset, _header.material_count * sizeof(GltfMaterial));
+        checkRange(_header.images_offset, _header.image_count * sizeof(ModelCacheImage));
+        checkRange(_header.mips_offset, _header.mip_count * sizeof(ModelCacheMip));
+        checkRange(_header.geometry_offset, _header.geometry_bytes);
+
+        for (const auto& source : Table<ModelCacheSource>(_header.sources_offset, _header.source_count))
+        {
+            if (static_cast<uint64_t>(source.path_offset) + source.path_bytes > _header.path_bytes)
+            {
+                throw file_load_error("malformed model cache " + path.string());
+            }
+        }
+
+        for (const auto& primitive : Table<ModelCachePrimitive>(_header.primitives_offset, _header.primitive_count))
+        {
+            auto bytes = primitive.index_count * sizeof(uint32_t) + primitive.vertex_count * PRIMITIVE_VERTEX_BYTES;
+            if (primitive.index_offset > _header.geometry_bytes || bytes > _header.geometry_bytes - primitive.index_offset)
+            {
+                throw file_load_error("malformed model cache " + path.string());
+            }
+        }
+
+        auto mips = Table<ModelCacheMip>(_header.mips_offset, _header.mip_count);
+        for (const auto& image : Images())
+        {
+            if (image.encoding == ModelCacheImageEncoding::eSkipped)
+            {
+                if (image.mip_count != 0)
+                {
+                    throw file_load_error("malformed model cache " + path.string());
+                }
+                continue;
+            }
+
+            if (static_cast<uint64_t>(image.first_mip) + image.mip_count > mips.size() || image.mip_count == 0)
+            {
+                throw file_load_error("malformed model cache " + path.string());
+            }
+
+            for (const auto& mip : mips.subspan(image.first_mip, image.mip_count))
+            {
+                checkRange(mip.offset, mip.bytes);
+
+                auto valid = image.encoding == ModelCacheImageEncoding::eKtx2
+                    ? image.mip_count == 1 && IsKtx2(Texels(mip))
+                    : image.encoding == ModelCacheImageEncoding::eRGBA8Mips && mip.bytes == static_cast<uint64_t>(mip.width) * mip.height * 4;
+                if (!valid)
+                {
+                    throw file_load_error("malformed model cache " + path.string());
+                }
+            }
+        }
+    }
+
+    std::filesystem::path ModelCacheFile::SourcePath(const ModelCacheSource& source) const
+    {
+        auto utf8 = Table<char>(_header.paths_offset, _header.path_bytes).subspan(source.path_offset, source.path_bytes);
+        return std::filesystem::path(std::u8string(utf8.begin(), utf8.end()));
+    }
+
+    bool ModelCacheFile::SourcesUnchanged() const
+    {
+        for (const auto& source : Table<ModelCacheSource>(_header.sources_offset, _header.source_count))
+        {
+            auto path = SourcePath(source);
+
+            std::error_code ec;
+            auto byteSize = std::filesystem::file_size(path, ec);
+            if (ec || byteSize != source.byte_size)
+            {
+                return false;
+            }
+
+            auto writeTime = std::filesystem::last_write_time(path, ec);
+            if (ec || WriteTimeTicks(writeTime) != source.write_time)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void ModelCacheFile::RestampSources(const std::filesystem::path& path)
+    {
+        uint64_t sourcesOffset = 0;
+        std::vector<ModelCacheSource> sources;
+        {
+            ModelCacheFile cache(path);
+            sourcesOffset = cache._header.sources_offset;
+            for (const auto& source : cache.Table<ModelCacheSource>(cache._header.sources_offset, cache._header.source_count))
+            {
+                auto sourcePath = cache.SourcePath(source);
+                auto& stamped = sources.emplace_back(source);
+                stamped.byte_size = std::filesystem::file_size(sourcePath);
+                stamped.write_time = WriteTimeTicks(std::filesystem::last_write_time(sourcePath));
+            }
+        }
+
+        // unmapped by now, windows doesn't open a mapped file for writing
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(sourcesOffset));
+        file.write(reinterpret_cast<const char*>(sources.data()), static_cast<std::streamsize>(sources.size() * sizeof(ModelCacheSource)));
+        file.close();
+        if (file.fail())
+        {
+            throw std::runtime_error("failed restamping model cache " + path.string());
+        }
+    }
+
+    std::vector<LoadedPrimitive> ModelCacheFile::Primitives() const
+    {
+        std::vector<LoadedPrimitive> primitives;
+        primitives.reserve(_header.primitive_count);
+        for (const auto& primitive : Table<ModelCachePrimitive>(_header.primitives_offset, _header.primitive_count))
+        {
+            primitives.emplace_back(LoadedPrimitive
+                {
+                    .index_offset = primitive.index_offset,
+                    .index_count = primitive.index_count,
+                    .position_offset = primitive.position_offset,
+                    .normal_offset = primitive.normal_offset,
+                    .uv_offset = primitive.uv_offset,
+                    .tangent_offset = primitive.tangent_offset,
+                    .vertex_count = primitive.vertex_count,
+                    .material = primitive.material
+                });
+        }
+        return primitives;
+    }
+
+    std::vector<GltfMaterial> ModelCacheFile::Materials() const
+    {
+        auto materials = Table<GltfMaterial>(_header.materials_offset, _header.material_count);
+        return { materials.begin(), materials.end() };
+    }
+
+    dcspan<ModelCacheImage> ModelCacheFile::Images() const
+    {
+        return Table<ModelCacheImage>(_header.images_offset, _header.image_count);
+    }
+
+    dcspan<ModelCacheMip> ModelCacheFile::Mips(const ModelCacheImage& image) const
+    {
+        return Table<ModelCacheMip>(_header.mips_offset, _header.mip_count).subspan(image.first_mip, image.mip_count);
+    }
+
+    dcspan<uint8_t> ModelCacheFile::Geometry() const
+    {
+        return _file.bytes().subspan(_header.geometry_offset, _header.geometry_bytes);
+    }
+
+    dcspan<uint8_t> ModelCacheFile::Texels(const ModelCacheMip& mip) const
+    {
+        return _file.bytes().subspan(mip.offset, mip.bytes);
+    }
+
+    void ModelCacheFile::Prefetch(dcspan<uint8_t> bytes) const
+    {
+        _file.prefetch(static_cast<std::size_t>(bytes.data() - _file.data()), bytes.size());
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        Keys
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    uint64_t HashBytes(dcspan<uint8_t> bytes, uint64_t seed)
+    {
+        // xxh64 construction, four independent lanes over 32 byte stripes
+        auto p = bytes.data();
+        auto end = p + bytes.size();
+        uint64_t hash;
+
+        if (bytes.size() >= 32)
+        {
+            uint64_t v1 = seed + HASH_PRIME1 + HASH_PRIME2;
+            uint64_t v2 = seed + HASH_PRIME2;
+            uint64_t v3 = seed;
+            uint64_t v4 = seed - HASH_PRIME1;
+            for (; p + 32 <= end; p += 32)
+            {
+                v1 = HashRound(v1, LoadUnaligned<uint64_t>(p));
+                v2 = HashRound(v2, LoadUnaligned<uint64_t>(p + 8));
+                v3 = HashRound(v3, LoadUnaligned<uint64_t>(p + 16));
+                v4 = HashRound(v4, LoadUnaligned<uint64_t>(p + 24));
+            }
+
+            hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+            hash = HashMerge(hash, v1);
+            hash = HashMerge(hash, v2);
+            hash = HashMerge(hash, v3);
+            hash = HashMerge(hash, v4);
+        }
+        else
+        {
+            hash = seed + HASH_PRIME5;
+        }
+
+        hash += bytes.size();
+        for (; p + 8 <= end; p += 8)
+        {
+            hash ^= HashRound(0, LoadUnaligned<uint64_t>(p));
+            hash = std::rotl(hash, 27) * HASH_PRIME1 + HASH_PRIME4;
+        }
+        if (p + 4 <= end)
+        {
+            hash ^= LoadUnaligned<uint32_t>(p) * HASH_PRIME1;
+            hash = std::rotl(hash, 23) * HASH_PRIME2 + HASH_PRIME3;
+            p += 4;
+        }
+        for (; p < end; ++p)
+        {
+            hash ^= *p * HASH_PRIME5;
+            hash = std::rotl(hash, 11) * HASH_PRIME1;
+        }
+
+        hash ^= hash >> 33;
+        hash *= HASH_PRIME2;
+        hash ^= hash >> 29;
+        hash *= HASH_PRIME3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    uint64_t GltfSourceHash(const GltfDocument& document)
+    {
+        PROFILE_CATEGORIZED_SCOPE("Hash gltf sources", eureka::profiling::Color::Red, eureka::profiling::PROFILING_CATEGORY_LOAD);
+
+        uint64_t hash = MODEL_CACHE_VERSION;
+        for (const auto& file : document.SourceFiles())
+        {
+            hash = HashBytes(file.bytes, hash);
+        }
+        return hash;
+    }
+
+    std::filesystem::path ModelCachePath(const std::filesystem::path& cacheDirectory, const std::filesystem::path& source)
+    {
+        auto absolute = std::filesystem::absolute(source).lexically_normal().u8string();
+        auto pathHash = HashBytes({ reinterpret_cast<const uint8_t*>(absolute.data()), absolute.size() });
+        auto name = source.stem();
+        name += std::format("-{:016x}", pathHash);
+        name += MODEL_CACHE_EXTENSION;
+        return cacheDirectory / name;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        Mips
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    uint32_t MipLevelCount(uint32_t width, uint32_t height)
+    {
+        return static_cast<uint32_t>(std::bit_width(std::max({ width, height, 1u })));
+    }
+
+    void DownsampleRGBA8(dcspan<uint8_t> src, uint32_t width, uint32_t height, dspan<uint8_t> dst)
+    {
+        auto dstWidth = std::max(width / 2, 1u);
+        auto dstHeight = std::max(height / 2, 1u);
+        assert(src.size() >= static_cast<uint64_t>(width) * height * 4);
+        assert(dst.size() >= static_cast<uint64_t>(dstWidth) * dstHeight * 4);
+
+        for (auto y = 0u; y < dstHeight; ++y)
+        {
+            auto row0 = src.data() + static_cast<uint64_t>(std::min(y * 2, height - 1)) * width * 4;
+            auto row1 = src.data() + static_cast<uint64_t>(std::min(y * 2 + 1, height - 1)) * width * 4;
+            auto out = dst.data() + static_cast<uint64_t>(y) * dstWidth * 4;
+
+            auto x = 0u;
+#ifdef EUREKA_MODEL_CACHE_SSE2
+            x = DownsampleRowRGBA8SSE(row0, row1, width, out);
+#endif
+            for (; x < dstWidth; ++x)
+            {
+                auto x0 = std::min(x * 2, width - 1) * 4;
+                auto x1 = std::min(x * 2 + 1, width - 1) * 4;
+                for (auto c = 0u; c < 4; ++c)
+                {
+                    auto sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c];
+                    out[x * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        Cooking
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    future_t<void> CookModelCacheAsync(
+        const GltfDocument& document,
+        uint64_t sourceHash,
+        std::filesystem::path cachePath,
+        PoolExecutor poolExecutor,
+        eureka::stop_token cancel
+    )
+    {
+        co_await concurrencpp::resume_on(*poolExecutor);
+        ThrowOnCancelled(cancel);
+
+        auto start = std::chrono::steady_clock::now();
+        auto layout = LayoutSceneGeometry(document);
+
+        //
+        // tables, the image sizes come from the image headers, nothing is decoded yet
+        //
+        std::vector<ModelCacheSource> sources;
+        std::string paths;
+        for (const auto& file : document.SourceFiles())
+        {
+            auto absolute = std::filesystem::absolute(file.path).lexically_normal();
+            auto utf8 = absolute.u8string();
+            sources.emplace_back(ModelCacheSource
+                {
+                    .byte_size = std::filesystem::file_size(absolute),
+                    .write_time = WriteTimeTicks(std::filesystem::last_write_time(absolute)),
+                    .path_offset = static_cast<uint32_t>(paths.size()),
+                    .path_bytes = static_cast<uint32_t>(utf8.size())
+                });
+            paths.append(utf8.begin(), utf8.end());
+        }
+
+        std::vector<ModelCachePrimitive> primitives;
+        primitives.reserve(layout.primitives.size());
+        for (const auto& primitive : layout.primitives)
+        {
+            primitives.emplace_back(ModelCachePrimitive
+                {
+                    .index_offset = primitive.index_offset,
+                    .position_offset = primitive.position_offset,
+                    .normal_offset = primitive.normal_offset,
+                    .uv_offset = primitive.uv_offset,
+                    .tangent_offset = primitive.tangent_offset,
+                    .index_count = primitive.index_count,
+                    .vertex_count = primitive.vertex_count,
+                    .material = primitive.material,
+                    .reserved = 0
+                });
+        }
+
+        std::vector<ModelCacheImage> images;
+        std::vector<ModelCacheMip> mips;
+        for (auto i = 0u; i < document.Images().size(); ++i)
+        {
+            if (document.Images()[i].basisu_fallback)
+            {
+                images.emplace_back(ModelCacheImage
+                    {
+                        .width = 0,
+                        .height = 0,
+                        .first_mip = static_cast<uint32_t>(mips.size()),
+                        .mip_count = 0,
+                        .encoding = ModelCacheImageEncoding::eSkipped,
+                        .reserved = 0
+                    });
+                continue;
+            }
+
+            auto encoded = document.ImageBytes(i);
+            if (IsKtx2(encoded))
+            {
+                auto extent = Ktx2Extent(encoded);
+                images.emplace_back(ModelCacheImage
+                    {
+                        .width = extent.width,
+                        .height = extent.height,
+                        .first_mip = static_cast<uint32_t>(mips.size()),
+                        .mip_count = 1,
+                        .encoding = ModelCacheImageEncoding::eKtx2,
+                        .reserved = 0
+                    });
+                mips.emplace_back(ModelCacheMip{ .offset = 0, .bytes = encoded.size(), .width = extent.width, .height = extent.height });
+                continue;
+            }
+
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            if (!stbi_info_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels))
+            {
+                throw file_load_error(std::string("failed reading gltf image header: ") + stbi_failure_reason());
+            }
+
+            auto& image = images.emplace_back(ModelCacheImage
+                {
+                    .width = static_cast<uint32_t>(width),
+                    .height = static_cast<uint32_t>(height),
+                    .first_mip = static_cast<uint32_t>(mips.size()),
+                    .mip_count = MipLevelCount(static_cast<uint32_t>(width), static_cast<uint32_t>(height)),
+                    .encoding = ModelCacheImageEncoding::eRGBA8Mips,
+                    .reserved = 0
+                });
+
+            for (auto level = 0u; level < image.mip_count; ++level)
+            {
+                auto mipWidth = std::max(image.width >> level, 1u);
+                auto mipHeight = std::max(image.height >> level, 1u);
+                mips.emplace_back(ModelCacheMip{ .offset = 0, .bytes = static_cast<uint64_t>(mipWidth) * mipHeight * 4, .width = mipWidth, .height = mipHeight });
+            }
+        }
+
+        auto materials = document.Materials();
+
+        //
+        // file layout
+        //
+        ModelCacheHeader header
+        {
+            .magic = MODEL_CACHE_MAGIC,
+            .version = MODEL_CACHE_VERSION,
+            .source_hash = sourceHash,
+            .file_bytes = 0,
+            .source_count = static_cast<uint32_t>(sources.size()),
+            .path_bytes = static_cast<uint32_t>(paths.size()),
+            .primitive_count = static_cast<uint32_t>(primitives.size()),
+            .material_count = static_cast<uint32_t>(materials.size()),
+            .image_count = static_cast<uint32_t>(images.size()),
+            .mip_count = static_cast<uint32_t>(mips.size()),
+            .sources_offset = sizeof(ModelCacheHeader),
+            .paths_offset = 0,
+            .primitives_offset = 0,
+            .materials_offset = 0,
+            .images_offset = 0,
+            .mips_offset = 0,
+            .geometry_offset = 0,
+            .geometry_bytes = layout.bytes
+        };
+
+        header.paths_offset = header.sources_offset + sources.size() * sizeof(ModelCacheSource);
+        header.primitives_offset = AlignUp(header.paths_offset + paths.size(), TABLE_ALIGNMENT);
+        header.materials_offset = header.primitives_offset + primitives.size() * sizeof(ModelCachePrimitive);
+        header.images_offset = AlignUp(header.materials_offset + materials.size() * sizeof(GltfMaterial), TABLE_ALIGNMENT);
+        header.mips_offset = header.images_offset + images.size() * sizeof(ModelCacheImage);
+        header.geometry_offset = AlignUp(header.mips_offset + mips.size() * sizeof(ModelCacheMip), BLOB_ALIGNMENT);
+
+        auto offset = header.geometry_offset + header.geometry_bytes;
+        for (const auto& image : images)
+        {
+            offset = AlignUp(offset, BLOB_ALIGNMENT);
+            for (auto level = 0u; level < image.mip_count; ++level)
+            {
+                auto& mip = mips[image.first_mip + level];
+                mip.offset = offset;
+                offset = AlignUp(offset + mip.bytes, MIP_ALIGNMENT);
+            }
+        }
+        header.file_bytes = offset;
+
+        //
+        // the tables, then the blobs in parallel
+        //
+        std::filesystem::create_directories(cachePath.parent_path());
+        auto tempPath = CookingPath(cachePath);
+
+        try
+        {
+            std::optional<CookTarget> target(std::in_place, tempPath, header.file_bytes);
+            {
+                std::array<dcspan<uint8_t>, 1> headerBytes{ dcspan<uint8_t>(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) };
+                target->Write(0, headerBytes);
+                target->WriteTable(header.sources_offset, sources);
+                target->WriteTable(header.paths_offset, std::vector<char>(paths.begin(), paths.end()));
+                target->WriteTable(header.primitives_offset, primitives);
+                target->WriteTable(header.materials_offset, materials);
+                target->WriteTable(header.images_offset, images);
+                target->WriteTable(header.mips_offset, mips);
+            }
+
+            std::vector<future_t<void>> tasks;
+            for (auto i = 0u; i < images.size(); ++i)
+            {
+                if (images[i].encoding == ModelCacheImageEncoding::eSkipped)
+                {
+                    continue;
+                }
+                tasks.emplace_back(CookImageAsync(
+                    document,
+                    i,
+                    images[i],
+                    dcspan<ModelCacheMip>(mips).subspan(images[i].first_mip, images[i].mip_count),
+                    *target,
+                    poolExecutor,
+                    cancel));
+            }
+
+            std::size_t batchBegin = 0;
+            uint64_t batchBytes = 0;
+            for (std::size_t i = 0; i < layout.primitives.size(); ++i)
+            {
+                PrefetchPrimitive(document, layout.sources[i]);
+
+                batchBytes += PrimitiveGeometryBytes(layout.primitives[i]);
+                if (batchBytes >= COOK_BATCH_BYTES || i + 1 == layout.primitives.size())
+                {
+                    auto count = i + 1 - batchBegin;
+                    tasks.emplace_back(CookGeometryBatchAsync(
+                        document,
+                        dcspan<GltfPrimitive>(layout.sources).subspan(batchBegin, count),
+                        dcspan<LoadedPrimitive>(layout.primitives).subspan(batchBegin, count),
+                        header.geometry_offset + layout.primitives[batchBegin].index_offset,
+                        *target,
+                        poolExecutor,
+                        cancel));
+
+                    batchBegin = i + 1;
+                    batchBytes = 0;
+                }
+            }
+
+            co_await await_all(std::move(tasks));
+            target->Close();
+            target.reset();
+
+            // readers never observe a partially written cache
+            std::filesystem::rename(tempPath, cachePath);
+        }
+        catch (...)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            throw;
+        }
+
+        DEBUGGER_TRACE("cooked {} - {} MB in {} ms",
+            cachePath.string(),
+            header.file_bytes / (1024 * 1024),
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+}
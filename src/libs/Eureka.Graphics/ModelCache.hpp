@@ -0,0 +1,160 @@
+#pragma once
+#include "GltfGeometry.hpp"
+#include "GraphicsDefaults.hpp"
+#include <future.hpp>
+#include <stop_token.hpp>
+
+namespace eureka::graphics
+{
+    inline constexpr uint32_t MODEL_CACHE_MAGIC = 0x434D4B45;    // "EKMC"
+    inline constexpr uint32_t MODEL_CACHE_VERSION = 3;
+    inline constexpr std::string_view MODEL_CACHE_EXTENSION = ".emc";
+
+    //
+    // model cache file, little endian
+    // header | sources | source paths | primitives | materials | images | mips | geometry | mip texels
+    // tables are 8 byte aligned, the geometry and every image's texels are page aligned
+    // the geometry is the LoadedModel geometry buffer as is, mips are tightly packed RGBA8
+    // KTX2 images are kept as their container, the transcode target depends on the device loading the cache
+    //
+    struct ModelCacheHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t source_hash;           // content hash of the document and the files it references
+        uint64_t file_bytes;
+        uint32_t source_count;
+        uint32_t path_bytes;
+        uint32_t primitive_count;
+        uint32_t material_count;
+        uint32_t image_count;
+        uint32_t mip_count;
+        uint64_t sources_offset;
+        uint64_t paths_offset;
+        uint64_t primitives_offset;
+        uint64_t materials_offset;
+        uint64_t images_offset;
+        uint64_t mips_offset;
+        uint64_t geometry_offset;
+        uint64_t geometry_bytes;
+    };
+
+    // a source file as it was when the cache was cooked, a match skips hashing the sources
+    struct ModelCacheSource
+    {
+        uint64_t byte_size;
+        int64_t  write_time;            // file clock ticks
+        uint32_t path_offset;           // utf8, into the paths table
+        uint32_t path_bytes;
+    };
+
+    struct ModelCachePrimitive
+    {
+        uint64_t index_offset;
+        uint64_t position_offset;
+        uint64_t normal_offset;
+        uint64_t uv_offset;
+        uint64_t tangent_offset;
+        uint32_t index_count;
+        uint32_t vertex_count;
+        int32_t  material;
+        uint32_t reserved;
+    };
+
+    enum class ModelCacheImageEncoding : uint32_t
+    {
+        eRGBA8Mips,                     // a mip per level
+        eKtx2,                          // a single mip entry holding the KTX2 container
+        eSkipped                        // a KHR_texture_basisu fallback, no mips, the model image stays unallocated
+    };
+
+    struct ModelCacheImage
+    {
+        uint32_t                width;
+        uint32_t                height;
+        uint32_t                first_mip;      // into the mips table
+        uint32_t                mip_count;
+        ModelCacheImageEncoding encoding;
+        uint32_t                reserved;
+    };
+
+    struct ModelCacheMip
+    {
+        uint64_t offset;                // from the start of the file
+        uint64_t bytes;
+        uint32_t width;
+        uint32_t height;
+    };
+
+    //
+    // ModelCacheFile
+    // a cooked model, memory mapped, the tables are validated against the file size on construction
+    // geometry and texel spans point into the mapping and can be handed to the AsyncDataLoader as is
+    //
+    class ModelCacheFile
+    {
+        os::mapped_file  _file;
+        ModelCacheHeader _header{};
+
+        template<typename T>
+        dcspan<T> Table(uint64_t offset, uint64_t count) const
+        {
+            return { reinterpret_cast<const T*>(_file.data() + offset), count };
+        }
+
+        std::filesystem::path SourcePath(const ModelCacheSource& source) const;
+    public:
+        // throws file_not_found_error, file_load_error when malformed or of another version
+        explicit ModelCacheFile(const std::filesystem::path& path);
+
+        uint64_t SourceHash() const { return _header.source_hash; }
+        uint64_t FileBytes() const { return _file.size(); }
+
+        // every source file still has the size and the write time it was cooked from
+        bool SourcesUnchanged() const;
+
+        // stores the current size and write time of the sources, for a cache whose sources were touched but kept
+        // their content, the file must not be mapped meanwhile
+        // throws file_not_found_error, file_load_error, std::runtime_error when the file can't be written
+        static void RestampSources(const std::filesystem::path& path);
+
+        std::vector<LoadedPrimitive> Primitives() const;
+        std::vector<GltfMaterial> Materials() const;
+        dcspan<ModelCacheImage> Images() const;
+        dcspan<ModelCacheMip> Mips(const ModelCacheImage& image) const;
+        dcspan<uint8_t> Geometry() const;
+        dcspan<uint8_t> Texels(const ModelCacheMip& mip) const;
+
+        // hints the kernel to read a span of the mapping ahead
+        void Prefetch(dcspan<uint8_t> bytes) const;
+    };
+
+    // 64 bit content hash, stable within a MODEL_CACHE_VERSION
+    uint64_t HashBytes(dcspan<uint8_t> bytes, uint64_t seed = 0);
+
+    // content hash of the document and the files it references
+    uint64_t GltfSourceHash(const GltfDocument& document);
+
+    // <cacheDirectory>/<source stem>-<hash of the absolute source path>.emc
+    std::filesystem::path ModelCachePath(const std::filesystem::path& cacheDirectory, const std::filesystem::path& source);
+
+    uint32_t MipLevelCount(uint32_t width, uint32_t height);
+
+    // next mip level of a tightly packed RGBA8 image, 2x2 box filter, the extents halve rounding down like vulkan mip levels
+    void DownsampleRGBA8(dcspan<uint8_t> src, uint32_t width, uint32_t height, dspan<uint8_t> dst);
+
+    //
+    // cooks the document into cachePath on the pool, the geometry batches and the images (decode and mip chain) in
+    // parallel, written straight to their place in the file
+    // the file is written under a temporary name unique to the cook and renamed once complete, a failed cook leaves
+    // no cache behind
+    // throws file_load_error for the document, operation_cancelled, std::runtime_error when the file can't be written
+    //
+    future_t<void> CookModelCacheAsync(
+        const GltfDocument& document,
+        uint64_t sourceHash,
+        std::filesystem::path cachePath,
+        PoolExecutor poolExecutor,
+        eureka::stop_token cancel = {}
+    );
+}
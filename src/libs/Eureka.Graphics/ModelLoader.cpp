@@ -0,0 +1,502 @@
+#include "ModelLoader.hpp"
+#include "AsyncDataLoader.hpp"
+#include <basic_errors.hpp>
+#include <profiling.hpp>
+#include <debugger_trace.hpp>
+#include <compiler.hpp>
+#include <optional>
+
+#define STB_IMAGE_IMPLEMENTATION
+EUREKA_MSVC_WARNING_PUSH
+EUREKA_MSVC_WARNING_DISABLE(4996)
+#include <stb_image.h>
+EUREKA_MSVC_WARNING_POP
+
+namespace eureka::graphics
+{
+    namespace
+    {
+        void ThrowOnCancelled(const eureka::stop_token& cancel)
+        {
+            if (cancel.stop_requested())
+            {
+                throw operation_cancelled("model loading cancelled");
+            }
+        }
+
+        // a missing, stale format or malformed cache is cooked again
+        std::optional<ModelCacheFile> TryOpenModelCache(const std::filesystem::path& cachePath)
+        {
+            std::error_code ec;
+            if (!std::filesystem::exists(cachePath, ec))
+            {
+                return std::nullopt;
+            }
+
+            try
+            {
+                return std::optional<ModelCacheFile>(std::in_place, cachePath);
+            }
+            catch (const std::exception& err)
+            {
+                DEBUGGER_TRACE("ignoring model cache {}: {}", cachePath.string(), err.what());
+                return std::nullopt;
+            }
+        }
+    }
+
+    ModelLoader::ModelLoader(
+        std::shared_ptr<vulkan::Device> device,
+        std::shared_ptr<vulkan::ResourceAllocator> allocator,
+        std::shared_ptr<AsyncDataLoader> asyncDataLoader,
+        IOExecutor ioExecutor,
+        PoolExecutor poolExecutor
+    ) :
+        _device(std::move(device)),
+        _allocator(std::move(allocator)),
+        _asyncDataLoader(std::move(asyncDataLoader)),
+        _ioExecutor(std::move(ioExecutor)),
+        _poolExecutor(std::move(poolExecutor)),
+        _textureFormats(QueryTextureFormatSupport(*_device))
+    {
+    }
+
+    future_t<void> ModelLoader::LoadImageAsync(
+        const GltfDocument& document,
+        uint32_t image,
+        vulkan::AllocatedImage2D& target,
+        LoadingCounters& counters,
+        eureka::stop_token cancel
+    )
+    {
+        co_await concurrencpp::resume_on(*_poolExecutor);
+        ThrowOnCancelled(cancel);
+
+        auto encoded = document.ImageBytes(image);
+        if (IsKtx2(encoded))
+        {
+            co_await UploadKtx2ImageAsync(encoded, target, counters);
+            co_return;
+        }
+
+        int width = 0;
+        int height = 0;
+        int channels = 0;
+        std::unique_ptr<stbi_uc, decltype(&stbi_image_free)> texels(nullptr, &stbi_image_free);
+        {
+            PROFILE_CATEGORIZED_SCOPE("Decode gltf image", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_LOAD);
+
+            texels.reset(stbi_load_from_memory(encoded.data(), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha));
+        }
+
+        if (!texels)
+        {
+            throw file_load_error(std::string("failed decoding gltf image: ") + stbi_failure_reason());
+        }
+
+        auto byteSize = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * 4;
+
+        VkExtent2D extent{ .width = static_cast<uint32_t>(width), .height = static_cast<uint32_t>(height) };
+        auto mipLevels = MipLevelCount(extent.width, extent.height);
+        for (auto level = 0u; level < mipLevels; ++level)
+        {
+            auto mipBytes = static_cast<uint64_t>(std::max(extent.width >> level, 1u)) * std::max(extent.height >> level, 1u) * 4;
+            counters.image_bytes.fetch_add(mipBytes, std::memory_order_relaxed);
+        }
+
+        target.Allocate(vulkan::Image2DProperties
+            {
+                .extent = extent,
+                .preset = vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResource,
+                .mip_levels = mipLevels
+            });
+
+        // only the base level is staged, the rest of the chain is blitted from it on the graphics queue
+        // the texels are copied to the stage before the upload first suspends
+        co_await _asyncDataLoader->UploadImageAsync(vulkan::ImageStageUploadDesc
+            {
+                .unpinned_src_span = dcspan<uint8_t>(texels.get(), byteSize),
+                .stage_zone_offset = 0,
+                .destination_image = target.Get(),
+                .destination_image_extent = VkExtent3D{ .width = extent.width, .height = extent.height, .depth = 1 },
+                .generate_mip_levels = mipLevels - 1
+            });
+        target.EnableRelocation(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    future_t<void> ModelLoader::LoadPrimitivesAsync(
+        const GltfDocument& document,
+        dcspan<GltfPrimitive> sources,
+        dcspan<LoadedPrimitive> targets,
+        VkBuffer geometry,
+        LoadingCounters& counters,
+        eureka::stop_token cancel
+    )
+    {
+        co_await concurrencpp::resume_on(*_poolExecutor);
+        ThrowOnCancelled(cancel);
+
+        GeometryStreamStorage storage;
+        vulkan::BufferDataUploadTransferDesc upload
+        {
+            .unpinned_src_spans = {},
+            .stage_zone_offset = 0,
+            .bytes = 0,
+            .dst_buffer = geometry,
+            .dst_offset = targets.front().index_offset
+        };
+
+        {
+            PROFILE_CATEGORIZED_SCOPE("Convert gltf primitives", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_LOAD);
+
+            // the batch is a contiguous range of the geometry buffer, streams in layout order
+            for (auto i = 0u; i < sources.size(); ++i)
+            {
+                auto streams = ConvertPrimitiveStreams(document, sources[i], targets[i], storage, counters.zero_copy_bytes);
+                upload.unpinned_src_spans.insert(upload.unpinned_src_spans.end(), streams.begin(), streams.end());
+                upload.bytes += PrimitiveGeometryBytes(targets[i]);
+            }
+        }
+
+        // the streams are copied to the stage before the upload first suspends
+        std::vector<vulkan::BufferDataUploadTransferDesc> uploads;
+        uploads.emplace_back(std::move(upload));
+        co_await _asyncDataLoader->UploadImagesAndBuffersAsync({}, std::move(uploads));
+    }
+
+    future_t<void> ModelLoader::UploadKtx2ImageAsync(
+        dcspan<uint8_t> container,
+        vulkan::AllocatedImage2D& target,
+        LoadingCounters& counters
+    )
+    {
+        Ktx2Texture texture(container, _textureFormats);
+        counters.image_bytes.fetch_add(texture.Bytes(), std::memory_order_relaxed);
+
+        target.Allocate(vulkan::Image2DProperties
+            {
+                .extent = texture.Extent(),
+                .preset = texture.Preset(),
+                .mip_levels = static_cast<uint32_t>(texture.Levels().size())
+            });
+
+        std::vector<vulkan::ImageStageUploadDesc> uploads;
+        for (auto level = 0u; level < texture.Levels().size(); ++level)
+        {
+            const auto& transcoded = texture.Levels()[level];
+            uploads.emplace_back(vulkan::ImageStageUploadDesc
+                {
+                    .unpinned_src_span = transcoded.bytes,
+                    .stage_zone_offset = 0,
+                    .destination_image = target.Get(),
+                    .destination_image_extent = VkExtent3D{ .width = transcoded.extent.width, .height = transcoded.extent.height, .depth = 1 },
+                    .destination_mip_level = level,
+                    .destination_format = texture.Format()
+                });
+        }
+
+        // the levels are copied to the stage before the upload first suspends
+        co_await _asyncDataLoader->UploadImagesAndBuffersAsync(std::move(uploads), {});
+        target.EnableRelocation(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    future_t<void> ModelLoader::UploadCachedImageAsync(
+        const ModelCacheFile& cache,
+        const ModelCacheImage& image,
+        vulkan::AllocatedImage2D& target,
+        LoadingCounters& counters,
+        eureka::stop_token cancel
+    )
+    {
+        co_await concurrencpp::resume_on(*_poolExecutor);
+        ThrowOnCancelled(cancel);
+
+        if (image.encoding == ModelCacheImageEncoding::eKtx2)
+        {
+            auto container = cache.Texels(cache.Mips(image).front());
+            cache.Prefetch(container);
+            co_await UploadKtx2ImageAsync(container, target, counters);
+            co_return;
+        }
+
+        target.Allocate(vulkan::Image2DProperties
+            {
+                .extent = VkExtent2D{ .width = image.width, .height = image.height },
+                .preset = vulkan::Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResource,
+                .mip_levels = image.mip_count
+            });
+
+        // the whole chain in one batch, every level straight from the mapping
+        std::vector<vulkan::ImageStageUploadDesc> uploads;
+        for (auto level = 0u; level < image.mip_count; ++level)
+        {
+            const auto& mip = cache.Mips(image)[level];
+            auto texels = cache.Texels(mip);
+            cache.Prefetch(texels);
+            counters.image_bytes.fetch_add(mip.bytes, std::memory_order_relaxed);
+
+            uploads.emplace_back(vulkan::ImageStageUploadDesc
+                {
+                    .unpinned_src_span = texels,
+                    .stage_zone_offset = 0,
+                    .destination_image = target.Get(),
+                    .destination_image_extent = VkExtent3D{ .width = mip.width, .height = mip.height, .depth = 1 },
+                    .destination_mip_level = level
+                });
+        }
+
+        co_await _asyncDataLoader->UploadImagesAndBuffersAsync(std::move(uploads), {});
+        target.EnableRelocation(VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    future_t<void> ModelLoader::UploadCachedGeometryAsync(
+        const ModelCacheFile& cache,
+        dcspan<uint8_t> bytes,
+        VkBuffer geometry,
+        uint64_t dstOffset,
+        eureka::stop_token cancel
+    )
+    {
+        co_await concurrencpp::resume_on(*_poolExecutor);
+        ThrowOnCancelled(cancel);
+
+        cache.Prefetch(bytes);
+
+        std::vector<vulkan::BufferDataUploadTransferDesc> uploads;
+        uploads.emplace_back(vulkan::BufferDataUploadTransferDesc
+            {
+                .unpinned_src_spans = { bytes },
+                .stage_zone_offset = 0,
+                .bytes = bytes.size(),
+                .dst_buffer = geometry,
+                .dst_offset = dstOffset
+            });
+        co_await _asyncDataLoader->UploadImagesAndBuffersAsync({}, std::move(uploads));
+    }
+
+    future_t<LoadedModel> ModelLoader::LoadDocumentModelAsync(
+        const GltfDocument& document,
+        const ModelLoadingConfig& config,
+        std::chrono::steady_clock::time_point start
+    )
+    {
+        LoadedModel model;
+        model.stats.parse_duration = std::chrono::steady_clock::now() - start;
+        model.stats.mapped_bytes = document.MappedBytes();
+        model.materials = document.Materials();
+
+        ThrowOnCancelled(config.cancel);
+        co_await concurrencpp::resume_on(*_poolExecutor);
+
+        auto layout = LayoutSceneGeometry(document);
+        model.primitives = layout.primitives;
+        model.stats.geometry_bytes = layout.bytes;
+
+        if (model.stats.geometry_bytes)
+        {
+            model.geometry = vulkan::VertexAndIndexTransferableDeviceBuffer(_allocator, model.stats.geometry_bytes);
+        }
+
+        //
+        // everything below runs in parallel on the pool, each task uploads as soon as its data is ready
+        //
+        LoadingCounters counters;
+        std::vector<future_t<void>> tasks;
+
+        model.images.reserve(document.Images().size());
+        for (auto i = 0u; i < document.Images().size(); ++i)
+        {
+            auto& image = model.images.emplace_back(_device, _allocator);
+            if (!document.Images()[i].basisu_fallback)
+            {
+                tasks.emplace_back(LoadImageAsync(document, i, image, counters, config.cancel));
+            }
+        }
+
+        std::size_t batchBegin = 0;
+        uint64_t batchBytes = 0;
+        for (std::size_t i = 0; i < model.primitives.size(); ++i)
+        {
+            // the kernel reads the batch ahead while the previous batches are converted
+            PrefetchPrimitive(document, layout.sources[i]);
+
+            batchBytes += PrimitiveGeometryBytes(model.primitives[i]);
+            if (batchBytes >= config.max_upload_batch_bytes || i + 1 == model.primitives.size())
+            {
+                auto count = i + 1 - batchBegin;
+                tasks.emplace_back(LoadPrimitivesAsync(
+                    document,
+                    dcspan<GltfPrimitive>(layout.sources).subspan(batchBegin, count),
+                    dcspan<LoadedPrimitive>(model.primitives).subspan(batchBegin, count),
+                    model.geometry.Buffer(),
+                    counters,
+                    config.cancel));
+
+                ++model.stats.upload_batches;
+                batchBegin = i + 1;
+                batchBytes = 0;
+            }
+        }
+
+        // the tasks reference the document, the model and the counters, all of them finish before anything is rethrown
+        co_await await_all(std::move(tasks));
+
+        model.stats.zero_copy_bytes = counters.zero_copy_bytes.load();
+        model.stats.image_bytes = counters.image_bytes.load();
+        model.stats.total_duration = std::chrono::steady_clock::now() - start;
+        co_return model;
+    }
+
+    future_t<LoadedModel> ModelLoader::LoadCachedModelAsync(
+        const ModelCacheFile& cache,
+        const ModelLoadingConfig& config,
+        std::chrono::steady_clock::time_point start
+    )
+    {
+        LoadedModel model;
+        model.stats.parse_duration = std::chrono::steady_clock::now() - start;
+        model.stats.mapped_bytes = cache.FileBytes();
+        model.stats.from_cache = true;
+        model.primitives = cache.Primitives();
+        model.materials = cache.Materials();
+
+        ThrowOnCancelled(config.cancel);
+        co_await concurrencpp::resume_on(*_poolExecutor);
+
+        auto geometry = cache.Geometry();
+        model.stats.geometry_bytes = geometry.size();
+        model.stats.zero_copy_bytes = geometry.size();
+        if (!geometry.empty())
+        {
+            model.geometry = vulkan::VertexAndIndexTransferableDeviceBuffer(_allocator, geometry.size());
+        }
+
+        // nothing is converted, the uploads start right away, only KTX2 images are transcoded
+        LoadingCounters counters;
+        std::vector<future_t<void>> tasks;
+
+        model.images.reserve(cache.Images().size());
+        for (const auto& image : cache.Images())
+        {
+            auto& target = model.images.emplace_back(_device, _allocator);
+            if (image.encoding != ModelCacheImageEncoding::eSkipped)
+            {
+                tasks.emplace_back(UploadCachedImageAsync(cache, image, target, counters, config.cancel));
+            }
+        }
+
+        auto batchBytes = std::max<uint64_t>(config.max_upload_batch_bytes, 1);
+        for (uint64_t offset = 0; offset < geometry.size(); offset += batchBytes)
+        {
+            auto bytes = geometry.subspan(offset, std::min(batchBytes, geometry.size() - offset));
+            tasks.emplace_back(UploadCachedGeometryAsync(cache, bytes, model.geometry.Buffer(), offset, config.cancel));
+            ++model.stats.upload_batches;
+        }
+
+        co_await await_all(std::move(tasks));
+
+        model.stats.image_bytes = counters.image_bytes.load();
+        model.stats.total_duration = std::chrono::steady_clock::now() - start;
+        co_return model;
+    }
+
+    future_t<LoadedModel> ModelLoader::LoadModel(std::filesystem::path path, ModelLoadingConfig config)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        co_await concurrencpp::resume_on(*_ioExecutor);
+
+        std::optional<GltfDocument> document;
+        auto mapDocument = [&]()
+        {
+            PROFILE_CATEGORIZED_SCOPE("Map gltf", eureka::profiling::Color::Red, eureka::profiling::PROFILING_CATEGORY_LOAD);
+            document.emplace(path);
+        };
+
+        //
+        // the cache is used as long as the sources keep their size and write time or, when they don't, their content
+        //
+        std::optional<ModelCacheFile> cache;
+        bool cooked = false;
+        if (!config.cache_directory.empty())
+        {
+            auto cachePath = ModelCachePath(config.cache_directory, path);
+            cache = TryOpenModelCache(cachePath);
+
+            if (!cache || !cache->SourcesUnchanged())
+            {
+                mapDocument();
+                auto sourceHash = GltfSourceHash(*document);
+
+                if (!cache || cache->SourceHash() != sourceHash)
+                {
+                    cache.reset();
+                    bool cacheWritten = false;
+                    try
+                    {
+                        co_await CookModelCacheAsync(*document, sourceHash, cachePath, _poolExecutor, config.cancel);
+                        cacheWritten = true;
+                    }
+                    catch (const file_load_error&)
+                    {
+                        throw;
+                    }
+                    catch (const operation_cancelled&)
+                    {
+                        throw;
+                    }
+                    catch (const std::exception& err)
+                    {
+                        DEBUGGER_TRACE("model cache {} not written: {}", cachePath.string(), err.what());
+                    }
+
+                    if (cacheWritten)
+                    {
+                        cache = TryOpenModelCache(cachePath);
+                        cooked = cache.has_value();
+                    }
+                }
+                else
+                {
+                    // touched but not changed (a copy, a checkout), the next load skips the hash again
+                    cache.reset();
+                    try
+                    {
+                        ModelCacheFile::RestampSources(cachePath);
+                    }
+                    catch (const std::exception& err)
+                    {
+                        DEBUGGER_TRACE("model cache {} not restamped: {}", cachePath.string(), err.what());
+                    }
+                    cache = TryOpenModelCache(cachePath);
+                }
+            }
+        }
+
+        LoadedModel model;
+        if (cache)
+        {
+            model = co_await LoadCachedModelAsync(*cache, config, start);
+            model.stats.cooked = cooked;
+        }
+        else
+        {
+            if (!document)
+            {
+                mapDocument();
+            }
+            model = co_await LoadDocumentModelAsync(*document, config, start);
+        }
+
+        DEBUGGER_TRACE("loaded {}{} - {} primitives, {} images, {} MB geometry ({} MB zero copy) in {} ms",
+            path.string(),
+            model.stats.from_cache ? (model.stats.cooked ? " (cooked)" : " (cached)") : "",
+            model.primitives.size(),
+            model.images.size(),
+            model.stats.geometry_bytes / (1024 * 1024),
+            model.stats.zero_copy_bytes / (1024 * 1024),
+            std::chrono::duration_cast<std::chrono::milliseconds>(model.stats.total_duration).count());
+
+        co_return model;
+    }
+}
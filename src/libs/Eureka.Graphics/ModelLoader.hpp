@@ -0,0 +1,99 @@
+#pragma once
+#include "../Eureka.Vulkan/Buffer.hpp"
+#include "../Eureka.Vulkan/Image.hpp"
+#include "ModelCache.hpp"
+#include "Ktx2Texture.hpp"
+#include "GraphicsDefaults.hpp"
+#include <future.hpp>
+#include <stop_token.hpp>
+#include <atomic>
+#include <chrono>
+
+namespace eureka::graphics
+{
+    class AsyncDataLoader;
+
+    struct ModelLoadingConfig
+    {
+        eureka::stop_token    cancel;
+        uint64_t              max_upload_batch_bytes{ 16 * 1024 * 1024 };  // primitives are grouped into uploads up to this size
+        std::filesystem::path cache_directory;                             // empty - no cache, the document is converted on every load
+    };
+
+    struct ModelLoadingStats
+    {
+        uint64_t                 mapped_bytes{ 0 };
+        uint64_t                 geometry_bytes{ 0 };
+        uint64_t                 zero_copy_bytes{ 0 };       // staged straight from a mapped file, no conversion
+        uint64_t                 image_bytes{ 0 };           // GPU texel bytes, every mip level
+        uint32_t                 upload_batches{ 0 };
+        bool                     from_cache{ false };
+        bool                     cooked{ false };            // the cache was written by this load
+        std::chrono::nanoseconds parse_duration{ 0 };
+        std::chrono::nanoseconds total_duration{ 0 };        // until the last upload is GPU resident
+    };
+
+    struct LoadedModel
+    {
+        vulkan::VertexAndIndexTransferableDeviceBuffer geometry;
+        // indexed like the document images, basisu fallbacks stay unallocated
+        // the defragmenter may move a loaded image, a consumer that builds descriptors of them calls EnableRelocation
+        // again with its own onRelocated
+        std::vector<vulkan::AllocatedImage2D>          images;
+        std::vector<LoadedPrimitive>                   primitives;
+        std::vector<GltfMaterial>                      materials;
+        ModelLoadingStats                              stats;
+    };
+
+    //
+    // ModelLoader
+    // glTF loading pipeline, disk to GPU resident
+    // 1. io executor - the file and its buffers are memory mapped, only the json is parsed
+    // 2. pool executor - the geometry layout is computed and the device buffer allocated
+    // 3. pool executor, in parallel - every image is decoded and uploaded on its own, primitives are converted
+    //    in upload sized batches, each batch is handed to the AsyncDataLoader as soon as it's converted
+    // streams that already have the target layout are staged straight from the mapping
+    // KTX2 images (KHR_texture_basisu) keep their mip chain and are transcoded to a block compressed format the
+    // device supports, see Ktx2Texture.hpp
+    //
+    // with a cache directory the document is cooked once (see ModelCache.hpp), later loads map the cache and
+    // upload the geometry and the mip chains straight from it, the document is not opened while the sources keep
+    // their size and write time
+    //
+    class ModelLoader
+    {
+        std::shared_ptr<vulkan::Device>            _device;
+        std::shared_ptr<vulkan::ResourceAllocator> _allocator;
+        std::shared_ptr<AsyncDataLoader>           _asyncDataLoader;
+        IOExecutor                                 _ioExecutor;
+        PoolExecutor                               _poolExecutor;
+        TextureFormatSupport                       _textureFormats;
+
+        struct LoadingCounters
+        {
+            std::atomic_uint64_t zero_copy_bytes{ 0 };
+            std::atomic_uint64_t image_bytes{ 0 };
+        };
+
+        future_t<LoadedModel> LoadDocumentModelAsync(const GltfDocument& document, const ModelLoadingConfig& config, std::chrono::steady_clock::time_point start);
+        future_t<LoadedModel> LoadCachedModelAsync(const ModelCacheFile& cache, const ModelLoadingConfig& config, std::chrono::steady_clock::time_point start);
+
+        future_t<void> LoadImageAsync(const GltfDocument& document, uint32_t image, vulkan::AllocatedImage2D& target, LoadingCounters& counters, eureka::stop_token cancel);
+        future_t<void> LoadPrimitivesAsync(const GltfDocument& document, dcspan<GltfPrimitive> sources, dcspan<LoadedPrimitive> targets, VkBuffer geometry, LoadingCounters& counters, eureka::stop_token cancel);
+        future_t<void> UploadKtx2ImageAsync(dcspan<uint8_t> container, vulkan::AllocatedImage2D& target, LoadingCounters& counters);
+        future_t<void> UploadCachedImageAsync(const ModelCacheFile& cache, const ModelCacheImage& image, vulkan::AllocatedImage2D& target, LoadingCounters& counters, eureka::stop_token cancel);
+        future_t<void> UploadCachedGeometryAsync(const ModelCacheFile& cache, dcspan<uint8_t> bytes, VkBuffer geometry, uint64_t dstOffset, eureka::stop_token cancel);
+    public:
+        ModelLoader(
+            std::shared_ptr<vulkan::Device> device,
+            std::shared_ptr<vulkan::ResourceAllocator> allocator,
+            std::shared_ptr<AsyncDataLoader> asyncDataLoader,
+            IOExecutor ioExecutor,
+            PoolExecutor poolExecutor
+        );
+
+        // throws file_not_found_error / file_load_error, operation_cancelled when config.cancel was requested
+        // a cache that can't be written is skipped, the model is loaded from the document
+        future_t<LoadedModel> LoadModel(std::filesystem::path path, ModelLoadingConfig config = {});
+    };
+}
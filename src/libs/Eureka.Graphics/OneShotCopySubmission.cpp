@@ -3,124 +3,60 @@
 
 namespace eureka::graphics
 {
-    //static constexpr uint64_t DONE_VAL = 1;
-
-    void DoPollCompletions(stable_vec<ExecutingnOneShotSubmissionBatch>& executing_vec)
-    {
-        if (!executing_vec.empty())
-        {
-            auto removeRange = std::ranges::remove_if(
-                executing_vec,
-                [&](ExecutingnOneShotSubmissionBatch& batch)
-                {
-                    if (std::ranges::all_of(batch.signal_list, [](vulkan::CounterSemaphoreHandle& sem)
-                        {
-                            return sem.Query();
-                        }))
-                    {
-                        for (auto& pr : batch.done_promises)
-                        {
-                            pr.set_result();
-                        }
-
-                        return true;
-                    }
-                    else
-                    {
-                        return false;
-                    }
-                }
-            );
-            executing_vec.erase(removeRange.begin(), removeRange.end());
-        }
-    }
-
-    void DoSubmitPending(
-        VkFence submitFence, 
-        vulkan::Queue& queue, 
-        stable_vec<ExecutingnOneShotSubmissionBatch>& executing_vec, 
-        std::vector<OneShotSubmissionPacket>& pending_vec
-    )
+    void DoPollCompletions(vulkan::SubmissionTracker& tracker, std::deque<ExecutingOneShotSubmission>& executing)
     {
-        auto& new_batch = executing_vec.emplace_back();
-
-        for (auto& pending : pending_vec)
+        if (executing.empty())
         {
-            new_batch.command_buffers.emplace_back(pending.command_buffer);
-            new_batch.signal_list.emplace_back(pending.signal);
-            new_batch.done_promises.emplace_back(std::move(pending.done_promise));
-            for (auto wait : pending.wait_list)
-            {
-                new_batch.wait_semaphores.emplace_back(wait.semaphore);
-                new_batch.wait_stages.emplace_back(wait.stages);
-            }
+            return;
         }
-        pending_vec.clear();
 
-        svec5<VkSemaphore> signalSemapores(new_batch.signal_list.size());
-        svec5<uint64_t> signalValues(new_batch.signal_list.size());
-        svec5<VkSemaphore> waitSemapores(new_batch.wait_semaphores.size());
-        svec5<uint64_t> waitValues(new_batch.wait_semaphores.size());
+        auto completed = tracker.PollCompleted();
 
-        for (auto i = 0u; i < new_batch.wait_semaphores.size(); ++i)
+        while (!executing.empty() && executing.front().value <= completed)
         {
-            auto& wait = new_batch.wait_semaphores[i];
-            
-            waitSemapores[i] = wait.Get();
-            waitValues[i] = wait.Value();
+            // resuming the awaiting coroutine may append new submissions, pop first
+            auto donePromise = std::move(executing.front().done_promise);
+            executing.pop_front();
+            donePromise.set_result();
         }
+    }
 
-        for (auto i = 0u; i < new_batch.signal_list.size(); ++i)
+    future_t<void> DoAppendSubmission(
+        vulkan::SubmissionTracker& tracker,
+        std::deque<ExecutingOneShotSubmission>& executing,
+        vulkan::LinearCommandBufferHandle buffer,
+        vulkan::CounterSemaphoreHandle signal,
+        dynamic_span<OneShotSubmissionWait> waitList
+    )
+    {
+        svec5<VkSemaphoreSubmitInfo> waits;
+        for (auto& wait : waitList)
         {
-            auto& signal = new_batch.signal_list[i];
-            auto prev = signal.Increment();
-            signalSemapores[i] = signal.Get();
-            signalValues[i] = prev + 1;
+            waits.emplace_back(VkSemaphoreSubmitInfo
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                    .semaphore = wait.semaphore,
+                    .value = wait.value,
+                    .stageMask = wait.stages
+                });
         }
 
-        VkTimelineSemaphoreSubmitInfo timelineInfo
-        { 
-            .sType = VkStructureType::VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
-            .waitSemaphoreValueCount = static_cast<uint32_t>(waitSemapores.size()),
-            .pWaitSemaphoreValues = waitValues.data(),
-            .signalSemaphoreValueCount = static_cast<uint32_t>(signalSemapores.size()),
-            .pSignalSemaphoreValues = signalValues.data()
-        };
-
-
-        // by default we unify multiple command buffers to a single submission
-        VkSubmitInfo uploadsSubmitInfo
+        auto prev = signal.Increment();
+        std::array<VkSemaphoreSubmitInfo, 1> signals
         {
-            .sType = VkStructureType::VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .pNext = &timelineInfo,
-            .waitSemaphoreCount = static_cast<uint32_t>(waitSemapores.size()),
-            .pWaitSemaphores = waitSemapores.data(),
-            .pWaitDstStageMask = new_batch.wait_stages.data(),
-            .commandBufferCount = static_cast<uint32_t>(new_batch.command_buffers.size()),
-            .pCommandBuffers = new_batch.command_buffers.data(),
-            .signalSemaphoreCount = static_cast<uint32_t>(signalSemapores.size()),
-            .pSignalSemaphores = signalSemapores.data()
+            VkSemaphoreSubmitInfo
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                .semaphore = signal.Get(),
+                .value = prev + 1,
+                .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+            }
         };
 
-        queue.Submit(uploadsSubmitInfo, submitFence);
+        auto& submission = executing.emplace_back();
+        submission.value = tracker.Enqueue(buffer.Get(), dcspan<VkSemaphoreSubmitInfo>(waits.data(), waits.size()), signals);
 
-    }
-
-    future_t<void> DoAppendSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal, dynamic_span<OneShotSubmissionWait> waitList, std::vector<OneShotSubmissionPacket>& vec)
-    {
-        assert(tls_is_rendering_thread);
-
-        auto& sumbissionPacket = vec.emplace_back();
-
-        sumbissionPacket.command_buffer = buffer.Get();
-        sumbissionPacket.signal = std::move(signal);
-
-        for (auto wait : waitList)
-        {
-            sumbissionPacket.wait_list.emplace_back(wait);
-        }
-
-        return sumbissionPacket.done_promise.get_result();
+        return submission.done_promise.get_result();
     }
 
     OneShotSubmissionHandler::OneShotSubmissionHandler(
@@ -128,37 +64,39 @@ namespace eureka::graphics
         vulkan::Queue copyQueue,
         vulkan::Queue graphicsQueue,
         std::shared_ptr<vulkan::FrameContext> frameContext,
-        std::shared_ptr<SubmissionThreadExecutionContext> submissionThreadExecutionContext
+        std::shared_ptr<SubmissionThreadExecutionContext> submissionThreadExecutionContext,
+        std::shared_ptr<TransferWorker> transferWorker
     ) :
         _device(std::move(device)),
         _copyQueue(copyQueue),
         _graphicsQueue(graphicsQueue),
         _submissionThreadExecutionContext(std::move(submissionThreadExecutionContext)),
-        _frameContext(std::move(frameContext))
+        _frameContext(std::move(frameContext)),
+        _transferWorker(std::move(transferWorker))
     {
-        _executingCopies.reserve(20);
-        _executingGraphics.reserve(20);
     }
-    
+
     void OneShotSubmissionHandler::PollCopyCompletions()
     {
-        DoPollCompletions(_executingCopies);
+        DoPollCompletions(_frameContext->CopySubmissions(), _executingCopies);
     }
 
     void OneShotSubmissionHandler::SubmitPendingCopies()
     {
-        if (!_pendingOneShotCopies.empty())
-        {
-            DoSubmitPending(_frameContext->NewCopySubmitFence(), _copyQueue, _executingCopies, _pendingOneShotCopies);
-        }
+        _frameContext->CopySubmissions().FlushIfDue();
     }
 
 
     future_t<void> OneShotSubmissionHandler::AppendCopyCommandSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal, dynamic_span<OneShotSubmissionWait> waitList)
     {
-        return DoAppendSubmission(buffer, std::move(signal), waitList, _pendingOneShotCopies);
+        assert(tls_is_rendering_thread);
+        return DoAppendSubmission(_frameContext->CopySubmissions(), _executingCopies, buffer, std::move(signal), waitList);
     }
 
+    vulkan::SubmissionTrackerCounters OneShotSubmissionHandler::CopySubmissionCounters() const
+    {
+        return _frameContext->CopySubmissions().Counters();
+    }
 
 
     //////////////////////////////////////////////////////////////////////////
@@ -169,20 +107,28 @@ namespace eureka::graphics
 
     void OneShotSubmissionHandler::PollGraphicsCompletions()
     {
-        DoPollCompletions(_executingGraphics);
+        DoPollCompletions(_frameContext->GraphicsSubmissions(), _executingGraphics);
     }
 
     void OneShotSubmissionHandler::SubmitPendingGraphics()
     {
-        if (!_pendingOneShotGraphics.empty())
-        {
-            DoSubmitPending(_frameContext->NewGraphicsSubmitFence(), _graphicsQueue, _executingGraphics, _pendingOneShotGraphics);
-        }
+        _frameContext->GraphicsSubmissions().FlushIfDue();
+    }
+
+    void OneShotSubmissionHandler::FlushPendingGraphics()
+    {
+        _frameContext->GraphicsSubmissions().Flush();
     }
 
     future_t<void> OneShotSubmissionHandler::AppendGraphicsSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal, dynamic_span<OneShotSubmissionWait> waitList)
     {
-        return DoAppendSubmission(buffer, std::move(signal), waitList, _pendingOneShotGraphics);
+        assert(tls_is_rendering_thread);
+        return DoAppendSubmission(_frameContext->GraphicsSubmissions(), _executingGraphics, buffer, std::move(signal), waitList);
+    }
+
+    vulkan::SubmissionTrackerCounters OneShotSubmissionHandler::GraphicsSubmissionCounters() const
+    {
+        return _frameContext->GraphicsSubmissions().Counters();
     }
 
 
@@ -197,4 +143,4 @@ namespace eureka::graphics
 
 
 
-}
\ No newline at end of file
+}
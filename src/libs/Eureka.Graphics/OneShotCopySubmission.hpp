@@ -3,58 +3,59 @@
 #include "../Eureka.Vulkan/FrameContext.hpp"
 #include "../Eureka.Vulkan/Synchronization.hpp"
 #include "SubmissionThreadExecutionContext.hpp"
-#include <boost/container/stable_vector.hpp>
+#include <deque>
 
 
 namespace eureka::graphics
 {
-    template<typename T>
-    using stable_vec = boost::container::stable_vector<T>;
-
+    // timeline wait of a one shot submission, the value is captured when the wait is built
     struct OneShotSubmissionWait
     {
-        vulkan::CounterSemaphoreHandle semaphore;
-        VkPipelineStageFlags stages;
+        VkSemaphore           semaphore;
+        uint64_t              value;
+        VkPipelineStageFlags2 stages;
     };
 
-    struct OneShotSubmissionPacket
+    // a submission handed to the queue's SubmissionTracker, done once the tracker timeline reached value
+    struct ExecutingOneShotSubmission
     {
-        VkCommandBuffer                        command_buffer{ nullptr };
-        vulkan::CounterSemaphoreHandle         signal;
-        svec5<OneShotSubmissionWait>           wait_list;
-        concurrencpp::result_promise<void>     done_promise;
+        uint64_t                               value;
+        promise_t<void>                        done_promise;
     };
 
-    struct ExecutingnOneShotSubmissionBatch
-    {
-        svec5<VkCommandBuffer>                         command_buffers;
-        svec5<vulkan::CounterSemaphoreHandle>          wait_semaphores;
-        svec5<VkPipelineStageFlags>                    wait_stages;
-        uint64_t                                       done_signal_value;
-        svec5<vulkan::CounterSemaphoreHandle>          signal_list;
-        svec5<promise_t<void>>                         done_promises;
-    };
+    class TransferWorker;
+
+    // resolves the submissions the tracker timeline already passed, in submission order
+    void DoPollCompletions(vulkan::SubmissionTracker& tracker, std::deque<ExecutingOneShotSubmission>& executing);
+
+    // enqueues the buffer on the tracker, signaling the next value of signal, done once the tracker reached the submission
+    future_t<void> DoAppendSubmission(
+        vulkan::SubmissionTracker& tracker,
+        std::deque<ExecutingOneShotSubmission>& executing,
+        vulkan::LinearCommandBufferHandle buffer,
+        vulkan::CounterSemaphoreHandle signal,
+        dynamic_span<OneShotSubmissionWait> waitList
+    );
 
     class OneShotSubmissionHandler
     {
         std::shared_ptr<vulkan::Device>                     _device;
         vulkan::Queue                                       _copyQueue;
         vulkan::Queue                                       _graphicsQueue;
-        std::vector<OneShotSubmissionPacket>                _pendingOneShotCopies;
-        std::vector<OneShotSubmissionPacket>                _pendingOneShotGraphics;
-
-        stable_vec<ExecutingnOneShotSubmissionBatch>        _executingCopies{};
-        stable_vec<ExecutingnOneShotSubmissionBatch>        _executingGraphics{};
-        // TODO linear ranges with fixed capacity and holes fixing
+        // in submission order, completion retires a prefix
+        std::deque<ExecutingOneShotSubmission>              _executingCopies;
+        std::deque<ExecutingOneShotSubmission>              _executingGraphics;
         std::shared_ptr<SubmissionThreadExecutionContext>   _submissionThreadExecutionContext;
         std::shared_ptr<vulkan::FrameContext>               _frameContext;
+        std::shared_ptr<TransferWorker>                     _transferWorker;
     public:
         OneShotSubmissionHandler(
             std::shared_ptr<vulkan::Device> device, 
             vulkan::Queue copyQueue, 
             vulkan::Queue graphicsQueue, 
             std::shared_ptr<vulkan::FrameContext> frameContext, 
-            std::shared_ptr<SubmissionThreadExecutionContext> submissionThreadExecutionContext
+            std::shared_ptr<SubmissionThreadExecutionContext> submissionThreadExecutionContext,
+            std::shared_ptr<TransferWorker> transferWorker = nullptr
         );
         future_t<void> AppendCopyCommandSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal, dynamic_span<OneShotSubmissionWait> waitList = {});
         void SubmitPendingCopies();
@@ -62,8 +63,13 @@ namespace eureka::graphics
         future_t<void> AppendGraphicsSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal, dynamic_span<OneShotSubmissionWait> waitList = {});
 
         void SubmitPendingGraphics();
+        // submits the pending graphics work now, ahead of the frame submit that follows
+        void FlushPendingGraphics();
         void PollGraphicsCompletions();
 
+        vulkan::SubmissionTrackerCounters CopySubmissionCounters() const;
+        vulkan::SubmissionTrackerCounters GraphicsSubmissionCounters() const;
+
         [[nodiscard]] auto ResumeOnRecordingContext()
         {
             return concurrencpp::resume_on(_submissionThreadExecutionContext->OneShotCopySubmitExecutor());
@@ -89,6 +95,12 @@ namespace eureka::graphics
             return _graphicsQueue;
         }
 
+        // when set, copy submissions are recorded and submitted by the worker instead of the rendering thread
+        TransferWorker* GetTransferWorker() const
+        {
+            return _transferWorker.get();
+        }
+
 
 
     };
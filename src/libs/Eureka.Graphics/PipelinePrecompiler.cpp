@@ -0,0 +1,286 @@
+#include "PipelinePrecompiler.hpp"
+#include "IPass.hpp"
+#include <profiling.hpp>
+#include <debugger_trace.hpp>
+#include <algorithm>
+
+namespace eureka::graphics
+{
+    std::shared_ptr<PresetPipeline> CompilePresetPipeline(
+        vulkan::PipelinePresetType preset,
+        std::shared_ptr<vulkan::Device> device,
+        vulkan::ShaderCache& shaderCache,
+        const vulkan::DescriptorSetLayoutCache& layoutCache,
+        std::shared_ptr<vulkan::RenderPass> renderPass,
+        VkPipelineCache pipelineCache
+    )
+    {
+        vulkan::PipelineLayoutCreationPreset layoutPreset(preset, layoutCache);
+        auto layout = std::make_shared<vulkan::PipelineLayout>(device, layoutPreset.GetCreateInfo());
+
+        vulkan::PipelineCreationPreset pipelinePreset(preset, shaderCache, layout->Get(), renderPass->Get());
+
+        auto pipeline = vulkan::Pipeline(device, layout, std::move(renderPass), pipelinePreset.GetCreateInfo(), pipelineCache);
+
+        return std::make_shared<PresetPipeline>(PresetPipeline
+            {
+                .layout = std::move(layout),
+                .pipeline = std::move(pipeline),
+                .shaders = pipelinePreset.GetShaders().names
+            });
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        PendingPresetPipeline
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    PendingPresetPipeline::PendingPresetPipeline(PresetPipelineFuture future) :
+        _future(std::move(future))
+    {
+    }
+
+    PendingPresetPipeline::PendingPresetPipeline(std::shared_ptr<PresetPipeline> pipeline) :
+        _pipeline(std::move(pipeline))
+    {
+    }
+
+    bool PendingPresetPipeline::Ready()
+    {
+        if (_pipeline)
+        {
+            return true;
+        }
+
+        if (!_future || _future.status() == concurrencpp::result_status::idle)
+        {
+            return false;
+        }
+
+        _pipeline = _future.get();
+        _future = {};
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        PipelinePrecompiler
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    PipelinePrecompiler::PipelinePrecompiler(
+        std::shared_ptr<vulkan::Device> device,
+        std::shared_ptr<vulkan::ShaderCache> shaderCache,
+        std::shared_ptr<vulkan::DescriptorSetLayoutCache> layoutCache,
+        std::shared_ptr<vulkan::PipelineCache> pipelineCache,
+        PoolExecutor executor
+    ) :
+        _device(std::move(device)),
+        _shaderCache(std::move(shaderCache)),
+        _layoutCache(std::move(layoutCache)),
+        _pipelineCache(std::move(pipelineCache)),
+        _executor(std::move(executor))
+    {
+        _counters.warm_cache = _pipelineCache->LoadedFromDisk();
+    }
+
+    PipelinePrecompiler::~PipelinePrecompiler()
+    {
+        WaitAll();
+    }
+
+    void PipelinePrecompiler::PrecompileAll(const std::shared_ptr<vulkan::RenderPass>& renderPass)
+    {
+        for (auto preset : vulkan::PIPELINE_PRESET_TYPES)
+        {
+            Request(preset, renderPass);
+        }
+    }
+
+    PresetPipelineFuture PipelinePrecompiler::Request(vulkan::PipelinePresetType preset, const std::shared_ptr<vulkan::RenderPass>& renderPass)
+    {
+        std::scoped_lock lk(_mtx);
+
+        auto [itr, inserted] = _compilations.try_emplace(std::make_pair(preset, renderPass->Get()));
+        if (inserted)
+        {
+            ++_counters.requested;
+            itr->second.render_pass = renderPass;
+            itr->second.future = PresetPipelineFuture(_executor->submit(
+                [this, preset, renderPass]
+                {
+                    return Compile(preset, renderPass);
+                }));
+        }
+
+        return itr->second.future;
+    }
+
+    std::shared_ptr<PresetPipeline> PipelinePrecompiler::Compile(vulkan::PipelinePresetType preset, std::shared_ptr<vulkan::RenderPass> renderPass)
+    {
+        PROFILE_CATEGORIZED_SCOPE("compile preset pipeline", eureka::profiling::Color::Yellow, eureka::profiling::PROFILING_CATEGORY_INIT);
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            auto pipeline = CompilePresetPipeline(preset, _device, *_shaderCache, *_layoutCache, std::move(renderPass), _pipelineCache->Get());
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+            std::scoped_lock lk(_mtx);
+            ++_counters.compiled;
+            _counters.total_compile_time += elapsed;
+            _counters.max_compile_time = std::max(_counters.max_compile_time, elapsed);
+
+            return pipeline;
+        }
+        catch (const std::exception& err)
+        {
+            DEBUGGER_TRACE("preset pipeline {} compilation failed: {}", static_cast<int>(preset), err.what());
+
+            std::scoped_lock lk(_mtx);
+            ++_counters.failed;
+            throw;
+        }
+    }
+
+    void PipelinePrecompiler::WaitAll()
+    {
+        std::vector<PresetPipelineFuture> compilations;
+        {
+            std::scoped_lock lk(_mtx);
+            compilations.reserve(_compilations.size());
+            for (const auto& [key, compilation] : _compilations)
+            {
+                compilations.emplace_back(compilation.future);
+            }
+        }
+
+        for (auto& compilation : compilations)
+        {
+            compilation.wait();
+        }
+    }
+
+    std::size_t PipelinePrecompiler::ReloadChangedShaders(vulkan::Queue& graphicsQueue)
+    {
+        auto changedShaders = _shaderCache->PollChangedShaders();
+        if (changedShaders.empty())
+        {
+            return 0;
+        }
+
+        struct Rebuild
+        {
+            std::shared_ptr<PresetPipeline>         current;
+            future_t<std::shared_ptr<PresetPipeline>> rebuilt;
+        };
+        std::vector<Rebuild> rebuilds;
+
+        {
+            std::scoped_lock lk(_mtx);
+            for (auto& [key, compilation] : _compilations)
+            {
+                if (compilation.future.status() != concurrencpp::result_status::value)
+                {
+                    // pending or failed, left as is
+                    continue;
+                }
+
+                const auto& current = compilation.future.get();
+                auto affected = std::ranges::any_of(current->shaders,
+                    [&](std::string_view shader)
+                    {
+                        return std::ranges::find(changedShaders, shader) != changedShaders.end();
+                    });
+
+                if (affected)
+                {
+                    rebuilds.emplace_back(Rebuild
+                        {
+                            .current = current,
+                            .rebuilt = _executor->submit(
+                                [this, preset = key.first, renderPass = compilation.render_pass]
+                                {
+                                    return Compile(preset, renderPass);
+                                })
+                        });
+                }
+            }
+        }
+
+        std::size_t swapped = 0;
+        for (auto& rebuild : rebuilds)
+        {
+            rebuild.rebuilt.wait();
+        }
+
+        // command buffers in flight may still reference the previous pipelines
+        graphicsQueue.WaitIdle();
+
+        for (auto& rebuild : rebuilds)
+        {
+            try
+            {
+                auto rebuilt = rebuild.rebuilt.get();
+                rebuild.current->pipeline = std::move(rebuilt->pipeline);
+                rebuild.current->shaders = std::move(rebuilt->shaders);
+                ++swapped;
+            }
+            catch (const std::exception& err)
+            {
+                DEBUGGER_TRACE("preset pipeline reload failed, keeping the previous pipeline: {}", err.what());
+            }
+        }
+
+        std::scoped_lock lk(_mtx);
+        _counters.reloaded += swapped;
+
+        return swapped;
+    }
+
+    PipelinePrecompilerCounters PipelinePrecompiler::Counters() const
+    {
+        std::scoped_lock lk(_mtx);
+        return _counters;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    std::shared_ptr<PipelinePrecompiler> MakePersistentPipelinePrecompiler(
+        std::shared_ptr<vulkan::Device> device,
+        std::shared_ptr<vulkan::ShaderCache> shaderCache,
+        std::shared_ptr<vulkan::DescriptorSetLayoutCache> layoutCache,
+        PoolExecutor executor
+    )
+    {
+        auto pipelineCache = std::make_shared<vulkan::PipelineCache>(device, vulkan::DefaultPipelineCachePath());
+        return std::make_shared<PipelinePrecompiler>(
+            std::move(device), std::move(shaderCache), std::move(layoutCache), std::move(pipelineCache), std::move(executor));
+    }
+
+    PendingPresetPipeline RequestPresetPipeline(
+        const GlobalInheritedData& globalInheritedData,
+        vulkan::PipelinePresetType preset,
+        const std::shared_ptr<vulkan::RenderPass>& renderPass
+    )
+    {
+        if (globalInheritedData.pipeline_precompiler)
+        {
+            return PendingPresetPipeline(globalInheritedData.pipeline_precompiler->Request(preset, renderPass));
+        }
+
+        return PendingPresetPipeline(CompilePresetPipeline(
+            preset,
+            globalInheritedData.device,
+            *globalInheritedData.shader_cache,
+            *globalInheritedData.layout_cache,
+            renderPass,
+            nullptr
+        ));
+    }
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include "../Eureka.Vulkan/Pipeline.hpp"
+#include "../Eureka.Vulkan/PipelineCache.hpp"
+#include "../Eureka.Vulkan/PipelinePresets.hpp"
+#include "GraphicsDefaults.hpp"
+#include <future.hpp>
+#include <assert.hpp>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+namespace eureka::graphics
+{
+    struct GlobalInheritedData;
+
+    struct PresetPipeline
+    {
+        std::shared_ptr<vulkan::PipelineLayout> layout;
+        vulkan::Pipeline                        pipeline;
+        svec2<std::string_view>                 shaders;  // names of the shaders the pipeline was built from
+    };
+
+    using PresetPipelineFuture = shared_future_t<std::shared_ptr<PresetPipeline>>;
+
+    // builds the preset pipeline on the calling thread, pipelineCache may be null
+    std::shared_ptr<PresetPipeline> CompilePresetPipeline(
+        vulkan::PipelinePresetType                  preset,
+        std::shared_ptr<vulkan::Device>             device,
+        vulkan::ShaderCache&                        shaderCache,
+        const vulkan::DescriptorSetLayoutCache&     layoutCache,
+        std::shared_ptr<vulkan::RenderPass>         renderPass,
+        VkPipelineCache                             pipelineCache
+    );
+
+    //
+    // PendingPresetPipeline
+    // a pass side handle of a pipeline that may still be compiling, polled from the pass' own thread so a frame
+    // never blocks on a compilation - the pass skips its draws until Ready()
+    //
+    class PendingPresetPipeline
+    {
+        PresetPipelineFuture            _future;
+        std::shared_ptr<PresetPipeline> _pipeline;
+    public:
+        PendingPresetPipeline() = default;
+        explicit PendingPresetPipeline(PresetPipelineFuture future);
+        explicit PendingPresetPipeline(std::shared_ptr<PresetPipeline> pipeline);
+
+        // non blocking, rethrows the compilation error
+        bool Ready();
+
+        const PresetPipeline& Get() const
+        {
+            assert(_pipeline);
+            return *_pipeline;
+        }
+    };
+
+    struct PipelinePrecompilerCounters
+    {
+        uint64_t                 requested{ 0 };        // distinct preset / render pass pairs
+        uint64_t                 compiled{ 0 };
+        uint64_t                 failed{ 0 };
+        uint64_t                 reloaded{ 0 };         // rebuilt after a shader change
+        bool                     warm_cache{ false };   // the pipeline cache was seeded from disk
+        std::chrono::nanoseconds total_compile_time{ 0 }; // summed over the pool threads
+        std::chrono::nanoseconds max_compile_time{ 0 };
+    };
+
+    //
+    // PipelinePrecompiler
+    // compiles preset pipelines on a thread pool through a shared pipeline cache, every preset / render pass pair
+    // is compiled once and handed to all the passes that request it
+    // vkCreateGraphicsPipelines and the pipeline cache are internally synchronized, the compilations run concurrently
+    //
+    // with a watching shader cache, ReloadChangedShaders rebuilds the pipelines that use a changed shader and swaps
+    // them in place, the passes keep their handles
+    //
+    class PipelinePrecompiler
+    {
+        struct Compilation
+        {
+            PresetPipelineFuture                future;
+            std::shared_ptr<vulkan::RenderPass> render_pass;
+        };
+
+        std::shared_ptr<vulkan::Device>                                         _device;
+        std::shared_ptr<vulkan::ShaderCache>                                    _shaderCache;
+        std::shared_ptr<vulkan::DescriptorSetLayoutCache>                       _layoutCache;
+        std::shared_ptr<vulkan::PipelineCache>                                  _pipelineCache;
+        PoolExecutor                                                            _executor;
+
+        mutable std::mutex                                                      _mtx;
+        std::map<std::pair<vulkan::PipelinePresetType, VkRenderPass>, Compilation> _compilations;
+        PipelinePrecompilerCounters                                             _counters;
+
+        std::shared_ptr<PresetPipeline> Compile(vulkan::PipelinePresetType preset, std::shared_ptr<vulkan::RenderPass> renderPass);
+    public:
+        PipelinePrecompiler(
+            std::shared_ptr<vulkan::Device> device,
+            std::shared_ptr<vulkan::ShaderCache> shaderCache,
+            std::shared_ptr<vulkan::DescriptorSetLayoutCache> layoutCache,
+            std::shared_ptr<vulkan::PipelineCache> pipelineCache,
+            PoolExecutor executor
+        );
+        // waits for the running compilations, they reference the precompiler
+        ~PipelinePrecompiler();
+        PipelinePrecompiler(const PipelinePrecompiler&) = delete;
+        PipelinePrecompiler& operator=(const PipelinePrecompiler&) = delete;
+
+        // starts every preset for the render pass
+        void PrecompileAll(const std::shared_ptr<vulkan::RenderPass>& renderPass);
+
+        // the first request of a preset / render pass pair starts its compilation
+        PresetPipelineFuture Request(vulkan::PipelinePresetType preset, const std::shared_ptr<vulkan::RenderPass>& renderPass);
+
+        // blocks until every started compilation finished
+        void WaitAll();
+
+        //
+        // rendering thread, between frames
+        // polls the shader cache, rebuilds the affected pipelines on the pool and waits for them, then waits for the
+        // graphics queue to drain before swapping - a development path, the frame stalls while shaders change
+        // a pipeline that fails to build keeps its previous version
+        // returns the number of swapped pipelines
+        //
+        std::size_t ReloadChangedShaders(vulkan::Queue& graphicsQueue);
+
+        PipelinePrecompilerCounters Counters() const;
+    };
+
+    // the precompiler of the apps, its pipeline cache is loaded from and saved to DefaultPipelineCachePath()
+    std::shared_ptr<PipelinePrecompiler> MakePersistentPipelinePrecompiler(
+        std::shared_ptr<vulkan::Device> device,
+        std::shared_ptr<vulkan::ShaderCache> shaderCache,
+        std::shared_ptr<vulkan::DescriptorSetLayoutCache> layoutCache,
+        PoolExecutor executor
+    );
+
+    //
+    // the precompiled pipeline when the global data carries a precompiler, otherwise compiles it right away
+    // without a pipeline cache
+    //
+    PendingPresetPipeline RequestPresetPipeline(
+        const GlobalInheritedData& globalInheritedData,
+        vulkan::PipelinePresetType preset,
+        const std::shared_ptr<vulkan::RenderPass>& renderPass
+    );
+}
@@ -0,0 +1,272 @@
+#include "PoseGraphViewPass.hpp"
+#include <profiling.hpp>
+#include <debugger_trace.hpp>
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace eureka::graphics
+{
+    // orientation triangles, in plot units (cm), matches the size the imgui path drew
+    inline constexpr float POSE_GRAPH_GLYPH_SCALE = 1.0f;
+
+    namespace
+    {
+        dynamic_cspan<uint8_t> AsBytes(auto span)
+        {
+            return dynamic_cspan<uint8_t>(reinterpret_cast<const uint8_t*>(span.data()), span.size_bytes());
+        }
+
+        // storage buffers can not be empty, an empty array keeps a placeholder that is never read
+        uint64_t StorageByteSize(uint64_t byteSize)
+        {
+            return std::max<uint64_t>(byteSize, sizeof(uint32_t));
+        }
+    }
+
+    PoseGraphViewPass::PoseGraphViewPass(GlobalInheritedData globalInheritedData, std::shared_ptr<vulkan::FrameContext> frameContext) :
+        IViewPass(std::move(globalInheritedData)),
+        _frameContext(std::move(frameContext))
+    {
+    }
+
+    PoseGraphViewPass::~PoseGraphViewPass()
+    {
+    }
+
+    void PoseGraphViewPass::BindToTargetPass(TargetInheritedData inheritedData)
+    {
+        _targetInheritedData = std::move(inheritedData);
+
+        _edgesPipeline = RequestPresetPipeline(_globalInheritedData, vulkan::PipelinePresetType::ePoseGraphEdges, _targetInheritedData.render_pass);
+        _glyphsPipeline = RequestPresetPipeline(_globalInheritedData, vulkan::PipelinePresetType::ePoseGraphGlyphs, _targetInheritedData.render_pass);
+    }
+
+    void PoseGraphViewPass::HandleResize(uint32_t /*w*/, uint32_t /*h*/)
+    {
+        // the plot state carries the viewport
+    }
+
+    void PoseGraphViewPass::UpdatePoseGraph(PoseGraphData data)
+    {
+        std::scoped_lock lk(_mtx);
+        // only the latest graph matters, an update arriving during an upload replaces the previous one
+        _pendingData = std::move(data);
+    }
+
+    void PoseGraphViewPass::UpdatePlot(const PoseGraphPlotState& state)
+    {
+        std::scoped_lock lk(_mtx);
+        _plotState = state;
+    }
+
+    void PoseGraphViewPass::Prepare()
+    {
+        ++_frames;
+
+        // the frame before the retirement recorded it last, the frame context waited for it MaxFramesInFlight frames later
+        std::erase_if(_retiredGraphs, [this](const RetiredPoseGraph& retired)
+            {
+                return _frames - retired.retired_at_frame >= _frameContext->MaxFramesInFlight();
+            });
+
+        std::optional<PoseGraphData> data;
+        {
+            std::scoped_lock lk(_mtx);
+
+            if (_uploadedGraph)
+            {
+                if (_currentGraph)
+                {
+                    _retiredGraphs.emplace_back(RetiredPoseGraph{ .graph = std::move(_currentGraph), .retired_at_frame = _frames });
+                }
+                _currentGraph = std::move(_uploadedGraph);
+
+                // the contents are final, relocations run on the rendering thread between frames
+                _currentGraph->poses.EnableRelocation();
+                _currentGraph->edges_meta.EnableRelocation();
+                _currentGraph->edges_data.EnableRelocation();
+            }
+
+            if (!_uploading && _pendingData)
+            {
+                data = std::move(_pendingData);
+                _pendingData.reset();
+                _uploading = true;
+            }
+        }
+
+        _frameDescriptorSet = _currentGraph ? MakeFrameDescriptorSet(*_currentGraph) : nullptr;
+
+        if (data)
+        {
+            // the upload resolves on its own, the graph is swapped in by a later Prepare
+            _upload = Upload(std::move(*data));
+        }
+    }
+
+    VkDescriptorSet PoseGraphViewPass::MakeFrameDescriptorSet(const GpuPoseGraph& graph)
+    {
+        // valid until this frame slot is reset by the frame context, it always points at the current buffer handles
+        // so a relocated buffer is picked up by the next frame
+        constexpr std::array<VkDescriptorPoolSize, 1> POSE_GRAPH_DESCRIPTORS
+        {
+            VkDescriptorPoolSize{ .type = VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 3 }
+        };
+
+        vulkan::DescriptorSetHandle descriptorSet(
+            _globalInheritedData.device,
+            _frameContext->FrameDescriptorAllocator().AllocateSet(
+                _globalInheritedData.layout_cache->GetLayoutHandle(vulkan::DescriptorSet0PresetType::ePoseGraphStorage),
+                POSE_GRAPH_DESCRIPTORS
+            )
+        );
+
+        descriptorSet.SetBinding(0, VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, graph.poses.DescriptorInfo());
+        descriptorSet.SetBinding(1, VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, graph.edges_meta.DescriptorInfo());
+        descriptorSet.SetBinding(2, VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, graph.edges_data.DescriptorInfo());
+        return descriptorSet.Get();
+    }
+
+    future_t<void> PoseGraphViewPass::Upload(PoseGraphData data)
+    {
+        PROFILE_CATEGORIZED_SCOPE("pose graph upload", eureka::profiling::Color::Brown, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+
+        std::unique_ptr<GpuPoseGraph> graph;
+        try
+        {
+            graph = std::make_unique<GpuPoseGraph>(GpuPoseGraph
+                {
+                    .poses = vulkan::StorageTransferableDeviceBuffer(_globalInheritedData.resource_allocator, StorageByteSize(data.poses.size_bytes())),
+                    .edges_meta = vulkan::StorageTransferableDeviceBuffer(_globalInheritedData.resource_allocator, StorageByteSize(data.edges_meta.size_bytes())),
+                    .edges_data = vulkan::StorageTransferableDeviceBuffer(_globalInheritedData.resource_allocator, StorageByteSize(data.edges_data.size_bytes())),
+                    .pose_count = static_cast<uint32_t>(data.poses.size() / 7),
+                    .edge_count = static_cast<uint32_t>(std::min(data.edges_meta.size() / 4, data.edges_data.size() / 12))
+                });
+
+            std::vector<vulkan::BufferDataUploadTransferDesc> uploads;
+            auto addUpload = [&uploads](dynamic_cspan<uint8_t> bytes, const vulkan::StorageTransferableDeviceBuffer& buffer)
+            {
+                if (!bytes.empty())
+                {
+                    uploads.emplace_back(vulkan::BufferDataUploadTransferDesc
+                        {
+                            .unpinned_src_spans = { bytes },
+                            .bytes = bytes.size_bytes(),
+                            .dst_buffer = buffer.Buffer(),
+                            .dst_offset = 0
+                        });
+                }
+            };
+            addUpload(AsBytes(data.poses), graph->poses);
+            addUpload(AsBytes(data.edges_meta), graph->edges_meta);
+            addUpload(AsBytes(data.edges_data), graph->edges_data);
+
+            // the sources are copied to the stage before the first suspension, the message can go right away
+            auto uploaded = _globalInheritedData.async_data_loader->UploadImagesAndBuffersAsync({}, std::move(uploads));
+            data = {};
+            co_await std::move(uploaded);
+        }
+        catch (const std::exception& err)
+        {
+            // the next received graph is uploaded again
+            DEBUGGER_TRACE("pose graph upload failed {}", err.what());
+            graph.reset();
+        }
+
+        // may resume on the transfer thread, the graph is swapped in by the next Prepare
+        std::scoped_lock lk(_mtx);
+        if (graph)
+        {
+            _uploadedGraph = std::move(graph);
+        }
+        _uploading = false;
+    }
+
+    void PoseGraphViewPass::RecordDraw(const RecordParameters& params)
+    {
+        // may run on a worker thread, only reads what Prepare left
+        PoseGraphPlotState plot;
+        {
+            std::scoped_lock lk(_mtx);
+            plot = _plotState;
+        }
+
+        if (!_currentGraph || !plot.visible || !_edgesPipeline.Ready() || !_glyphsPipeline.Ready())
+        {
+            return;
+        }
+
+        if (plot.viewport_size[0] <= 0.0f || plot.viewport_size[1] <= 0.0f)
+        {
+            return;
+        }
+
+        const auto& commandBuffer = params.command_buffer;
+        const auto& graph = *_currentGraph;
+        const auto& edgesPipeline = _edgesPipeline.Get();
+        const auto& glyphsPipeline = _glyphsPipeline.Get();
+
+        // same viewport and projection as the imgui layer, the plot transform is in its pixel space
+        VkViewport viewport
+        {
+            .x = plot.viewport_pos[0],
+            .y = plot.viewport_pos[1],
+            .width = plot.viewport_size[0],
+            .height = plot.viewport_size[1],
+            .minDepth = 0.0f,
+            .maxDepth = 1.0f
+        };
+
+        VkRect2D scissorRect;
+        scissorRect.offset.x = std::max(static_cast<int32_t>(plot.rect_min[0]), 0);
+        scissorRect.offset.y = std::max(static_cast<int32_t>(plot.rect_min[1]), 0);
+        scissorRect.extent.width = static_cast<uint32_t>(std::max(plot.rect_max[0] - plot.rect_min[0], 0.0f));
+        scissorRect.extent.height = static_cast<uint32_t>(std::max(plot.rect_max[1] - plot.rect_min[1], 0.0f));
+
+        Eigen::Vector2f pixelToNdc(2.0f / plot.viewport_size[0], 2.0f / plot.viewport_size[1]);
+
+        vulkan::PoseGraphPushConstantsBlock pushConstants
+        {
+            .scale = Eigen::Vector2f(plot.plot_to_pixel_scale[0], plot.plot_to_pixel_scale[1]).cwiseProduct(pixelToNdc),
+            .translate = Eigen::Vector2f(plot.plot_to_pixel_translate[0], plot.plot_to_pixel_translate[1]).cwiseProduct(pixelToNdc) - Eigen::Vector2f(1.0f, 1.0f),
+            .edge_mask = plot.edge_mask,
+            .source = vulkan::POSE_GRAPH_SOURCE_EDGES,
+            .glyph_scale = POSE_GRAPH_GLYPH_SCALE,
+            .padding = 0
+        };
+
+        // both pipelines share the layout preset, the set stays bound across the pipeline switch
+        commandBuffer.BindGraphicsPipeline(edgesPipeline.pipeline.Get());
+        commandBuffer.SetViewport(viewport);
+        commandBuffer.SetScissor(scissorRect);
+        commandBuffer.Bind(VkPipelineBindPoint::VK_PIPELINE_BIND_POINT_GRAPHICS, edgesPipeline.layout->Get(), _frameDescriptorSet, 0u);
+
+        if (plot.edge_mask && graph.edge_count)
+        {
+            commandBuffer.PushConstants(edgesPipeline.layout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstants);
+            commandBuffer.Draw(4, graph.edge_count, 0, 0);
+        }
+        if (plot.show_poses && graph.pose_count > 1)
+        {
+            pushConstants.source = vulkan::POSE_GRAPH_SOURCE_POSES;
+            commandBuffer.PushConstants(edgesPipeline.layout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstants);
+            commandBuffer.Draw(2, graph.pose_count - 1, 0, 0);
+        }
+
+        commandBuffer.BindGraphicsPipeline(glyphsPipeline.pipeline.Get());
+
+        if (plot.edge_mask && graph.edge_count)
+        {
+            pushConstants.source = vulkan::POSE_GRAPH_SOURCE_EDGES;
+            commandBuffer.PushConstants(glyphsPipeline.layout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstants);
+            commandBuffer.Draw(3, graph.edge_count, 0, 0);
+        }
+        if (plot.show_poses && graph.pose_count)
+        {
+            pushConstants.source = vulkan::POSE_GRAPH_SOURCE_POSES;
+            commandBuffer.PushConstants(glyphsPipeline.layout->Get(), VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT, pushConstants);
+            commandBuffer.Draw(3, graph.pose_count, 0, 0);
+        }
+    }
+}
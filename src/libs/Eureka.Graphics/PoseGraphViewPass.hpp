@@ -0,0 +1,84 @@
+#pragma once
+
+#include "../Eureka.Vulkan/Buffer.hpp"
+#include "../Eureka.Vulkan/Descriptor.hpp"
+#include "../Eureka.Vulkan/FrameContext.hpp"
+#include "IPass.hpp"
+#include "PipelinePrecompiler.hpp"
+
+#include <IPoseGraphRenderer.hpp>
+#include <mutex>
+#include <optional>
+
+namespace eureka::graphics
+{
+    //
+    // PoseGraphViewPass
+    // draws the pose graph map with instanced pipelines reading the poses and edges from storage buffers
+    // - the buffers are uploaded once per received pose graph, a frame only pushes the plot transform and the
+    //   edge filter (type / inlier flag), filtering happens in the vertex shader
+    // - it is recorded below the imgui pass, the layout keeps the plot background transparent and draws the
+    //   axes, legend and text on top
+    // - the descriptor set comes from the per-frame allocator and is written by every Prepare, the buffers of the
+    //   current graph can be moved by the memory defragmenter without rebuilding anything
+    //
+    class PoseGraphViewPass : public IViewPass, public IPoseGraphRenderer
+    {
+        struct GpuPoseGraph
+        {
+            vulkan::StorageTransferableDeviceBuffer poses;
+            vulkan::StorageTransferableDeviceBuffer edges_meta;
+            vulkan::StorageTransferableDeviceBuffer edges_data;
+            uint32_t                                pose_count{ 0 };
+            uint32_t                                edge_count{ 0 };
+        };
+
+        struct RetiredPoseGraph
+        {
+            std::unique_ptr<GpuPoseGraph> graph;
+            uint64_t                      retired_at_frame;
+        };
+
+        std::shared_ptr<vulkan::FrameContext>         _frameContext;
+        TargetInheritedData                           _targetInheritedData;
+        PendingPresetPipeline                         _edgesPipeline;
+        PendingPresetPipeline                         _glyphsPipeline;
+
+        std::mutex                                    _mtx;
+        std::optional<PoseGraphData>                  _pendingData;      // received, waiting for the running upload
+        std::unique_ptr<GpuPoseGraph>                 _uploadedGraph;    // uploaded, waiting for the next Prepare
+        PoseGraphPlotState                            _plotState;
+        bool                                          _uploading{ false };
+        future_t<void>                                _upload;
+
+        // rendering thread, RecordDraw only reads them
+        std::unique_ptr<GpuPoseGraph>                 _currentGraph;
+        std::vector<RetiredPoseGraph>                 _retiredGraphs;
+        uint64_t                                      _frames{ 0 };
+        VkDescriptorSet                               _frameDescriptorSet{ nullptr };
+
+        VkDescriptorSet MakeFrameDescriptorSet(const GpuPoseGraph& graph);
+        future_t<void> Upload(PoseGraphData data);
+    public:
+        PoseGraphViewPass(GlobalInheritedData globalInheritedData, std::shared_ptr<vulkan::FrameContext> frameContext);
+        ~PoseGraphViewPass();
+
+        void BindToTargetPass(TargetInheritedData inheritedData) override;
+        void HandleResize(uint32_t w, uint32_t h) override;
+
+        void Prepare() override;
+        void RecordDraw(const RecordParameters& params) override;
+
+        // uploads go through the rendering thread's one shot submissions
+        ViewPassThreading Threading() const override
+        {
+            return ViewPassThreading{ .parallel_prepare = false, .secondary_recording = true };
+        }
+
+        //
+        // IPoseGraphRenderer
+        //
+        void UpdatePoseGraph(PoseGraphData data) override;
+        void UpdatePlot(const PoseGraphPlotState& state) override;
+    };
+}
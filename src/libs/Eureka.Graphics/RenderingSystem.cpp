@@ -4,6 +4,7 @@
 #include "GraphicsDefaults.hpp"
 #include <profiling_macros.hpp>
 #include "RenderDocIntegration.hpp"
+#include "TransferWorker.hpp"
 #include <debugger_trace.hpp>
 
 namespace eureka::graphics
@@ -17,7 +18,10 @@ namespace eureka::graphics
         std::shared_ptr<vulkan::FrameContext> frameContext,
         std::shared_ptr<ITargetPass> mainPass,
         std::shared_ptr<SubmissionThreadExecutionContext> submissionThreadExecutionContext,
-        std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler
+        std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler,
+        std::shared_ptr<PipelinePrecompiler> pipelinePrecompiler,
+        std::shared_ptr<vulkan::MemoryBudgetTracker> memoryBudget,
+        std::shared_ptr<MemoryDefragmenter> defragmenter
     )
         :
         _device(std::move(device)),
@@ -26,6 +30,9 @@ namespace eureka::graphics
         _frameContext(std::move(frameContext)),
         _submissionThreadExecutionContext(/*std::move(*/submissionThreadExecutionContext/*)*/), // TODO
         _oneShotSubmissionHandler(std::move(oneShotSubmissionHandler)),
+        _pipelinePrecompiler(std::move(pipelinePrecompiler)),
+        _memoryBudget(std::move(memoryBudget)),
+        _defragmenter(std::move(defragmenter)),
         _mainPass(std::move(mainPass))
     {
 
@@ -65,6 +72,11 @@ namespace eureka::graphics
 
     void RenderingSystem::Deinitialize()
     {
+        // the transfer thread submits to the copy queue, stop it before touching the queue
+        if (auto transferWorker = _oneShotSubmissionHandler->GetTransferWorker())
+        {
+            transferWorker->Stop();
+        }
         _graphicsQueue.WaitIdle();
         _copyQueue.WaitIdle();
     }
@@ -85,13 +97,29 @@ namespace eureka::graphics
             PROFILE_CATEGORIZED_SCOPE("RunOne", eureka::profiling::Color::Blue, eureka::profiling::PROFILING_CATEGORY_RENDERING);
 
             //_graphicsQueue->waitIdle();
+            if (_pipelinePrecompiler)
+            {
+                // no-op unless the shader cache watches a directory
+                _pipelinePrecompiler->ReloadChangedShaders(_graphicsQueue);
+            }
+
+            // the waits are kept out of the frame cost the app paces by
+            auto waitStart = std::chrono::steady_clock::now();
             _frameContext->BeginFrame();
+            _lastFrameWait = std::chrono::steady_clock::now() - waitStart;
+
+            if (_memoryBudget)
+            {
+                _memoryBudget->BeginFrame();
+            }
 
             _mainPass->Prepare();
 
             _submissionThreadExecutionContext->PreRenderExecutor().loop(100);
 
+            waitStart = std::chrono::steady_clock::now();
             auto [valid, targetReady] = _mainPass->PreRecord();
+            _lastFrameWait += std::chrono::steady_clock::now() - waitStart;
             if (!valid)
             {
                 return;
@@ -100,7 +128,7 @@ namespace eureka::graphics
             auto [mainCommandBuffer, doneSemaphore] = _frameContext->NewGraphicsPresentCommandBuffer();
             mainCommandBuffer.Begin();
 
-            _mainPass->RecordDraw({ mainCommandBuffer });
+            _mainPass->RecordDraw({ .command_buffer = mainCommandBuffer, .frame_context = _frameContext.get() });
             _mainPass->PostRecord();
 
             mainCommandBuffer.End();
@@ -136,10 +164,18 @@ namespace eureka::graphics
             // https://stackoverflow.com/questions/63320119/vksubpassdependency-specification-clarification
             // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkQueuePresentKHR.html
             // https://stackoverflow.com/questions/68050676/can-vkqueuepresentkhr-be-synced-using-a-pipeline-barrier
+            waitStart = std::chrono::steady_clock::now();
             _mainPass->PostSubmit(doneSemaphore);
+            _lastFrameWait += std::chrono::steady_clock::now() - waitStart;
             //_graphicsQueue->waitIdle();
             _frameContext->EndFrame();    
 
+            if (_defragmenter)
+            {
+                // the relocated handles are picked up by the next frame's Prepare
+                _defragmenter->RunOne();
+            }
+
 
         }
         catch (const std::exception& err)
@@ -1,6 +1,7 @@
 #include "../Eureka.Vulkan/Instance.hpp"
 #include "../Eureka.Vulkan/Instance.hpp"
 #include "../Eureka.Vulkan/Device.hpp"
+#include "../Eureka.Vulkan/MemoryBudget.hpp"
 
 #include <GLFWRuntime.hpp>
 #include "GraphicsDefaults.hpp"
@@ -10,6 +11,8 @@
 #include "ImGuiViewPass.hpp"
 
 #include "IPass.hpp"
+#include "PipelinePrecompiler.hpp"
+#include "MemoryDefragmenter.hpp"
 
 namespace eureka::graphics
 {
@@ -38,12 +41,17 @@ namespace eureka::graphics
             std::shared_ptr<vulkan::FrameContext> frameContext,
             std::shared_ptr<ITargetPass> mainPass,
             std::shared_ptr<SubmissionThreadExecutionContext> submissionThreadExecutionContext,
-            std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler   
+            std::shared_ptr<OneShotSubmissionHandler> oneShotSubmissionHandler,
+            std::shared_ptr<PipelinePrecompiler> pipelinePrecompiler = nullptr, // optional, hot reloads the preset pipelines
+            std::shared_ptr<vulkan::MemoryBudgetTracker> memoryBudget = nullptr, // optional, refreshes the heap budgets every frame
+            std::shared_ptr<MemoryDefragmenter> defragmenter = nullptr // optional, a bounded defragmentation pass between frames
         );
 
         ~RenderingSystem();
 
         void RunOne();
+        // time the last RunOne blocked on the frame fences, the image acquire and the present
+        std::chrono::nanoseconds LastFrameWait() const { return _lastFrameWait; }
         void PollTasks();
         void Initialize();
         void HandleResize(uint32_t w, uint32_t h);
@@ -55,8 +63,12 @@ namespace eureka::graphics
         std::shared_ptr<vulkan::FrameContext>                      _frameContext;
         std::shared_ptr<SubmissionThreadExecutionContext>          _submissionThreadExecutionContext;
         std::shared_ptr<OneShotSubmissionHandler>                  _oneShotSubmissionHandler;
+        std::shared_ptr<PipelinePrecompiler>                       _pipelinePrecompiler;
+        std::shared_ptr<vulkan::MemoryBudgetTracker>               _memoryBudget;
+        std::shared_ptr<MemoryDefragmenter>                        _defragmenter;
         sigslot::scoped_connection                                 _resizeConnection;
         std::chrono::high_resolution_clock::time_point             _lastFrameTime;
+        std::chrono::nanoseconds                                   _lastFrameWait{ 0 };
         std::shared_ptr<ITargetPass>                               _mainPass;
     };
 }
\ No newline at end of file
@@ -1,18 +1,69 @@
 #include "TargetPass.hpp"
+#include "../Eureka.Vulkan/FrameContext.hpp"
+#include "PipelinePrecompiler.hpp"
 #include <profiling.hpp>
 
 namespace eureka::graphics
 {
+    namespace
+    {
+        //
+        // runs the calling thread's share while the tasks run, then waits for every task before rethrowing
+        // the tasks reference the caller's stack
+        //
+        template<typename Callable>
+        void RunAndWaitAll(std::vector<result_t<void>>& tasks, Callable&& callingThreadWork)
+        {
+            std::exception_ptr callingThreadError;
+            try
+            {
+                callingThreadWork();
+            }
+            catch (...)
+            {
+                callingThreadError = std::current_exception();
+            }
+
+            for (auto& task : tasks)
+            {
+                task.wait();
+            }
+            if (callingThreadError)
+            {
+                std::rethrow_exception(callingThreadError);
+            }
+            for (auto& task : tasks)
+            {
+                task.get();
+            }
+        }
+
+        VkCommandBuffer RecordViewSecondary(
+            vulkan::FrameContext& frameContext,
+            uint32_t slot,
+            IViewPass& view,
+            const VkCommandBufferInheritanceInfo& inheritanceInfo
+        )
+        {
+            auto commandBuffer = frameContext.NewGraphicsSecondaryCommandBuffer(slot);
+            commandBuffer.BeginSecondary(inheritanceInfo);
+            view.RecordDraw(RecordParameters{ .command_buffer = commandBuffer, .frame_context = &frameContext });
+            commandBuffer.End();
+            return commandBuffer.Get();
+        }
+    }
 
 
     SwapChainDepthColorPass::SwapChainDepthColorPass(
         GlobalInheritedData globalInheritedData,
         vulkan::Queue graphicsQueue,
-        std::shared_ptr<vulkan::SwapChain> swapChain
+        std::shared_ptr<vulkan::SwapChain> swapChain,
+        PoolExecutor recordExecutor
     ) :
         ITargetPass(std::move(globalInheritedData)),
         _graphicsQueue(graphicsQueue),
-        _swapChain(std::move(swapChain))
+        _swapChain(std::move(swapChain)),
+        _recordExecutor(std::move(recordExecutor))
     {
         _maxFramesInFlight = _swapChain->ImageCount();
 
@@ -24,6 +75,12 @@ namespace eureka::graphics
 
         _renderPass = std::make_shared<vulkan::DepthColorRenderPass>(_globalInheritedData.device, depthColorConfig);
 
+        // the view passes bound later pick the compiled pipelines up instead of compiling inline
+        if (_globalInheritedData.pipeline_precompiler)
+        {
+            _globalInheritedData.pipeline_precompiler->PrecompileAll(_renderPass);
+        }
+
         
         _resizeConnection = _swapChain->ConnectResizeSlot(
             [this](uint32_t w, uint32_t h)
@@ -49,10 +106,34 @@ namespace eureka::graphics
 
     void SwapChainDepthColorPass::Prepare()
     {
+        if (!_recordExecutor)
+        {
+            for (auto& view : _viewPasses)
+            {
+                view->Prepare();
+            }
+            return;
+        }
+
+        std::vector<result_t<void>> preparations;
         for (auto& view : _viewPasses)
         {
-            view->Prepare();
+            if (view->Threading().parallel_prepare)
+            {
+                preparations.emplace_back(_recordExecutor->submit([view = view.get()] { view->Prepare(); }));
+            }
         }
+
+        RunAndWaitAll(preparations, [this]
+            {
+                for (auto& view : _viewPasses)
+                {
+                    if (!view->Threading().parallel_prepare)
+                    {
+                        view->Prepare();
+                    }
+                }
+            });
     }
 
     TargetPassBeginInfo SwapChainDepthColorPass::PreRecord()
@@ -121,6 +202,12 @@ namespace eureka::graphics
 
     void SwapChainDepthColorPass::RecordDraw(const RecordParameters& params)
     {
+        if (_recordExecutor && params.frame_context)
+        {
+            RecordDrawSecondary(params);
+            return;
+        }
+
         params.command_buffer.BeginRenderPass(_currentRenderTarget->BeginInfo());
 
         for (auto& view : _viewPasses)
@@ -131,5 +218,67 @@ namespace eureka::graphics
         params.command_buffer.EndRenderPass();
     }
 
-}
+    void SwapChainDepthColorPass::RecordDrawSecondary(const RecordParameters& params)
+    {
+        PROFILE_CATEGORIZED_SCOPE("Record view passes", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+
+        auto& frameContext = *params.frame_context;
+        auto beginInfo = _currentRenderTarget->BeginInfo();
+
+        VkCommandBufferInheritanceInfo inheritanceInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+            .renderPass = beginInfo.renderPass,
+            .subpass = 0,
+            .framebuffer = beginInfo.framebuffer
+        };
+
+        //
+        // slot 0 belongs to the calling thread and records the thread bound view passes,
+        // the others are spread over the remaining slots, one worker task per slot
+        //
+        auto slots = frameContext.SecondaryCommandSlots();
+        std::vector<svec5<std::size_t>> slotViews(slots);
+        std::size_t threadedViews = 0;
+        for (auto i = 0u; i < _viewPasses.size(); ++i)
+        {
+            auto slot = (slots > 1 && _viewPasses[i]->Threading().secondary_recording) ? 1 + threadedViews++ % (slots - 1) : 0;
+            slotViews[slot].emplace_back(i);
+        }
 
+        std::vector<VkCommandBuffer> secondaryCommandBuffers(_viewPasses.size());
+        std::vector<result_t<void>> recordings;
+        for (auto slot = 1u; slot < slots; ++slot)
+        {
+            if (slotViews[slot].empty())
+            {
+                continue;
+            }
+
+            recordings.emplace_back(_recordExecutor->submit(
+                [&, slot]
+                {
+                    for (auto i : slotViews[slot])
+                    {
+                        secondaryCommandBuffers[i] = RecordViewSecondary(frameContext, slot, *_viewPasses[i], inheritanceInfo);
+                    }
+                }));
+        }
+
+        RunAndWaitAll(recordings, [&]
+            {
+                for (auto i : slotViews[0])
+                {
+                    secondaryCommandBuffers[i] = RecordViewSecondary(frameContext, 0, *_viewPasses[i], inheritanceInfo);
+                }
+            });
+
+        // executed in view pass order regardless of the recording thread
+        params.command_buffer.BeginRenderPass(beginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+        if (!secondaryCommandBuffers.empty())
+        {
+            params.command_buffer.ExecuteCommands(secondaryCommandBuffers);
+        }
+        params.command_buffer.EndRenderPass();
+    }
+}
@@ -13,7 +13,8 @@ namespace eureka::graphics
         SwapChainDepthColorPass(
             GlobalInheritedData globalInheritedData,
             vulkan::Queue graphicsQueue,
-            std::shared_ptr<vulkan::SwapChain> swapChain
+            std::shared_ptr<vulkan::SwapChain> swapChain,
+            PoolExecutor recordExecutor = nullptr
         );
         
         void AddViewPass(std::shared_ptr<IViewPass> viewPass) override;
@@ -48,7 +49,11 @@ namespace eureka::graphics
         uint32_t                                         _height{ 0 };
 
         std::vector<std::shared_ptr<IViewPass>>          _viewPasses;
+
+        // when set, view passes are prepared in parallel and recorded into secondary command buffers
+        PoolExecutor                                     _recordExecutor;
     private:
+        void RecordDrawSecondary(const RecordParameters& params);
         void RecreateTargets();
         void HandleSwapChainResize(uint32_t width, uint32_t height);
     };
@@ -0,0 +1,152 @@
+#include "TransferWorker.hpp"
+#include <thread_name.hpp>
+#include <profiling.hpp>
+#include <debugger_trace.hpp>
+
+namespace eureka::graphics
+{
+    TransferWorker::TransferWorker(
+        std::shared_ptr<vulkan::Device> device,
+        vulkan::Queue copyQueue,
+        vulkan::Queue graphicsQueue,
+        std::shared_ptr<ManualExecutor> executor,
+        TransferWorkerConfig config
+    ) :
+        _config(config),
+        _device(device),
+        _copyQueue(copyQueue),
+        _executor(std::move(executor)),
+        _submissions(device, copyQueue)
+    {
+        if (_copyQueue.Get() == graphicsQueue.Get())
+        {
+            // both threads would submit to the same VkQueue
+            throw std::logic_error("transfer worker requires a dedicated copy queue");
+        }
+
+        if (_config.command_pools < 2)
+        {
+            throw std::logic_error("transfer worker requires at least two command pools");
+        }
+
+        _pools.reserve(_config.command_pools);
+        for (auto i = 0u; i < _config.command_pools; ++i)
+        {
+            _pools.emplace_back(device, copyQueue, vulkan::FrameCommandsConfig
+                {
+                    .max_command_buffers = _config.command_buffers_per_pool,
+                    .preallocated_command_buffers = _config.command_buffers_per_pool / 2
+                });
+        }
+        _poolRetireValue.resize(_config.command_pools, 0);
+
+        _thread = jthread(
+            [this]
+            {
+                Run();
+            });
+    }
+
+    TransferWorker::~TransferWorker()
+    {
+        Stop();
+    }
+
+    void TransferWorker::Stop()
+    {
+        _executor->shutdown();
+        _thread = jthread();
+    }
+
+    void TransferWorker::Run()
+    {
+        eureka::os::set_current_thread_name("eureka transfer thread");
+        tls_is_transfer_thread = true;
+
+        try
+        {
+            while (true)
+            {
+                if (_executing.empty())
+                {
+                    _executor->wait_for_task();
+                }
+                else
+                {
+                    _executor->wait_for_task_for(_config.poll_interval);
+                }
+
+                {
+                    PROFILE_CATEGORIZED_SCOPE("Transfer thread batch", eureka::profiling::Color::Green, eureka::profiling::PROFILING_CATEGORY_RENDERING);
+
+                    // everything recorded by the drained tasks goes out with a single submit
+                    _executor->loop(_config.command_buffers_per_pool);
+                    _submissions.Flush();
+                }
+
+                DoPollCompletions(_submissions, _executing);
+
+                if (_currentPoolCommandBuffers == _config.command_buffers_per_pool || (_executing.empty() && _currentPoolCommandBuffers))
+                {
+                    RotatePool();
+                }
+            }
+        }
+        catch (const concurrencpp::errors::runtime_shutdown&)
+        {
+        }
+        catch (const std::exception& err)
+        {
+            DEBUGGER_TRACE("transfer thread error {}", err.what());
+        }
+
+        // the queued tasks were dropped, only the submitted work is waited for
+        _submissions.Wait(_submissions.EnqueuedValue());
+        _executing.clear();
+    }
+
+    void TransferWorker::RotatePool()
+    {
+        if (_currentPoolCommandBuffers == 0)
+        {
+            return;
+        }
+
+        _submissions.Flush();
+        _poolRetireValue[_currentPool] = _submissions.EnqueuedValue();
+
+        _currentPool = (_currentPool + 1) % _config.command_pools;
+        _currentPoolCommandBuffers = 0;
+
+        // only blocks when the device is a full pool cycle behind
+        _submissions.Wait(_poolRetireValue[_currentPool]);
+        _pools[_currentPool].Reset();
+    }
+
+    vulkan::SubmitCommandBuffer TransferWorker::NewCopyCommandBuffer()
+    {
+        assert(tls_is_transfer_thread);
+
+        if (_currentPoolCommandBuffers == _config.command_buffers_per_pool)
+        {
+            RotatePool();
+        }
+
+        ++_currentPoolCommandBuffers;
+        return _pools[_currentPool].NewSubmitCommandBuffer();
+    }
+
+    TransferSubmission TransferWorker::AppendCopyCommandSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal)
+    {
+        assert(tls_is_transfer_thread);
+
+        auto done = DoAppendSubmission(_submissions, _executing, buffer, std::move(signal), {});
+
+        return TransferSubmission
+        {
+            .timeline = _submissions.Semaphore(),
+            .value = _submissions.EnqueuedValue(),
+            .done = std::move(done)
+        };
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "../Eureka.Vulkan/Device.hpp"
+#include "../Eureka.Vulkan/FrameContext.hpp"
+#include "../Eureka.Vulkan/SubmissionTracker.hpp"
+#include "GraphicsDefaults.hpp"
+#include "OneShotCopySubmission.hpp"
+#include <jthread.hpp>
+#include <future.hpp>
+#include <deque>
+
+namespace eureka::graphics
+{
+    inline thread_local bool tls_is_transfer_thread = false;
+
+    struct TransferWorkerConfig
+    {
+        uint32_t                  command_pools{ 3 };                                 // pools cycled by the worker, a pool is reset once its submissions completed
+        uint64_t                  command_buffers_per_pool{ 16 };
+        std::chrono::milliseconds poll_interval{ std::chrono::milliseconds(1) };     // completion polling period while submissions are in flight
+    };
+
+    //
+    // a copy submission appended by the transfer worker
+    // timeline / value is what a graphics queue acquire waits on, done is resolved on the transfer thread
+    //
+    struct TransferSubmission
+    {
+        VkSemaphore    timeline;
+        uint64_t       value;
+        future_t<void> done;
+    };
+
+    //
+    // TransferWorker
+    // records, submits and retires copy queue work on its own thread, so bulk uploads don't compete with frame
+    // recording on the rendering thread
+    // the worker is the only thread allowed to submit to the copy queue, it requires a copy queue that is not
+    // the graphics queue
+    // ownership moves to the graphics queue through a wait on the worker's submission timeline, the acquire
+    // submission can be appended on the rendering thread before the worker flushed the copy
+    //
+    class TransferWorker
+    {
+        TransferWorkerConfig                                _config;
+        std::shared_ptr<vulkan::Device>                     _device;
+        vulkan::Queue                                       _copyQueue;
+        std::shared_ptr<ManualExecutor>                     _executor;
+        vulkan::SubmissionTracker                           _submissions;
+        std::deque<ExecutingOneShotSubmission>              _executing;
+
+        std::vector<vulkan::FrameCommands>                  _pools;
+        std::vector<uint64_t>                               _poolRetireValue;
+        uint32_t                                            _currentPool{ 0 };
+        uint64_t                                            _currentPoolCommandBuffers{ 0 };
+
+        jthread                                             _thread;
+
+        void Run();
+        void RotatePool();
+    public:
+        TransferWorker(
+            std::shared_ptr<vulkan::Device> device,
+            vulkan::Queue copyQueue,
+            vulkan::Queue graphicsQueue,
+            std::shared_ptr<ManualExecutor> executor,
+            TransferWorkerConfig config = {}
+        );
+        ~TransferWorker();
+        TransferWorker(const TransferWorker&) = delete;
+        TransferWorker& operator=(const TransferWorker&) = delete;
+
+        // drops the queued tasks, waits for the submitted work and joins the thread
+        void Stop();
+
+        [[nodiscard]] auto ResumeOnTransferThread()
+        {
+            return concurrencpp::resume_on(*_executor);
+        }
+
+        //
+        // Transfer thread accessors
+        //
+
+        vulkan::SubmitCommandBuffer NewCopyCommandBuffer();
+        TransferSubmission AppendCopyCommandSubmission(vulkan::LinearCommandBufferHandle buffer, vulkan::CounterSemaphoreHandle signal);
+
+        vulkan::Queue& CopyQueue()
+        {
+            return _copyQueue;
+        }
+    };
+}
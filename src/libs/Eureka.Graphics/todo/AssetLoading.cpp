@@ -274,10 +274,9 @@ namespace eureka
             .dst_offset = 0
         };
 
-        co_await _asyncDataLoader->UploadImagesAndBufferAsync(
+        co_await _asyncDataLoader->UploadImagesAndBuffersAsync(
             std::move(imageUploadDescs),
-            totalImageMemory,
-            std::move(bufferUploadDesc)
+            { std::move(bufferUploadDesc) }
             );
 
         //auto stageBuffer = co_await _uploadPool->EnqueueAllocation(totalIndexBufferMemory + totalVertexBufferMemory + totalImageMemory);
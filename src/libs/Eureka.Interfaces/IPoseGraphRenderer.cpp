@@ -0,0 +1,12 @@
+#include "IPoseGraphRenderer.hpp"
+
+namespace eureka
+{
+
+
+    IPoseGraphRenderer::~IPoseGraphRenderer()
+    {
+
+    }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include "IImGuiLayout.hpp"
+#include <cstdint>
+#include <memory>
+#include <span>
+
+namespace eureka
+{
+    // edge categories drawn by the renderer, one bit each in PoseGraphPlotState::edge_mask
+    inline constexpr uint32_t POSE_GRAPH_EDGES_PNP_INLIERS = 1u << 0;
+    inline constexpr uint32_t POSE_GRAPH_EDGES_PNP_OUTLIERS = 1u << 1;
+    inline constexpr uint32_t POSE_GRAPH_EDGES_FILTER = 1u << 2;
+
+    //
+    // a received pose graph, the spans point into the message kept alive by owner
+    // poses: 7 floats per pose (id, tx, ty, tz, rx, ry, rz)
+    // edges_meta: 4 uints per edge (ref id, target id, type, is inlier)
+    // edges_data: 12 floats per edge (ref txtytz, induced target txtytz, induced target rxryrz, optimized target txtytz)
+    //
+    struct PoseGraphData
+    {
+        std::shared_ptr<const void> owner;
+        std::span<const float>      poses;
+        std::span<const uint32_t>   edges_meta;
+        std::span<const float>      edges_data;
+    };
+
+    //
+    // where the map plot is this frame, in the imgui draw data coordinates (screen pixels)
+    // a plot (x, z) point lands on pixel plot_to_pixel_scale * (x, z) + plot_to_pixel_translate
+    // the viewport is the one the imgui layer is rendered with, so both layers line up
+    //
+    struct PoseGraphPlotState
+    {
+        bool     visible{ false };
+        float    viewport_pos[2]{};
+        float    viewport_size[2]{};
+        float    rect_min[2]{};
+        float    rect_max[2]{};
+        float    plot_to_pixel_scale[2]{ 1.0f, 1.0f };
+        float    plot_to_pixel_translate[2]{};
+        uint32_t edge_mask{ 0 };
+        bool     show_poses{ false };
+    };
+
+    //
+    // draws the pose graph below the imgui layer, the layout makes the plot background transparent and
+    // keeps drawing the axes, legend and overlays itself
+    // both calls may come from any thread
+    //
+    class EUREKA_NO_VTABLE IPoseGraphRenderer
+    {
+    public:
+        virtual ~IPoseGraphRenderer() = 0;
+        // uploaded once, the data is drawn every frame until the next update
+        virtual void UpdatePoseGraph(PoseGraphData data) = 0;
+        virtual void UpdatePlot(const PoseGraphPlotState& state) = 0;
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace eureka::rpc
+{
+    struct BackoffConfig
+    {
+        std::chrono::milliseconds initial{ 100 };
+        std::chrono::milliseconds max{ 10000 };
+        double                    multiplier{ 1.6 };
+        double                    jitter{ 0.2 };   // +- fraction applied to every delay
+    };
+
+    //
+    // ExponentialBackoff
+    // jittered so that clients dropped by the same network event do not retry in lockstep
+    //
+    class ExponentialBackoff
+    {
+        BackoffConfig             _config;
+        std::chrono::nanoseconds  _current;
+        std::minstd_rand          _rng;
+    public:
+        explicit ExponentialBackoff(BackoffConfig config = {}, uint32_t seed = std::random_device{}())
+            :
+            _config(config),
+            _current(config.initial),
+            _rng(seed)
+        {
+        }
+
+        std::chrono::nanoseconds Next()
+        {
+            std::uniform_real_distribution<double> jitter(1.0 - _config.jitter, 1.0 + _config.jitter);
+            auto delay = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double, std::nano>(static_cast<double>(_current.count()) * jitter(_rng)));
+
+            auto grown = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double, std::nano>(static_cast<double>(_current.count()) * _config.multiplier));
+            _current = std::min<std::chrono::nanoseconds>(grown, _config.max);
+            return delay;
+        }
+
+        void Reset()
+        {
+            _current = _config.initial;
+        }
+
+        const BackoffConfig& Config() const { return _config; }
+    };
+}
@@ -0,0 +1,276 @@
+#include "SharedMemorySegment.hpp"
+#include <system_error>
+#include <utility>
+
+// NOLINTBEGIN
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <fstream>
+#endif
+// NOLINTEND
+
+namespace eureka::rpc
+{
+    namespace
+    {
+        [[noreturn]] void ThrowSystemError(const std::string& what)
+        {
+#ifdef _WIN32
+            std::error_code ec(static_cast<int>(GetLastError()), std::system_category());
+#else
+            std::error_code ec(errno, std::system_category());
+#endif
+            throw std::system_error(ec, what);
+        }
+
+#ifdef _WIN32
+        std::string MappingName(const std::string& name)
+        {
+            return "Local\\" + name;
+        }
+#else
+        std::string MappingName(const std::string& name)
+        {
+            return "/" + name;
+        }
+#endif
+    }
+
+    SharedMemorySegment::~SharedMemorySegment()
+    {
+        Release();
+    }
+
+    SharedMemorySegment::SharedMemorySegment(SharedMemorySegment&& that) noexcept
+        :
+        _name(std::move(that._name)),
+        _address(std::exchange(that._address, nullptr)),
+        _size(std::exchange(that._size, 0)),
+        _owner(std::exchange(that._owner, false))
+#ifdef _WIN32
+        , _mapping(std::exchange(that._mapping, nullptr))
+#endif
+    {
+    }
+
+    SharedMemorySegment& SharedMemorySegment::operator=(SharedMemorySegment&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            Release();
+            _name = std::move(rhs._name);
+            _address = std::exchange(rhs._address, nullptr);
+            _size = std::exchange(rhs._size, 0);
+            _owner = std::exchange(rhs._owner, false);
+#ifdef _WIN32
+            _mapping = std::exchange(rhs._mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+#ifdef _WIN32
+
+    SharedMemorySegment SharedMemorySegment::Create(std::string name, std::size_t size)
+    {
+        auto mappingName = MappingName(name);
+        auto mapping = CreateFileMappingA(
+            INVALID_HANDLE_VALUE,
+            nullptr,
+            PAGE_READWRITE,
+            static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+            static_cast<DWORD>(size & 0xFFFFFFFF),
+            mappingName.c_str()
+        );
+        if (!mapping)
+        {
+            ThrowSystemError("CreateFileMapping " + mappingName);
+        }
+        if (GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            CloseHandle(mapping);
+            SetLastError(ERROR_ALREADY_EXISTS);
+            ThrowSystemError("CreateFileMapping " + mappingName);
+        }
+
+        auto address = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!address)
+        {
+            CloseHandle(mapping);
+            ThrowSystemError("MapViewOfFile " + mappingName);
+        }
+
+        SharedMemorySegment segment;
+        segment._name = std::move(name);
+        segment._address = address;
+        segment._size = size;
+        segment._owner = true;
+        segment._mapping = mapping;
+        return segment; // pagefile backed mappings are zero filled
+    }
+
+    SharedMemorySegment SharedMemorySegment::Open(std::string name, std::size_t size)
+    {
+        auto mappingName = MappingName(name);
+        auto mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, mappingName.c_str());
+        if (!mapping)
+        {
+            ThrowSystemError("OpenFileMapping " + mappingName);
+        }
+
+        auto address = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!address)
+        {
+            CloseHandle(mapping);
+            ThrowSystemError("MapViewOfFile " + mappingName);
+        }
+
+        SharedMemorySegment segment;
+        segment._name = std::move(name);
+        segment._address = address;
+        segment._size = size;
+        segment._mapping = mapping;
+        return segment;
+    }
+
+    void SharedMemorySegment::Release() noexcept
+    {
+        if (_address)
+        {
+            UnmapViewOfFile(_address);
+            _address = nullptr;
+        }
+        if (_mapping)
+        {
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+        }
+        _size = 0;
+        _owner = false;
+    }
+
+    std::string LocalHostId()
+    {
+        char name[MAX_COMPUTERNAME_LENGTH + 1]{};
+        DWORD size = sizeof(name);
+        GetComputerNameA(name, &size);
+        return std::string(name, size);
+    }
+
+#else
+
+    SharedMemorySegment SharedMemorySegment::Create(std::string name, std::size_t size)
+    {
+        auto mappingName = MappingName(name);
+        auto fd = shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        if (fd < 0 && errno == EEXIST)
+        {
+            // left behind by a creator that crashed or was killed, nothing unlinked it - readers that still
+            // map it keep their mapping, new ones are directed to the new segment
+            shm_unlink(mappingName.c_str());
+            fd = shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+        }
+        if (fd < 0)
+        {
+            ThrowSystemError("shm_open " + mappingName);
+        }
+
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            auto err = errno;
+            close(fd);
+            shm_unlink(mappingName.c_str());
+            errno = err;
+            ThrowSystemError("ftruncate " + mappingName);
+        }
+
+        auto address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd); // the mapping keeps the object alive
+        if (address == MAP_FAILED)
+        {
+            auto err = errno;
+            shm_unlink(mappingName.c_str());
+            errno = err;
+            ThrowSystemError("mmap " + mappingName);
+        }
+
+        SharedMemorySegment segment;
+        segment._name = std::move(name);
+        segment._address = address;
+        segment._size = size;
+        segment._owner = true;
+        return segment; // ftruncate zero fills
+    }
+
+    SharedMemorySegment SharedMemorySegment::Open(std::string name, std::size_t size)
+    {
+        auto mappingName = MappingName(name);
+        auto fd = shm_open(mappingName.c_str(), O_RDWR, 0);
+        if (fd < 0)
+        {
+            ThrowSystemError("shm_open " + mappingName);
+        }
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < size)
+        {
+            close(fd);
+            throw std::system_error(std::make_error_code(std::errc::invalid_argument), "shared memory segment too small " + mappingName);
+        }
+
+        auto address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (address == MAP_FAILED)
+        {
+            ThrowSystemError("mmap " + mappingName);
+        }
+
+        SharedMemorySegment segment;
+        segment._name = std::move(name);
+        segment._address = address;
+        segment._size = size;
+        return segment;
+    }
+
+    void SharedMemorySegment::Release() noexcept
+    {
+        if (_address)
+        {
+            munmap(_address, _size);
+            _address = nullptr;
+        }
+        if (_owner)
+        {
+            shm_unlink(MappingName(_name).c_str());
+            _owner = false;
+        }
+        _size = 0;
+    }
+
+    std::string LocalHostId()
+    {
+        char name[256]{};
+        gethostname(name, sizeof(name) - 1);
+        std::string id(name);
+
+        // host names are not unique across containers, the boot id narrows it down on linux
+        std::ifstream bootId("/proc/sys/kernel/random/boot_id");
+        std::string boot;
+        if (bootId >> boot)
+        {
+            id += "/" + boot;
+        }
+        return id;
+    }
+
+#endif
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace eureka::rpc
+{
+    //
+    // SharedMemorySegment
+    // a named, memory mapped segment visible to other processes on the same host
+    // POSIX shm_open / mmap, or a pagefile backed file mapping on windows
+    // the creator owns the name, it is unlinked when the creating segment is destroyed
+    // a POSIX segment of the same name left behind by a creator that did not exit cleanly is replaced, windows
+    // mappings go away with their last handle
+    //
+    class SharedMemorySegment
+    {
+        std::string _name;
+        void*       _address{ nullptr };
+        std::size_t _size{ 0 };
+        bool        _owner{ false };
+#ifdef _WIN32
+        void*       _mapping{ nullptr };
+#endif
+
+        void Release() noexcept;
+    public:
+        SharedMemorySegment() = default;
+        ~SharedMemorySegment();
+
+        SharedMemorySegment(const SharedMemorySegment&) = delete;
+        SharedMemorySegment& operator=(const SharedMemorySegment&) = delete;
+        SharedMemorySegment(SharedMemorySegment&& that) noexcept;
+        SharedMemorySegment& operator=(SharedMemorySegment&& rhs) noexcept;
+
+        // creates a zero filled segment, replacing a stale one, throws std::system_error
+        static SharedMemorySegment Create(std::string name, std::size_t size);
+
+        // maps an existing segment, throws std::system_error
+        static SharedMemorySegment Open(std::string name, std::size_t size);
+
+        void* Data() const { return _address; }
+        std::size_t Size() const { return _size; }
+        const std::string& Name() const { return _name; }
+        bool Valid() const { return _address != nullptr; }
+    };
+
+    // identifies the host for same host transports (host name + boot session where available)
+    std::string LocalHostId();
+}
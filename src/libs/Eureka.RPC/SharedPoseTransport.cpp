@@ -0,0 +1,255 @@
+#include "SharedPoseTransport.hpp"
+#include <cstring>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+namespace eureka::rpc
+{
+    namespace
+    {
+        constexpr std::size_t GRAPH_OFFSET = sizeof(SharedTransportHeader);
+        constexpr std::size_t RING_OFFSET = GRAPH_OFFSET + sizeof(SharedPoseGraphBuffer);
+        constexpr std::size_t PAYLOAD_OFFSET = RING_OFFSET + sizeof(SharedRealtimePoseRing);
+        constexpr uint64_t RING_MASK = SHARED_REALTIME_POSE_RING_CAPACITY - 1;
+
+        static_assert((SHARED_REALTIME_POSE_RING_CAPACITY & RING_MASK) == 0);
+        static_assert(RING_OFFSET % SHARED_CACHE_LINE == 0 && PAYLOAD_OFFSET % SHARED_CACHE_LINE == 0);
+
+        std::size_t AlignSlotBytes(std::size_t slotBytes)
+        {
+            return (slotBytes + SHARED_CACHE_LINE - 1) & ~(SHARED_CACHE_LINE - 1);
+        }
+
+        std::size_t PayloadBytes(std::size_t poses, std::size_t edgesMeta, std::size_t edgesData)
+        {
+            return (poses + edgesData) * sizeof(float) + edgesMeta * sizeof(uint32_t);
+        }
+    }
+
+    std::size_t SharedPoseTransportSize(std::size_t slotBytes)
+    {
+        return PAYLOAD_OFFSET + 2 * AlignSlotBytes(slotBytes);
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        SharedPoseTransportWriter
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    SharedPoseTransportWriter::SharedPoseTransportWriter(const SharedMemoryTransportConfig& config)
+        :
+        _segment(SharedMemorySegment::Create(config.segment_name, SharedPoseTransportSize(config.pose_graph_slot_bytes)))
+    {
+        auto base = static_cast<std::byte*>(_segment.Data());
+
+        // the segment is zero filled, the objects still have to be started
+        _header = new (base) SharedTransportHeader{};
+        _graph = new (base + GRAPH_OFFSET) SharedPoseGraphBuffer{};
+        _ring = new (base + RING_OFFSET) SharedRealtimePoseRing{};
+        _payload = base + PAYLOAD_OFFSET;
+
+        _header->magic = SHARED_POSE_TRANSPORT_MAGIC;
+        _header->version = SHARED_POSE_TRANSPORT_VERSION;
+        _header->segment_size = _segment.Size();
+        _header->slot_bytes = AlignSlotBytes(config.pose_graph_slot_bytes);
+        _header->ring_capacity = static_cast<uint32_t>(SHARED_REALTIME_POSE_RING_CAPACITY);
+        _header->writer_state.store(static_cast<uint32_t>(SharedWriterState::Open), std::memory_order_release);
+    }
+
+    SharedPoseTransportWriter::~SharedPoseTransportWriter()
+    {
+        // readers that already mapped the segment keep it alive, tell them to fall back
+        _header->writer_state.store(static_cast<uint32_t>(SharedWriterState::Closed), std::memory_order_release);
+    }
+
+    bool SharedPoseTransportWriter::WritePoseGraph(uint64_t timestampNs, std::span<const float> poses, std::span<const uint32_t> edgesMeta, std::span<const float> edgesData)
+    {
+        std::scoped_lock lock(_graphMutex);
+
+        if (PayloadBytes(poses.size(), edgesMeta.size(), edgesData.size()) > _header->slot_bytes)
+        {
+            _header->graph_overflow.store(1, std::memory_order_release);
+            return false;
+        }
+
+        // write the slot readers are not directed to
+        auto target = 1u - _graph->latest_slot.load(std::memory_order_relaxed);
+        auto& slot = _graph->slots[target];
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto publishCount = _graph->publish_count.load(std::memory_order_relaxed) + 1;
+        slot.timestamp_ns = timestampNs;
+        slot.publish_count = publishCount;
+        slot.poses_count = static_cast<uint32_t>(poses.size());
+        slot.edges_meta_count = static_cast<uint32_t>(edgesMeta.size());
+        slot.edges_data_count = static_cast<uint32_t>(edgesData.size());
+
+        auto dst = _payload + target * _header->slot_bytes;
+        std::memcpy(dst, poses.data(), poses.size_bytes());
+        dst += poses.size_bytes();
+        std::memcpy(dst, edgesMeta.data(), edgesMeta.size_bytes());
+        dst += edgesMeta.size_bytes();
+        std::memcpy(dst, edgesData.data(), edgesData.size_bytes());
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        _graph->publish_count.store(publishCount, std::memory_order_release);
+        _graph->latest_slot.store(target, std::memory_order_release);
+        _header->graph_overflow.store(0, std::memory_order_release);
+        return true;
+    }
+
+    bool SharedPoseTransportWriter::PushRealtimePose(const SharedRealtimePose& pose)
+    {
+        std::scoped_lock lock(_ringMutex);
+
+        auto head = _ring->head.load(std::memory_order_relaxed);
+        auto tail = _ring->tail.load(std::memory_order_acquire);
+        if (head - tail >= SHARED_REALTIME_POSE_RING_CAPACITY)
+        {
+            _ring->dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        _ring->entries[head & RING_MASK] = pose;
+        _ring->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        SharedPoseTransportReader
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    SharedPoseTransportReader::SharedPoseTransportReader(std::string segmentName, std::size_t segmentSize, uint32_t layoutVersion)
+    {
+        if (layoutVersion != SHARED_POSE_TRANSPORT_VERSION || segmentSize < PAYLOAD_OFFSET)
+        {
+            throw std::runtime_error("unsupported shared pose transport layout");
+        }
+
+        _segment = SharedMemorySegment::Open(std::move(segmentName), segmentSize);
+
+        auto base = static_cast<std::byte*>(_segment.Data());
+        _header = std::launder(reinterpret_cast<SharedTransportHeader*>(base));
+        _graph = std::launder(reinterpret_cast<SharedPoseGraphBuffer*>(base + GRAPH_OFFSET));
+        _ring = std::launder(reinterpret_cast<SharedRealtimePoseRing*>(base + RING_OFFSET));
+        _payload = base + PAYLOAD_OFFSET;
+
+        if (_header->magic != SHARED_POSE_TRANSPORT_MAGIC ||
+            _header->version != SHARED_POSE_TRANSPORT_VERSION ||
+            _header->segment_size != segmentSize ||
+            SharedPoseTransportSize(_header->slot_bytes) != segmentSize)
+        {
+            throw std::runtime_error("shared pose transport header mismatch " + _segment.Name());
+        }
+
+        // claim the ring consumer side, other readers get realtime poses over gRPC
+        std::random_device rd;
+        uint64_t token = (uint64_t(rd()) << 32) | rd() | 1;
+        uint64_t expected = 0;
+        if (_header->ring_consumer.compare_exchange_strong(expected, token, std::memory_order_acq_rel))
+        {
+            _ringToken = token;
+            // start from the newest pose, the backlog belongs to a previous consumer
+            _ring->tail.store(_ring->head.load(std::memory_order_acquire), std::memory_order_release);
+        }
+    }
+
+    SharedPoseTransportReader::~SharedPoseTransportReader()
+    {
+        if (_ringToken)
+        {
+            auto expected = _ringToken;
+            _header->ring_consumer.compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+        }
+    }
+
+    bool SharedPoseTransportReader::WriterOpen() const
+    {
+        return _header->writer_state.load(std::memory_order_acquire) == static_cast<uint32_t>(SharedWriterState::Open);
+    }
+
+    bool SharedPoseTransportReader::GraphOverflow() const
+    {
+        return _header->graph_overflow.load(std::memory_order_acquire) != 0;
+    }
+
+    uint64_t SharedPoseTransportReader::PublishCount() const
+    {
+        return _graph->publish_count.load(std::memory_order_acquire);
+    }
+
+    std::optional<SharedPoseGraphView> SharedPoseTransportReader::BeginRead(uint32_t slotIndex, uint64_t& sequence) const
+    {
+        if (slotIndex > 1)
+        {
+            return std::nullopt;
+        }
+
+        const auto& slot = _graph->slots[slotIndex];
+        sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || (sequence & 1))
+        {
+            // never written or the writer is inside
+            return std::nullopt;
+        }
+
+        // the counts may be torn as well, never build a view outside of the slot
+        std::size_t poses = slot.poses_count;
+        std::size_t edgesMeta = slot.edges_meta_count;
+        std::size_t edgesData = slot.edges_data_count;
+        if (PayloadBytes(poses, edgesMeta, edgesData) > _header->slot_bytes)
+        {
+            return std::nullopt;
+        }
+
+        auto src = _payload + slotIndex * _header->slot_bytes;
+        auto posesPtr = reinterpret_cast<const float*>(src);
+        auto edgesMetaPtr = reinterpret_cast<const uint32_t*>(src + poses * sizeof(float));
+        auto edgesDataPtr = reinterpret_cast<const float*>(src + poses * sizeof(float) + edgesMeta * sizeof(uint32_t));
+
+        return SharedPoseGraphView{
+            .timestamp_ns = slot.timestamp_ns,
+            .publish_count = slot.publish_count,
+            .poses = { posesPtr, poses },
+            .edges_meta = { edgesMetaPtr, edgesMeta },
+            .edges_data = { edgesDataPtr, edgesData }
+        };
+    }
+
+    bool SharedPoseTransportReader::EndRead(uint32_t slotIndex, uint64_t sequence) const
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return _graph->slots[slotIndex].sequence.load(std::memory_order_relaxed) == sequence;
+    }
+
+    bool SharedPoseTransportReader::PopRealtimePose(SharedRealtimePose& pose)
+    {
+        if (!_ringToken)
+        {
+            return false;
+        }
+
+        auto tail = _ring->tail.load(std::memory_order_relaxed);
+        auto head = _ring->head.load(std::memory_order_acquire);
+        if (tail == head)
+        {
+            return false;
+        }
+
+        pose = _ring->entries[tail & RING_MASK];
+        _ring->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint64_t SharedPoseTransportReader::DroppedRealtimePoses() const
+    {
+        return _ring->dropped.load(std::memory_order_relaxed);
+    }
+}
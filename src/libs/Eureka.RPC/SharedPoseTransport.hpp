@@ -0,0 +1,181 @@
+#pragma once
+#include "SharedMemorySegment.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+
+namespace eureka::rpc
+{
+    //
+    // same host transport for the live slam visualization data
+    //
+    // segment layout:
+    //   SharedTransportHeader
+    //   SharedPoseGraphBuffer                  - seqlock protected double buffer, any number of readers
+    //   SharedRealtimePoseRing                 - single producer single consumer ring
+    //   2 x pose graph slot payload
+    //
+    // discovery goes over gRPC (SharedMemoryDiscovery rpc), the segment only carries data
+    //
+
+    inline constexpr uint32_t SHARED_POSE_TRANSPORT_MAGIC = 0x45524b31; // "ERK1"
+    inline constexpr uint32_t SHARED_POSE_TRANSPORT_VERSION = 2;
+    inline constexpr std::size_t SHARED_CACHE_LINE = 64;
+    inline constexpr std::size_t SHARED_REALTIME_POSE_RING_CAPACITY = 1024; // power of two
+
+    static_assert(std::atomic_uint64_t::is_always_lock_free && std::atomic_uint32_t::is_always_lock_free, "shared memory atomics must be lock free");
+
+    struct SharedMemoryTransportConfig
+    {
+        std::string segment_name;
+        std::size_t pose_graph_slot_bytes{ 64 * 1024 * 1024 };
+    };
+
+    struct SharedRealtimePose
+    {
+        uint64_t             timestamp_ns;
+        std::array<float, 6> txtytzrxryrz;
+    };
+
+    struct SharedPoseGraphView
+    {
+        uint64_t                  timestamp_ns;
+        uint64_t                  publish_count;
+        std::span<const float>    poses;       // 7 per pose, see rgorpc.proto
+        std::span<const uint32_t> edges_meta;  // 4 per edge
+        std::span<const float>    edges_data;  // 12 per edge
+    };
+
+    enum class SharedWriterState : uint32_t
+    {
+        Closed = 0,
+        Open = 1
+    };
+
+    struct alignas(SHARED_CACHE_LINE) SharedTransportHeader
+    {
+        uint32_t               magic;
+        uint32_t               version;
+        uint64_t               segment_size;
+        uint64_t               slot_bytes;
+        uint32_t               ring_capacity;
+        std::atomic_uint32_t   writer_state;
+        std::atomic_uint64_t   ring_consumer; // non zero while a reader owns the ring consumer side
+        std::atomic_uint32_t   graph_overflow; // non zero while the latest graph did not fit a slot and is only streamed
+    };
+
+    struct alignas(SHARED_CACHE_LINE) SharedPoseGraphSlot
+    {
+        std::atomic_uint64_t   sequence;      // odd while the writer is inside the slot
+        uint64_t               timestamp_ns;
+        uint64_t               publish_count;
+        uint32_t               poses_count;
+        uint32_t               edges_meta_count;
+        uint32_t               edges_data_count;
+    };
+
+    struct alignas(SHARED_CACHE_LINE) SharedPoseGraphBuffer
+    {
+        std::atomic_uint32_t                   latest_slot;
+        std::atomic_uint64_t                   publish_count;
+        std::array<SharedPoseGraphSlot, 2>     slots;
+    };
+
+    struct SharedRealtimePoseRing
+    {
+        alignas(SHARED_CACHE_LINE) std::atomic_uint64_t head; // written by the producer
+        alignas(SHARED_CACHE_LINE) std::atomic_uint64_t tail; // written by the consumer
+        alignas(SHARED_CACHE_LINE) std::atomic_uint64_t dropped;
+        alignas(SHARED_CACHE_LINE) std::array<SharedRealtimePose, SHARED_REALTIME_POSE_RING_CAPACITY> entries;
+    };
+
+    std::size_t SharedPoseTransportSize(std::size_t slotBytes);
+
+    //
+    // SharedPoseTransportWriter
+    // owned by the server, writes may come from any thread
+    // graph writes and realtime pose pushes are serialized separately, the segment itself has a single producer
+    //
+    class SharedPoseTransportWriter
+    {
+        std::mutex                   _graphMutex;
+        std::mutex                   _ringMutex;
+        SharedMemorySegment          _segment;
+        SharedTransportHeader*       _header{ nullptr };
+        SharedPoseGraphBuffer*       _graph{ nullptr };
+        SharedRealtimePoseRing*      _ring{ nullptr };
+        std::byte*                   _payload{ nullptr };
+    public:
+        explicit SharedPoseTransportWriter(const SharedMemoryTransportConfig& config);
+        ~SharedPoseTransportWriter();
+
+        SharedPoseTransportWriter(const SharedPoseTransportWriter&) = delete;
+        SharedPoseTransportWriter& operator=(const SharedPoseTransportWriter&) = delete;
+
+        const std::string& SegmentName() const { return _segment.Name(); }
+        std::size_t SegmentSize() const { return _segment.Size(); }
+
+        // returns false when the graph does not fit a slot, graph_overflow is raised so readers switch to the gRPC stream
+        bool WritePoseGraph(uint64_t timestampNs, std::span<const float> poses, std::span<const uint32_t> edgesMeta, std::span<const float> edgesData);
+
+        // never waits for the consumer, a full ring drops the pose (counted in SharedRealtimePoseRing::dropped)
+        bool PushRealtimePose(const SharedRealtimePose& pose);
+    };
+
+    //
+    // SharedPoseTransportReader
+    // maps the segment announced through discovery
+    // any number of readers may read the pose graph, only the reader that claimed the ring may pop realtime poses
+    //
+    class SharedPoseTransportReader
+    {
+        SharedMemorySegment          _segment;
+        SharedTransportHeader*       _header{ nullptr };
+        SharedPoseGraphBuffer*       _graph{ nullptr };
+        SharedRealtimePoseRing*      _ring{ nullptr };
+        const std::byte*             _payload{ nullptr };
+        uint64_t                     _ringToken{ 0 };
+
+        std::optional<SharedPoseGraphView> BeginRead(uint32_t slot, uint64_t& sequence) const;
+        bool EndRead(uint32_t slot, uint64_t sequence) const;
+    public:
+        SharedPoseTransportReader(std::string segmentName, std::size_t segmentSize, uint32_t layoutVersion);
+        ~SharedPoseTransportReader();
+
+        SharedPoseTransportReader(const SharedPoseTransportReader&) = delete;
+        SharedPoseTransportReader& operator=(const SharedPoseTransportReader&) = delete;
+
+        bool WriterOpen() const;
+        // the latest graph was too large for the segment, the shared graph is stale until the flag clears
+        bool GraphOverflow() const;
+        bool OwnsRealtimePoses() const { return _ringToken != 0; }
+        uint64_t PublishCount() const;
+
+        //
+        // reads the latest graph in place, the view points straight into the segment
+        // the writer may overwrite the slot while the callable runs, in which case the result
+        // is discarded and false is returned - the callable must not keep the view or act on it
+        // before ReadLatestPoseGraph returns true
+        //
+        template<typename Callable>
+        bool ReadLatestPoseGraph(Callable&& callable) const
+        {
+            auto slot = _graph->latest_slot.load(std::memory_order_acquire);
+            uint64_t sequence = 0;
+            auto view = BeginRead(slot, sequence);
+            if (!view)
+            {
+                return false;
+            }
+            callable(*view);
+            return EndRead(slot, sequence);
+        }
+
+        // consumer side of the ring, only valid when OwnsRealtimePoses()
+        bool PopRealtimePose(SharedRealtimePose& pose);
+        uint64_t DroppedRealtimePoses() const;
+    };
+}
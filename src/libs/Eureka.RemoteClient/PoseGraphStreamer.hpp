@@ -5,6 +5,7 @@ EUREKA_MSVC_WARNING_DISABLE(4127 4702)
 #include <proto/rgorpc.grpc.pb.h>
 EUREKA_MSVC_WARNING_POP
 #include <asio/detached.hpp>
+#include <ExponentialBackoff.hpp>
 #include <debugger_trace.hpp>
 #include <logging.hpp>
 
@@ -25,10 +26,11 @@ namespace eureka
         using RequestMessage = rgoproto::PoseGraphStreamingRequestMsg;
         using IncomingMessageT = rgoproto::PoseGraphStreamingMsg;
 
-        static RequestMessage MakeRequestMessage()
+        static RequestMessage MakeRequestMessage(const rgoproto::StreamResumeToken& resume)
         {
             RequestMessage clientRequest;
             clientRequest.set_integer(42);
+            *clientRequest.mutable_resume() = resume;
             return clientRequest;
         }
     };
@@ -40,10 +42,11 @@ namespace eureka
         using RequestMessage = rgoproto::RealtimePoseStreamingRequestMsg;
         using IncomingMessageT = rgoproto::RealtimePoseStreamingMsg;
 
-        static RequestMessage MakeRequestMessage()
+        static RequestMessage MakeRequestMessage(const rgoproto::StreamResumeToken& resume)
         {
             RequestMessage clientRequest;
             clientRequest.set_integer(42);
+            *clientRequest.mutable_resume() = resume;
             return clientRequest;
         }
     };
@@ -63,6 +66,8 @@ namespace eureka
         bool                                                                       _active{ false };
         std::vector<std::shared_ptr<IncomingMessageT>>                             _messages;
         sigslot::signal<std::shared_ptr<IncomingMessageT>>                         _newMessageSignal;
+        rgoproto::StreamResumeToken                                                _resumeToken; // last message read, survives reconnects
+        rpc::ExponentialBackoff                                                    _backoff;
 
 
         std::shared_ptr<IncomingMessageT> GetAvailableMessage()
@@ -92,7 +97,7 @@ namespace eureka
             _context = rpc.context;
 
 
-            RequestMessage clientRequest = Policy::MakeRequestMessage();
+            RequestMessage clientRequest = Policy::MakeRequestMessage(_resumeToken);
            
 
             bool requestOK = false;
@@ -148,8 +153,9 @@ namespace eureka
                     }
                     else
                     {
+                        // jittered, so viewers dropped together do not come back together
                         grpc::Alarm alarm;
-                        co_await agrpc::wait(alarm, grpc_deadline_from_now(500ms));
+                        co_await agrpc::wait(alarm, grpc_deadline_from_now(_backoff.Next()));
                     }
                 }
 
@@ -185,6 +191,9 @@ namespace eureka
                         DEBUGGER_TRACE("got pose graph updates {}", packetNum);
                     }
 
+                    _resumeToken = msg->token();
+                    _backoff.Reset(); // only a stream that delivers counts as recovered
+
                     _newMessageSignal(std::move(msg));
                 }
 
@@ -204,6 +213,12 @@ namespace eureka
 
                 _context.reset();
 
+                if (_active)
+                {
+                    // a server that accepts and drops the stream must not be hammered either
+                    grpc::Alarm alarm;
+                    co_await agrpc::wait(alarm, grpc_deadline_from_now(_backoff.Next()));
+                }
             }
 
             //_poseGraphStreamingContext.reset();
@@ -266,6 +281,22 @@ namespace eureka
         {
             return _newMessageSignal.connect(std::forward<Callable>(slot));
         }
+
+        //
+        // messages arriving from another transport (shared memory) are delivered through
+        // the same pool and signal as the ones read from the stream
+        //
+        std::shared_ptr<IncomingMessageT> AcquireMessage()
+        {
+            return GetAvailableMessage();
+        }
+
+        void Emit(std::shared_ptr<IncomingMessageT> msg)
+        {
+            // these messages carry no token, a later stream must not resume from before them
+            _resumeToken.Clear();
+            _newMessageSignal(std::move(msg));
+        }
     };
 
 
@@ -2,14 +2,26 @@
 #include <logging.hpp>
 #include <asio/detached.hpp>
 #include <grpcpp/create_channel.h>
+#include <ExponentialBackoff.hpp>
 #include <debugger_trace.hpp>
 #include <basic_errors.hpp>
 #include <stop_token.hpp>
+#include <utility>
 #include <logging.hpp>
 using namespace std::chrono_literals;
 
 namespace eureka::rpc
 {
+    namespace
+    {
+        constexpr auto SHARED_TRANSPORT_DISCOVERY_TIMEOUT = 2s;
+        constexpr int SHARED_TRANSPORT_READ_ATTEMPTS = 3;
+
+        // state changes wake the waits immediately, the period only bounds how long a cancel or
+        // shutdown waits for them (the completion queue drains pending waits when destroyed)
+        constexpr auto CONNECTION_STATE_WAIT_PERIOD = 500ms;
+    }
+
     RemoteLiveSlamClient::RemoteLiveSlamClient()
         :
         _completionQueue(std::make_shared<ClientCompletionQueuePollingExecutor>()),
@@ -55,7 +67,14 @@ namespace eureka::rpc
             _connectCancellationSource = stop_source();
             auto stopToken = _connectCancellationSource.get_token();
 
-            _channel = grpc::CreateChannel(remoteServerEndpoint, grpc::InsecureChannelCredentials());
+            // the channel reconnects on its own, with gRPC's jittered exponential backoff
+            constexpr BackoffConfig reconnect{};
+            grpc::ChannelArguments channelArgs;
+            channelArgs.SetInt(GRPC_ARG_INITIAL_RECONNECT_BACKOFF_MS, static_cast<int>(reconnect.initial.count()));
+            channelArgs.SetInt(GRPC_ARG_MIN_RECONNECT_BACKOFF_MS, static_cast<int>(reconnect.initial.count()));
+            channelArgs.SetInt(GRPC_ARG_MAX_RECONNECT_BACKOFF_MS, static_cast<int>(reconnect.max.count()));
+
+            _channel = grpc::CreateCustomChannel(remoteServerEndpoint, grpc::InsecureChannelCredentials(), channelArgs);
            
             asio::co_spawn(_completionQueue->Get(),
                 [this, stopToken = std::move(stopToken)]() -> asio::awaitable<void>
@@ -95,16 +114,25 @@ namespace eureka::rpc
 
     void RemoteLiveSlamClient::StartStreams()
     {
+        _streamsRequested = true;
         auto stub = _remoteLiveSlamStub;
         if (stub)
         {
-            _poseGraphStreamRead.Start(stub);
-            _realtimePoseStreamRead.Start(std::move(stub));
+            // whatever the shared memory transport carries is not streamed
+            if (!_sharedTransport || _sharedGraphStreamed)
+            {
+                _poseGraphStreamRead.Start(stub);
+            }
+            if (!_sharedTransport || !_sharedTransport->OwnsRealtimePoses())
+            {
+                _realtimePoseStreamRead.Start(std::move(stub));
+            }
         }      
     }
 
     void RemoteLiveSlamClient::StopStreams()
     {
+        _streamsRequested = false;
         _poseGraphStreamRead.Stop();
         _realtimePoseStreamRead.Stop();
     }
@@ -117,7 +145,7 @@ namespace eureka::rpc
         //pendingConnection->set_result();
         while (state != grpc_connectivity_state::GRPC_CHANNEL_READY && !stopToken.stop_requested())
         {
-            auto deadline = std::chrono::system_clock::now() + 500ms;
+            auto deadline = std::chrono::system_clock::now() + CONNECTION_STATE_WAIT_PERIOD;
      
             co_await agrpc::notify_on_state_change(_completionQueue->Get(), *_channel, state, deadline);
 
@@ -140,6 +168,17 @@ namespace eureka::rpc
 
             SetConnectionState(ConnectionState::Connected);
 
+            if (_sharedTransportEnabled && !_sharedTransport)
+            {
+                asio::co_spawn(_completionQueue->Get(),
+                    [this]() -> asio::awaitable<void>
+                    {
+                        co_await DoDiscoverSharedTransport();
+                    },
+                    asio::detached
+                );
+            }
+
             asio::co_spawn(_completionQueue->Get(),
                 [this, stopToken = std::move(stopToken)]() -> asio::awaitable<void>
                 {
@@ -169,6 +208,7 @@ namespace eureka::rpc
 
     asio::awaitable<void> RemoteLiveSlamClient::DoDisconnect()
     {
+        _sharedTransport.reset();
         _channel.reset();
         _remoteLiveSlamStub.reset();
         SetConnectionState(ConnectionState::Disconnected);
@@ -189,7 +229,7 @@ namespace eureka::rpc
             if (!channel) break;
 
 
-            auto deadline = std::chrono::system_clock::now() + 500ms;
+            auto deadline = std::chrono::system_clock::now() + CONNECTION_STATE_WAIT_PERIOD;
 
             co_await agrpc::notify_on_state_change(_completionQueue->Get(), *_channel, state, deadline);
             //co_await agrpc::grpc_initiate([this, channel, state, deadline](agrpc::GrpcContext& grpc_context, void* tag)
@@ -258,6 +298,169 @@ namespace eureka::rpc
 
     }
 
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        Shared Memory Transport
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    asio::awaitable<void> RemoteLiveSlamClient::DoDiscoverSharedTransport()
+    {
+        auto stub = _remoteLiveSlamStub;
+        if (!stub)
+        {
+            co_return;
+        }
+
+        rgoproto::SharedMemoryDiscoveryRequestMsg request{};
+        request.set_host_id(LocalHostId());
+        grpc::ClientContext clientContext{};
+        clientContext.set_deadline(std::chrono::system_clock::now() + SHARED_TRANSPORT_DISCOVERY_TIMEOUT);
+
+        auto reader = agrpc::request(
+            &rgoproto::LiveSlamUIService::Stub::AsyncSharedMemoryDiscovery,
+            *stub,
+            clientContext,
+            request,
+            _completionQueue->Get()
+        );
+
+        rgoproto::SharedMemoryDiscoveryResponseMsg response{};
+        grpc::Status status;
+        co_await agrpc::finish(reader, response, status, asio::use_awaitable);
+
+        // servers without the rpc answer UNIMPLEMENTED, remote hosts answer not available
+        if (!status.ok() || !response.available() || _state != ConnectionState::Connected || _sharedTransport)
+        {
+            co_return;
+        }
+
+        try
+        {
+            _sharedTransport = std::make_unique<SharedPoseTransportReader>(response.segment_name(), response.segment_size(), response.layout_version());
+        }
+        catch (const std::exception& err)
+        {
+            EUREKA_LOG_ERROR("shared memory transport unavailable, streaming over gRPC: {}", err.what());
+            co_return;
+        }
+
+        _sharedGraphPublishCount = 0;
+        _sharedGraphStreamed = false;
+        DEBUGGER_TRACE("using shared memory transport {}", response.segment_name());
+
+        _poseGraphStreamRead.Stop();
+        if (_sharedTransport->OwnsRealtimePoses())
+        {
+            _realtimePoseStreamRead.Stop();
+        }
+    }
+
+    void RemoteLiveSlamClient::CloseSharedTransport()
+    {
+        if (!_sharedTransport)
+        {
+            return;
+        }
+
+        auto ownedRealtimePoses = _sharedTransport->OwnsRealtimePoses();
+        auto graphStreamed = std::exchange(_sharedGraphStreamed, false);
+        _sharedTransport.reset();
+
+        // fall back to the streams the transport was covering
+        auto stub = _remoteLiveSlamStub;
+        if (_streamsRequested && stub)
+        {
+            if (!graphStreamed)
+            {
+                _poseGraphStreamRead.Start(stub);
+            }
+            if (ownedRealtimePoses)
+            {
+                _realtimePoseStreamRead.Start(std::move(stub));
+            }
+        }
+    }
+
+    void RemoteLiveSlamClient::PollSharedTransport()
+    {
+        if (!_sharedTransport || !_streamsRequested)
+        {
+            return;
+        }
+
+        // a restarted server is discovered again on reconnection
+        if (!_sharedTransport->WriterOpen())
+        {
+            DEBUGGER_TRACE("shared memory transport closed, streaming over gRPC");
+            CloseSharedTransport();
+            return;
+        }
+
+        // a graph larger than the segment is only streamed, the segment stays mapped (realtime poses included)
+        // and takes the pose graph back once a graph fits again
+        auto overflow = _sharedTransport->GraphOverflow();
+        if (overflow != _sharedGraphStreamed)
+        {
+            _sharedGraphStreamed = overflow;
+            if (overflow)
+            {
+                DEBUGGER_TRACE("shared pose graph overflowed, streaming it over gRPC");
+                if (auto stub = _remoteLiveSlamStub)
+                {
+                    _poseGraphStreamRead.Start(std::move(stub));
+                }
+            }
+            else
+            {
+                DEBUGGER_TRACE("shared pose graph fits again, leaving the gRPC stream");
+                _poseGraphStreamRead.Stop();
+                _sharedGraphPublishCount = 0;
+            }
+        }
+
+        // the slot is copied into the message, once - the writer may overwrite it as soon as the read ends
+        if (!_sharedGraphStreamed && _sharedTransport->PublishCount() != _sharedGraphPublishCount)
+        {
+            for (auto attempt = 0; attempt < SHARED_TRANSPORT_READ_ATTEMPTS; ++attempt)
+            {
+                auto msg = _poseGraphStreamRead.AcquireMessage();
+                uint64_t publishCount = 0;
+
+                auto readOk = _sharedTransport->ReadLatestPoseGraph(
+                    [&](const SharedPoseGraphView& view)
+                    {
+                        msg->mutable_poses()->Assign(view.poses.begin(), view.poses.end());
+                        msg->mutable_edges_meta()->Assign(view.edges_meta.begin(), view.edges_meta.end());
+                        msg->mutable_edges_data()->Assign(view.edges_data.begin(), view.edges_data.end());
+                        msg->set_timestamp_ns(view.timestamp_ns);
+                        publishCount = view.publish_count;
+                    }
+                );
+
+                if (readOk)
+                {
+                    _sharedGraphPublishCount = publishCount;
+                    _poseGraphStreamRead.Emit(std::move(msg));
+                    break;
+                }
+                // torn by the writer, the next attempt reads the newer slot
+            }
+        }
+
+        if (_sharedTransport->OwnsRealtimePoses())
+        {
+            SharedRealtimePose pose;
+            while (_sharedTransport->PopRealtimePose(pose))
+            {
+                auto msg = _realtimePoseStreamRead.AcquireMessage();
+                msg->mutable_txtytzrxryrz()->Assign(pose.txtytzrxryrz.begin(), pose.txtytzrxryrz.end());
+                msg->set_timestamp_ns(pose.timestamp_ns);
+                _realtimePoseStreamRead.Emit(std::move(msg));
+            }
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////
     //
     //                             PollCompletions
@@ -267,17 +470,20 @@ namespace eureka::rpc
     void RemoteLiveSlamClient::PollCompletions()
     {
         _completionQueue->PollCompletions();
+        PollSharedTransport();
     }
 
     void RemoteLiveSlamClient::PollCompletions(std::chrono::nanoseconds duration)
     {
         _completionQueue->PollCompletions(duration);
+        PollSharedTransport();
     }
 
 
     void RemoteLiveSlamClient::RunCompletions()
     {
         _completionQueue->PollCompletions();
+        PollSharedTransport();
     }
 
 
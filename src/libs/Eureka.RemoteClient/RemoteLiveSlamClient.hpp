@@ -6,6 +6,7 @@ EUREKA_MSVC_WARNING_DISABLE(4127 4702 4005)
 #include <proto/rgorpc.grpc.pb.h>
 EUREKA_MSVC_WARNING_POP
 #include <stop_token.hpp>
+#include <SharedPoseTransport.hpp>
 #include "PoseGraphStreamer.hpp"
 
 namespace eureka::rpc
@@ -33,9 +34,20 @@ namespace eureka::rpc
         PoseGraphStreamRead _poseGraphStreamRead;
         RealtimePoseStreamRead _realtimePoseStreamRead;
 
+        // same host transport, replaces the gRPC streams it covers once discovered
+        bool                                                                        _sharedTransportEnabled{ true };
+        bool                                                                        _streamsRequested{ false };
+        std::unique_ptr<SharedPoseTransportReader>                                  _sharedTransport;
+        uint64_t                                                                    _sharedGraphPublishCount{ 0 };
+        bool                                                                        _sharedGraphStreamed{ false }; // the latest graph overflowed the segment
+
         asio::awaitable<void> DoDisconnect();
         asio::awaitable<void> DoMonitorConnection(stop_token stopToken);
         asio::awaitable<void> DoWaitForConnection(stop_token stopToken);
+        asio::awaitable<void> DoDiscoverSharedTransport();
+
+        void PollSharedTransport();
+        void CloseSharedTransport();
 
         void SetConnectionState(ConnectionState state);
     public:
@@ -64,6 +76,16 @@ namespace eureka::rpc
         void StartStreams();
         void StopStreams();
         void SendForceGPOOptimization();
+
+        //
+        // Shared Memory Transport
+        //
+        // enabled by default, takes effect on the next connection
+        void SetSharedTransportEnabled(bool enabled) { _sharedTransportEnabled = enabled; }
+        bool UsingSharedTransport() const { return _sharedTransport != nullptr; }
+        // direct access to the mapped segment for local viewers, null while streaming over gRPC
+        const SharedPoseTransportReader* SharedTransport() const { return _sharedTransport.get(); }
+
         template<typename Callable>
         sigslot::connection ConnectConnectionStateSlot(Callable&& slot)
         {
@@ -6,6 +6,7 @@
 #include <basic_utils.hpp>
 #include <asio/ip/address.hpp>
 #include <ranges>
+#include <optional>
 
 namespace ImGui
 {
@@ -189,6 +190,20 @@ namespace eureka::ui
         }
     }
 
+    // legend entry without geometry, the item is drawn by the pose graph renderer
+    // false when the item was hidden through the legend
+    bool PlotRendererItem(const char* label, ImU32 color)
+    {
+        IMGUI_SCOPED(ImPlot::ScopedStyleColor(ImPlotCol_Line, color));
+
+        if (ImPlot::BeginItem(label, ImPlotCol_Line))
+        {
+            ImPlot::EndItem();
+            return true;
+        }
+        return false;
+    }
+
     RemoteLiveSlamUI::RemoteLiveSlamUI(LiveSlamUIMemo memo, std::shared_ptr<rpc::RemoteLiveSlamClient> handler) :
         _memo(memo),
         _remoteHandler(std::move(handler))
@@ -235,6 +250,32 @@ namespace eureka::ui
         _newPoseGraphConnection = _remoteHandler->ConnectPoseGraphSlot([this]
         (std::shared_ptr<rgoproto::PoseGraphStreamingMsg> msg)
             {
+                if (_poseGraphRenderer)
+                {
+                    static constexpr int POSES_STRIDE = 7;
+                    static constexpr int OFFSET_TX = 1;
+                    static constexpr int OFFSET_TZ = 3;
+
+                    const auto& poses = msg->poses();
+                    Eigen::Vector2f minXZ = Eigen::Vector2f::Zero();
+                    Eigen::Vector2f maxXZ = Eigen::Vector2f::Zero();
+                    for (auto i = 0; i + POSES_STRIDE <= poses.size(); i += POSES_STRIDE)
+                    {
+                        Eigen::Vector2f xz(poses[i + OFFSET_TX], poses[i + OFFSET_TZ]);
+                        minXZ = i ? minXZ.cwiseMin(xz) : xz;
+                        maxXZ = i ? maxXZ.cwiseMax(xz) : xz;
+                    }
+                    _model.map_view.pose_graph_min = minXZ;
+                    _model.map_view.pose_graph_max = maxXZ;
+
+                    _poseGraphRenderer->UpdatePoseGraph(PoseGraphData
+                        {
+                            .owner = msg,
+                            .poses = std::span<const float>(msg->poses().data(), msg->poses().size()),
+                            .edges_meta = std::span<const uint32_t>(msg->edges_meta().data(), msg->edges_meta().size()),
+                            .edges_data = std::span<const float>(msg->edges_data().data(), msg->edges_data().size())
+                        });
+                }
                 _model.map_view.last_pose_graph_msg = std::move(msg);
             }
         );
@@ -310,6 +351,11 @@ namespace eureka::ui
         liveslam = _memo;
     }
 
+    void RemoteLiveSlamUI::AttachPoseGraphRenderer(std::shared_ptr<IPoseGraphRenderer> renderer)
+    {
+        _poseGraphRenderer = std::move(renderer);
+    }
+
     void RemoteLiveSlamUI::TopView()
     {
      
@@ -424,7 +470,20 @@ namespace eureka::ui
         //    _fitMap = false;
         //}
         //ImPlot::SetNextAxesToFit();
-        if (ImGui::Begin(MAP_WINDOW_NAME, nullptr, ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoDecoration))
+        ImGuiWindowFlags mapWindowFlags = ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoDecoration;
+
+        // the pose graph renderer draws below the imgui layer, keep the plot see-through
+        std::optional<ImPlot::ScopedStyleColor> frameBg;
+        std::optional<ImPlot::ScopedStyleColor> plotBg;
+        if (_poseGraphRenderer)
+        {
+            mapWindowFlags |= ImGuiWindowFlags_NoBackground;
+            frameBg.emplace(ImPlotCol_FrameBg, IM_COL32(0, 0, 0, 0));
+            plotBg.emplace(ImPlotCol_PlotBg, IM_COL32(0, 0, 0, 0));
+        }
+        _model.map_view.pose_graph_plot.visible = false;
+
+        if (ImGui::Begin(MAP_WINDOW_NAME, nullptr, mapWindowFlags))
         {
             if (ImPlot::BeginPlot("Map", mapPlotSize, ImPlotFlags_Equal))
             {
@@ -434,7 +493,11 @@ namespace eureka::ui
             }  
         }
         ImGui::End();
-       
+
+        if (_poseGraphRenderer)
+        {
+            _poseGraphRenderer->UpdatePlot(_model.map_view.pose_graph_plot);
+        }
     }
 
     void RemoteLiveSlamUI::SideMenuView()
@@ -502,7 +565,11 @@ namespace eureka::ui
         ImPlot::SetupAxesLimits(-MAP_AXIS_LIMIT, MAP_AXIS_LIMIT, -MAP_AXIS_LIMIT, MAP_AXIS_LIMIT);
         ImPlot::SetupAxes("x(cm)", "z(cm)", axisFlags, axisFlags);
 
-        if (_model.map_view.last_pose_graph_msg)
+        if (_poseGraphRenderer)
+        {
+            PlotPoseGraphLayer();
+        }
+        else if (_model.map_view.last_pose_graph_msg)
         {
             if (_memo.show_gpo_optimized)
             {
@@ -654,6 +721,69 @@ namespace eureka::ui
 
     }
 
+    void RemoteLiveSlamUI::PlotPoseGraphLayer()
+    {
+        static constexpr char OPTIMIZED_LABEL[] = "optimized";
+        static constexpr char PNP_INLIER_LABEL[] = "pnp induced ref->target (inlier)";
+        static constexpr char PNP_OUTLIER_LABEL[] = "pnp induced ref->target (outlier)";
+        static constexpr char FILTER_RELATIVE_LABEL[] = "filter induced ref->target";
+
+        auto& plotState = _model.map_view.pose_graph_plot;
+        plotState.edge_mask = 0;
+        plotState.show_poses = false;
+
+        if (_model.map_view.last_pose_graph_msg)
+        {
+            if (_memo.show_gpo_optimized)
+            {
+                IMGUI_SCOPED(ImPlot::ScopedStyleColor(ImPlotCol_Line, IMGUI_COLOR_BLUE));
+                if (ImPlot::BeginItem(OPTIMIZED_LABEL, ImPlotCol_Line))
+                {
+                    if (ImPlot::FitThisFrame())
+                    {
+                        ImPlot::FitPoint(ImPlotPoint(_model.map_view.pose_graph_min.x(), _model.map_view.pose_graph_min.y()));
+                        ImPlot::FitPoint(ImPlotPoint(_model.map_view.pose_graph_max.x(), _model.map_view.pose_graph_max.y()));
+                    }
+                    ImPlot::EndItem();
+                    plotState.show_poses = true;
+                }
+            }
+            if (_memo.show_pnp_inliers && PlotRendererItem(PNP_INLIER_LABEL, COLOR_PNP_INLIER_COLOR))
+            {
+                plotState.edge_mask |= POSE_GRAPH_EDGES_PNP_INLIERS;
+            }
+            if (_memo.show_pnp_outliers && PlotRendererItem(PNP_OUTLIER_LABEL, COLOR_PNP_OUTLIER_COLOR))
+            {
+                plotState.edge_mask |= POSE_GRAPH_EDGES_PNP_OUTLIERS;
+            }
+            if (_memo.show_filter_constraints && PlotRendererItem(FILTER_RELATIVE_LABEL, COLOR_FILTER_COLOR))
+            {
+                plotState.edge_mask |= POSE_GRAPH_EDGES_FILTER;
+            }
+        }
+
+        // the renderer replays the imgui projection, hand it the plot mapping in imgui pixels
+        auto viewport = ImGui::GetMainViewport();
+        auto origin = ImPlot::PlotToPixels(ImPlotPoint(0.0, 0.0));
+        auto unit = ImPlot::PlotToPixels(ImPlotPoint(1.0, 1.0));
+        auto plotPos = ImPlot::GetPlotPos();
+        auto plotSize = ImPlot::GetPlotSize();
+
+        plotState.viewport_pos[0] = viewport->Pos.x;
+        plotState.viewport_pos[1] = viewport->Pos.y;
+        plotState.viewport_size[0] = viewport->Size.x;
+        plotState.viewport_size[1] = viewport->Size.y;
+        plotState.rect_min[0] = plotPos.x;
+        plotState.rect_min[1] = plotPos.y;
+        plotState.rect_max[0] = plotPos.x + plotSize.x;
+        plotState.rect_max[1] = plotPos.y + plotSize.y;
+        plotState.plot_to_pixel_scale[0] = unit.x - origin.x;
+        plotState.plot_to_pixel_scale[1] = unit.y - origin.y;
+        plotState.plot_to_pixel_translate[0] = origin.x;
+        plotState.plot_to_pixel_translate[1] = origin.y;
+        plotState.visible = true;
+    }
+
     void RemoteLiveSlamUI::InitiateConnection()
     {
         try
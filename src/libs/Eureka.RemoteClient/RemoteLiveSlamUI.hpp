@@ -1,5 +1,6 @@
 #pragma once
 #include <IImGuiLayout.hpp>
+#include <IPoseGraphRenderer.hpp>
 #include <AppTypes.hpp>
 #include "RemoteLiveSlamClient.hpp"
 
@@ -29,6 +30,11 @@ namespace eureka::ui
 
         std::string        upper_right_text;
 
+        // gpu pose graph layer, the plot is published every frame, the bounds feed the plot autofit
+        PoseGraphPlotState pose_graph_plot;
+        Eigen::Vector2f    pose_graph_min = Eigen::Vector2f::Zero();
+        Eigen::Vector2f    pose_graph_max = Eigen::Vector2f::Zero();
+
     };
 
     struct ModelLayer
@@ -46,6 +52,7 @@ namespace eureka::ui
         ModelLayer                                     _model;
 
         std::shared_ptr<rpc::RemoteLiveSlamClient>          _remoteHandler;
+        std::shared_ptr<IPoseGraphRenderer>                 _poseGraphRenderer; // optional, the pose graph is drawn through imgui without it
   
         sigslot::scoped_connection                          _newPoseGraphConnection;
         sigslot::scoped_connection                          _newRealtimePoseConnection;
@@ -64,6 +71,7 @@ namespace eureka::ui
         void PlotOptimizedCausalPoses();
         void PlotPoseConstraints();
         void PlotRealtimePose();
+        void PlotPoseGraphLayer();
 
    
         void InitiateConnection();
@@ -75,6 +83,9 @@ namespace eureka::ui
         void OnDeactivated() override;
         void UpdateLayout() override;
         void UpdateMemo(LiveSlamUIMemo& liveslam) const;
+
+        // call before activation
+        void AttachPoseGraphRenderer(std::shared_ptr<IPoseGraphRenderer> renderer);
     };
 
 }
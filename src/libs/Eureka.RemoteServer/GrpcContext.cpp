@@ -5,8 +5,6 @@
 
 namespace eureka::rpc
 {
-    constexpr std::size_t GRPC_CONTEXT_POOL_SIZE = 512;
-
     struct GrpcCompletion
     {
         GrpcTag tag{ nullptr };
@@ -4,6 +4,7 @@
 #include <stack>
 #include <atomic>
 #include <debugger_trace.hpp>
+#include <fixed_capacity_vector.hpp>
 
 using namespace std::chrono_literals;
 EUREKA_MSVC_WARNING_PUSH
@@ -16,6 +17,8 @@ namespace eureka::rpc
 {
     using GrpcTag = void*;
 
+    constexpr std::size_t GRPC_CONTEXT_POOL_SIZE = 512;
+
     template<unsigned SPINCOUNT = 100>
     class spinlock_t
     {
@@ -198,7 +201,7 @@ namespace eureka::rpc
         FixedObjectPool<CompletionPacket>                     _pktsPool;
         std::atomic_bool                                      _shutdown = false;
         std::atomic_uint64_t                                  _strandIds = 0;
-        std::vector<CompletionPacket*>                        _pendingCompletions;
+        fixed_capacity_vector<CompletionPacket*, GRPC_CONTEXT_POOL_SIZE> _pendingCompletions; // bounded by the packets pool
         std::unordered_set<uint64_t>                          _pendingStrands;
         std::unordered_map<uint64_t, std::shared_ptr<Strand>> _strands;
         uint64_t                                              _totalCompletions = 0;
@@ -2,6 +2,9 @@
 #include "LiveSlamServiceHelpers.hpp"
 #include "GrpcContext.hpp"
 #include <memory>
+#include <deque>
+#include <mutex>
+#include <random>
 
 EUREKA_MSVC_WARNING_PUSH
 EUREKA_MSVC_WARNING_DISABLE(4702)
@@ -31,6 +34,9 @@ namespace eureka::rpc
         static constexpr StreamMethodT StreamRequestMethod = &rgoproto::LiveSlamUIService::AsyncService::RequestPoseGraphStreaming;
 
         static constexpr char PRETTY_NAME[] = "GPO Stream";
+
+        // every message is a full snapshot, resuming only skips a graph the client already has
+        static constexpr std::size_t HISTORY_CAPACITY = 0;
     };
 
     struct RealtimePoseStreamPolicy
@@ -44,6 +50,8 @@ namespace eureka::rpc
 
         static constexpr char PRETTY_NAME[] = "RT Pose Stream";
 
+        // poses published while a client was away are replayed from here on resume
+        static constexpr std::size_t HISTORY_CAPACITY = 1024;
 
     };
 
@@ -76,6 +84,15 @@ namespace eureka::rpc
         std::shared_ptr<StreamMsgT>                                  _writingStreamMsg;
         std::shared_ptr<StreamMsgT>                                  _writtenStreamMsg;
 
+        // resumption
+        const uint64_t                                               _epoch;
+        std::mutex                                                   _historyMutex;
+        uint64_t                                                     _sequence{ 0 };          // guarded by _historyMutex
+        std::deque<std::shared_ptr<StreamMsgT>>                      _history;                // guarded by _historyMutex
+        std::deque<std::shared_ptr<StreamMsgT>>                      _replay;                 // session, history entries the client missed
+        uint64_t                                                     _lastSentSequence{ 0 };  // session
+        bool                                                         _writingReplay{ false };
+
 
         struct PrivatePassKey {}; // only allow creation via Make that calls make_shared
     public:
@@ -94,7 +111,8 @@ namespace eureka::rpc
             _service(std::move(service)),
             _startAlarm(_grpcContext),
             _stopAlarm(_grpcContext),
-            _checkDataAlarm(_grpcContext)
+            _checkDataAlarm(_grpcContext),
+            _epoch(MakeEpoch())
         {
 
         }
@@ -148,6 +166,10 @@ namespace eureka::rpc
 
         std::shared_ptr<StreamMsgT> ExchangeData(std::shared_ptr<StreamMsgT> msg)
         {
+            if (msg)
+            {
+                StampAndRecord(*msg);
+            }
             auto writtenData = std::move(_writtenStreamMsg);
             _pendingStreamMsg = std::move(msg);
             _checkDataAlarm.Trigger(_grpcContext->Get(),
@@ -162,6 +184,70 @@ namespace eureka::rpc
         }
 
     private:
+        static uint64_t MakeEpoch()
+        {
+            std::random_device rd;
+            return ((uint64_t(rd()) << 32) | rd()) | 1; // never 0, which is what a first connection sends
+        }
+
+        void StampAndRecord(StreamMsgT& msg)
+        {
+            std::scoped_lock lock(_historyMutex);
+            auto& token = *msg.mutable_token();
+            token.set_epoch(_epoch);
+            token.set_sequence(++_sequence);
+
+            if constexpr (StreamPolicy::HISTORY_CAPACITY > 0)
+            {
+                // the producer reuses its messages, the history keeps copies
+                // recycle the oldest entry unless a session is still replaying it
+                std::shared_ptr<StreamMsgT> entry;
+                if (_history.size() == StreamPolicy::HISTORY_CAPACITY)
+                {
+                    entry = std::move(_history.front());
+                    _history.pop_front();
+                    if (entry.use_count() != 1)
+                    {
+                        entry.reset();
+                    }
+                }
+                if (!entry)
+                {
+                    entry = std::make_shared<StreamMsgT>();
+                }
+                entry->CopyFrom(msg);
+                _history.emplace_back(std::move(entry));
+            }
+        }
+
+        void PrepareSessionResume()
+        {
+            _replay.clear();
+            _lastSentSequence = 0;
+
+            const auto& resume = _clientRequest.resume();
+            if (resume.epoch() != _epoch)
+            {
+                // first connection, or a token from before a server restart
+                return;
+            }
+
+            _lastSentSequence = resume.sequence();
+
+            if constexpr (StreamPolicy::HISTORY_CAPACITY > 0)
+            {
+                std::scoped_lock lock(_historyMutex);
+                for (const auto& entry : _history)
+                {
+                    if (entry->token().sequence() > _lastSentSequence)
+                    {
+                        _replay.emplace_back(entry);
+                    }
+                }
+            }
+            DEBUGGER_TRACE("{} - resuming after {}, replaying {}", StreamPolicy::PRETTY_NAME, _lastSentSequence, _replay.size());
+        }
+
         bool IsStreaming() const
         {
             return _state == HandlerState::WaitingForAvailableData ||
@@ -227,6 +313,7 @@ namespace eureka::rpc
             {
                 _state = HandlerState::WaitingForAvailableData;
 
+                PrepareSessionResume();
                 PollPendingDataAndWrite();
             }
             else
@@ -278,10 +365,27 @@ namespace eureka::rpc
         {
             if (_state == HandlerState::WaitingForAvailableData)
             {
-                auto data = std::move(_pendingStreamMsg);
+                std::shared_ptr<StreamMsgT> data;
+                _writingReplay = !_replay.empty();
+                if (_writingReplay)
+                {
+                    data = std::move(_replay.front());
+                    _replay.pop_front();
+                }
+                else
+                {
+                    data = std::move(_pendingStreamMsg);
+                    if (data && data->token().sequence() <= _lastSentSequence)
+                    {
+                        // the client had it before reconnecting, or it was just replayed
+                        data.reset();
+                    }
+                }
 
                 if (data)
                 {
+                    _lastSentSequence = data->token().sequence();
+
                     auto tag = _grpcContext->CreateTag(
                         [self = this->weak_from_this()](bool ok) mutable
                         {
@@ -304,7 +408,15 @@ namespace eureka::rpc
             if (ok && _state == HandlerState::WaitngForWriteDone)
             {
                 ++_packetsCount;
-                _writtenStreamMsg = std::move(_writingStreamMsg);
+                if (_writingReplay)
+                {
+                    // history entries are never handed back to the producer
+                    _writingStreamMsg.reset();
+                }
+                else
+                {
+                    _writtenStreamMsg = std::move(_writingStreamMsg);
+                }
                 _state = HandlerState::WaitingForAvailableData;
                 PollPendingDataAndWrite();
             }
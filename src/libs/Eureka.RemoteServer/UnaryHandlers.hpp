@@ -25,6 +25,15 @@ namespace eureka::rpc
         static constexpr RPCMethodT RPCRequestMethod = &rgoproto::LiveSlamUIService::AsyncService::RequestForceFullGPO;
     };
 
+    struct SharedMemoryDiscoveryRPCPolicy
+    {
+        using RequestMsg = rgoproto::SharedMemoryDiscoveryRequestMsg;
+        using ResponseMsg = rgoproto::SharedMemoryDiscoveryResponseMsg;
+        using AsyncService = rgoproto::LiveSlamUIService::AsyncService;
+        using RPCMethodT = decltype(&rgoproto::LiveSlamUIService::AsyncService::RequestSharedMemoryDiscovery);
+        static constexpr RPCMethodT RPCRequestMethod = &rgoproto::LiveSlamUIService::AsyncService::RequestSharedMemoryDiscovery;
+    };
+
     template<typename RPCPolicy>
     class GenericImmediateUnaryRPC : public std::enable_shared_from_this<GenericImmediateUnaryRPC<RPCPolicy>>
     {
@@ -4,6 +4,7 @@
 #include "GrpcContext.hpp"
 #include <profiling.hpp>
 #include <debugger_trace.hpp>
+#include <logging.hpp>
 
 namespace eureka::rpc
 {
@@ -15,7 +16,8 @@ namespace eureka::rpc
         _grpcContext(std::move(grpcContext)),
         _poseGraphStreamingHandler(PoseGraphStreamingHandler::Make(_service, _grpcContext)),
         _realtimePoseStreamingHandler(RealtimePoseStreamingHandler::Make(_service, _grpcContext)),
-        _forceFullGPOHandler(ForceFullGPOHandler::Make(_service, _grpcContext))
+        _forceFullGPOHandler(ForceFullGPOHandler::Make(_service, _grpcContext)),
+        _sharedMemoryDiscoveryHandler(SharedMemoryDiscoveryHandler::Make(_service, _grpcContext))
     {
 
     }
@@ -45,6 +47,24 @@ namespace eureka::rpc
                     DEBUGGER_TRACE("force gpo optimization");
                 }
             );
+            _sharedMemoryDiscoveryHandler->Start(
+                [this]
+                (const rgoproto::SharedMemoryDiscoveryRequestMsg& request, rgoproto::SharedMemoryDiscoveryResponseMsg& response)
+                {
+                    // a matching host id is what makes the segment name meaningful to the client
+                    if (_sharedTransport && request.host_id() == _hostId)
+                    {
+                        response.set_available(true);
+                        response.set_segment_name(_sharedTransport->SegmentName());
+                        response.set_segment_size(_sharedTransport->SegmentSize());
+                        response.set_layout_version(SHARED_POSE_TRANSPORT_VERSION);
+                    }
+                    else
+                    {
+                        response.set_available(false);
+                    }
+                }
+            );
         }
     }
 
@@ -56,16 +76,52 @@ namespace eureka::rpc
             _poseGraphStreamingHandler->Stop();
             _realtimePoseStreamingHandler->Stop();
             _forceFullGPOHandler->Stop();
+            _sharedMemoryDiscoveryHandler->Stop();
         }
     }
 
+    void VisualizationService::EnableSharedMemoryTransport(const SharedMemoryTransportConfig& config)
+    {
+        if (_active)
+        {
+            throw std::logic_error("shared memory transport must be enabled before the service starts");
+        }
+        _sharedTransport = std::make_unique<SharedPoseTransportWriter>(config);
+        _hostId = LocalHostId();
+    }
+
     std::shared_ptr<rgoproto::PoseGraphStreamingMsg> VisualizationService::ExchangeData(std::shared_ptr<rgoproto::PoseGraphStreamingMsg> msg)
     {
+        if (_sharedTransport && msg)
+        {
+            // a graph too large for the slot is only streamed, local clients see the overflow flag and switch to the stream
+            auto written = _sharedTransport->WritePoseGraph(
+                msg->timestamp_ns(),
+                { msg->poses().data(), static_cast<std::size_t>(msg->poses_size()) },
+                { msg->edges_meta().data(), static_cast<std::size_t>(msg->edges_meta_size()) },
+                { msg->edges_data().data(), static_cast<std::size_t>(msg->edges_data_size()) }
+            );
+
+            if (!written && !_sharedGraphOverflow.exchange(true))
+            {
+                EUREKA_LOG_ERROR("pose graph of {} poses exceeds the shared memory slot, local clients fall back to gRPC streaming", msg->poses_size() / 7);
+            }
+            else if (written)
+            {
+                _sharedGraphOverflow = false;
+            }
+        }
         return _poseGraphStreamingHandler->ExchangeData(std::move(msg));
     }
 
     std::shared_ptr<rgoproto::RealtimePoseStreamingMsg> VisualizationService::ExchangeData(std::shared_ptr<rgoproto::RealtimePoseStreamingMsg> msg)
     {
+        if (_sharedTransport && msg && msg->txtytzrxryrz_size() == 6)
+        {
+            SharedRealtimePose pose{ .timestamp_ns = msg->timestamp_ns() };
+            std::ranges::copy(msg->txtytzrxryrz(), pose.txtytzrxryrz.begin());
+            _sharedTransport->PushRealtimePose(pose);
+        }
         return _realtimePoseStreamingHandler->ExchangeData(std::move(msg));
     }
 }
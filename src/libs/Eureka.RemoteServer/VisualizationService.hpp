@@ -4,6 +4,7 @@ EUREKA_MSVC_WARNING_PUSH
 EUREKA_MSVC_WARNING_DISABLE(4702 4127)
 #include <proto/rgorpc.grpc.pb.h>
 EUREKA_MSVC_WARNING_POP
+#include <SharedPoseTransport.hpp>
 
 
 using namespace std::chrono_literals;
@@ -19,6 +20,7 @@ namespace eureka::rpc
     struct GPOStreamPolicy;
     struct RealtimePoseStreamPolicy;
     struct ForceFullGPORPCPolicy;
+    struct SharedMemoryDiscoveryRPCPolicy;
 
     template<typename StreamPolicy> class GenericServerToClientStreamer;
     template<typename RPCPolicy> class GenericImmediateUnaryRPC;
@@ -26,6 +28,7 @@ namespace eureka::rpc
     using PoseGraphStreamingHandler = GenericServerToClientStreamer<GPOStreamPolicy>;
     using RealtimePoseStreamingHandler = GenericServerToClientStreamer<RealtimePoseStreamPolicy>;
     using ForceFullGPOHandler = GenericImmediateUnaryRPC<ForceFullGPORPCPolicy>;
+    using SharedMemoryDiscoveryHandler = GenericImmediateUnaryRPC<SharedMemoryDiscoveryRPCPolicy>;
 
     class VisualizationService
     {
@@ -35,6 +38,10 @@ namespace eureka::rpc
         std::shared_ptr<PoseGraphStreamingHandler>                     _poseGraphStreamingHandler;
         std::shared_ptr<RealtimePoseStreamingHandler>                  _realtimePoseStreamingHandler;
         std::shared_ptr<ForceFullGPOHandler>                           _forceFullGPOHandler;
+        std::shared_ptr<SharedMemoryDiscoveryHandler>                  _sharedMemoryDiscoveryHandler;
+        std::unique_ptr<SharedPoseTransportWriter>                     _sharedTransport;
+        std::string                                                    _hostId;
+        std::atomic_bool                                               _sharedGraphOverflow{ false }; // logged once per overflow streak
     public:
         VisualizationService(std::shared_ptr<rgoproto::LiveSlamUIService::AsyncService> service, std::shared_ptr<GrpcContext> grpcContext);
         ~VisualizationService();
@@ -43,6 +50,8 @@ namespace eureka::rpc
         // public thread safe functions
         //
         void Start();
+        // offers same host clients a shared memory segment next to the gRPC streams, call before Start
+        void EnableSharedMemoryTransport(const SharedMemoryTransportConfig& config);
         void Stop();
         std::shared_ptr<rgoproto::PoseGraphStreamingMsg> ExchangeData(std::shared_ptr<rgoproto::PoseGraphStreamingMsg> msg);
         std::shared_ptr<rgoproto::RealtimePoseStreamingMsg> ExchangeData(std::shared_ptr<rgoproto::RealtimePoseStreamingMsg> msg);
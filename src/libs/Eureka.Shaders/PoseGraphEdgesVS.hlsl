@@ -0,0 +1,33 @@
+#include "pose_graph.hlsli"
+
+//
+// line list, instanced
+// SOURCE_EDGES : 4 vertices per edge, ref -> induced target in the edge color, induced -> optimized target (residual)
+// SOURCE_POSES : 2 vertices per instance, the optimized path segment pose i -> pose i + 1
+//
+
+VSOutput main(uint vertexIndex : SV_VertexID, uint instanceIndex : SV_InstanceID)
+{
+	VSOutput output = (VSOutput)0;
+
+	if (pushConstants.source == SOURCE_POSES)
+	{
+		output.position = PlotToClip(PoseXZ(instanceIndex + vertexIndex));
+		output.color = COLOR_OPTIMIZED;
+		return output;
+	}
+
+	uint category = EdgeCategory(instanceIndex);
+	if (category == 0)
+	{
+		output.position = CULLED_POSITION;
+		return output;
+	}
+
+	// points: 0 ref, 1 induced target, 3 optimized target (2 is the induced orientation)
+	static const uint LINE_POINTS[4] = { 0, 1, 1, 3 };
+
+	output.position = PlotToClip(EdgePointXZ(instanceIndex, LINE_POINTS[vertexIndex]));
+	output.color = vertexIndex < 2 ? EdgeColor(category) : COLOR_RESIDUAL;
+	return output;
+}
@@ -0,0 +1,57 @@
+#include "pose_graph.hlsli"
+
+//
+// triangle list, instanced, 3 vertices per orientation glyph
+// SOURCE_EDGES : the induced target of every drawn edge
+// SOURCE_POSES : every optimized pose
+//
+
+VSOutput main(uint vertexIndex : SV_VertexID, uint instanceIndex : SV_InstanceID)
+{
+	VSOutput output = (VSOutput)0;
+
+	float2 tip;
+	float3 dir;
+
+	if (pushConstants.source == SOURCE_POSES)
+	{
+		uint base = instanceIndex * POSE_STRIDE;
+		tip = PoseXZ(instanceIndex);
+		dir = float3(poses[base + 4], poses[base + 5], poses[base + 6]);
+		output.color = COLOR_OPTIMIZED;
+	}
+	else
+	{
+		uint category = EdgeCategory(instanceIndex);
+		if (category == 0)
+		{
+			output.position = CULLED_POSITION;
+			return output;
+		}
+
+		uint base = instanceIndex * EDGE_DATA_STRIDE;
+		tip = EdgePointXZ(instanceIndex, 1);
+		dir = float3(edgesData[base + 6], edgesData[base + 7], edgesData[base + 8]);
+		output.color = EdgeColor(category);
+	}
+
+	// same triangle the imgui path used to build on the cpu
+	// a vertical (or zero) direction has no plot heading, the glyph points along +x instead of going NaN
+	float2 heading = float2(dir.x, dir.z);
+	float headingLength = length(heading);
+	float2 back = headingLength > 1e-6 ? heading / headingLength : float2(1.0, 0.0);
+	float2 perp = float2(back.y, -back.x);
+
+	float2 corner = tip;
+	if (vertexIndex == 1)
+	{
+		corner = tip - pushConstants.glyphScale * (back * 4.0 + perp);
+	}
+	else if (vertexIndex == 2)
+	{
+		corner = tip - pushConstants.glyphScale * (back * 4.0 - perp);
+	}
+
+	output.position = PlotToClip(corner);
+	return output;
+}
@@ -11,6 +11,7 @@ namespace eureka::vulkan
         const unsigned char* ptr;
         const unsigned long long size;
         VkShaderStageFlagBits shader_type;
+        const char* name; // identifier, the file name of a hot reloaded override
 
         bool operator==(const ShaderId& s) const
         {
@@ -46,4 +47,7 @@ EUREKA_SHADER_IDENTIFIER(ImGuiGLSLVS, VkShaderStageFlagBits::VK_SHADER_STAGE_VER
 EUREKA_SHADER_IDENTIFIER(ImGuiGLSLFS, VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT);
 EUREKA_SHADER_IDENTIFIER(Textured2DRegionVS, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT);
 EUREKA_SHADER_IDENTIFIER(Textured2DRegionFS, VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT);
+EUREKA_SHADER_IDENTIFIER(PoseGraphEdgesVS, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT);
+EUREKA_SHADER_IDENTIFIER(PoseGraphGlyphsVS, VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT);
+EUREKA_SHADER_IDENTIFIER(PoseGraphFS, VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT);
 #endif // SHADERS_HEADER
\ No newline at end of file
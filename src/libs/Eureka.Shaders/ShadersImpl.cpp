@@ -11,10 +11,13 @@
 #include <TriangleFS.spvhpp>
 #include <ShadedMeshWithNormalMapVS.spvhpp>
 #include <PhongShadedMeshWithNormalMapFS.spvhpp>
+#include <PoseGraphEdgesVS.spvhpp>
+#include <PoseGraphGlyphsVS.spvhpp>
+#include <PoseGraphFS.spvhpp>
 
 #define EUREKA_DEFINE_SHADER_ID(IDENTIFIER, SHADER_FULL_NAME, SHADER_TYPE) \
 extern const eureka::vulkan::ShaderId IDENTIFIER; \
-const eureka::vulkan::ShaderId IDENTIFIER{ SHADER_FULL_NAME, sizeof(SHADER_FULL_NAME), SHADER_TYPE }; 
+const eureka::vulkan::ShaderId IDENTIFIER{ SHADER_FULL_NAME, sizeof(SHADER_FULL_NAME), SHADER_TYPE, #IDENTIFIER }; 
 //static_assert(false);
 
 #undef EUREKA_SHADER_IDENTIFIER
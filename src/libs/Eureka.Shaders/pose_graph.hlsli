@@ -0,0 +1,97 @@
+////////////////////////////////////////////////////////////////////////////
+// 
+//                         Pose Graph common data
+// 
+////////////////////////////////////////////////////////////////////////////
+
+// must match eureka::vulkan::PoseGraphPushConstantsBlock
+struct PushConstants
+{
+	float2 scale;       // plot (x, z) to normalized device coordinates
+	float2 translate;
+	uint   edgeMask;    // edge categories to draw, see EDGE_* below
+	uint   source;      // SOURCE_EDGES or SOURCE_POSES
+	float  glyphScale;  // orientation triangle size, in plot units
+	uint   padding;
+};
+
+[[vk::push_constant]]
+PushConstants pushConstants;
+
+static const uint SOURCE_EDGES = 0;
+static const uint SOURCE_POSES = 1;
+
+static const uint EDGE_PNP_INLIER = 1;
+static const uint EDGE_PNP_OUTLIER = 2;
+static const uint EDGE_FILTER = 4;
+
+static const uint POSE_STRIDE = 7;        // id, tx, ty, tz, rx, ry, rz
+static const uint EDGE_META_STRIDE = 4;   // ref id, target id, type, is inlier
+static const uint EDGE_DATA_STRIDE = 12;  // ref t, induced target t, induced target r, optimized target t
+
+static const float4 COLOR_OPTIMIZED = float4(0.0, 0.0, 1.0, 1.0);
+static const float4 COLOR_PNP_INLIER = float4(0.0, 1.0, 0.0, 1.0);
+static const float4 COLOR_PNP_OUTLIER = float4(1.0, 165.0 / 255.0, 0.0, 1.0);
+static const float4 COLOR_FILTER = float4(0.0, 1.0, 1.0, 1.0);
+static const float4 COLOR_RESIDUAL = float4(1.0, 0.0, 0.0, 1.0);
+
+// outside the depth range, the primitive is clipped away
+static const float4 CULLED_POSITION = float4(0.0, 0.0, -2.0, 1.0);
+
+[[vk::binding(0, 0)]] StructuredBuffer<float> poses;
+[[vk::binding(1, 0)]] StructuredBuffer<uint> edgesMeta;
+[[vk::binding(2, 0)]] StructuredBuffer<float> edgesData;
+
+struct VSOutput
+{
+	float4 position : SV_POSITION;
+	[[vk::location(0)]] float4 color : COLOR0;
+};
+
+float4 PlotToClip(float2 xz)
+{
+	return float4(xz * pushConstants.scale + pushConstants.translate, 0.0, 1.0);
+}
+
+// 0 when the edge is filtered out
+uint EdgeCategory(uint edge)
+{
+	uint type = edgesMeta[edge * EDGE_META_STRIDE + 2];
+	uint isInlier = edgesMeta[edge * EDGE_META_STRIDE + 3];
+
+	uint category = 0;
+	if (type == 2)
+	{
+		category = isInlier != 0 ? EDGE_PNP_INLIER : EDGE_PNP_OUTLIER;
+	}
+	else if (type == 0)
+	{
+		category = EDGE_FILTER;
+	}
+	return category & pushConstants.edgeMask;
+}
+
+float4 EdgeColor(uint category)
+{
+	if (category == EDGE_PNP_INLIER)
+	{
+		return COLOR_PNP_INLIER;
+	}
+	if (category == EDGE_PNP_OUTLIER)
+	{
+		return COLOR_PNP_OUTLIER;
+	}
+	return COLOR_FILTER;
+}
+
+float2 EdgePointXZ(uint edge, uint point)
+{
+	uint base = edge * EDGE_DATA_STRIDE + point * 3;
+	return float2(edgesData[base], edgesData[base + 2]);
+}
+
+float2 PoseXZ(uint pose)
+{
+	uint base = pose * POSE_STRIDE;
+	return float2(poses[base + 1], poses[base + 3]);
+}
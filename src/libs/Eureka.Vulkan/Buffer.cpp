@@ -1,4 +1,5 @@
 #include "Buffer.hpp"
+#include <utility>
 
 namespace eureka::vulkan
 {
@@ -84,6 +85,81 @@ namespace eureka::vulkan
         }
     }
 
+    AllocatedBuffer::AllocatedBuffer(AllocatedBuffer&& that) noexcept
+        :
+        AllocatedBufferBase(std::move(that)),
+        _onRelocated(std::move(that._onRelocated)),
+        _relocatable(std::exchange(that._relocatable, false))
+    {
+        if (_relocatable)
+        {
+            _allocator->SetRelocatable(_allocation.allocation, this);
+        }
+    }
+
+    AllocatedBuffer& AllocatedBuffer::operator=(AllocatedBuffer&& rhs) noexcept
+    {
+        if (nullptr != _allocation.buffer)
+        {
+            _allocator->DeallocateBuffer(_allocation);
+        }
+
+        AllocatedBufferBase::operator=(std::move(rhs));
+        _onRelocated = std::move(rhs._onRelocated);
+        _relocatable = std::exchange(rhs._relocatable, false);
+        if (_relocatable)
+        {
+            _allocator->SetRelocatable(_allocation.allocation, this);
+        }
+        return *this;
+    }
+
+    void AllocatedBuffer::EnableRelocation(std::function<void()> onRelocated)
+    {
+        assert(_allocation.allocation);
+        assert(!_allocation.ptr);
+        // relocation copies the buffer into a buffer with the same usage
+        assert(_allocation.usage & VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+        assert(_allocation.usage & VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+
+        _onRelocated = std::move(onRelocated);
+        _relocatable = true;
+        _allocator->SetRelocatable(_allocation.allocation, this);
+    }
+
+    RelocatedHandles AllocatedBuffer::Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer)
+    {
+        auto buffer = _allocator->CreateBuffer(dstMemory, _allocation.byte_size, _allocation.usage);
+
+        VkBufferCopy2 region
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_COPY_2,
+            .srcOffset = 0,
+            .dstOffset = 0,
+            .size = _allocation.byte_size
+        };
+
+        commandBuffer.CopyBuffer(VkCopyBufferInfo2
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_COPY_BUFFER_INFO_2,
+                .srcBuffer = _allocation.buffer,
+                .dstBuffer = buffer,
+                .regionCount = 1,
+                .pRegions = &region
+            });
+
+        RelocatedHandles replaced
+        {
+            .buffer = std::exchange(_allocation.buffer, buffer)
+        };
+
+        if (_onRelocated)
+        {
+            _onRelocated();
+        }
+        return replaced;
+    }
+
     //////////////////////////////////////////////////////////////////////////
     //
     //                        HostWriteCombinedBuffer
@@ -113,5 +189,11 @@ namespace eureka::vulkan
 
     }
 
+    StorageTransferableDeviceBuffer::StorageTransferableDeviceBuffer(std::shared_ptr<ResourceAllocator> allocator, uint64_t byteSize)
+        : AllocatedBuffer(std::move(allocator), byteSize, BufferAllocationPreset::eStorageTransferableDeviceBuffer)
+    {
+
+    }
+
 }
 
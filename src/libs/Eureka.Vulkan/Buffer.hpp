@@ -1,7 +1,9 @@
 #pragma once
 
 #include "ResourceAllocator.hpp"
+#include "Relocatable.hpp"
 #include <macros.hpp>
+#include <functional>
 #include <span>
 #include <assert.hpp>
 
@@ -29,15 +31,23 @@ namespace eureka::vulkan
         VkDescriptorBufferInfo DescriptorInfo() const;
     };
 
-    class AllocatedBuffer : public AllocatedBufferBase
+    class AllocatedBuffer : public AllocatedBufferBase, public Relocatable
     {
+        std::function<void()> _onRelocated;
+        bool                  _relocatable{ false };
     protected:
         AllocatedBuffer(std::shared_ptr<ResourceAllocator> allocator);
         AllocatedBuffer(std::shared_ptr<ResourceAllocator> allocator, uint64_t byteSize, BufferAllocationPreset preset);
         ~AllocatedBuffer() noexcept;
         AllocatedBuffer() = default;
-        AllocatedBuffer& operator=(AllocatedBuffer&& rhs) noexcept = default;
-        AllocatedBuffer(AllocatedBuffer&& that) noexcept = default;
+        AllocatedBuffer& operator=(AllocatedBuffer&& rhs) noexcept;
+        AllocatedBuffer(AllocatedBuffer&& that) noexcept;
+    public:
+        // lets the defragmenter move the buffer, host mapped buffers can't be moved
+        // onRelocated runs on the defragmenting thread once Buffer() changed, descriptors of the buffer have to be
+        // rebuilt before the next frame records with them
+        void EnableRelocation(std::function<void()> onRelocated = {});
+        RelocatedHandles Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer) override;
     };
 
     //////////////////////////////////////////////////////////////////////////
@@ -176,6 +186,20 @@ namespace eureka::vulkan
     };
 
 
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                  StorageTransferableDeviceBuffer
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    class StorageTransferableDeviceBuffer : public AllocatedBuffer
+    {
+    public:
+        StorageTransferableDeviceBuffer() = default;
+        StorageTransferableDeviceBuffer(std::shared_ptr<ResourceAllocator> allocator, uint64_t byteSize);
+    };
+
+
     //////////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////////
     //////////////////////////////////////////////////////////////////////////
@@ -3,7 +3,7 @@
 namespace eureka::vulkan
 {
     BufferMemoryPool::BufferMemoryPool(std::shared_ptr<ResourceAllocator> allocator,
-                                       uint64_t                           byteSize,
+                                       const PoolBlocksConfig&            blocks,
                                        VmaPoolCreateFlags                 poolFlags,
                                        VkBufferUsageFlags                 usageFlags,
                                        VmaAllocationCreateFlags           allocationFlags) :
@@ -11,6 +11,6 @@ namespace eureka::vulkan
         _allocationFlags(allocationFlags),
         _usageFlags(usageFlags)
     {
-        _allocation = _allocator->AllocateBufferPool(byteSize, usageFlags, _allocationFlags, poolFlags);
+        _allocation = _allocator->AllocateBufferPool(blocks, usageFlags, _allocationFlags, poolFlags);
     }
 } // namespace eureka::vulkan
\ No newline at end of file
@@ -11,7 +11,7 @@ namespace eureka::vulkan
 
     public:
         BufferMemoryPool(std::shared_ptr<ResourceAllocator> allocator,
-                         uint64_t                           byteSize,
+                         const PoolBlocksConfig&            blocks,
                          VmaPoolCreateFlags                 poolFlags,
                          VkBufferUsageFlags                 usageFlags,
                          VmaAllocationCreateFlags           allocationFlags);
@@ -20,10 +20,23 @@ namespace eureka::vulkan
         {
             return _allocator->AllocatePoolBuffer(_allocation.pool, byteSize, _usageFlags, _allocationFlags);
         }
+        // nullopt when the pool can't grow, either out of blocks or a new block would exceed the heap budget
+        std::optional<BufferAllocation> TryAllocateBuffer(uint64_t byteSize)
+        {
+            return _allocator->TryAllocatePoolBuffer(_allocation.pool, byteSize, _usageFlags, _allocationFlags);
+        }
         void DeallocateBuffer(const BufferAllocation& buffer)
         {
             return _allocator->DeallocateBuffer(buffer);
         }
+        PoolStatistics Statistics() const
+        {
+            return _allocator->GetPoolStatistics(_allocation);
+        }
+        uint64_t BlockByteSize() const
+        {
+            return _allocation.block_byte_size;
+        }
         ~BufferMemoryPool()
         {
             _allocator->DeallocatePool(_allocation);
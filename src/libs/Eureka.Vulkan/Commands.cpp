@@ -17,6 +17,17 @@ namespace eureka::vulkan
         VK_CHECK(vkBeginCommandBuffer(_commandBuffer, &beginInfo));
     }
 
+    void LinearCommandBufferHandle::BeginSecondary(const VkCommandBufferInheritanceInfo& inheritanceInfo)
+    {
+        VkCommandBufferBeginInfo beginInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT,
+            .pInheritanceInfo = &inheritanceInfo
+        };
+        VK_CHECK(vkBeginCommandBuffer(_commandBuffer, &beginInfo));
+    }
+
     void LinearCommandBufferHandle::End()
     {
         VK_CHECK(vkEndCommandBuffer(_commandBuffer));
@@ -67,6 +78,11 @@ namespace eureka::vulkan
         return LinearCommandBufferHandle(_device->AllocatePrimaryCommandBuffer(_pool));
     }
 
+    LinearCommandBufferHandle LinearCommandPool::AllocateSecondaryCommandBuffer() const
+    {
+        return LinearCommandBufferHandle(_device->AllocateSecondaryCommandBuffer(_pool));
+    }
+
 
 
 }
\ No newline at end of file
@@ -15,6 +15,8 @@ namespace eureka::vulkan
     public:
         VkCommandBuffer Get() const { return _commandBuffer; }
         void Begin();
+        // secondary command buffers continuing the inherited render pass
+        void BeginSecondary(const VkCommandBufferInheritanceInfo& inheritanceInfo);
         void End();
         void PipelineBarrier(
             VkPipelineStageFlags                        srcStageMask,
@@ -70,6 +72,27 @@ namespace eureka::vulkan
             vkCmdCopyBuffer(_commandBuffer, srcBuffer, dstBuffer, regionCount, pRegions);
         }
 
+        void CopyBuffer(
+            const VkCopyBufferInfo2& info
+        )
+        {
+            vkCmdCopyBuffer2(_commandBuffer, &info);
+        }
+
+        void CopyImage(
+            const VkCopyImageInfo2& info
+        )
+        {
+            vkCmdCopyImage2(_commandBuffer, &info);
+        }
+
+        void BlitImage(
+            const VkBlitImageInfo2& info
+        )
+        {
+            vkCmdBlitImage2(_commandBuffer, &info);
+        }
+
         void Bind(
             VkPipelineBindPoint bindPoint,
             VkPipelineLayout pipelineLayout,
@@ -89,15 +112,20 @@ namespace eureka::vulkan
             );
         }
 
-        void BeginRenderPass(const VkRenderPassBeginInfo& beginInfo) const
+        void BeginRenderPass(const VkRenderPassBeginInfo& beginInfo, VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) const
         {
             vkCmdBeginRenderPass(
                 _commandBuffer,
                 &beginInfo,
-                VK_SUBPASS_CONTENTS_INLINE
+                contents
             );
         }
 
+        void ExecuteCommands(dcspan<VkCommandBuffer> commandBuffers) const
+        {
+            vkCmdExecuteCommands(_commandBuffer, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+        }
+
         void BindGraphicsPipeline(VkPipeline pipeline) const
         {
             vkCmdBindPipeline(
@@ -219,6 +247,7 @@ namespace eureka::vulkan
         void Reset();
         VkCommandPool Get() const { return _pool; } 
         LinearCommandBufferHandle AllocatePrimaryCommandBuffer() const;
+        LinearCommandBufferHandle AllocateSecondaryCommandBuffer() const;
     };
 
 
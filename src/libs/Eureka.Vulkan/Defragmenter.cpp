@@ -0,0 +1,145 @@
+#include "Defragmenter.hpp"
+#include <assert.hpp>
+
+namespace eureka::vulkan
+{
+    Defragmenter::Defragmenter(std::shared_ptr<Device> device, std::shared_ptr<ResourceAllocator> allocator, DefragmentationLimits limits)
+        :
+        _device(std::move(device)),
+        _allocator(std::move(allocator)),
+        _limits(limits)
+    {
+    }
+
+    Defragmenter::~Defragmenter()
+    {
+        if (_passOpen)
+        {
+            EndPass();
+        }
+        if (_context)
+        {
+            End();
+        }
+    }
+
+    bool Defragmenter::Begin(VmaPool pool)
+    {
+        assert(!_context);
+
+        _context = _allocator->BeginDefragmentation(pool, _limits);
+        if (!_context)
+        {
+            return false;
+        }
+
+        ++_counters.runs;
+        return true;
+    }
+
+    void Defragmenter::End()
+    {
+        _counters.last_run = _allocator->EndDefragmentation(_context);
+        _counters.total.bytes_moved += _counters.last_run.bytes_moved;
+        _counters.total.bytes_freed += _counters.last_run.bytes_freed;
+        _counters.total.allocations_moved += _counters.last_run.allocations_moved;
+        _counters.total.blocks_freed += _counters.last_run.blocks_freed;
+        _context = nullptr;
+    }
+
+    bool Defragmenter::BeginPass()
+    {
+        assert(_context);
+        assert(!_passOpen);
+
+        if (!_allocator->BeginDefragmentationPass(_context, _pass))
+        {
+            End();
+            return false;
+        }
+        _passOpen = true;
+        ++_counters.passes;
+        return true;
+    }
+
+    void Defragmenter::RecordPass(LinearCommandBufferHandle& commandBuffer)
+    {
+        assert(_passOpen);
+
+        // everything submitted before may still write the old memory
+        VkMemoryBarrier2 preCopyBarrier
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT
+        };
+        commandBuffer.PipelineBarrier(VkDependencyInfo
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .memoryBarrierCount = 1,
+                .pMemoryBarriers = &preCopyBarrier
+            });
+
+        _allocator->VisitDefragmentationMoves(_pass,
+            [&](VmaDefragmentationMove& move, Relocatable* relocatable)
+            {
+                _replaced.emplace_back(relocatable->Relocate(move.dstTmpAllocation, commandBuffer));
+                ++_counters.relocated;
+            });
+
+        for (auto i = 0u; i < _pass.moveCount; ++i)
+        {
+            if (_pass.pMoves[i].operation == VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE)
+            {
+                ++_counters.ignored;
+            }
+        }
+
+        VkMemoryBarrier2 postCopyBarrier
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_MEMORY_BARRIER_2,
+            .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+            .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+            .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+            .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT
+        };
+        commandBuffer.PipelineBarrier(VkDependencyInfo
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                .memoryBarrierCount = 1,
+                .pMemoryBarriers = &postCopyBarrier
+            });
+    }
+
+    bool Defragmenter::EndPass()
+    {
+        assert(_passOpen);
+
+        for (const auto& replaced : _replaced)
+        {
+            if (replaced.view)
+            {
+                _device->DestroyImageView(replaced.view);
+            }
+            if (replaced.image)
+            {
+                _allocator->DestroyImage(replaced.image);
+            }
+            if (replaced.buffer)
+            {
+                _allocator->DestroyBuffer(replaced.buffer);
+            }
+        }
+        _replaced.clear();
+        _passOpen = false;
+
+        if (_allocator->EndDefragmentationPass(_context, _pass))
+        {
+            End();
+            return true;
+        }
+        return false;
+    }
+}
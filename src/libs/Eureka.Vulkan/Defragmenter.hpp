@@ -0,0 +1,62 @@
+#pragma once
+#include "ResourceAllocator.hpp"
+#include "Relocatable.hpp"
+
+namespace eureka::vulkan
+{
+    struct DefragmenterCounters
+    {
+        uint64_t                  runs{ 0 };
+        uint64_t                  passes{ 0 };
+        uint64_t                  relocated{ 0 };  // allocations copied and rebound
+        uint64_t                  ignored{ 0 };    // moves vma proposed for allocations without a relocatable owner
+        DefragmentationStatistics last_run{};
+        DefragmentationStatistics total{};         // over the completed runs
+    };
+
+    //
+    // Defragmenter
+    // incremental defragmentation of a pool (or the default pools), a pass moves at most the configured bytes /
+    // allocations so the work can be spread over frames
+    //  BeginPass  - vma picks the moves
+    //  RecordPass - every relocatable owner records a copy into handles bound to the new memory and switches to
+    //               them, the commands have to be submitted before any work that uses the new handles
+    //  EndPass    - once the copy and all the work recorded with the old handles completed, the old handles are
+    //               destroyed and vma releases the old memory
+    // allocations without a Relocatable owner stay where they are
+    // not thread safe, owned by the thread recording the copies
+    //
+    class Defragmenter
+    {
+        std::shared_ptr<Device>             _device;
+        std::shared_ptr<ResourceAllocator>  _allocator;
+        DefragmentationLimits               _limits;
+        VmaDefragmentationContext           _context{ nullptr };
+        VmaDefragmentationPassMoveInfo      _pass{};
+        bool                                _passOpen{ false };
+        std::vector<RelocatedHandles>       _replaced;
+        DefragmenterCounters                _counters;
+
+        void End();
+    public:
+        Defragmenter(std::shared_ptr<Device> device, std::shared_ptr<ResourceAllocator> allocator, DefragmentationLimits limits = {});
+        Defragmenter(const Defragmenter&) = delete;
+        Defragmenter& operator=(const Defragmenter&) = delete;
+        // the device must be idle when a run is still going
+        ~Defragmenter();
+
+        // false when the pool can't be defragmented (linear pools)
+        bool Begin(VmaPool pool = nullptr);
+        bool Running() const { return _context != nullptr; }
+        bool PassOpen() const { return _passOpen; }
+
+        // false when nothing was left to move, the run is over then
+        bool BeginPass();
+        void RecordPass(LinearCommandBufferHandle& commandBuffer);
+
+        // true when the run is over
+        bool EndPass();
+
+        const DefragmenterCounters& Counters() const { return _counters; }
+    };
+}
@@ -164,6 +164,11 @@ namespace eureka::vulkan
         return _allocation.set;
     }
 
+    void FreeableDescriptorSet::SetBinding(uint32_t bindingSlot, VkDescriptorType descType, const VkDescriptorBufferInfo& bufferInfo)
+    {
+        DescriptorSetBase::SetBinding(_allocation.set, bindingSlot, descType, bufferInfo);
+    }
+
     void FreeableDescriptorSet::SetBindings(uint32_t startSlot, VkDescriptorType descType, dynamic_cspan<VkDescriptorImageInfo> imageInfos)
     {
         DescriptorSetBase::SetBindings(_allocation.set, startSlot, descType, imageInfos);
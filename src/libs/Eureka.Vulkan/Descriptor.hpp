@@ -45,6 +45,7 @@ namespace eureka::vulkan
         void Allocate(const VkDescriptorSetLayout& layout);
         void Deallocate();
 
+        void SetBinding(uint32_t bindingSlot, VkDescriptorType descType, const VkDescriptorBufferInfo& bufferInfo);
         void SetBindings(uint32_t startSlot, VkDescriptorType descType, dynamic_cspan<VkDescriptorImageInfo> imageInfos);
         VkDescriptorSet Get() const;
         FreeableDescriptorSet& operator=(FreeableDescriptorSet&& rhs) noexcept;
@@ -1,5 +1,7 @@
 #include "DescriptorAllocators.hpp"
 #include "Result.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace eureka::vulkan
 {
@@ -72,5 +74,175 @@ namespace eureka::vulkan
         return DescriptorPool(_device, descriptorPoolCreateInfo);
     }
 
-}
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                        LinearDescriptorAllocator
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    LinearDescriptorAllocator::LinearDescriptorAllocator(std::shared_ptr<Device> device, LinearDescriptorAllocatorConfig config)
+        :
+        _config(std::move(config)),
+        _device(std::move(device)),
+        _nextPoolSets(std::max(_config.initial_sets_per_pool, 1u))
+    {
+
+    }
+
+    VkDescriptorSet LinearDescriptorAllocator::AllocateSet(VkDescriptorSetLayout layout, dcspan<VkDescriptorPoolSize> layoutDescriptors)
+    {
+        // exhausted pools stay exhausted until the reset, only the newest pools are tried
+        for (; _currentPool < _pools.size(); ++_currentPool)
+        {
+            if (auto set = _pools[_currentPool].TryAllocateDescriptorSet(layout))
+            {
+                RecordUsage(layoutDescriptors);
+                return set;
+            }
+        }
+
+        // the observed shape may miss types of layouts not seen yet, fall back to the configured ones
+        auto multipliers = _config.multipliers;
+        for (const auto& [type, multiplier] : _observedMultipliers)
+        {
+            auto it = std::ranges::find(multipliers, type, &DescriptorTypeMultiplier::type);
+            if (it == multipliers.end())
+            {
+                multipliers.emplace_back(DescriptorTypeMultiplier{ .type = type, .multiplier = multiplier });
+            }
+            else
+            {
+                it->multiplier = std::max(it->multiplier, multiplier);
+            }
+        }
+
+        auto& pool = AddPool(_nextPoolSets, multipliers);
+        _currentPool = _pools.size() - 1;
+        _nextPoolSets = static_cast<uint32_t>(static_cast<float>(_nextPoolSets) * _config.growth_factor);
+
+        auto set = pool.TryAllocateDescriptorSet(layout);
+        if (!set)
+        {
+            throw ResultError(VkResult::VK_ERROR_OUT_OF_POOL_MEMORY, "descriptor set layout does not fit an empty pool");
+        }
+
+        RecordUsage(layoutDescriptors);
+        return set;
+    }
+
+    void LinearDescriptorAllocator::Reset()
+    {
+        ++_resets;
+
+        if (_sets)
+        {
+            _observedMultipliers.clear();
+            for (const auto& [type, count] : _descriptors)
+            {
+                _observedMultipliers.emplace_back(DescriptorTypeMultiplier
+                    {
+                        .type = type,
+                        .multiplier = static_cast<float>(count) / static_cast<float>(_sets)
+                    });
+            }
+        }
+
+        if (_pools.size() > 1)
+        {
+            // the frame outgrew its pools, replace them with a single pool that fits the whole frame
+            auto sets = std::max(static_cast<uint32_t>(std::ceil(static_cast<float>(_sets) * _config.headroom)), _config.initial_sets_per_pool);
+
+            _pools.clear();
+            _poolSets.clear();
+            AddPool(sets, _observedMultipliers);
+            _nextPoolSets = static_cast<uint32_t>(static_cast<float>(sets) * _config.growth_factor);
+            ++_consolidations;
+        }
+        else if (!_pools.empty() && _sets)
+        {
+            _pools.front().Reset();
+        }
+
+        _currentPool = 0;
+        _sets = 0;
+        _descriptors.clear();
+    }
+
+    LinearDescriptorAllocatorCounters LinearDescriptorAllocator::Counters() const
+    {
+        uint64_t capacity = 0;
+        for (auto poolSets : _poolSets)
+        {
+            capacity += poolSets;
+        }
+
+        return LinearDescriptorAllocatorCounters
+        {
+            .sets = _sets,
+            .pools = _pools.size(),
+            .pool_sets_capacity = capacity,
+            .resets = _resets,
+            .consolidations = _consolidations
+        };
+    }
+
+    void LinearDescriptorAllocator::RecordUsage(dcspan<VkDescriptorPoolSize> layoutDescriptors)
+    {
+        ++_sets;
+
+        auto accumulate = [this](VkDescriptorType type, uint32_t count)
+        {
+            auto it = std::ranges::find(_descriptors, type, &VkDescriptorPoolSize::type);
+            if (it == _descriptors.end())
+            {
+                _descriptors.emplace_back(VkDescriptorPoolSize{ .type = type, .descriptorCount = count });
+            }
+            else
+            {
+                it->descriptorCount += count;
+            }
+        };
+
+        if (layoutDescriptors.empty())
+        {
+            for (const auto& [type, multiplier] : _config.multipliers)
+            {
+                accumulate(type, static_cast<uint32_t>(std::ceil(multiplier)));
+            }
+        }
+        else
+        {
+            for (const auto& layoutDescriptor : layoutDescriptors)
+            {
+                accumulate(layoutDescriptor.type, layoutDescriptor.descriptorCount);
+            }
+        }
+    }
+
+    DescriptorPool& LinearDescriptorAllocator::AddPool(uint32_t maxSets, const std::vector<DescriptorTypeMultiplier>& multipliers)
+    {
+        std::vector<VkDescriptorPoolSize> perTypeMaxCount;
+        perTypeMaxCount.reserve(multipliers.size());
+
+        for (const auto& [type, multiplier] : multipliers)
+        {
+            auto count = static_cast<uint32_t>(std::ceil(static_cast<float>(maxSets) * multiplier));
+            if (count)
+            {
+                perTypeMaxCount.emplace_back(VkDescriptorPoolSize{ .type = type, .descriptorCount = count });
+            }
+        }
+
+        VkDescriptorPoolCreateInfo descriptorPoolCreateInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+            .flags = 0, // no individual frees, the pool is reset at once
+            .maxSets = maxSets,
+            .poolSizeCount = static_cast<uint32_t>(perTypeMaxCount.size()),
+            .pPoolSizes = perTypeMaxCount.data()
+        };
 
+        _poolSets.emplace_back(maxSets);
+        return _pools.emplace_back(_device, descriptorPoolCreateInfo);
+    }
+}
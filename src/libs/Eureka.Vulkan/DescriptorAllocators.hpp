@@ -61,5 +61,64 @@ namespace eureka::vulkan
 
 
     };
-}
 
+    struct LinearDescriptorAllocatorConfig
+    {
+        uint32_t initial_sets_per_pool = 64;
+        float    growth_factor = 2.f;   // a pool added when the frame ran out is that much larger than the previous one
+        float    headroom = 1.25f;      // a consolidated pool holds the observed frame usage times the headroom
+        std::vector<DescriptorTypeMultiplier> multipliers = DEFAULT_DESCRIPTOR_POOL_MULTIPLIERS; // descriptors per set, until usage was observed
+    };
+
+    struct LinearDescriptorAllocatorCounters
+    {
+        uint64_t sets{ 0 };                // allocated since the last reset
+        uint64_t pools{ 0 };               // pools currently owned
+        uint64_t pool_sets_capacity{ 0 };  // max sets of the owned pools
+        uint64_t resets{ 0 };
+        uint64_t consolidations{ 0 };      // resets that replaced several pools with a single one
+    };
+
+    class LinearDescriptorAllocator
+    {
+        // a per frame descriptor allocator.
+        // - sets are never freed individually, Reset() recycles all of them with a pool reset.
+        // - running out adds a larger pool, on the following Reset() the pools are replaced by a single pool
+        //   sized by the usage observed during the frame (sets and descriptors per type), so a steady frame
+        //   allocates from one pool and resets with a single call.
+        // - descriptors per set are only known for allocations that pass the layout's descriptor counts,
+        //   other allocations are accounted with the configured multipliers.
+        // - not thread safe - allocations must be externally synchronized
+    private:
+        LinearDescriptorAllocatorConfig   _config;
+        std::shared_ptr<Device>           _device;
+        std::vector<DescriptorPool>       _pools;
+        std::vector<uint32_t>             _poolSets;
+        std::size_t                       _currentPool{ 0 };
+        uint32_t                          _nextPoolSets{ 0 };
+
+        // since the last reset
+        uint64_t                          _sets{ 0 };
+        std::vector<VkDescriptorPoolSize> _descriptors;
+        // per set descriptor counts the next consolidated pool is sized with
+        std::vector<DescriptorTypeMultiplier> _observedMultipliers;
+
+        uint64_t                          _resets{ 0 };
+        uint64_t                          _consolidations{ 0 };
+
+        void RecordUsage(dcspan<VkDescriptorPoolSize> layoutDescriptors);
+        DescriptorPool& AddPool(uint32_t maxSets, const std::vector<DescriptorTypeMultiplier>& multipliers);
+    public:
+        LinearDescriptorAllocator(std::shared_ptr<Device> device, LinearDescriptorAllocatorConfig config = {});
+        LinearDescriptorAllocator(LinearDescriptorAllocator&&) = default;
+        LinearDescriptorAllocator& operator=(LinearDescriptorAllocator&&) = default;
+
+        // the set is valid until the next Reset()
+        VkDescriptorSet AllocateSet(VkDescriptorSetLayout layout, dcspan<VkDescriptorPoolSize> layoutDescriptors = {});
+
+        // frees every set, the command buffers that used them must have completed
+        void Reset();
+
+        LinearDescriptorAllocatorCounters Counters() const;
+    };
+}
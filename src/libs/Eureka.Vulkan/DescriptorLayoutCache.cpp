@@ -25,6 +25,17 @@ namespace eureka::vulkan
                 .stageFlags = VkShaderStageFlagBits::VK_SHADER_STAGE_FRAGMENT_BIT,
             });
             break;
+        case DescriptorSet0PresetType::ePoseGraphStorage:
+            for (auto binding = 0u; binding < 3u; ++binding)
+            {
+                _bindings.emplace_back(VkDescriptorSetLayoutBinding {
+                    .binding = binding,
+                    .descriptorType = VkDescriptorType::VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                    .descriptorCount = 1,
+                    .stageFlags = VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT,
+                });
+            }
+            break;
         default:
             throw std::invalid_argument("bad");
         }
@@ -50,7 +61,7 @@ namespace eureka::vulkan
     {
         // TODO iterate over enums
 
-        for(auto preset : {DescriptorSet0PresetType::ePerViewUniform, DescriptorSet0PresetType::eSingleTexture})
+        for(auto preset : {DescriptorSet0PresetType::ePerViewUniform, DescriptorSet0PresetType::eSingleTexture, DescriptorSet0PresetType::ePoseGraphStorage})
         {
             DescriptorSetLayoutPreset presetVal(preset);
 
@@ -13,7 +13,8 @@ namespace eureka::vulkan
     enum class DescriptorSet0PresetType
     {
         ePerViewUniform, // MVP
-        eSingleTexture // all shaders use the same first texture
+        eSingleTexture, // all shaders use the same first texture
+        ePoseGraphStorage // poses, edges meta, edges data storage buffers
     };
 
     static constexpr uint64_t MAX_SET_SLOTS = 4;
@@ -32,6 +32,11 @@ namespace eureka::vulkan
         return *this;
     }
 
+    void DescriptorPool::Reset()
+    {
+        _device->ResetDescriptorPool(_pool);
+    }
+
     VkDescriptorSet DescriptorPool::AllocateDescriptorSet(const VkDescriptorSetLayout& layout)
     {
         VkDescriptorSetAllocateInfo allocInfo {
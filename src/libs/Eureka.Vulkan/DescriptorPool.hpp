@@ -18,6 +18,8 @@ namespace eureka::vulkan
         DescriptorPool& operator=(DescriptorPool&& rhs) noexcept;
         ~DescriptorPool();
         VkDescriptorPool Get() const { return _pool; }
+        // frees every set allocated from the pool
+        void Reset();
 
         VkDescriptorSet AllocateDescriptorSet(const VkDescriptorSetLayout& layout);
         VkDescriptorSet TryAllocateDescriptorSet(const VkDescriptorSetLayout& layout);
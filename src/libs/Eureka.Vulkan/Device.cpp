@@ -93,6 +93,30 @@ namespace eureka::vulkan
         return supportedLayers;
     }
 
+    std::vector<const char*> FilterDeviceSupportedExtensions(VkPhysicalDevice physicalDevice, dcspan<const char*> optionalExtensions)
+    {
+        uint32_t propertyCount = 0;
+        VK_CHECK(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &propertyCount, nullptr));
+        std::vector<VkExtensionProperties> extentionProperties(propertyCount);
+        VK_CHECK(vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &propertyCount, extentionProperties.data()));
+
+        std::vector<const char*> supportedExtensions;
+        for (const auto& optionalExtension : optionalExtensions)
+        {
+            for (const auto& availableExtention : extentionProperties)
+            {
+                std::string_view availableExtentionName(availableExtention.extensionName);
+                if (availableExtentionName == optionalExtension)
+                {
+                    supportedExtensions.emplace_back(optionalExtension);
+                    break;
+                }
+            }
+        }
+
+        return supportedExtensions;
+    }
+
     std::string to_string(VkPhysicalDeviceType deviceType) // 
     {
         std::string str;
@@ -131,7 +155,13 @@ namespace eureka::vulkan
 
         auto createDesc = MakeDeviceCreationDesc(config);
 
+        // block compressed textures are enabled whenever the device has them, the loaders pick the format at runtime
+        VkPhysicalDeviceFeatures supportedFeatures{};
+        vkGetPhysicalDeviceFeatures(_physicalDevice, &supportedFeatures);
+
         VkPhysicalDeviceFeatures deviceFeatures{ };
+        deviceFeatures.textureCompressionBC = supportedFeatures.textureCompressionBC;
+        deviceFeatures.textureCompressionASTC_LDR = supportedFeatures.textureCompressionASTC_LDR;
         
         void* deviceCreateInfoNext = nullptr;
         VkPhysicalDeviceVulkan12Features features12{};
@@ -160,6 +190,13 @@ namespace eureka::vulkan
 
         auto supportedLayers = FilterDeviceSupportedLayers(_physicalDevice, config.optional_layers);
 
+        _enabledExtentions = config.required_extentions;
+        for (auto optionalExtention : FilterDeviceSupportedExtensions(_physicalDevice, config.optional_extentions))
+        {
+            DEBUGGER_TRACE("enabling optional device extention = {}", optionalExtention);
+            _enabledExtentions.emplace_back(optionalExtention);
+        }
+
         VkDeviceCreateInfo deviceCreateInfo
         {
             .sType = VkStructureType::VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
@@ -169,8 +206,8 @@ namespace eureka::vulkan
             .pQueueCreateInfos = createDesc.queue_create_info.data(),
             .enabledLayerCount = static_cast<uint32_t>(supportedLayers.size()),
             .ppEnabledLayerNames = supportedLayers.data(),
-            .enabledExtensionCount = static_cast<uint32_t>(config.required_extentions.size()),
-            .ppEnabledExtensionNames = config.required_extentions.data(),
+            .enabledExtensionCount = static_cast<uint32_t>(_enabledExtentions.size()),
+            .ppEnabledExtensionNames = _enabledExtentions.data(),
             .pEnabledFeatures = &deviceFeatures
         };
 
@@ -179,11 +216,15 @@ namespace eureka::vulkan
         VK_CHECK(vkCreateDevice(_physicalDevice, &deviceCreateInfo, nullptr, &_logicalDevice));
 
         volkLoadDevice(_logicalDevice);
+        _enabledFeatures = deviceFeatures;
         
         if (_apiVersion.Major() >= 1 && _apiVersion.Minor() < 3)
         {
             EUREKA_VULKAN_REPLACE_WITH_KHR(vkCmdPipelineBarrier2);
             EUREKA_VULKAN_REPLACE_WITH_KHR(vkCmdCopyBufferToImage2);
+            EUREKA_VULKAN_REPLACE_WITH_KHR(vkCmdCopyBuffer2);
+            EUREKA_VULKAN_REPLACE_WITH_KHR(vkCmdCopyImage2);
+            EUREKA_VULKAN_REPLACE_WITH_KHR(vkCmdBlitImage2);
         }
 
         _preferredGraphicsFamily = createDesc.graphics_family;
@@ -512,8 +553,13 @@ namespace eureka::vulkan
     dspan<const char*> Device::EnabledExtentions() const
     {
         // that const cast is OK I guess
-        auto ptr = const_cast<const char**>(_config.required_extentions.data());
-        return dspan<const char*>(ptr, _config.required_extentions.size());
+        auto ptr = const_cast<const char**>(_enabledExtentions.data());
+        return dspan<const char*>(ptr, _enabledExtentions.size());
+    }
+
+    bool Device::IsExtentionEnabled(std::string_view extention) const
+    {
+        return std::ranges::any_of(_enabledExtentions, [extention](const char* enabled) { return extention == enabled; });
     }
 
     std::string_view Device::GetPrettyName() const
@@ -634,13 +680,31 @@ namespace eureka::vulkan
         return _physicalDevice;
     }
 
-    VkPipelineCache Device::CreatePipelineCache() const
+    VkPhysicalDeviceProperties Device::GetPhysicalDeviceProperties() const
+    {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(_physicalDevice, &properties);
+        return properties;
+    }
+
+    bool Device::IsSampledImageFormatSupported(VkFormat format) const
+    {
+        VkFormatProperties properties{};
+        vkGetPhysicalDeviceFormatProperties(_physicalDevice, format, &properties);
+
+        constexpr VkFormatFeatureFlags REQUIRED = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+        return (properties.optimalTilingFeatures & REQUIRED) == REQUIRED;
+    }
+
+    VkPipelineCache Device::CreatePipelineCache(dynamic_cspan<uint8_t> initialData) const
     {
         VkPipelineCache result{};
 
         VkPipelineCacheCreateInfo createInfo
         {
-            .sType = VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+            .initialDataSize = initialData.size(),
+            .pInitialData = initialData.data()
         };
 
         VK_CHECK(vkCreatePipelineCache(_logicalDevice, &createInfo, nullptr, &result));
@@ -648,6 +712,18 @@ namespace eureka::vulkan
         return result;
     }
 
+    std::vector<uint8_t> Device::GetPipelineCacheData(VkPipelineCache pipelineCache) const
+    {
+        std::size_t size{ 0 };
+        VK_CHECK(vkGetPipelineCacheData(_logicalDevice, pipelineCache, &size, nullptr));
+
+        std::vector<uint8_t> data(size);
+        VK_CHECK(vkGetPipelineCacheData(_logicalDevice, pipelineCache, &size, data.data()));
+        data.resize(size);
+
+        return data;
+    }
+
     void Device::DestroyPipelineCache(VkPipelineCache pipelineCache) const
     {
         vkDestroyPipelineCache(_logicalDevice, pipelineCache, nullptr);
@@ -720,6 +796,21 @@ namespace eureka::vulkan
         return result;
     }
 
+    VkCommandBuffer Device::AllocateSecondaryCommandBuffer(VkCommandPool commandPool) const
+    {
+        VkCommandBufferAllocateInfo allocationInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = commandPool,
+            .level = VkCommandBufferLevel::VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1
+        };
+
+        VkCommandBuffer result{};
+        VK_CHECK(vkAllocateCommandBuffers(_logicalDevice, &allocationInfo, &result));
+        return result;
+    }
+
     void Device::DestroyFrameBuffer(VkFramebuffer frameBuffer) const
     {
         vkDestroyFramebuffer(_logicalDevice, frameBuffer, nullptr);
@@ -760,6 +851,11 @@ namespace eureka::vulkan
         vkDestroyDescriptorPool(_logicalDevice, pool, nullptr);
     }
 
+    void Device::ResetDescriptorPool(VkDescriptorPool pool) const
+    {
+        VK_CHECK(vkResetDescriptorPool(_logicalDevice, pool, 0));
+    }
+
     VkDescriptorSet Device::AllocateDescriptorSet(const VkDescriptorSetAllocateInfo& allocInfo) const
     {
         assert(allocInfo.descriptorSetCount == 1);
@@ -870,6 +966,9 @@ namespace eureka::vulkan
         deviceConfig.required_extentions.emplace_back("VK_KHR_synchronization2");
         deviceConfig.required_extentions.emplace_back("VK_KHR_copy_commands2");
 
+        // lets the allocator track the heap budgets of the whole process
+        deviceConfig.optional_extentions.emplace_back(DEVICE_EXTENTION_MEMORY_BUDGET);
+
  
         //deviceConfig.required_layers.emplace_back("VK_LAYER_KHRONOS_synchronization2");
         //deviceConfig.required_layers.emplace_back(DEVICE_LAYER_PRE13_SYNCHRONIZATION2);
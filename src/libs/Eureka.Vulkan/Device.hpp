@@ -22,11 +22,13 @@ namespace eureka::vulkan
     inline constexpr char DEVICE_LAYER_PRE13_SYNCHRONIZATION2[] = "VK_LAYER_KHRONOS_synchronization2";
     inline constexpr char DEVICE_EXTENTION_PRE13_SYNCHRONIZATION2[] = "VK_KHR_synchronization2";
     inline constexpr char DEVICE_EXTENTION_SWAPCHAIN[] = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+    inline constexpr char DEVICE_EXTENTION_MEMORY_BUDGET[] = VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
     
     struct DeviceConfig
     {
         std::vector<const char*> optional_layers;
         std::vector<const char*> required_extentions;
+        std::vector<const char*> optional_extentions;  // enabled when the chosen device supports them
         VkSurfaceKHR             presentation_surface; // optional
         Version                  min_version = Version(VK_API_VERSION_1_2);
         uint32_t                 preferred_number_of_graphics_queues{ 1 };
@@ -73,12 +75,14 @@ namespace eureka::vulkan
     class Device
     {
         DeviceConfig                           _config;
+        std::vector<const char*>               _enabledExtentions;
         Version                                _apiVersion;
         std::string                            _prettyName;
         std::shared_ptr<Instance>              _instance{};
 
         VkPhysicalDevice                       _physicalDevice{};
         VkDevice                               _logicalDevice{};
+        VkPhysicalDeviceFeatures               _enabledFeatures{};
 
         uint32_t                               _preferredGraphicsFamily{};
         uint32_t                               _preferredComputeFamily{};
@@ -103,9 +107,14 @@ namespace eureka::vulkan
         Device& operator=(const Device&) = delete;
         Version GetApiVersion() const { return _apiVersion; }
         dspan<const char*> EnabledExtentions() const;
+        bool IsExtentionEnabled(std::string_view extention) const;
         std::string_view GetPrettyName() const;
         VkDevice GetDevice() const;
         VkPhysicalDevice GetPhysicalDevice() const;
+        VkPhysicalDeviceProperties GetPhysicalDeviceProperties() const;
+        const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return _enabledFeatures; }
+        // optimal tiling images of the format can be sampled and copied into
+        bool IsSampledImageFormatSupported(VkFormat format) const;
         Queue GetGraphicsQueue();
         Queue GetComputeQueue();
         Queue GetCopyQueue();
@@ -125,7 +134,8 @@ namespace eureka::vulkan
         std::vector<VkImage> GetSwapchainImages(VkSwapchainKHR swapchain) const;
         SwapChainImageAquisition AcquireNextSwapChainImage(VkSwapchainKHR swapchain, uint64_t timeout, VkSemaphore imageReady, VkFence fence) const;
         void DestroySwapChain(VkSwapchainKHR _swapchain) const;
-        VkPipelineCache CreatePipelineCache() const;
+        VkPipelineCache CreatePipelineCache(dynamic_cspan<uint8_t> initialData = {}) const;
+        std::vector<uint8_t> GetPipelineCacheData(VkPipelineCache pipelineCache) const;
         void DestroyPipelineCache(VkPipelineCache pipelineCache) const;
         VkShaderModule CreateShaderModule(const VkShaderModuleCreateInfo& shaderModuleCreateInfo) const;
         void DestroyShaderModule(VkShaderModule shaderModule) const;
@@ -133,6 +143,7 @@ namespace eureka::vulkan
         void ResetCommandPool(VkCommandPool commandPool) const;
         void DestroyCommandPool(VkCommandPool commandPool) const;
         VkCommandBuffer AllocatePrimaryCommandBuffer(VkCommandPool commandPool) const;
+        VkCommandBuffer AllocateSecondaryCommandBuffer(VkCommandPool commandPool) const;
         void DestroyRenderPass(VkRenderPass renderPass) const;
         VkRenderPass CreateRenderPass(const VkRenderPassCreateInfo& renderPassCreateInfo) const;
         VkFramebuffer CreateFrameBuffer(const VkFramebufferCreateInfo& framebufferCreateInfo) const;
@@ -142,6 +153,7 @@ namespace eureka::vulkan
         void UpdateDescriptorSet(dynamic_cspan<VkWriteDescriptorSet> writeDescriptorSet) const;
         VkDescriptorPool CreateDescriptorPool(const VkDescriptorPoolCreateInfo& descriptorPoolCreateInfo) const;
         void DestroyDescriptorPool(VkDescriptorPool pool) const;
+        void ResetDescriptorPool(VkDescriptorPool pool) const;
         void FreeDescriptorSet(VkDescriptorPool pool, VkDescriptorSet set) const;
         VkDescriptorSet AllocateDescriptorSet(const VkDescriptorSetAllocateInfo& allocInfo) const;
         VkDescriptorSet TryAllocateDescriptorSet(const VkDescriptorSetAllocateInfo& allocInfo) const;
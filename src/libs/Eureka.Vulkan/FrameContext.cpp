@@ -115,8 +115,12 @@ namespace eureka::vulkan
     {
         if (!_usedCommandBuffers.empty())
         {
-            _device->WaitForFences(_usedDoneFencesHandles);
-            _device->ResetFences(_usedDoneFencesHandles);
+            // one shot command buffers carry no fence, the owner waited on their submission timeline
+            if (!_usedDoneFencesHandles.empty())
+            {
+                _device->WaitForFences(_usedDoneFencesHandles);
+                _device->ResetFences(_usedDoneFencesHandles);
+            }
             _pool.Reset();
 
             std::ranges::move(_usedCommandBuffers, std::back_inserter(_availableCommandBuffers));
@@ -132,24 +136,65 @@ namespace eureka::vulkan
 
     }
 
+    SecondaryCommands::SecondaryCommands(std::shared_ptr<Device> device, Queue queue) :
+        _pool(std::move(device), queue.Family())
+    {
+
+    }
+
+    LinearCommandBufferHandle SecondaryCommands::NewCommandBuffer()
+    {
+        if (_used == _commandBuffers.size())
+        {
+            _commandBuffers.emplace_back(_pool.AllocateSecondaryCommandBuffer());
+        }
+
+        return _commandBuffers[_used++];
+    }
+
+    void SecondaryCommands::Reset()
+    {
+        if (_used)
+        {
+            _pool.Reset();
+            _used = 0;
+        }
+    }
+
     FrameContext::FrameContext(
         std::shared_ptr<Device> device,
         Queue copyQueue,
-        Queue graphicsQueue
+        Queue graphicsQueue,
+        FrameContextConfig config
     ) :
         _device(std::move(device)),
         _copyQueue(copyQueue),
-        _graphicsQueue(graphicsQueue)
+        _graphicsQueue(graphicsQueue),
+        _graphicsSubmissions(std::make_shared<SubmissionTracker>(_device, _graphicsQueue)),
+        _copySubmissions(std::make_shared<SubmissionTracker>(_device, _copyQueue))
     {
         //_maxFramesInFlight = _swapChain->ImageCount();
 
+        _frameGraphicsSubmissionsValue.resize(_maxFramesInFlight, 0);
+        _frameCopySubmissionsValue.resize(_maxFramesInFlight, 0);
+
 
         // init commands
         for (auto i = 0u; i < _maxFramesInFlight; ++i)
         {
             _frameGraphicsCommands.emplace_back(_device, _graphicsQueue);
             _frameCopyCommands.emplace_back(_device, _copyQueue);
+
+            auto& secondaryCommands = _frameGraphicsSecondaryCommands.emplace_back();
+            for (auto slot = 0u; slot < std::max(config.secondary_command_slots, 1u); ++slot)
+            {
+                secondaryCommands.emplace_back(_device, _graphicsQueue);
+            }
+
+            _frameDescriptorAllocators.emplace_back(_device, config.frame_descriptors);
         }
+        _currentFrameGraphicsSecondaryCommands = &_frameGraphicsSecondaryCommands[_currentFrame];
+        _currentFrameDescriptorAllocator = &_frameDescriptorAllocators[_currentFrame];
 
         //bool found = false;
         //vk::Format depthFormat = DEFAULT_DEPTH_BUFFER_FORMAT;
@@ -191,12 +236,30 @@ namespace eureka::vulkan
     {
         _currentFrameGraphicsCommands = &_frameGraphicsCommands[_currentFrame];
         _currentFrameCopyCommands = &_frameCopyCommands[_currentFrame];
+        _currentFrameGraphicsSecondaryCommands = &_frameGraphicsSecondaryCommands[_currentFrame];
+        _currentFrameDescriptorAllocator = &_frameDescriptorAllocators[_currentFrame];
+
+        // flushes submissions still batched from that frame
+        _graphicsSubmissions->Wait(_frameGraphicsSubmissionsValue[_currentFrame]);
+        _copySubmissions->Wait(_frameCopySubmissionsValue[_currentFrame]);
+
         _currentFrameGraphicsCommands->Reset();
         _currentFrameCopyCommands->Reset();
+
+        // executed by the graphics commands waited on above
+        for (auto& secondaryCommands : *_currentFrameGraphicsSecondaryCommands)
+        {
+            secondaryCommands.Reset();
+        }
+        _currentFrameDescriptorAllocator->Reset();
     }
 
     void FrameContext::BeginFrame()
     {
+        // everything enqueued up to here may use command buffers of the frame being left
+        _frameGraphicsSubmissionsValue[_currentFrame] = _graphicsSubmissions->EnqueuedValue();
+        _frameCopySubmissionsValue[_currentFrame] = _copySubmissions->EnqueuedValue();
+
         _currentFrame = (_currentFrame + 1) % _maxFramesInFlight;
         SyncCurrentFrame();
     }
@@ -221,6 +284,11 @@ namespace eureka::vulkan
         return _currentFrameCopyCommands->NewSubmitCommandBuffer();
     }
 
+    LinearCommandBufferHandle FrameContext::NewGraphicsSecondaryCommandBuffer(uint32_t slot)
+    {
+        return _currentFrameGraphicsSecondaryCommands->at(slot).NewCommandBuffer();
+    }
+
     VkFence FrameContext::NewGraphicsSubmitFence()
     {
         return _currentFrameGraphicsCommands->NewSubmitFence();
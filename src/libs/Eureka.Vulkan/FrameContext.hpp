@@ -1,6 +1,8 @@
 #pragma once
 #include "../Eureka.Vulkan/Commands.hpp"
 #include "../Eureka.Vulkan/Synchronization.hpp"
+#include "../Eureka.Vulkan/SubmissionTracker.hpp"
+#include "../Eureka.Vulkan/DescriptorAllocators.hpp"
 
 namespace eureka::vulkan
 {
@@ -10,6 +12,12 @@ namespace eureka::vulkan
         uint64_t preallocated_command_buffers = 5;
     };
 
+    struct FrameContextConfig
+    {
+        uint32_t secondary_command_slots{ 4 }; // graphics secondary command pools per frame, one recording thread per slot at a time
+        LinearDescriptorAllocatorConfig frame_descriptors{};
+    };
+
     struct SubmitCommandBuffer
     {
         LinearCommandBufferHandle command_buffer;
@@ -67,6 +75,25 @@ namespace eureka::vulkan
 
 
 
+    //
+    // SecondaryCommands
+    // secondary command buffers of a {Frame, slot}, the pool is owned by a single recording thread at a time
+    // buffers are reused across frames, Reset() once the frame's primary command buffers completed
+    //
+    class SecondaryCommands
+    {
+        LinearCommandPool                      _pool;
+        std::vector<LinearCommandBufferHandle> _commandBuffers;
+        std::size_t                            _used{ 0 };
+    public:
+        SecondaryCommands(SecondaryCommands&& that) = default;
+        SecondaryCommands& operator=(SecondaryCommands&& rhs) = default;
+        SecondaryCommands(std::shared_ptr<Device> device, Queue queue);
+
+        LinearCommandBufferHandle NewCommandBuffer();
+        void Reset();
+    };
+
     class FrameContext
     {
     private:
@@ -75,17 +102,29 @@ namespace eureka::vulkan
         Queue                                       _graphicsQueue;
         std::vector<FrameCommands>                  _frameGraphicsCommands;
         std::vector<FrameCommands>                  _frameCopyCommands;
+        std::vector<std::vector<SecondaryCommands>> _frameGraphicsSecondaryCommands; // [frame][slot]
+        std::vector<LinearDescriptorAllocator>      _frameDescriptorAllocators;
 
         uint32_t                                    _maxFramesInFlight{ 2 };
         uint32_t                                    _currentFrame{ 1 };
 
         FrameCommands*                              _currentFrameGraphicsCommands{ nullptr };
         FrameCommands*                              _currentFrameCopyCommands{ nullptr };
+        std::vector<SecondaryCommands>*             _currentFrameGraphicsSecondaryCommands{ nullptr };
+        LinearDescriptorAllocator*                  _currentFrameDescriptorAllocator{ nullptr };
+
+        // one shot submissions are tracked on per queue timelines instead of per submit fences
+        // a frame's command buffers are recycled once the timelines reached the values enqueued during that frame
+        std::shared_ptr<SubmissionTracker>          _graphicsSubmissions;
+        std::shared_ptr<SubmissionTracker>          _copySubmissions;
+        std::vector<uint64_t>                       _frameGraphicsSubmissionsValue;
+        std::vector<uint64_t>                       _frameCopySubmissionsValue;
     public:
         FrameContext(
             std::shared_ptr<Device> device,
             Queue copyQueue,
-            Queue graphicsQueue
+            Queue graphicsQueue,
+            FrameContextConfig config = {}
         );
         ~FrameContext();
         void SyncCurrentFrame();
@@ -94,8 +133,21 @@ namespace eureka::vulkan
         PresentCommandBuffer NewGraphicsPresentCommandBuffer();
         SubmitCommandBuffer NewGraphicsCommandBuffer();
         SubmitCommandBuffer NewCopyCommandBuffer();
+
+        // may be called concurrently for different slots, the buffer is executed by the frame's graphics commands
+        LinearCommandBufferHandle NewGraphicsSecondaryCommandBuffer(uint32_t slot);
+        // sets live until the frame is begun again, not thread safe - recording threads must synchronize
+        LinearDescriptorAllocator& FrameDescriptorAllocator() { return *_currentFrameDescriptorAllocator; }
+
+        // index of the frame being recorded, its previous use completed when the frame was begun
+        uint32_t FrameIndex() const { return _currentFrame; }
+        uint32_t MaxFramesInFlight() const { return _maxFramesInFlight; }
+
+        uint32_t SecondaryCommandSlots() const { return static_cast<uint32_t>(_currentFrameGraphicsSecondaryCommands->size()); }
         VkFence NewGraphicsSubmitFence();
         VkFence NewCopySubmitFence();
+        SubmissionTracker& GraphicsSubmissions() { return *_graphicsSubmissions; }
+        SubmissionTracker& CopySubmissions() { return *_copySubmissions; }
     };
 
 }
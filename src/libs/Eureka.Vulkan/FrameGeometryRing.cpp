@@ -0,0 +1,110 @@
+#include "FrameGeometryRing.hpp"
+#include <assert.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+namespace eureka::vulkan
+{
+    namespace
+    {
+        // keeps every frame's sub range start aligned for any allocation alignment we hand out
+        inline constexpr uint64_t FRAME_SUB_RANGE_ALIGNMENT = 256;
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    FrameGeometryRing::FrameGeometryRing(std::shared_ptr<ResourceAllocator> allocator, uint32_t framesInFlight, FrameGeometryRingConfig config)
+        :
+        _allocator(std::move(allocator)),
+        _framesInFlight(framesInFlight),
+        _frameByteSize(AlignUp(std::max<uint64_t>(config.initial_frame_byte_size, 1), FRAME_SUB_RANGE_ALIGNMENT))
+    {
+        if (_framesInFlight == 0)
+        {
+            throw std::invalid_argument("frame geometry ring requires at least one frame in flight");
+        }
+
+        _allocation = _allocator->AllocateBuffer(_frameByteSize * _framesInFlight, BufferAllocationPreset::eHostWriteCombinedVertexAndIndexBuffer);
+        assert(_allocation.ptr);
+    }
+
+    FrameGeometryRing::~FrameGeometryRing()
+    {
+        // the owner waited for the device before releasing the ring
+        for (const auto& retired : _retired)
+        {
+            _allocator->DeallocateBuffer(retired.allocation);
+        }
+        _allocator->DeallocateBuffer(_allocation);
+    }
+
+    void FrameGeometryRing::BeginFrame(uint32_t frameIndex)
+    {
+        assert(frameIndex < _framesInFlight);
+
+        _frame = frameIndex;
+        _frameFront = 0;
+        ++_begins;
+
+        // a buffer outgrown during begin N is read by frames up to N, each of them was begun again by N + frames in flight
+        std::erase_if(_retired, [this](const RetiredBuffer& retired)
+            {
+                if (retired.release_at_begin > _begins)
+                {
+                    return false;
+                }
+                _allocator->DeallocateBuffer(retired.allocation);
+                return true;
+            });
+    }
+
+    FrameGeometryAllocation FrameGeometryRing::Allocate(uint64_t byteSize, uint64_t alignment)
+    {
+        assert(alignment && (alignment & (alignment - 1)) == 0 && alignment <= FRAME_SUB_RANGE_ALIGNMENT);
+
+        auto offset = AlignUp(_frameFront, alignment);
+        if (offset + byteSize > _frameByteSize)
+        {
+            // allocations already made this frame keep pointing into the outgrown buffer
+            Grow(byteSize);
+            offset = 0;
+        }
+        _frameFront = offset + byteSize;
+
+        return FrameGeometryAllocation
+        {
+            .memory = _allocation,
+            .offset = _frame * _frameByteSize + offset,
+            .byte_size = byteSize
+        };
+    }
+
+    void FrameGeometryRing::Flush(const FrameGeometryAllocation& allocation)
+    {
+        if (allocation.byte_size)
+        {
+            _allocator->FlushBufferRange(allocation.memory, allocation.offset, allocation.byte_size);
+        }
+    }
+
+    void FrameGeometryRing::Grow(uint64_t requiredFrameByteSize)
+    {
+        auto frameByteSize = _frameByteSize;
+        while (frameByteSize < requiredFrameByteSize)
+        {
+            frameByteSize *= 2;
+        }
+        frameByteSize = AlignUp(std::max(frameByteSize, _frameByteSize * 2), FRAME_SUB_RANGE_ALIGNMENT);
+
+        auto allocation = _allocator->AllocateBuffer(frameByteSize * _framesInFlight, BufferAllocationPreset::eHostWriteCombinedVertexAndIndexBuffer);
+        assert(allocation.ptr);
+
+        _retired.emplace_back(RetiredBuffer{ .allocation = _allocation, .release_at_begin = _begins + _framesInFlight });
+        _allocation = allocation;
+        _frameByteSize = frameByteSize;
+        _frameFront = 0;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "ResourceAllocator.hpp"
+#include <vector>
+
+namespace eureka::vulkan
+{
+    // covers uint16 / uint32 indices and every vertex layout we stream
+    inline constexpr uint64_t FRAME_GEOMETRY_RING_DEFAULT_ALIGNMENT = 16;
+
+    struct FrameGeometryRingConfig
+    {
+        uint64_t initial_frame_byte_size{ 1024 * 1024 }; // sub range of each frame in flight, doubled when a frame outgrows it
+    };
+
+    struct FrameGeometryAllocation
+    {
+        BufferAllocation memory{};     // the ring buffer the bytes live in
+        uint64_t         offset{ 0 };  // byte offset inside memory.buffer, bind / draw relative to it
+        uint64_t         byte_size{ 0 };
+
+        VkBuffer Buffer() const { return memory.buffer; }
+        uint8_t* Ptr() const { return static_cast<uint8_t*>(memory.ptr) + offset; }
+    };
+
+    //
+    // FrameGeometryRing
+    // a persistently mapped vertex / index buffer split into one sub range per frame in flight, for geometry
+    // rebuilt by the cpu every frame
+    //
+    // - a frame bump allocates inside its own sub range, the sub range is rewound when the frame index comes
+    //   around again, which FrameContext only hands out once that frame's submissions completed
+    // - a frame that does not fit grows the ring, the outgrown buffer stays alive until every frame that may
+    //   still read it was begun again
+    //
+    // not thread safe, owned by the thread recording the geometry
+    //
+    class FrameGeometryRing
+    {
+        struct RetiredBuffer
+        {
+            BufferAllocation allocation;
+            uint64_t         release_at_begin;
+        };
+
+        std::shared_ptr<ResourceAllocator> _allocator;
+        uint32_t                           _framesInFlight;
+        BufferAllocation                   _allocation;
+        uint64_t                           _frameByteSize;
+
+        uint32_t                           _frame{ 0 };
+        uint64_t                           _frameFront{ 0 };
+        uint64_t                           _begins{ 0 };
+        std::vector<RetiredBuffer>         _retired;
+
+        void Grow(uint64_t requiredFrameByteSize);
+    public:
+        FrameGeometryRing(std::shared_ptr<ResourceAllocator> allocator, uint32_t framesInFlight, FrameGeometryRingConfig config = {});
+        ~FrameGeometryRing();
+        FrameGeometryRing(const FrameGeometryRing&) = delete;
+        FrameGeometryRing& operator=(const FrameGeometryRing&) = delete;
+
+        // rewinds the frame's sub range, call once per recorded frame with FrameContext::FrameIndex()
+        void BeginFrame(uint32_t frameIndex);
+
+        // valid until the same frame index is begun again
+        FrameGeometryAllocation Allocate(uint64_t byteSize, uint64_t alignment = FRAME_GEOMETRY_RING_DEFAULT_ALIGNMENT);
+
+        // makes the written bytes visible to the device, required before submitting on non coherent memory
+        void Flush(const FrameGeometryAllocation& allocation);
+
+        uint64_t FrameByteSize() const { return _frameByteSize; }
+        uint64_t ByteSize() const { return _allocation.byte_size; }
+    };
+}
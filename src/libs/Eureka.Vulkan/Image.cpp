@@ -1,6 +1,10 @@
 #include "Image.hpp"
 #include "Result.hpp"
 #include <move.hpp>
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
 namespace eureka::vulkan
 {
 
@@ -24,6 +28,129 @@ namespace eureka::vulkan
     }
 
 
+    namespace
+    {
+        // copies the image into a new one bound to dstMemory, swaps the new image and view in
+        RelocatedHandles RelocateImage2D(
+            ResourceAllocator& allocator,
+            const Device& device,
+            const Image2DProperties& props,
+            VkImageLayout steadyLayout,
+            VmaAllocation dstMemory,
+            LinearCommandBufferHandle& commandBuffer,
+            VkImage& current,
+            VkImageView& currentView
+        )
+        {
+            auto image = allocator.CreateImage2D(dstMemory, props.extent, props.preset, props.mip_levels);
+            auto aspect = GetImagePresetAspect(props.preset);
+
+            VkImageSubresourceRange range
+            {
+                .aspectMask = aspect,
+                .baseMipLevel = 0,
+                .levelCount = props.mip_levels,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            };
+
+            std::array<VkImageMemoryBarrier2, 2> toTransfer
+            {
+                VkImageMemoryBarrier2
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                    .srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                    .srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT,
+                    .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                    .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT,
+                    .oldLayout = steadyLayout,
+                    .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = current,
+                    .subresourceRange = range
+                },
+                VkImageMemoryBarrier2
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                    .srcStageMask = VK_PIPELINE_STAGE_2_NONE,
+                    .srcAccessMask = VK_ACCESS_2_NONE,
+                    .dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                    .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+                    .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = image,
+                    .subresourceRange = range
+                }
+            };
+
+            commandBuffer.PipelineBarrier(VkDependencyInfo
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .imageMemoryBarrierCount = static_cast<uint32_t>(toTransfer.size()),
+                    .pImageMemoryBarriers = toTransfer.data()
+                });
+
+            // every level at its own extent, block compressed levels smaller than a block are copied whole
+            std::vector<VkImageCopy2> regions;
+            regions.reserve(props.mip_levels);
+            for (auto level = 0u; level < props.mip_levels; ++level)
+            {
+                regions.emplace_back(VkImageCopy2
+                    {
+                        .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_COPY_2,
+                        .srcSubresource = VkImageSubresourceLayers{ .aspectMask = aspect, .mipLevel = level, .baseArrayLayer = 0, .layerCount = 1 },
+                        .srcOffset = VkOffset3D{},
+                        .dstSubresource = VkImageSubresourceLayers{ .aspectMask = aspect, .mipLevel = level, .baseArrayLayer = 0, .layerCount = 1 },
+                        .dstOffset = VkOffset3D{},
+                        .extent = VkExtent3D{ std::max(props.extent.width >> level, 1u), std::max(props.extent.height >> level, 1u), 1 }
+                    });
+            }
+
+            commandBuffer.CopyImage(VkCopyImageInfo2
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_COPY_IMAGE_INFO_2,
+                    .srcImage = current,
+                    .srcImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .dstImage = image,
+                    .dstImageLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .regionCount = static_cast<uint32_t>(regions.size()),
+                    .pRegions = regions.data()
+                });
+
+            // the old image stays in transfer src, nothing records with it anymore
+            VkImageMemoryBarrier2 toSteady
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+                .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .newLayout = steadyLayout,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = range
+            };
+
+            commandBuffer.PipelineBarrier(VkDependencyInfo
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
+                    .imageMemoryBarrierCount = 1,
+                    .pImageMemoryBarriers = &toSteady
+                });
+
+            return RelocatedHandles
+            {
+                .image = std::exchange(current, image),
+                .view = std::exchange(currentView, CreateImage2DView(device, image, props.preset, props.mip_levels))
+            };
+        }
+    }
+
     //////////////////////////////////////////////////////////////////////////
     //
     //                         Image
@@ -82,20 +209,83 @@ namespace eureka::vulkan
         _allocator(std::move(allocator))
     {}
 
+    AllocatedImage::AllocatedImage(AllocatedImage&& that) noexcept :
+        Image(std::move(that)),
+        _allocator(std::move(that._allocator)),
+        _props(that._props),
+        _steadyLayout(that._steadyLayout),
+        _onRelocated(std::move(that._onRelocated)),
+        _relocatable(std::exchange(that._relocatable, false))
+    {
+        if (_relocatable)
+        {
+            _allocator->SetRelocatable(_allocation.allocation, this);
+        }
+    }
+
+    AllocatedImage& AllocatedImage::operator=(AllocatedImage&& rhs) noexcept
+    {
+        if (_allocator)
+        {
+            Deallocate();
+        }
+
+        Image::operator=(std::move(rhs));
+        _allocator = std::move(rhs._allocator);
+        _props = rhs._props;
+        _steadyLayout = rhs._steadyLayout;
+        _onRelocated = std::move(rhs._onRelocated);
+        _relocatable = std::exchange(rhs._relocatable, false);
+        if (_relocatable)
+        {
+            _allocator->SetRelocatable(_allocation.allocation, this);
+        }
+        return *this;
+    }
+
     void AllocatedImage::Allocate(const Image2DProperties& props)
     {
         Deallocate();
 
-        _allocation = _allocator->AllocateImage2D(props.extent, props.preset);
-        _view = CreateImage2DView(*_device, _allocation.image, props.preset);
+        _props = props;
+        _allocation = _allocator->AllocateImage2D(props.extent, props.preset, false, props.mip_levels);
+        _view = CreateImage2DView(*_device, _allocation.image, props.preset, props.mip_levels);
     }
 
     void AllocatedImage::Deallocate()
     {
+        if (nullptr != _view)
+        {
+            _device->DestroyImageView(steal(_view));
+        }
         if(nullptr != _allocation.image)
         {
             _allocator->DeallocateImage(_allocation);
+            _allocation = {};
+        }
+        _relocatable = false;
+    }
+
+    void AllocatedImage::EnableRelocation(VkImageLayout steadyLayout, std::function<void()> onRelocated)
+    {
+        assert(_allocation.allocation);
+        assert(steadyLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+        assert(IsImagePresetRelocatable(_props.preset));
+
+        _steadyLayout = steadyLayout;
+        _onRelocated = std::move(onRelocated);
+        _relocatable = true;
+        _allocator->SetRelocatable(_allocation.allocation, this);
+    }
+
+    RelocatedHandles AllocatedImage::Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer)
+    {
+        auto replaced = RelocateImage2D(*_allocator, *_device, _props, _steadyLayout, dstMemory, commandBuffer, _allocation.image, _view);
+        if (_onRelocated)
+        {
+            _onRelocated();
         }
+        return replaced;
     }
 
 
@@ -114,23 +304,87 @@ namespace eureka::vulkan
     {
         Deallocate();
 
-        _allocation = _allocator->AllocateImage(props.extent);
-        _view = CreateImage2DView(*_device, _allocation.image, props.preset);
+        _props = props;
+        _allocation = _allocator->AllocateImage(props.extent, props.mip_levels);
+        _view = CreateImage2DView(*_device, _allocation.image, props.preset, props.mip_levels);
     }
 
     void PoolAllocatedImage::Deallocate()
     {
+        if (nullptr != _view)
+        {
+            _device->DestroyImageView(steal(_view));
+        }
         if (nullptr != _allocation.image)
         {
             _allocator->DeallocateImage(_allocation);
+            _allocation = {};
         }
+        _relocatable = false;
     }
+
     PoolAllocatedImage::PoolAllocatedImage(std::shared_ptr<Device> device, std::shared_ptr<ImageMemoryPool> allocator) :
         Image(std::move(device)),
         _allocator(std::move(allocator))
     {
     }
 
+    PoolAllocatedImage::PoolAllocatedImage(PoolAllocatedImage&& that) noexcept :
+        Image(std::move(that)),
+        _allocator(std::move(that._allocator)),
+        _props(that._props),
+        _steadyLayout(that._steadyLayout),
+        _onRelocated(std::move(that._onRelocated)),
+        _relocatable(std::exchange(that._relocatable, false))
+    {
+        if (_relocatable)
+        {
+            _allocator->Allocator()->SetRelocatable(_allocation.allocation, this);
+        }
+    }
+
+    PoolAllocatedImage& PoolAllocatedImage::operator=(PoolAllocatedImage&& rhs) noexcept
+    {
+        if (_allocator)
+        {
+            Deallocate();
+        }
+
+        Image::operator=(std::move(rhs));
+        _allocator = std::move(rhs._allocator);
+        _props = rhs._props;
+        _steadyLayout = rhs._steadyLayout;
+        _onRelocated = std::move(rhs._onRelocated);
+        _relocatable = std::exchange(rhs._relocatable, false);
+        if (_relocatable)
+        {
+            _allocator->Allocator()->SetRelocatable(_allocation.allocation, this);
+        }
+        return *this;
+    }
+
+    void PoolAllocatedImage::EnableRelocation(VkImageLayout steadyLayout, std::function<void()> onRelocated)
+    {
+        assert(_allocation.allocation);
+        assert(steadyLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+        assert(IsImagePresetRelocatable(_props.preset));
+
+        _steadyLayout = steadyLayout;
+        _onRelocated = std::move(onRelocated);
+        _relocatable = true;
+        _allocator->Allocator()->SetRelocatable(_allocation.allocation, this);
+    }
+
+    RelocatedHandles PoolAllocatedImage::Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer)
+    {
+        auto replaced = RelocateImage2D(*_allocator->Allocator(), *_device, _props, _steadyLayout, dstMemory, commandBuffer, _allocation.image, _view);
+        if (_onRelocated)
+        {
+            _onRelocated();
+        }
+        return replaced;
+    }
+
 
 
     //////////////////////////////////////////////////////////////////////////
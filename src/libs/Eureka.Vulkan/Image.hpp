@@ -1,6 +1,8 @@
 #pragma once
 #include "ResourceAllocator.hpp"
 #include "ImageMemoryPool.hpp"
+#include "Relocatable.hpp"
+#include <functional>
 
 
 namespace eureka::vulkan
@@ -45,9 +47,10 @@ namespace eureka::vulkan
     {
         VkExtent2D extent{};
         Image2DAllocationPreset preset{};
+        uint32_t mip_levels{ 1 };
     };
 
-    class AllocatedImage : public Image
+    class AllocatedImage : public Image, public Relocatable
     {
     public:
         virtual ~AllocatedImage() noexcept;
@@ -55,14 +58,22 @@ namespace eureka::vulkan
         void Allocate(const Image2DProperties& props);
         void Deallocate();
 
-        AllocatedImage(AllocatedImage&& that) noexcept = default;
-        AllocatedImage& operator=(AllocatedImage&& rhs) noexcept = default;
+        AllocatedImage(AllocatedImage&& that) noexcept;
+        AllocatedImage& operator=(AllocatedImage&& rhs) noexcept;
         AllocatedImage(std::shared_ptr<Device> device, std::shared_ptr<ResourceAllocator> allocator);
+
+        // see PoolAllocatedImage::EnableRelocation, dedicated allocations are never moved
+        void EnableRelocation(VkImageLayout steadyLayout, std::function<void()> onRelocated = {});
+        RelocatedHandles Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer) override;
     protected:
         std::shared_ptr<ResourceAllocator> _allocator;
+        Image2DProperties                  _props{};
+        VkImageLayout                      _steadyLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+        std::function<void()>              _onRelocated;
+        bool                               _relocatable{ false };
     };
 
-    class PoolAllocatedImage : public Image
+    class PoolAllocatedImage : public Image, public Relocatable
     {
     public:
         virtual ~PoolAllocatedImage() noexcept;
@@ -70,11 +81,21 @@ namespace eureka::vulkan
         void Allocate(const Image2DProperties& props);
         void Deallocate();
 
-        PoolAllocatedImage(PoolAllocatedImage&& that) noexcept = default;
-        PoolAllocatedImage& operator=(PoolAllocatedImage&& rhs) noexcept = default;
+        PoolAllocatedImage(PoolAllocatedImage&& that) noexcept;
+        PoolAllocatedImage& operator=(PoolAllocatedImage&& rhs) noexcept;
         PoolAllocatedImage(std::shared_ptr<Device> device, std::shared_ptr<ImageMemoryPool> allocator);
+
+        // lets the defragmenter move the image, the image has to be in steadyLayout at submission boundaries
+        // onRelocated runs on the defragmenting thread once Get() / GetView() changed, descriptors of the image
+        // have to be rebuilt before the next frame records with them
+        void EnableRelocation(VkImageLayout steadyLayout, std::function<void()> onRelocated = {});
+        RelocatedHandles Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer) override;
     protected:
         std::shared_ptr<ImageMemoryPool> _allocator;
+        Image2DProperties                _props{};
+        VkImageLayout                    _steadyLayout{ VK_IMAGE_LAYOUT_UNDEFINED };
+        std::function<void()>            _onRelocated;
+        bool                             _relocatable{ false };
     };
 
     
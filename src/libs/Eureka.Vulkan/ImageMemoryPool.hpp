@@ -12,7 +12,7 @@ namespace eureka::vulkan
 
     public:
         ImageMemoryPool(std::shared_ptr<ResourceAllocator> allocator,
-                        uint64_t                           byteSize,
+                        const PoolBlocksConfig&            blocks,
                         VmaPoolCreateFlags                 poolFlags,
                         Image2DAllocationPreset            preset,
                         VmaAllocationCreateFlags           allocationFlags = 0// dedicated or not
@@ -22,17 +22,29 @@ namespace eureka::vulkan
             _preset(preset)
 
         {
-            _allocation = _allocator->AllocateImage2DPool(byteSize, preset, _allocationFlags, poolFlags);
+            _allocation = _allocator->AllocateImage2DPool(blocks, preset, _allocationFlags, poolFlags);
         }
 
-        ImageAllocation AllocateImage(const VkExtent2D& extent)
+        ImageAllocation AllocateImage(const VkExtent2D& extent, uint32_t mipLevels = 1)
         {
-            return _allocator->AllocatePoolImage(_allocation.pool, extent, _preset);
+            return _allocator->AllocatePoolImage(_allocation.pool, extent, _preset, mipLevels);
         }
         void DeallocateImage(const ImageAllocation& image)
         {
             return _allocator->DeallocateImage(image);
         }
+        PoolStatistics Statistics() const
+        {
+            return _allocator->GetPoolStatistics(_allocation);
+        }
+        const PoolAllocation& Allocation() const
+        {
+            return _allocation;
+        }
+        const std::shared_ptr<ResourceAllocator>& Allocator() const
+        {
+            return _allocator;
+        }
         ~ImageMemoryPool()
         {
             _allocator->DeallocatePool(_allocation);
@@ -0,0 +1,101 @@
+#include "MemoryBudget.hpp"
+#include <assert.hpp>
+#include <format>
+
+namespace eureka::vulkan
+{
+    MemoryBudgetTracker::MemoryBudgetTracker(std::shared_ptr<ResourceAllocator> allocator, MemoryBudgetConfig config) :
+        _allocator(std::move(allocator)),
+        _config(config)
+    {
+        assert(_config.soft_limit > 0.0f && _config.soft_limit <= 1.0f);
+    }
+
+    void MemoryBudgetTracker::BeginFrame()
+    {
+        auto frame = ++_frames;
+        _allocator->SetCurrentFrameIndex(static_cast<uint32_t>(frame));
+    }
+
+    bool MemoryBudgetTracker::FitsBudget(uint32_t heapIndex, uint64_t byteSize)
+    {
+        auto heaps = _allocator->HeapBudgets();
+        assert(heapIndex < heaps.size());
+
+        const auto& heap = heaps[heapIndex];
+        auto softLimit = static_cast<uint64_t>(static_cast<double>(heap.budget) * _config.soft_limit);
+
+        if (heap.usage + byteSize > softLimit)
+        {
+            ++_refused;
+            return false;
+        }
+        return true;
+    }
+
+    bool MemoryBudgetTracker::FitsBudget(BufferAllocationPreset preset, uint64_t byteSize)
+    {
+        return FitsBudget(_allocator->HeapIndexForPreset(preset), byteSize);
+    }
+
+    void MemoryBudgetTracker::RecordDeferred()
+    {
+        ++_deferred;
+    }
+
+    float MemoryBudgetTracker::HeapPressure(uint32_t heapIndex) const
+    {
+        auto heaps = _allocator->HeapBudgets();
+        assert(heapIndex < heaps.size());
+
+        const auto& heap = heaps[heapIndex];
+        return heap.budget ? static_cast<float>(static_cast<double>(heap.usage) / static_cast<double>(heap.budget)) : 0.0f;
+    }
+
+    MemoryBudgetCounters MemoryBudgetTracker::Counters() const
+    {
+        return MemoryBudgetCounters
+        {
+            .heaps = _allocator->HeapBudgets(),
+            .frames = _frames,
+            .refused = _refused,
+            .deferred = _deferred
+        };
+    }
+
+    std::string MemoryBudgetTracker::DumpJson(bool detailedMap) const
+    {
+        auto counters = Counters();
+
+        std::string heaps;
+        for (const auto& heap : counters.heaps)
+        {
+            if (!heaps.empty())
+            {
+                heaps += ",";
+            }
+            heaps += std::format(
+                "{{\"heap_index\":{},\"device_local\":{},\"block_count\":{},\"allocation_count\":{},\"block_bytes\":{},\"allocation_bytes\":{},\"usage\":{},\"budget\":{}}}",
+                heap.heap_index,
+                heap.device_local,
+                heap.block_count,
+                heap.allocation_count,
+                heap.block_bytes,
+                heap.allocation_bytes,
+                heap.usage,
+                heap.budget
+            );
+        }
+
+        return std::format(
+            "{{\"budget\":{{\"memory_budget_extention\":{},\"soft_limit\":{},\"frames\":{},\"refused\":{},\"deferred\":{},\"heaps\":[{}]}},\"allocator\":{}}}",
+            _allocator->HasMemoryBudgetExtention(),
+            _config.soft_limit,
+            counters.frames,
+            counters.refused,
+            counters.deferred,
+            heaps,
+            _allocator->BuildStatsJson(detailedMap)
+        );
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "ResourceAllocator.hpp"
+#include <atomic>
+
+namespace eureka::vulkan
+{
+    struct MemoryBudgetConfig
+    {
+        float soft_limit{ 0.9f }; // fraction of a heap budget past which optional allocations are refused
+    };
+
+    struct MemoryBudgetCounters
+    {
+        std::vector<HeapBudget> heaps;
+        uint64_t                frames{ 0 };
+        uint64_t                refused{ 0 };   // allocations refused above the soft limit
+        uint64_t                deferred{ 0 };  // work the callers postponed after a refusal
+    };
+
+    //
+    // MemoryBudgetTracker
+    // per heap budget tracking on top of vmaGetHeapBudgets, with VK_EXT_memory_budget the usage and budget cover
+    // the whole process as reported by the driver, without it they are estimated from our own allocations
+    // callers with a fallback (wait for the staging ring, evict a cache, skip a pool block) ask before allocating
+    // memory they could do without, so we degrade near the budget instead of failing an allocation
+    // thread safe
+    //
+    class MemoryBudgetTracker
+    {
+        std::shared_ptr<ResourceAllocator> _allocator;
+        MemoryBudgetConfig                 _config;
+        std::atomic<uint64_t>              _frames{ 0 };
+        std::atomic<uint64_t>              _refused{ 0 };
+        std::atomic<uint64_t>              _deferred{ 0 };
+    public:
+        MemoryBudgetTracker(std::shared_ptr<ResourceAllocator> allocator, MemoryBudgetConfig config = {});
+        MemoryBudgetTracker(const MemoryBudgetTracker&) = delete;
+        MemoryBudgetTracker& operator=(const MemoryBudgetTracker&) = delete;
+
+        // once per frame, lets the allocator refetch the driver budgets
+        void BeginFrame();
+
+        // false (and counted as refused) when byteSize more would take the heap past the soft limit
+        bool FitsBudget(uint32_t heapIndex, uint64_t byteSize);
+        bool FitsBudget(BufferAllocationPreset preset, uint64_t byteSize);
+
+        void RecordDeferred();
+
+        // usage / budget of a heap, above 1 the heap is over budget
+        float HeapPressure(uint32_t heapIndex) const;
+
+        MemoryBudgetCounters Counters() const;
+
+        // tracker counters and the allocator statistics (vma json) for capacity planning
+        std::string DumpJson(bool detailedMap = false) const;
+    };
+}
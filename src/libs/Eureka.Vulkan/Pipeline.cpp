@@ -44,12 +44,13 @@ namespace eureka::vulkan
         std::shared_ptr<Device> device,
         std::shared_ptr<PipelineLayout> layout,
         std::shared_ptr<RenderPass> renderPass,
-        const VkGraphicsPipelineCreateInfo& pipelineCreateInfo
+        const VkGraphicsPipelineCreateInfo& pipelineCreateInfo,
+        VkPipelineCache pipelineCache
     ) :
         _device(std::move(device)),
         _pipelineLayout(std::move(layout)),
         _renderPass(std::move(renderPass)),
-        _pipeline(_device->CreatePipeline(pipelineCreateInfo))
+        _pipeline(_device->CreatePipeline(pipelineCreateInfo, pipelineCache))
     {
 
     }
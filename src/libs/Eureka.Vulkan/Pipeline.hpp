@@ -47,7 +47,8 @@ namespace eureka::vulkan
         Pipeline(std::shared_ptr<Device>             device,
                  std::shared_ptr<PipelineLayout>     layout,
                  std::shared_ptr<RenderPass>         renderPass,
-                 const VkGraphicsPipelineCreateInfo& pipelineCreateInfo);
+                 const VkGraphicsPipelineCreateInfo& pipelineCreateInfo,
+                 VkPipelineCache                     pipelineCache = nullptr);
         ~Pipeline();
 
         VkPipeline Get() const
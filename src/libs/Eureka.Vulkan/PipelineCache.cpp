@@ -1,7 +1,147 @@
 #include "PipelineCache.hpp"
+#include <debugger_trace.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 
 namespace eureka::vulkan
 {
+    namespace
+    {
+        PipelineCacheFileHeader MakeFileHeader(const VkPhysicalDeviceProperties& properties, uint64_t dataSize)
+        {
+            // value initialized, no byte of the written header is indeterminate
+            PipelineCacheFileHeader header{};
+            header.magic = PIPELINE_CACHE_FILE_MAGIC;
+            header.file_version = PIPELINE_CACHE_FILE_VERSION;
+            header.vendor_id = properties.vendorID;
+            header.device_id = properties.deviceID;
+            header.driver_version = properties.driverVersion;
+            header.data_size = dataSize;
+            std::copy_n(properties.pipelineCacheUUID, VK_UUID_SIZE, header.pipeline_cache_uuid);
+
+            return header;
+        }
+
+        bool SameDevice(const PipelineCacheFileHeader& lhs, const PipelineCacheFileHeader& rhs)
+        {
+            return lhs.magic == rhs.magic &&
+                lhs.file_version == rhs.file_version &&
+                lhs.vendor_id == rhs.vendor_id &&
+                lhs.device_id == rhs.device_id &&
+                lhs.driver_version == rhs.driver_version &&
+                std::equal(lhs.pipeline_cache_uuid, lhs.pipeline_cache_uuid + VK_UUID_SIZE, rhs.pipeline_cache_uuid);
+        }
+
+        // the blob must also carry the vulkan header of this device, a mismatch means a foreign or truncated blob
+        bool ValidBlobHeader(const std::vector<uint8_t>& blob, const VkPhysicalDeviceProperties& properties)
+        {
+            VkPipelineCacheHeaderVersionOne blobHeader{};
+            if (blob.size() < sizeof(blobHeader))
+            {
+                return false;
+            }
+            std::memcpy(&blobHeader, blob.data(), sizeof(blobHeader));
+
+            return blobHeader.headerSize >= sizeof(blobHeader) &&
+                blobHeader.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                blobHeader.vendorID == properties.vendorID &&
+                blobHeader.deviceID == properties.deviceID &&
+                std::equal(blobHeader.pipelineCacheUUID, blobHeader.pipelineCacheUUID + VK_UUID_SIZE, properties.pipelineCacheUUID);
+        }
+
+        std::vector<uint8_t> LoadCacheBlob(const std::filesystem::path& path, const VkPhysicalDeviceProperties& properties)
+        {
+            std::ifstream is(path, std::ios::binary | std::ios::in);
+            if (!is)
+            {
+                return {};
+            }
+
+            PipelineCacheFileHeader header{};
+            is.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!is || !SameDevice(header, MakeFileHeader(properties, header.data_size)))
+            {
+                DEBUGGER_TRACE("pipeline cache {} was written by a different device or driver, ignored", path.string());
+                return {};
+            }
+
+            std::error_code ec;
+            auto fileSize = std::filesystem::file_size(path, ec);
+            if (ec || fileSize != sizeof(header) + header.data_size)
+            {
+                DEBUGGER_TRACE("pipeline cache {} is truncated, ignored", path.string());
+                return {};
+            }
+
+            std::vector<uint8_t> blob(header.data_size);
+            is.read(reinterpret_cast<char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+            if (!is || !ValidBlobHeader(blob, properties))
+            {
+                DEBUGGER_TRACE("pipeline cache {} is corrupted, ignored", path.string());
+                return {};
+            }
+
+            return blob;
+        }
+
+        std::filesystem::path EnvironmentPath(const char* name)
+        {
+#ifdef _WIN32
+            char* value = nullptr;
+            size_t length = 0;
+            if (_dupenv_s(&value, &length, name) != 0 || !value)
+            {
+                return {};
+            }
+            std::filesystem::path result(value);
+            free(value);
+            return result;
+#else
+            const char* value = std::getenv(name);
+            return value ? std::filesystem::path(value) : std::filesystem::path();
+#endif
+        }
+
+        std::filesystem::path UserCacheDirectory()
+        {
+#ifdef _WIN32
+            return EnvironmentPath("LOCALAPPDATA");
+#else
+            if (auto xdgCache = EnvironmentPath("XDG_CACHE_HOME"); xdgCache.is_absolute())
+            {
+                return xdgCache;
+            }
+            if (auto home = EnvironmentPath("HOME"); !home.empty())
+            {
+                return home / ".cache";
+            }
+            return {};
+#endif
+        }
+    }
+
+    std::filesystem::path DefaultPipelineCachePath()
+    {
+        auto cacheDirectory = UserCacheDirectory();
+        if (cacheDirectory.empty())
+        {
+            return PIPELINE_CACHE_DEFAULT_FILENAME;
+        }
+
+        cacheDirectory /= "eureka";
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDirectory, ec);
+        if (ec)
+        {
+            DEBUGGER_TRACE("failed creating pipeline cache directory {}: {}", cacheDirectory.string(), ec.message());
+            return PIPELINE_CACHE_DEFAULT_FILENAME;
+        }
+
+        return cacheDirectory / PIPELINE_CACHE_DEFAULT_FILENAME;
+    }
+
     //////////////////////////////////////////////////////////////////////////
     //
     //                        PipelineCache
@@ -12,12 +152,57 @@ namespace eureka::vulkan
         _piplineCache(_device->CreatePipelineCache())
     {}
 
+    PipelineCache::PipelineCache(std::shared_ptr<Device> device, std::filesystem::path path) :
+        _device(std::move(device)),
+        _path(std::move(path))
+    {
+        auto blob = LoadCacheBlob(_path, _device->GetPhysicalDeviceProperties());
+        _piplineCache = _device->CreatePipelineCache(blob);
+        _loadedFromDisk = !blob.empty();
+    }
+
     PipelineCache::~PipelineCache()
     {
         if(_piplineCache)
         {
+            Save();
             _device->DestroyPipelineCache(_piplineCache);
         }
     }
 
+    void PipelineCache::Save() const
+    {
+        if (_path.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            auto blob = _device->GetPipelineCacheData(_piplineCache);
+            auto header = MakeFileHeader(_device->GetPhysicalDeviceProperties(), blob.size());
+
+            auto tempPath = _path;
+            tempPath += ".tmp";
+
+            {
+                std::ofstream os(tempPath, std::ios::binary | std::ios::out | std::ios::trunc);
+                os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                os.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+                if (!os)
+                {
+                    DEBUGGER_TRACE("failed writing pipeline cache {}", tempPath.string());
+                    return;
+                }
+            }
+
+            // readers never observe a partially written cache
+            std::filesystem::rename(tempPath, _path);
+        }
+        catch (const std::exception& err)
+        {
+            DEBUGGER_TRACE("failed saving pipeline cache {}: {}", _path.string(), err.what());
+        }
+    }
+
 } // namespace eureka::vulkan
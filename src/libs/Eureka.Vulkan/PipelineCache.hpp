@@ -1,9 +1,39 @@
 #pragma once
 
 #include "Device.hpp"
+#include <filesystem>
 
 namespace eureka::vulkan
 {
+    //
+    // on disk layout of a serialized pipeline cache, followed by data_size bytes of vkGetPipelineCacheData
+    // the vulkan blob header only identifies the device, the driver version is kept here so a driver update
+    // discards the blob instead of handing it to a driver that may not validate it thoroughly
+    //
+    struct PipelineCacheFileHeader
+    {
+        uint32_t magic;
+        uint32_t file_version;
+        uint32_t vendor_id;
+        uint32_t device_id;
+        uint32_t driver_version;
+        uint8_t  pipeline_cache_uuid[VK_UUID_SIZE];
+        uint32_t padding;   // keeps data_size aligned, written as zero
+        uint64_t data_size;
+    };
+    static_assert(sizeof(PipelineCacheFileHeader) == 48, "the header is written as is, it must not have implicit padding");
+
+    inline constexpr uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x50434B45; // "EKCP"
+    inline constexpr uint32_t PIPELINE_CACHE_FILE_VERSION = 1;
+    inline constexpr const char* PIPELINE_CACHE_DEFAULT_FILENAME = "pipeline_cache.bin";
+
+    //
+    // PIPELINE_CACHE_DEFAULT_FILENAME in the per user cache directory:
+    // %LOCALAPPDATA%/eureka on windows, $XDG_CACHE_HOME/eureka or ~/.cache/eureka elsewhere
+    // the directory is created on demand, without any of them the file falls back to the working directory
+    //
+    std::filesystem::path DefaultPipelineCachePath();
+
     //////////////////////////////////////////////////////////////////////////
     //
     //                        PipelineCache
@@ -13,12 +43,33 @@ namespace eureka::vulkan
     {
         std::shared_ptr<Device> _device;
         VkPipelineCache _piplineCache{ nullptr };
+        std::filesystem::path _path;
+        bool _loadedFromDisk{ false };
     public:
         PipelineCache() = default;
         PipelineCache(std::shared_ptr<Device> device);
+        //
+        // seeds the cache from path when the file was written by the same device and driver version,
+        // a missing, stale or corrupted file starts an empty cache
+        // the cache is saved back to path on destruction
+        //
+        PipelineCache(std::shared_ptr<Device> device, std::filesystem::path path);
         ~PipelineCache();
         PipelineCache(const PipelineCache&) = delete;
         PipelineCache& operator=(const PipelineCache&) = delete;
+
+        VkPipelineCache Get() const
+        {
+            return _piplineCache;
+        }
+
+        bool LoadedFromDisk() const
+        {
+            return _loadedFromDisk;
+        }
+
+        // writes the cache through a temporary file, failures are traced and leave the previous file intact
+        void Save() const;
     };
 }
 
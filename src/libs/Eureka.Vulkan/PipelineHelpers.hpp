@@ -147,15 +147,17 @@ namespace eureka::vulkan
     {
         ShadersPipeline shaderPipeline;
         shaderPipeline.modules.resize(COUNT);
+        shaderPipeline.names.resize(COUNT);
         shaderPipeline.stages.resize(COUNT);
 
         for(auto i = 0u; i < ids.size(); ++i)
         {
             shaderPipeline.modules[i] = shaderCache.LoadShaderModule(ids[i]);
+            shaderPipeline.names[i] = ids[i].name;
             shaderPipeline.stages[i] = VkPipelineShaderStageCreateInfo{
                 .sType = VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
                 .stage = ids[i].shader_type,
-                .module = shaderPipeline.modules[i].Get(),
+                .module = shaderPipeline.modules[i]->Get(),
                 .pName = "main",
             };
         }
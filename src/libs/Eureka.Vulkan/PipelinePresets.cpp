@@ -22,6 +22,23 @@ namespace eureka::vulkan
             _createInfo.pushConstantRangeCount = static_cast<uint32_t>(_pushConstantRanges.size());
             _createInfo.pPushConstantRanges = _pushConstantRanges.data();
         }
+        else if (preset == PipelinePresetType::ePoseGraphEdges || preset == PipelinePresetType::ePoseGraphGlyphs)
+        {
+            _setLayoutHandles.emplace_back(layoutCache.GetLayoutHandle(DescriptorSet0PresetType::ePoseGraphStorage));
+
+            VkPushConstantRange pushConstantsRange{
+                .stageFlags = VkShaderStageFlagBits::VK_SHADER_STAGE_VERTEX_BIT,
+                .offset = 0,
+                .size = sizeof(PoseGraphPushConstantsBlock),
+            };
+            _pushConstantRanges.emplace_back(pushConstantsRange);
+
+            _createInfo.sType = VkStructureType::VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+            _createInfo.setLayoutCount = static_cast<uint32_t>(_setLayoutHandles.size());
+            _createInfo.pSetLayouts = _setLayoutHandles.data();
+            _createInfo.pushConstantRangeCount = static_cast<uint32_t>(_pushConstantRanges.size());
+            _createInfo.pPushConstantRanges = _pushConstantRanges.data();
+        }
         else
         {
             throw std::logic_error("bad");
@@ -44,6 +61,16 @@ namespace eureka::vulkan
             // no vertex data
             _stages = MakeShaderPipeline(std::array<ShaderId, 2> { Textured2DRegionVS, Textured2DRegionFS }, shaderCache);
         }
+        else if (preset == PipelinePresetType::ePoseGraphEdges)
+        {
+            // no vertex data, the instances read the storage buffers
+            _inputAssembly.topology = VkPrimitiveTopology::VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+            _stages = MakeShaderPipeline(std::array<ShaderId, 2> { PoseGraphEdgesVS, PoseGraphFS }, shaderCache);
+        }
+        else if (preset == PipelinePresetType::ePoseGraphGlyphs)
+        {
+            _stages = MakeShaderPipeline(std::array<ShaderId, 2> { PoseGraphGlyphsVS, PoseGraphFS }, shaderCache);
+        }
         else
         {
             throw std::logic_error("bad");
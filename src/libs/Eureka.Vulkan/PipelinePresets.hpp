@@ -3,6 +3,7 @@
 #include "PipelineTypes.hpp"
 #include "ShaderModule.hpp"
 #include "ShadersCache.hpp"
+#include <array>
 #include <vector>
 #include <macros.hpp>
 
@@ -17,7 +18,17 @@ namespace eureka::vulkan
     enum class PipelinePresetType
     {
         eImGui,
-        eTexturedRegion
+        eTexturedRegion,
+        ePoseGraphEdges,
+        ePoseGraphGlyphs
+    };
+
+    inline constexpr std::array<PipelinePresetType, 4> PIPELINE_PRESET_TYPES
+    {
+        PipelinePresetType::eImGui,
+        PipelinePresetType::eTexturedRegion,
+        PipelinePresetType::ePoseGraphEdges,
+        PipelinePresetType::ePoseGraphGlyphs
     };
 
     class PipelineLayoutCreationPreset
@@ -131,6 +142,11 @@ namespace eureka::vulkan
         {
             return _createInfo;
         }
+
+        const ShadersPipeline& GetShaders() const
+        {
+            return _stages;
+        }
     };
 
 } // namespace eureka::vulkan
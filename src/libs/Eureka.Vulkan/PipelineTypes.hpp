@@ -19,6 +19,20 @@ namespace eureka::vulkan
     };
 
 
+    // must match pose_graph.hlsli
+    struct PoseGraphPushConstantsBlock
+    {
+        Eigen::Vector2f scale;
+        Eigen::Vector2f translate;
+        uint32_t        edge_mask;
+        uint32_t        source;
+        float           glyph_scale;
+        uint32_t        padding;
+    };
+
+    inline constexpr uint32_t POSE_GRAPH_SOURCE_EDGES = 0;
+    inline constexpr uint32_t POSE_GRAPH_SOURCE_POSES = 1;
+
     //struct vector3
     //{
     //    float x;
@@ -18,6 +18,11 @@ namespace eureka::vulkan
         VK_CHECK(vkQueueSubmit(_queue, 1u, &submitInfo, fence));
     }
 
+    void Queue::Submit2(uint32_t submitCount, const VkSubmitInfo2* submitInfos, VkFence fence)
+    {
+        VK_CHECK(vkQueueSubmit2(_queue, submitCount, submitInfos, fence));
+    }
+
     void Queue::WaitIdle()
     {
         VK_CHECK(vkQueueWaitIdle(_queue));
@@ -17,6 +17,7 @@ namespace eureka::vulkan
 
         [[nodiscard]] VkResult Present(const VkPresentInfoKHR& presentInfo);
         void Submit(const VkSubmitInfo& submitInfo, VkFence fence);
+        void Submit2(uint32_t submitCount, const VkSubmitInfo2* submitInfos, VkFence fence = VK_NULL_HANDLE);
     };
 }
 
@@ -0,0 +1,28 @@
+#pragma once
+#include "Commands.hpp"
+#include "vk_mem_alloc.h"
+
+namespace eureka::vulkan
+{
+    struct RelocatedHandles
+    {
+        VkBuffer    buffer{ nullptr };
+        VkImage     image{ nullptr };
+        VkImageView view{ nullptr };
+    };
+
+    //
+    // Relocatable
+    // owner of an allocation that follows it when the Defragmenter moves it to other memory
+    // the contents must be final once relocation is enabled, a pass copies them while nothing else writes them
+    //
+    class Relocatable
+    {
+    public:
+        // records the copy of the contents into new handles bound to dstMemory and switches to the new handles
+        // returns the previous handles, the defragmenter destroys them once no submitted work uses them
+        virtual RelocatedHandles Relocate(VmaAllocation dstMemory, LinearCommandBufferHandle& commandBuffer) = 0;
+    protected:
+        ~Relocatable() = default;
+    };
+}
@@ -44,10 +44,14 @@ namespace eureka::vulkan
         BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT),
         // eHostWriteCombinedBufferAsTransferSrc
         BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT),
-        // eVertexAndIndexTransferableDeviceBuffer
-        BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0),
+        // eVertexAndIndexTransferableDeviceBuffer (transfer src for relocation)
+        BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, 0),
         // eHostVisibleVertexAndIndexTransferableDeviceBuffer
-        BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT)
+        BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT),
+        // eHostWriteCombinedVertexAndIndexBuffer
+        BufferAllocationPresetVals(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT),
+        // eStorageTransferableDeviceBuffer (transfer src for relocation)
+        BufferAllocationPresetVals(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, 0)
     };
 
     inline constexpr std::array<BufferPoolAllocationPresetVals, PoolAllocationPreset::POOL_ALLOCATION_PRESETS_COUNT> POOL_ALLOCATION_PRESETS
@@ -58,10 +62,22 @@ namespace eureka::vulkan
 
     inline constexpr std::array<Image2DAllocationPresetVals, Image2DAllocationPreset::IMAGE2D_ALLOCATION_PRESETS_COUNT> IMAGE2D_ALLOCATION_PRESETS
     {
-        // eR8G8B8A8UnormSampledShaderResource
-        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_R8G8B8A8_UNORM, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eR8G8B8A8UnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_R8G8B8A8_UNORM, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
         // eR8G8B8A8UnormSampledShaderResourceRenderTargetTransferSrcDst
         Image2DAllocationPresetVals(VkFormat::VK_FORMAT_R8G8B8A8_UNORM, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eBC1RgbaUnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_BC1_RGBA_UNORM_BLOCK, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eBC1RgbUnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_BC1_RGB_UNORM_BLOCK, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eBC3UnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_BC3_UNORM_BLOCK, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eBC5UnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_BC5_UNORM_BLOCK, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eBC7UnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_BC7_UNORM_BLOCK, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
+        // eASTC4x4UnormSampledShaderResource (transfer src for relocation)
+        Image2DAllocationPresetVals(VkFormat::VK_FORMAT_ASTC_4x4_UNORM_BLOCK, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT),
         // eD24UnormS8UintDepthImage
         Image2DAllocationPresetVals(VkFormat::VK_FORMAT_D24_UNORM_S8_UINT, 1, VK_SAMPLE_COUNT_1_BIT , VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT),
         // eD32FloatDepthImage
@@ -70,7 +86,32 @@ namespace eureka::vulkan
     };
 
 
-    ResourceAllocator::ResourceAllocator(std::shared_ptr<Instance> instance, std::shared_ptr<Device> device) :
+    namespace
+    {
+        PoolAllocation CreatePool(VmaAllocator vma, const PoolBlocksConfig& blocks, uint32_t memTypeIndex, VmaPoolCreateFlags poolFlags)
+        {
+            VmaPoolCreateInfo poolCreateInfo = {};
+            poolCreateInfo.flags = poolFlags;
+            poolCreateInfo.memoryTypeIndex = memTypeIndex;
+            poolCreateInfo.blockSize = blocks.block_byte_size;
+            poolCreateInfo.minBlockCount = blocks.min_block_count;
+            poolCreateInfo.maxBlockCount = blocks.max_block_count;
+
+            PoolAllocation poolAllocation{};
+
+            VK_CHECK(vmaCreatePool(vma, &poolCreateInfo, &poolAllocation.pool));
+
+            poolAllocation.block_byte_size = poolCreateInfo.blockSize;
+            poolAllocation.max_block_count = blocks.max_block_count;
+
+            const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+            vmaGetMemoryProperties(vma, &memoryProperties);
+            poolAllocation.heap_index = memoryProperties->memoryTypes[memTypeIndex].heapIndex;
+            return poolAllocation;
+        }
+    }
+
+    ResourceAllocator::ResourceAllocator(std::shared_ptr<Instance> instance, std::shared_ptr<Device> device, ResourceAllocatorConfig config) :
         _instnace(std::move(instance)),
         _device(std::move(device))
     {
@@ -95,12 +136,16 @@ namespace eureka::vulkan
         vulkanFunction.vkCmdCopyBuffer = vkCmdCopyBuffer;
         vulkanFunction.vkGetDeviceProcAddr = vkGetDeviceProcAddr;
         vulkanFunction.vkGetInstanceProcAddr = vkGetInstanceProcAddr;
+        vulkanFunction.vkGetPhysicalDeviceMemoryProperties2KHR = vkGetPhysicalDeviceMemoryProperties2;
+
+        _memoryBudgetExtention = _device->IsExtentionEnabled(DEVICE_EXTENTION_MEMORY_BUDGET);
 
         VmaAllocatorCreateInfo allocatorCreateInfo
         {
-            .flags = 0,
+            .flags = _memoryBudgetExtention ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
             .physicalDevice = _device->GetPhysicalDevice(),
             .device = _device->GetDevice(),
+            .preferredLargeHeapBlockSize = config.preferred_block_byte_size,
             .pVulkanFunctions = &vulkanFunction,
             .instance = _instnace->Get(),
             .vulkanApiVersion = _device->GetApiVersion().Get()
@@ -152,25 +197,28 @@ namespace eureka::vulkan
         assert(allocationInfo.size == byteSize);
         mappedAllocation.ptr = allocationInfo.pMappedData;
         mappedAllocation.byte_size = allocationInfo.size;
+        mappedAllocation.usage = bufferCreateInfo.usage;
         return mappedAllocation;
     }
     
-    PoolAllocation ResourceAllocator::AllocateBufferPool(uint64_t byteSize, PoolAllocationPreset preset)
+    PoolAllocation ResourceAllocator::AllocateBufferPool(const PoolBlocksConfig& blocks, PoolAllocationPreset preset)
     {
         return AllocateBufferPool(
-            byteSize,
+            blocks,
             POOL_ALLOCATION_PRESETS[preset].buffer_usage_flags,
             POOL_ALLOCATION_PRESETS[preset].allocation_flags,
             POOL_ALLOCATION_PRESETS[preset].pool_flags
         );
     }
 
-    PoolAllocation ResourceAllocator::AllocateBufferPool(uint64_t byteSize, VkBufferUsageFlags usageFlags, VmaAllocationCreateFlags allocationFlags, VmaPoolCreateFlags poolFlags)
+    PoolAllocation ResourceAllocator::AllocateBufferPool(const PoolBlocksConfig& blocks, VkBufferUsageFlags usageFlags, VmaAllocationCreateFlags allocationFlags, VmaPoolCreateFlags poolFlags)
     {
+        assert(blocks.max_block_count == 0 || blocks.min_block_count <= blocks.max_block_count);
+
         VkBufferCreateInfo bufferCreateInfo
         {
             .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-            .size = byteSize,
+            .size = blocks.block_byte_size ? blocks.block_byte_size : 1,
             .usage = usageFlags
         };
 
@@ -188,22 +236,10 @@ namespace eureka::vulkan
             &memTypeIndex
         ));
 
-        VmaPoolCreateInfo poolCreateInfo = {};
-        poolCreateInfo.flags = poolFlags;
-        poolCreateInfo.memoryTypeIndex = memTypeIndex;
-        poolCreateInfo.blockSize = byteSize;
-        poolCreateInfo.maxBlockCount = 1;
-
-        PoolAllocation poolAllocation{};
-
-        VK_CHECK(vmaCreatePool(_vma, &poolCreateInfo, &poolAllocation.pool));
-        assert(poolCreateInfo.blockSize == byteSize);
-
-        poolAllocation.byte_size = poolCreateInfo.blockSize;
-        return poolAllocation;
+        return CreatePool(_vma, blocks, memTypeIndex, poolFlags);
     }
 
-    PoolAllocation ResourceAllocator::AllocateImage2DPool(uint64_t byteSize, Image2DAllocationPreset preset, VmaAllocationCreateFlags allocationFlags, VmaPoolCreateFlags poolFlags)
+    PoolAllocation ResourceAllocator::AllocateImage2DPool(const PoolBlocksConfig& blocks, Image2DAllocationPreset preset, VmaAllocationCreateFlags allocationFlags, VmaPoolCreateFlags poolFlags)
     {
         const Image2DAllocationPresetVals& presetVals = IMAGE2D_ALLOCATION_PRESETS[preset];
 
@@ -238,20 +274,7 @@ namespace eureka::vulkan
             &memTypeIndex
         ));
 
-        VmaPoolCreateInfo poolCreateInfo = {};
-        poolCreateInfo.flags = poolFlags;
-        poolCreateInfo.memoryTypeIndex = memTypeIndex;
-        poolCreateInfo.blockSize = byteSize;
-        poolCreateInfo.maxBlockCount = 0;
-
-        PoolAllocation poolAllocation{};
-
-        VK_CHECK(vmaCreatePool(_vma, &poolCreateInfo, &poolAllocation.pool));
-        assert(poolCreateInfo.blockSize == byteSize);
-
-        poolAllocation.byte_size = poolCreateInfo.blockSize;
-
-        return poolAllocation;
+        return CreatePool(_vma, blocks, memTypeIndex, poolFlags);
     }
 
 
@@ -286,10 +309,50 @@ namespace eureka::vulkan
 
         allocation.ptr = allocationInfo.pMappedData;
         allocation.byte_size = allocationInfo.size;
+        allocation.usage = usage;
+        return allocation;
+    }
+
+    std::optional<BufferAllocation> ResourceAllocator::TryAllocatePoolBuffer(VmaPool pool, uint64_t byteSize, VkBufferUsageFlags usage, VmaAllocationCreateFlags allocationFlags)
+    {
+        VkBufferCreateInfo bufferCreateInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = byteSize,
+            .usage = usage,
+        };
+
+        VmaAllocationCreateInfo allocationCreateInfo
+        {
+            .flags = allocationFlags | VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT,
+            .pool = pool
+        };
+
+        VmaAllocationInfo allocationInfo{};
+
+        BufferAllocation allocation{};
+        auto result = vmaCreateBuffer(
+            _vma,
+            &bufferCreateInfo,
+            &allocationCreateInfo,
+            &allocation.buffer,
+            &allocation.allocation,
+            &allocationInfo
+        );
+
+        if (result == VkResult::VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VkResult::VK_ERROR_OUT_OF_HOST_MEMORY)
+        {
+            return std::nullopt;
+        }
+        VK_CHECK(result);
+
+        allocation.ptr = allocationInfo.pMappedData;
+        allocation.byte_size = allocationInfo.size;
+        allocation.usage = usage;
         return allocation;
     }
 
-    ImageAllocation ResourceAllocator::AllocatePoolImage(VmaPool pool, const VkExtent2D& extent, Image2DAllocationPreset preset)
+    ImageAllocation ResourceAllocator::AllocatePoolImage(VmaPool pool, const VkExtent2D& extent, Image2DAllocationPreset preset, uint32_t mipLevels)
     {
         const Image2DAllocationPresetVals& presetVals = IMAGE2D_ALLOCATION_PRESETS[preset];
 
@@ -299,7 +362,7 @@ namespace eureka::vulkan
             .imageType = VkImageType::VK_IMAGE_TYPE_2D,
             .format = presetVals.format,
             .extent = VkExtent3D{extent.width, extent.height, 1},
-            .mipLevels = 1,
+            .mipLevels = mipLevels,
             .arrayLayers = 1,
             .samples = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
             .tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
@@ -334,7 +397,7 @@ namespace eureka::vulkan
 
 
 
-    ImageAllocation ResourceAllocator::AllocateImage2D(const VkExtent2D& extent, Image2DAllocationPreset preset, bool dedicated)
+    ImageAllocation ResourceAllocator::AllocateImage2D(const VkExtent2D& extent, Image2DAllocationPreset preset, bool dedicated, uint32_t mipLevels)
     {
         const Image2DAllocationPresetVals& presetVals = IMAGE2D_ALLOCATION_PRESETS[preset];
 
@@ -344,7 +407,7 @@ namespace eureka::vulkan
             .imageType = VkImageType::VK_IMAGE_TYPE_2D,
             .format = presetVals.format,
             .extent = VkExtent3D{extent.width, extent.height, 1},
-            .mipLevels = 1,
+            .mipLevels = mipLevels,
             .arrayLayers = 1,
             .samples = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
             .tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
@@ -378,36 +441,15 @@ namespace eureka::vulkan
         return imageAllocation;
     }
 
-    //std::optional<BufferAllocation> ResourceAllocator::TryAllocatePoolBuffer(VmaPool pool, [[maybe_unused]] uint64_t byteSize)
-    //{
-    //    VmaAllocationCreateInfo allocationCreateInfo
-    //    {
-    //        .pool = pool
-    //    };
-    //    VmaAllocationInfo allocationInfo{};
-    //    BufferAllocation bufferAllocation{};
-    //    auto result = vmaCreateBuffer(
-    //        _vma,
-    //        nullptr,
-    //        &allocationCreateInfo,
-    //        &bufferAllocation.buffer,
-    //        &bufferAllocation.allocation,
-    //        &allocationInfo
-    //    );
-
-    //    if (result != VkResult::VK_SUCCESS)
-    //    {
-    //        return std::nullopt;
-    //    }
-
-    //    assert(allocationInfo.pMappedData);
-    //    assert(allocationInfo.size == byteSize);
-
-    //    return bufferAllocation;
-    //}
-    
     void ResourceAllocator::DeallocateBuffer(const BufferAllocation& bufferAllocation)
     {
+        // a pass starting between the check and the free would pick a freed allocation
+        std::scoped_lock lock(_movesMutex);
+        if (TryAbandonMove(bufferAllocation.allocation, bufferAllocation.buffer, nullptr))
+        {
+            // vma frees the memory and the handle is destroyed when the pass ends
+            return;
+        }
         vmaDestroyBuffer(_vma, bufferAllocation.buffer, bufferAllocation.allocation);
     }
 
@@ -418,6 +460,11 @@ namespace eureka::vulkan
 
     void ResourceAllocator::DeallocateImage(const ImageAllocation& imageAllocation)
     {
+        std::scoped_lock lock(_movesMutex);
+        if (TryAbandonMove(imageAllocation.allocation, nullptr, imageAllocation.image))
+        {
+            return;
+        }
         vmaDestroyImage(_vma, imageAllocation.image, imageAllocation.allocation);
     }
 
@@ -431,10 +478,309 @@ namespace eureka::vulkan
         VK_CHECK(vmaFlushAllocation(_vma, bufferAllocation.allocation, 0, bufferAllocation.byte_size));
     }
 
+    void ResourceAllocator::FlushBufferRange(const BufferAllocation& bufferAllocation, uint64_t byteOffset, uint64_t byteSize)
+    {
+        // no-op on coherent memory, vma rounds the range to nonCoherentAtomSize otherwise
+        VK_CHECK(vmaFlushAllocation(_vma, bufferAllocation.allocation, byteOffset, byteSize));
+    }
+
+    void ResourceAllocator::SetCurrentFrameIndex(uint32_t frameIndex)
+    {
+        vmaSetCurrentFrameIndex(_vma, frameIndex);
+    }
+
+    std::vector<HeapBudget> ResourceAllocator::HeapBudgets() const
+    {
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(_vma, &memoryProperties);
+
+        std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+        vmaGetHeapBudgets(_vma, budgets.data());
+
+        std::vector<HeapBudget> heapBudgets;
+        heapBudgets.reserve(memoryProperties->memoryHeapCount);
+        for (auto heapIndex = 0u; heapIndex < memoryProperties->memoryHeapCount; ++heapIndex)
+        {
+            const auto& budget = budgets[heapIndex];
+            heapBudgets.emplace_back(HeapBudget
+                {
+                    .heap_index = heapIndex,
+                    .device_local = (memoryProperties->memoryHeaps[heapIndex].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0,
+                    .block_count = budget.statistics.blockCount,
+                    .allocation_count = budget.statistics.allocationCount,
+                    .block_bytes = budget.statistics.blockBytes,
+                    .allocation_bytes = budget.statistics.allocationBytes,
+                    .usage = budget.usage,
+                    .budget = budget.budget
+                });
+        }
+        return heapBudgets;
+    }
+
+    uint32_t ResourceAllocator::HeapIndexForPreset(BufferAllocationPreset preset) const
+    {
+        VkBufferCreateInfo bufferCreateInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = 1,
+            .usage = BUFFER_ALLOCATION_PRESETS[preset].buffer_usage_bits
+        };
+
+        VmaAllocationCreateInfo allocationCreateInfo
+        {
+            .flags = BUFFER_ALLOCATION_PRESETS[preset].allocation_flags,
+            .usage = VMA_MEMORY_USAGE_AUTO
+        };
+
+        uint32_t memTypeIndex;
+        VK_CHECK(vmaFindMemoryTypeIndexForBufferInfo(
+            _vma,
+            &bufferCreateInfo,
+            &allocationCreateInfo,
+            &memTypeIndex
+        ));
+
+        const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+        vmaGetMemoryProperties(_vma, &memoryProperties);
+        return memoryProperties->memoryTypes[memTypeIndex].heapIndex;
+    }
+
+    PoolStatistics ResourceAllocator::GetPoolStatistics(const PoolAllocation& poolAllocation) const
+    {
+        VmaStatistics statistics{};
+        vmaGetPoolStatistics(_vma, poolAllocation.pool, &statistics);
+
+        return PoolStatistics
+        {
+            .block_count = statistics.blockCount,
+            .allocation_count = statistics.allocationCount,
+            .block_bytes = statistics.blockBytes,
+            .allocation_bytes = statistics.allocationBytes
+        };
+    }
+
+    std::string ResourceAllocator::BuildStatsJson(bool detailedMap) const
+    {
+        char* statsString = nullptr;
+        vmaBuildStatsString(_vma, &statsString, detailedMap ? VK_TRUE : VK_FALSE);
+
+        std::string json(statsString);
+        vmaFreeStatsString(_vma, statsString);
+        return json;
+    }
+
+    bool ResourceAllocator::TryAbandonMove(VmaAllocation allocation, VkBuffer buffer, VkImage image)
+    {
+        if (_moves.empty())
+        {
+            return false;
+        }
+
+        auto it = _moves.find(allocation);
+        if (it == _moves.end())
+        {
+            return false;
+        }
+
+        // the source allocation and the reserved destination are both freed by vmaEndDefragmentationPass
+        // the handle may already be bound to the destination with the pass copy still pending
+        it->second->operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_DESTROY;
+        _moves.erase(it);
+        if (buffer)
+        {
+            _abandonedBuffers.emplace_back(buffer);
+        }
+        if (image)
+        {
+            _abandonedImages.emplace_back(image);
+        }
+        return true;
+    }
+
+    VmaDefragmentationContext ResourceAllocator::BeginDefragmentation(VmaPool pool, const DefragmentationLimits& limits)
+    {
+        VmaDefragmentationInfo defragmentationInfo
+        {
+            .flags = VMA_DEFRAGMENTATION_FLAG_ALGORITHM_BALANCED_BIT,
+            .pool = pool,
+            .maxBytesPerPass = limits.max_bytes_per_pass,
+            .maxAllocationsPerPass = limits.max_allocations_per_pass
+        };
+
+        VmaDefragmentationContext context{ nullptr };
+        auto result = vmaBeginDefragmentation(_vma, &defragmentationInfo, &context);
+        if (result == VkResult::VK_ERROR_FEATURE_NOT_PRESENT)
+        {
+            return nullptr;
+        }
+        VK_CHECK(result);
+        return context;
+    }
+
+    DefragmentationStatistics ResourceAllocator::EndDefragmentation(VmaDefragmentationContext context)
+    {
+        VmaDefragmentationStats stats{};
+        vmaEndDefragmentation(_vma, context, &stats);
+
+        return DefragmentationStatistics
+        {
+            .bytes_moved = stats.bytesMoved,
+            .bytes_freed = stats.bytesFreed,
+            .allocations_moved = stats.allocationsMoved,
+            .blocks_freed = stats.deviceMemoryBlocksFreed
+        };
+    }
+
+    bool ResourceAllocator::BeginDefragmentationPass(VmaDefragmentationContext context, VmaDefragmentationPassMoveInfo& pass)
+    {
+        // an allocation freed while vma picks the moves would otherwise become a move source
+        std::scoped_lock lock(_movesMutex);
+
+        auto result = vmaBeginDefragmentationPass(_vma, context, &pass);
+        if (result == VkResult::VK_SUCCESS)
+        {
+            return false;
+        }
+        assert(result == VkResult::VK_INCOMPLETE);
+
+        for (auto i = 0u; i < pass.moveCount; ++i)
+        {
+            _moves.emplace(pass.pMoves[i].srcAllocation, &pass.pMoves[i]);
+        }
+        return true;
+    }
+
+    bool ResourceAllocator::EndDefragmentationPass(VmaDefragmentationContext context, VmaDefragmentationPassMoveInfo& pass)
+    {
+        std::scoped_lock lock(_movesMutex);
+        _moves.clear();
+
+        // the handles go before the memory vma frees now
+        for (auto buffer : _abandonedBuffers)
+        {
+            DestroyBuffer(buffer);
+        }
+        for (auto image : _abandonedImages)
+        {
+            DestroyImage(image);
+        }
+        _abandonedBuffers.clear();
+        _abandonedImages.clear();
+
+        auto result = vmaEndDefragmentationPass(_vma, context, &pass);
+        assert(result == VkResult::VK_SUCCESS || result == VkResult::VK_INCOMPLETE);
+        return result == VkResult::VK_SUCCESS;
+    }
+
+    void ResourceAllocator::SetRelocatable(VmaAllocation allocation, Relocatable* relocatable)
+    {
+        std::scoped_lock lock(_movesMutex);
+        vmaSetAllocationUserData(_vma, allocation, relocatable);
+    }
+
+    VkBuffer ResourceAllocator::CreateBuffer(VmaAllocation memory, uint64_t byteSize, VkBufferUsageFlags usage)
+    {
+        VkBufferCreateInfo bufferCreateInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+            .size = byteSize,
+            .usage = usage
+        };
+
+        VkBuffer buffer{ nullptr };
+        VK_CHECK(vkCreateBuffer(_device->GetDevice(), &bufferCreateInfo, nullptr, &buffer));
+        VK_CHECK(vmaBindBufferMemory(_vma, memory, buffer));
+        return buffer;
+    }
+
+    VkImage ResourceAllocator::CreateImage2D(VmaAllocation memory, const VkExtent2D& extent, Image2DAllocationPreset preset, uint32_t mipLevels)
+    {
+        const Image2DAllocationPresetVals& presetVals = IMAGE2D_ALLOCATION_PRESETS[preset];
+
+        VkImageCreateInfo createInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VkImageType::VK_IMAGE_TYPE_2D,
+            .format = presetVals.format,
+            .extent = VkExtent3D{extent.width, extent.height, 1},
+            .mipLevels = mipLevels,
+            .arrayLayers = 1,
+            .samples = VkSampleCountFlagBits::VK_SAMPLE_COUNT_1_BIT,
+            .tiling = VkImageTiling::VK_IMAGE_TILING_OPTIMAL,
+            .usage = presetVals.usage_flags,
+            .sharingMode = VkSharingMode::VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        VkImage image{ nullptr };
+        VK_CHECK(vkCreateImage(_device->GetDevice(), &createInfo, nullptr, &image));
+        VK_CHECK(vmaBindImageMemory(_vma, memory, image));
+        return image;
+    }
+
+    void ResourceAllocator::DestroyBuffer(VkBuffer buffer)
+    {
+        vkDestroyBuffer(_device->GetDevice(), buffer, nullptr);
+    }
+
+    void ResourceAllocator::DestroyImage(VkImage image)
+    {
+        vkDestroyImage(_device->GetDevice(), image, nullptr);
+    }
+
+    FormatBlock GetFormatBlock(VkFormat format)
+    {
+        switch (format)
+        {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SRGB:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT:
+            return FormatBlock{ .width = 1, .height = 1, .bytes = 4 };
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+            return FormatBlock{ .width = 4, .height = 4, .bytes = 8 };
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+        case VK_FORMAT_BC3_SRGB_BLOCK:
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+        case VK_FORMAT_ASTC_4x4_SRGB_BLOCK:
+            return FormatBlock{ .width = 4, .height = 4, .bytes = 16 };
+        default:
+            throw std::logic_error("not implemented");
+        }
+    }
+
+    uint64_t GetImageLevelBytes(VkFormat format, VkExtent2D extent)
+    {
+        auto block = GetFormatBlock(format);
+        uint64_t blocksWide = (extent.width + block.width - 1) / block.width;
+        uint64_t blocksHigh = (extent.height + block.height - 1) / block.height;
+        return blocksWide * blocksHigh * block.bytes;
+    }
+
     Image2DAllocationPreset GetDefaultImagePresetForFormat(VkFormat format)
     {
         switch (format)
         {
+        case VK_FORMAT_R8G8B8A8_UNORM:
+            return Image2DAllocationPreset::eR8G8B8A8UnormSampledShaderResource;
+        case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+            return Image2DAllocationPreset::eBC1RgbaUnormSampledShaderResource;
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+            return Image2DAllocationPreset::eBC1RgbUnormSampledShaderResource;
+        case VK_FORMAT_BC3_UNORM_BLOCK:
+            return Image2DAllocationPreset::eBC3UnormSampledShaderResource;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            return Image2DAllocationPreset::eBC5UnormSampledShaderResource;
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+            return Image2DAllocationPreset::eBC7UnormSampledShaderResource;
+        case VK_FORMAT_ASTC_4x4_UNORM_BLOCK:
+            return Image2DAllocationPreset::eASTC4x4UnormSampledShaderResource;
         case VK_FORMAT_D24_UNORM_S8_UINT:
             return Image2DAllocationPreset::eD24UnormS8UintDepthImage;
         case VK_FORMAT_D32_SFLOAT:
@@ -444,7 +790,23 @@ namespace eureka::vulkan
         }
     }
 
-    VkImageView CreateImage2DView(const Device& device, VkImage image, Image2DAllocationPreset preset)
+    VkFormat GetImagePresetFormat(Image2DAllocationPreset preset)
+    {
+        return IMAGE2D_ALLOCATION_PRESETS[preset].format;
+    }
+
+    VkImageAspectFlags GetImagePresetAspect(Image2DAllocationPreset preset)
+    {
+        return IMAGE2D_ALLOCATION_PRESETS[preset].aspect_flags;
+    }
+
+    bool IsImagePresetRelocatable(Image2DAllocationPreset preset)
+    {
+        constexpr VkImageUsageFlags COPY_USAGE = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        return (IMAGE2D_ALLOCATION_PRESETS[preset].usage_flags & COPY_USAGE) == COPY_USAGE;
+    }
+
+    VkImageView CreateImage2DView(const Device& device, VkImage image, Image2DAllocationPreset preset, uint32_t mipLevels)
     {
         const Image2DAllocationPresetVals& presetVals = IMAGE2D_ALLOCATION_PRESETS[preset];
        
@@ -452,7 +814,7 @@ namespace eureka::vulkan
         {
             .aspectMask = presetVals.aspect_flags,
             .baseMipLevel = 0,
-            .levelCount = presetVals.mip_levels, 
+            .levelCount = mipLevels ? mipLevels : presetVals.mip_levels,
             .baseArrayLayer = 0,
             .layerCount = 1
         };
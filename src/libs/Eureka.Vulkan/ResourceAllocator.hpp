@@ -4,21 +4,60 @@
 #include "Instance.hpp"
 #include "vk_mem_alloc.h"
 #include <array>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace eureka::vulkan
 {
+    //
+    // pools grow a block at a time, a full pool allocates a new block instead of failing as long as the
+    // block count and the heap budget allow it
+    //
+    struct PoolBlocksConfig
+    {
+        uint64_t    block_byte_size{ 0 };  // 0 - vma default, 1/8 of the heap up to 256MB
+        std::size_t min_block_count{ 0 };  // allocated up front and never released
+        std::size_t max_block_count{ 0 };  // 0 - unbounded, only the heap budget limits the growth
+    };
+
     struct PoolAllocation
     {
-        VmaPool  pool {nullptr};
-        uint64_t byte_size {0};
+        VmaPool     pool {nullptr};
+        uint64_t    block_byte_size {0};
+        std::size_t max_block_count {0};
+        uint32_t    heap_index {0};
+    };
+
+    struct PoolStatistics
+    {
+        uint32_t block_count{ 0 };
+        uint32_t allocation_count{ 0 };
+        uint64_t block_bytes{ 0 };       // device memory owned by the pool
+        uint64_t allocation_bytes{ 0 };  // bytes handed out, block_bytes - allocation_bytes is the free space
+    };
+
+    struct HeapBudget
+    {
+        uint32_t heap_index{ 0 };
+        bool     device_local{ false };
+        uint32_t block_count{ 0 };
+        uint32_t allocation_count{ 0 };
+        uint64_t block_bytes{ 0 };       // device memory allocated by this allocator
+        uint64_t allocation_bytes{ 0 };
+        uint64_t usage{ 0 };             // heap usage of the whole process, estimated from block_bytes without VK_EXT_memory_budget
+        uint64_t budget{ 0 };            // what the process can use before allocations start failing or evicting other apps
     };
 
     struct BufferAllocation
     {
-        VmaAllocation allocation {nullptr};
-        VkBuffer      buffer {nullptr};
-        uint64_t      byte_size {0};
-        void*         ptr {nullptr};
+        VmaAllocation      allocation {nullptr};
+        VkBuffer           buffer {nullptr};
+        uint64_t           byte_size {0};
+        void*              ptr {nullptr};
+        VkBufferUsageFlags usage {0};
     };
 
     struct ImageAllocation
@@ -33,6 +72,8 @@ namespace eureka::vulkan
         eHostWriteCombinedBufferAsTransferSrc,
         eVertexAndIndexTransferableDeviceBuffer,
         eHostVisibleVertexAndIndexTransferableDeviceBuffer,
+        eHostWriteCombinedVertexAndIndexBuffer,
+        eStorageTransferableDeviceBuffer,
         BUFFER_ALLOCATION_PRESETS_COUNT
     };
 
@@ -46,35 +87,95 @@ namespace eureka::vulkan
     {
         eR8G8B8A8UnormSampledShaderResource,
         eR8G8B8A8UnormSampledShaderResourceRenderTargetTransferSrcDst,
+        eBC1RgbaUnormSampledShaderResource,
+        eBC1RgbUnormSampledShaderResource,
+        eBC3UnormSampledShaderResource,
+        eBC5UnormSampledShaderResource,
+        eBC7UnormSampledShaderResource,
+        eASTC4x4UnormSampledShaderResource,
         eD24UnormS8UintDepthImage,
         eD32FloatDepthImage,
         IMAGE2D_ALLOCATION_PRESETS_COUNT
     };
 
+    //
+    // texel block of a format, 1x1 for uncompressed formats
+    // rows of a tightly packed image are rounded up to whole blocks
+    //
+    struct FormatBlock
+    {
+        uint32_t width{ 1 };
+        uint32_t height{ 1 };
+        uint32_t bytes{ 0 };
+    };
+
+    FormatBlock GetFormatBlock(VkFormat format);
+    // bytes of a tightly packed level of the given extent
+    uint64_t GetImageLevelBytes(VkFormat format, VkExtent2D extent);
+
     Image2DAllocationPreset GetDefaultImagePresetForFormat(VkFormat format);
+    VkFormat GetImagePresetFormat(Image2DAllocationPreset preset);
+    VkImageAspectFlags GetImagePresetAspect(Image2DAllocationPreset preset);
+    // images are relocated with a copy, their usage has to allow it
+    bool IsImagePresetRelocatable(Image2DAllocationPreset preset);
+
+    struct DefragmentationLimits
+    {
+        uint64_t max_bytes_per_pass{ 0 };        // 0 - unbounded
+        uint32_t max_allocations_per_pass{ 0 };  // 0 - unbounded
+    };
+
+    struct DefragmentationStatistics
+    {
+        uint64_t bytes_moved{ 0 };
+        uint64_t bytes_freed{ 0 };
+        uint32_t allocations_moved{ 0 };
+        uint32_t blocks_freed{ 0 };
+    };
+
+    struct ResourceAllocatorConfig
+    {
+        uint64_t preferred_block_byte_size{ 0 }; // default pools block size on large heaps, 0 - vma default (256MB)
+    };
+
+    class Relocatable;
 
     class ResourceAllocator
     {
         std::shared_ptr<Instance> _instnace;
         std::shared_ptr<Device>   _device;
         VmaAllocator              _vma {nullptr};
+        bool                      _memoryBudgetExtention {false};
+
+        // allocations moved by the current defragmentation pass, a deallocation of one of them abandons the move
+        // instead of freeing memory that vma still owns
+        // the lock is held across the vma pass calls as well, deallocations on other threads see either no pass or
+        // the whole of it
+        mutable std::mutex                                          _movesMutex;
+        std::unordered_map<VmaAllocation, VmaDefragmentationMove*> _moves;
+        // handles of abandoned moves, the pass copy may still write them, destroyed when the pass ends
+        std::vector<VkBuffer>                                       _abandonedBuffers;
+        std::vector<VkImage>                                        _abandonedImages;
+
+        // with the moves lock held
+        bool TryAbandonMove(VmaAllocation allocation, VkBuffer buffer, VkImage image);
 
     public:
-        ResourceAllocator(std::shared_ptr<Instance> instance, std::shared_ptr<Device> device);
+        ResourceAllocator(std::shared_ptr<Instance> instance, std::shared_ptr<Device> device, ResourceAllocatorConfig config = {});
         ResourceAllocator(const ResourceAllocator&) = delete;
         ResourceAllocator& operator=(const ResourceAllocator&) = delete;
         ~ResourceAllocator();
 
         BufferAllocation AllocateBuffer(uint64_t byteSize, BufferAllocationPreset preset);
-        PoolAllocation   AllocateBufferPool(uint64_t byteSize, PoolAllocationPreset preset);
+        PoolAllocation   AllocateBufferPool(const PoolBlocksConfig& blocks, PoolAllocationPreset preset);
         ImageAllocation
-        AllocateImage2D(const VkExtent2D& extent, Image2DAllocationPreset preset, bool dedicated = false);
-        PoolAllocation AllocateBufferPool(uint64_t                 byteSize,
+        AllocateImage2D(const VkExtent2D& extent, Image2DAllocationPreset preset, bool dedicated = false, uint32_t mipLevels = 1);
+        PoolAllocation AllocateBufferPool(const PoolBlocksConfig&  blocks,
                                           VkBufferUsageFlags       usageFlags,
                                           VmaAllocationCreateFlags allocationFlags,
                                           VmaPoolCreateFlags       poolFlags);
 
-        PoolAllocation AllocateImage2DPool(uint64_t                 byteSize,
+        PoolAllocation AllocateImage2DPool(const PoolBlocksConfig&  blocks,
                                            Image2DAllocationPreset  preset,
                                            VmaAllocationCreateFlags allocationFlags,
                                            VmaPoolCreateFlags       poolFlags);
@@ -84,16 +185,83 @@ namespace eureka::vulkan
                                             VkBufferUsageFlags       usage,
                                             VmaAllocationCreateFlags allocationFlags);
 
-        ImageAllocation AllocatePoolImage(VmaPool pool, const VkExtent2D& extent, Image2DAllocationPreset preset);
-        //std::optional<BufferAllocation> TryAllocatePoolBuffer(VmaPool pool, uint64_t byteSize);
+        // nullopt instead of throwing when the pool is out of blocks or a new block would exceed the heap budget
+        std::optional<BufferAllocation> TryAllocatePoolBuffer(VmaPool                  pool,
+                                                              uint64_t                 byteSize,
+                                                              VkBufferUsageFlags       usage,
+                                                              VmaAllocationCreateFlags allocationFlags);
+
+        ImageAllocation AllocatePoolImage(VmaPool pool, const VkExtent2D& extent, Image2DAllocationPreset preset, uint32_t mipLevels = 1);
         void DeallocateBuffer(const BufferAllocation& bufferAllocation);
         void DeallocatePool(const PoolAllocation& poolAllocation);
         void DeallocateImage(const ImageAllocation& imageAllocation);
 
         void InvalidateBuffer(const BufferAllocation& bufferAllocation);
         void FlushBuffer(const BufferAllocation& bufferAllocation);
+        void FlushBufferRange(const BufferAllocation& bufferAllocation, uint64_t byteOffset, uint64_t byteSize);
+
+        //
+        // budget and statistics, thread safe
+        //
+
+        // the budgets are refetched from the driver when the frame index changes (or every few allocations)
+        void SetCurrentFrameIndex(uint32_t frameIndex);
+        bool HasMemoryBudgetExtention() const { return _memoryBudgetExtention; }
+        std::vector<HeapBudget> HeapBudgets() const;
+        uint32_t HeapIndexForPreset(BufferAllocationPreset preset) const;
+        PoolStatistics GetPoolStatistics(const PoolAllocation& poolAllocation) const;
+
+        // vma json dump, per heap / memory type / pool statistics, detailedMap adds every allocation
+        std::string BuildStatsJson(bool detailedMap = false) const;
+
+        //
+        // incremental defragmentation, driven by Defragmenter
+        //
+
+        // a null pool defragments the default pools, returns nullptr for pools that can't be defragmented (linear)
+        VmaDefragmentationContext BeginDefragmentation(VmaPool pool, const DefragmentationLimits& limits);
+        DefragmentationStatistics EndDefragmentation(VmaDefragmentationContext context);
+
+        // false when there is nothing left to move, the pass moves are tracked until the pass ends
+        bool BeginDefragmentationPass(VmaDefragmentationContext context, VmaDefragmentationPassMoveInfo& pass);
+        // false while more passes are needed, call once the pass copy completed
+        bool EndDefragmentationPass(VmaDefragmentationContext context, VmaDefragmentationPassMoveInfo& pass);
+
+        // fn(VmaDefragmentationMove&, Relocatable*) under the moves lock, moves without a relocatable owner are ignored
+        template<typename Fn>
+        void VisitDefragmentationMoves(VmaDefragmentationPassMoveInfo& pass, Fn&& fn)
+        {
+            std::scoped_lock lock(_movesMutex);
+            for (auto i = 0u; i < pass.moveCount; ++i)
+            {
+                auto& move = pass.pMoves[i];
+                if (move.operation != VMA_DEFRAGMENTATION_MOVE_OPERATION_COPY)
+                {
+                    continue;
+                }
+
+                VmaAllocationInfo allocationInfo{};
+                vmaGetAllocationInfo(_vma, move.srcAllocation, &allocationInfo);
+                if (!allocationInfo.pUserData)
+                {
+                    move.operation = VMA_DEFRAGMENTATION_MOVE_OPERATION_IGNORE;
+                    continue;
+                }
+                fn(move, static_cast<Relocatable*>(allocationInfo.pUserData));
+            }
+        }
+
+        // registers the owner that rebinds the allocation when it moves, nullptr opts out
+        void SetRelocatable(VmaAllocation allocation, Relocatable* relocatable);
+
+        // handles bound to the destination memory of a move, the memory becomes the allocation's once the pass ends
+        VkBuffer CreateBuffer(VmaAllocation memory, uint64_t byteSize, VkBufferUsageFlags usage);
+        VkImage  CreateImage2D(VmaAllocation memory, const VkExtent2D& extent, Image2DAllocationPreset preset, uint32_t mipLevels = 1);
+        void     DestroyBuffer(VkBuffer buffer);
+        void     DestroyImage(VkImage image);
     };
 
-    VkImageView CreateImage2DView(const Device& device, VkImage image, Image2DAllocationPreset preset);
+    // mipLevels 0 - the preset's level count
+    VkImageView CreateImage2DView(const Device& device, VkImage image, Image2DAllocationPreset preset, uint32_t mipLevels = 0);
 
 } // namespace eureka::vulkan
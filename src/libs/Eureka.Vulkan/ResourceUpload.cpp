@@ -1,7 +1,30 @@
 #include "ResourceUpload.hpp"
+#include "ResourceAllocator.hpp"
+#include <algorithm>
+#include <cassert>
 
 namespace eureka::vulkan
 {
+    namespace
+    {
+        //
+        // buffer rows of the copy in texels, whole blocks for block compressed formats
+        // the image extent itself stays the level extent, the copy may end mid block only at the level edge
+        //
+        VkExtent2D StageRowExtent(const ImageStageUploadDesc& imageUploadDesc)
+        {
+            auto block = GetFormatBlock(imageUploadDesc.destination_format);
+            const auto& extent = imageUploadDesc.destination_image_extent;
+            assert(imageUploadDesc.unpinned_src_span.size_bytes() >= GetImageLevelBytes(imageUploadDesc.destination_format, VkExtent2D{ extent.width, extent.height }));
+
+            return VkExtent2D
+            {
+                .width = (extent.width + block.width - 1) / block.width * block.width,
+                .height = (extent.height + block.height - 1) / block.height * block.height
+            };
+        }
+    }
+
     CopyQueueSampledImageUploadSequence CreateImageUploadCommandSequence(
         const Queue& copyQueue,
         const Queue& graphicsQueue,
@@ -10,6 +33,9 @@ namespace eureka::vulkan
         // https://github.com/KhronosGroup/Vulkan-Docs/wiki/Synchronization-Examples#upload-data-from-the-cpu-to-an-image-sampled-in-a-fragment-shader
         // https://www.khronos.org/registry/vulkan/specs/1.0/html/vkspec.html#synchronization-queue-transfers
         // https://stackoverflow.com/questions/67993790/how-do-you-properly-transition-the-image-layout-from-transfer-optimal-to-shader
+        assert(imageUploadDesc.generate_mip_levels == 0); // only the synchronization2 sequences generate mips
+
+        auto rows = StageRowExtent(imageUploadDesc);
 
         return CopyQueueSampledImageUploadSequence
         {
@@ -29,21 +55,23 @@ namespace eureka::vulkan
                 .subresourceRange = VkImageSubresourceRange
                 {
                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                   .baseMipLevel = 0,
+                   .baseMipLevel = imageUploadDesc.destination_mip_level,
                    .levelCount = 1,
                    .layerCount = 1
                 }
             },
             // copy command 
             // we copy a certain range from a stage buffer
-            // this assumes we write a single mip layer and the whole image at once
+            // this assumes we write a whole mip level at once, tightly packed
             .copy_queue_transfer = VkBufferImageCopy
             {
                 .bufferOffset = imageUploadDesc.stage_zone_offset,
+                .bufferRowLength = rows.width,
+                .bufferImageHeight = rows.height,
                 .imageSubresource = VkImageSubresourceLayers
                 {
                     .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                    .mipLevel = 0,
+                    .mipLevel = imageUploadDesc.destination_mip_level,
                     .baseArrayLayer = 0,
                     .layerCount = 1
                 },
@@ -64,7 +92,7 @@ namespace eureka::vulkan
                 .subresourceRange = VkImageSubresourceRange
                 {
                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                   .baseMipLevel = 0,
+                   .baseMipLevel = imageUploadDesc.destination_mip_level,
                    .levelCount = 1,
                    .layerCount = 1
                 }
@@ -83,7 +111,7 @@ namespace eureka::vulkan
                 .subresourceRange = VkImageSubresourceRange
                 {
                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                   .baseMipLevel = 0,
+                   .baseMipLevel = imageUploadDesc.destination_mip_level,
                    .levelCount = 1,
                    .layerCount = 1
                 }
@@ -94,6 +122,14 @@ namespace eureka::vulkan
 
     CopyQueueSampledImageUploadSequence2 CreateImageUploadCommandSequence2(const Queue& copyQueue, const Queue& graphicsQueue, const ImageStageUploadDesc& imageUploadDesc)
     {
+        auto rows = StageRowExtent(imageUploadDesc);
+
+        // the level is either sampled right away or read by the first mip blit
+        auto blitSource = imageUploadDesc.generate_mip_levels > 0;
+        auto finalLayout = blitSource ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        auto finalStage = blitSource ? VK_PIPELINE_STAGE_2_BLIT_BIT : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        auto finalAccess = blitSource ? VK_ACCESS_2_TRANSFER_READ_BIT : VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+
         return CopyQueueSampledImageUploadSequence2
         {            
             // Pipeline barrier before the copy to perform a layout transition
@@ -114,28 +150,30 @@ namespace eureka::vulkan
                 .subresourceRange = VkImageSubresourceRange
                 {
                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                   .baseMipLevel = 0,
+                   .baseMipLevel = imageUploadDesc.destination_mip_level,
                    .levelCount = 1,
                    .layerCount = 1
                 }
             },
             // copy command 
             // we copy a certain range from a stage buffer
-            // this assumes we write a single mip layer and the whole image at once
+            // this assumes we write a whole mip level at once, tightly packed
             .copy_queue_transfer = VkBufferImageCopy2
             {
                 .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_IMAGE_COPY_2,
                 .bufferOffset = imageUploadDesc.stage_zone_offset,
+                .bufferRowLength = rows.width,
+                .bufferImageHeight = rows.height,
                 .imageSubresource = VkImageSubresourceLayers
                 {
                     .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                    .mipLevel = 0,
+                    .mipLevel = imageUploadDesc.destination_mip_level,
                     .baseArrayLayer = 0,
                     .layerCount = 1
                 },
                 .imageExtent = imageUploadDesc.destination_image_extent
             },
-            // release copy queue ownership and transition layout to shader read only optimal
+            // release copy queue ownership and transition layout to shader read only optimal (transfer src for mip generation)
             // flushes the caches after the transfer 
             //
             .copy_queue_release = VkImageMemoryBarrier2
@@ -143,17 +181,17 @@ namespace eureka::vulkan
                 .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
                 .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
                 .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
-                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
-                .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, // ignored in copy queue
+                .dstStageMask = finalStage,
+                .dstAccessMask = finalAccess, // ignored in copy queue
                 .oldLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .newLayout = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .newLayout = finalLayout,
                 .srcQueueFamilyIndex = copyQueue.Family(),  // ignored in unified
                 .dstQueueFamilyIndex = graphicsQueue.Family(), // ignored in unified
                 .image = imageUploadDesc.destination_image,
                 .subresourceRange = VkImageSubresourceRange
                 {
                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                   .baseMipLevel = 0,
+                   .baseMipLevel = imageUploadDesc.destination_mip_level,
                    .levelCount = 1,
                    .layerCount = 1
                 }
@@ -165,17 +203,17 @@ namespace eureka::vulkan
                 .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
                 .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
                 .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,  // ignored in graphics queue
-                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
-                .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                .dstStageMask = finalStage,
+                .dstAccessMask = finalAccess,
                 .oldLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                .newLayout = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .newLayout = finalLayout,
                 .srcQueueFamilyIndex = copyQueue.Family(),  // ignored in unified
                 .dstQueueFamilyIndex = graphicsQueue.Family(), // ignored in unified
                 .image = imageUploadDesc.destination_image,
                 .subresourceRange = VkImageSubresourceRange
                 {
                    .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
-                   .baseMipLevel = 0,
+                   .baseMipLevel = imageUploadDesc.destination_mip_level,
                    .levelCount = 1,
                    .layerCount = 1
                 }
@@ -183,6 +221,151 @@ namespace eureka::vulkan
         };
     }
 
+    GraphicsQueueMipGenerationSequence2 CreateMipGenerationCommandSequence2(const ImageStageUploadDesc& imageUploadDesc)
+    {
+        // blits can't scale block compressed formats, those come with their mip chain
+        assert(GetFormatBlock(imageUploadDesc.destination_format).width == 1);
+        assert(imageUploadDesc.generate_mip_levels > 0);
 
-}
+        auto baseLevel = imageUploadDesc.destination_mip_level;
+        auto levelOffset = [&](uint32_t level)
+        {
+            return VkOffset3D
+            {
+                .x = static_cast<int32_t>(std::max(imageUploadDesc.destination_image_extent.width >> level, 1u)),
+                .y = static_cast<int32_t>(std::max(imageUploadDesc.destination_image_extent.height >> level, 1u)),
+                .z = 1
+            };
+        };
+        auto levelRange = [&](uint32_t level, uint32_t count)
+        {
+            return VkImageSubresourceRange
+            {
+                .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = baseLevel + level,
+                .levelCount = count,
+                .layerCount = 1
+            };
+        };
+        auto levelLayers = [&](uint32_t level)
+        {
+            return VkImageSubresourceLayers
+            {
+                .aspectMask = VkImageAspectFlagBits::VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = baseLevel + level,
+                .baseArrayLayer = 0,
+                .layerCount = 1
+            };
+        };
+
+        GraphicsQueueMipGenerationSequence2 sequence
+        {
+            // the generated levels were never written, their contents are discarded
+            .pre_blit_barrier = VkImageMemoryBarrier2
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT,
+                .srcAccessMask = VK_ACCESS_2_NONE,
+                .dstStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT,
+                .dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .oldLayout = VkImageLayout::VK_IMAGE_LAYOUT_UNDEFINED,
+                .newLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = imageUploadDesc.destination_image,
+                .subresourceRange = levelRange(1, imageUploadDesc.generate_mip_levels)
+            },
+            .blits = {},
+            .blit_done_barriers = {},
+            // every level ends in transfer src, the last one through its own blit done barrier
+            .shader_read_barrier = VkImageMemoryBarrier2
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                .oldLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                .newLayout = VkImageLayout::VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = imageUploadDesc.destination_image,
+                .subresourceRange = levelRange(0, imageUploadDesc.generate_mip_levels + 1)
+            }
+        };
+
+        sequence.blits.reserve(imageUploadDesc.generate_mip_levels);
+        sequence.blit_done_barriers.reserve(imageUploadDesc.generate_mip_levels);
+        for (auto level = 1u; level <= imageUploadDesc.generate_mip_levels; ++level)
+        {
+            sequence.blits.emplace_back(VkImageBlit2
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_BLIT_2,
+                    .srcSubresource = levelLayers(level - 1),
+                    .srcOffsets = { VkOffset3D{ 0, 0, 0 }, levelOffset(level - 1) },
+                    .dstSubresource = levelLayers(level),
+                    .dstOffsets = { VkOffset3D{ 0, 0, 0 }, levelOffset(level) }
+                });
 
+            // the written level becomes the source of the next blit
+            sequence.blit_done_barriers.emplace_back(VkImageMemoryBarrier2
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2,
+                    .srcStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT,
+                    .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                    .dstStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT,
+                    .dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT,
+                    .oldLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                    .newLayout = VkImageLayout::VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = imageUploadDesc.destination_image,
+                    .subresourceRange = levelRange(level, 1)
+                });
+        }
+
+        return sequence;
+    }
+
+    CopyQueueBufferUploadSequence2 CreateBufferUploadCommandSequence2(const Queue& copyQueue, const Queue& graphicsQueue, const BufferDataUploadTransferDesc& bufferUploadDesc)
+    {
+        return CopyQueueBufferUploadSequence2
+        {
+            .copy_queue_transfer = VkBufferCopy2
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_COPY_2,
+                .srcOffset = bufferUploadDesc.stage_zone_offset,
+                .dstOffset = bufferUploadDesc.dst_offset,
+                .size = bufferUploadDesc.bytes
+            },
+            // release copy queue ownership, the consumer of the buffer is not known here (vertex, index, storage...)
+            .copy_queue_release = VkBufferMemoryBarrier2
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT, // ignored in copy queue
+                .srcQueueFamilyIndex = copyQueue.Family(),  // ignored in unified
+                .dstQueueFamilyIndex = graphicsQueue.Family(), // ignored in unified
+                .buffer = bufferUploadDesc.dst_buffer,
+                .offset = bufferUploadDesc.dst_offset,
+                .size = bufferUploadDesc.bytes
+            },
+            // acquire ownership via graphics queue
+            .graphics_queue_acquire = VkBufferMemoryBarrier2
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2,
+                .srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT,
+                .srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT, // ignored in graphics queue
+                .dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+                .dstAccessMask = VK_ACCESS_2_MEMORY_READ_BIT,
+                .srcQueueFamilyIndex = copyQueue.Family(),  // ignored in unified
+                .dstQueueFamilyIndex = graphicsQueue.Family(), // ignored in unified
+                .buffer = bufferUploadDesc.dst_buffer,
+                .offset = bufferUploadDesc.dst_offset,
+                .size = bufferUploadDesc.bytes
+            }
+        };
+    }
+}
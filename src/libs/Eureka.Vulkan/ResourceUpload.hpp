@@ -3,6 +3,7 @@
 #include "../Eureka.Vulkan/Queue.hpp"
 #include <containers_aliases.hpp>
 #include <cstdint>
+#include <vector>
 
 namespace eureka::vulkan
 {
@@ -11,7 +12,10 @@ namespace eureka::vulkan
         dynamic_cspan<uint8_t> unpinned_src_span; // point to data in memory
         uint64_t               stage_zone_offset;
         VkImage                destination_image;
-        VkExtent3D             destination_image_extent;
+        VkExtent3D             destination_image_extent; // of the mip level
+        uint32_t               destination_mip_level{ 0 };
+        VkFormat               destination_format{ VK_FORMAT_R8G8B8A8_UNORM }; // the span holds tightly packed texel blocks of it
+        uint32_t               generate_mip_levels{ 0 }; // levels after destination_mip_level blitted from it on the graphics queue, blittable color formats only
     };
 
     struct BufferDataUploadTransferDesc
@@ -46,8 +50,8 @@ namespace eureka::vulkan
     );
 
     // CopyQueueSampledImageUploadSequence2
-    //
-    //
+    // same as CopyQueueSampledImageUploadSequence with synchronization2 barriers
+    // an upload that generates mips leaves its level in transfer src layout for the first blit instead of shader read only
     struct CopyQueueSampledImageUploadSequence2
     {
         VkImageMemoryBarrier2         copy_queue_pre_transfer_barrier;
@@ -61,5 +65,41 @@ namespace eureka::vulkan
         const Queue& graphicsQueue,
         const ImageStageUploadDesc& imageUploadDesc
     );
+
+    // GraphicsQueueMipGenerationSequence2
+    // mip chain generation from the level of a CopyQueueSampledImageUploadSequence2, recorded on the graphics queue after
+    // the acquire
+    // 1. transition the generated levels to receive the blits
+    // 2. blit level i - 1 into level i (linear filter), then transition level i to be the source of the next blit
+    // 3. transition the whole chain to shader read only optimal
+    struct GraphicsQueueMipGenerationSequence2
+    {
+        VkImageMemoryBarrier2              pre_blit_barrier;
+        std::vector<VkImageBlit2>          blits;
+        std::vector<VkImageMemoryBarrier2> blit_done_barriers; // per blit
+        VkImageMemoryBarrier2              shader_read_barrier;
+    };
+
+    GraphicsQueueMipGenerationSequence2 CreateMipGenerationCommandSequence2(
+        const ImageStageUploadDesc& imageUploadDesc
+    );
+
+    // CopyQueueBufferUploadSequence2
+    // buffer upload sequence via a copy queue, same as the image sequence without the layout transitions
+    // 1. actual transfer (stage_zone_offset -> dst_offset)
+    // 2. release copy queue ownership
+    // 3. acquire graphics queue ownership
+    struct CopyQueueBufferUploadSequence2
+    {
+        VkBufferCopy2                 copy_queue_transfer;
+        VkBufferMemoryBarrier2        copy_queue_release;
+        VkBufferMemoryBarrier2        graphics_queue_acquire;
+    };
+
+    CopyQueueBufferUploadSequence2 CreateBufferUploadCommandSequence2(
+        const Queue& copyQueue,
+        const Queue& graphicsQueue,
+        const BufferDataUploadTransferDesc& bufferUploadDesc
+    );
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 #include "Device.hpp"
 #include <containers_aliases.hpp>
+#include <string_view>
 
 namespace eureka::vulkan
 {
@@ -21,8 +22,9 @@ namespace eureka::vulkan
 
     struct ShadersPipeline
     {
-        svec2<ShaderModule>                    modules;
-        svec2<VkPipelineShaderStageCreateInfo> stages;
+        svec2<std::shared_ptr<const ShaderModule>> modules; // shared with the shader cache
+        svec2<std::string_view>                    names;
+        svec2<VkPipelineShaderStageCreateInfo>     stages;
     };
 }
 
@@ -1,55 +1,318 @@
 #include "ShadersCache.hpp"
 #include <cstdint>
 #include <debugger_trace.hpp>
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
 namespace eureka::vulkan
-{  
-    ShaderCache::ShaderCache(std::shared_ptr<Device> device) 
+{
+    namespace
+    {
+        std::vector<uint8_t> ReadShaderFile(const std::filesystem::path& filename)
+        {
+            std::ifstream is(filename, std::ios::binary | std::ios::in | std::ios::ate);
+            if (!is)
+            {
+                throw std::invalid_argument("bad path");
+            }
+
+            auto shaderSize = static_cast<std::size_t>(is.tellg());
+            is.seekg(0, std::ios::beg);
+
+            std::vector<uint8_t> shaderCode(shaderSize);
+            is.read(reinterpret_cast<char*>(shaderCode.data()), static_cast<std::streamsize>(shaderSize));
+
+            if (!is || shaderSize == 0 || shaderSize % sizeof(uint32_t) != 0)
+            {
+                throw std::invalid_argument("bad spirv file");
+            }
+
+            return shaderCode;
+        }
+
+        std::optional<std::filesystem::file_time_type> WriteTime(const std::filesystem::path& filename)
+        {
+            std::error_code ec;
+            auto writeTime = std::filesystem::last_write_time(filename, ec);
+            if (ec)
+            {
+                return std::nullopt;
+            }
+            return writeTime;
+        }
+    }
+
+    ShaderContentHash HashShaderCode(dcspan<uint8_t> code)
+    {
+        constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+        // SPIR-V is a stream of words, hashing a word at a time is 4x fewer multiplies
+        ShaderContentHash hash = FNV_OFFSET_BASIS;
+        auto words = code.size() / sizeof(uint32_t);
+        for (auto i = 0u; i < words; ++i)
+        {
+            uint32_t word;
+            std::memcpy(&word, code.data() + i * sizeof(uint32_t), sizeof(uint32_t));
+            hash = (hash ^ word) * FNV_PRIME;
+        }
+        for (auto i = words * sizeof(uint32_t); i < code.size(); ++i)
+        {
+            hash = (hash ^ code[i]) * FNV_PRIME;
+        }
+
+        return hash;
+    }
+
+    ShaderCache::ShaderCache(std::shared_ptr<Device> device, ShaderCacheConfig config) 
         :
-        _device(std::move(device))
+        _device(std::move(device)),
+        _config(std::move(config))
     {
     
     }
 
-    ShaderModule ShaderCache::LoadShaderModule(const ShaderId& id) const 
+    std::shared_ptr<const ShaderModule> ShaderCache::FindModule(dcspan<uint8_t> code, ShaderContentHash contentHash) const
+    {
+        auto candidates = _modules.find(contentHash);
+        if (candidates == _modules.end())
+        {
+            return nullptr;
+        }
+
+        auto itr = std::find_if(candidates->second.begin(), candidates->second.end(),
+            [&](const CachedModule& cached)
+            {
+                return std::equal(cached.code.begin(), cached.code.end(), code.begin(), code.end());
+            });
+
+        return itr != candidates->second.end() ? itr->module : nullptr;
+    }
+
+    std::shared_ptr<const ShaderModule> ShaderCache::GetOrCreateModule(std::unique_lock<std::mutex>& lk, dcspan<uint8_t> code, ShaderContentHash contentHash)
     {
+        if (auto module = FindModule(code, contentHash))
+        {
+            ++_counters.deduplicated;
+            return module;
+        }
+
         VkShaderModuleCreateInfo createInfo
         {
             .sType = VkStructureType::VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
             .flags = {},
-            .codeSize = id.size,
-            .pCode = reinterpret_cast<const uint32_t*>(id.ptr)
+            .codeSize = code.size(),
+            .pCode = reinterpret_cast<const uint32_t*>(code.data())
         };
 
-        return ShaderModule(_device, createInfo);
+        lk.unlock();
+        auto module = std::make_shared<const ShaderModule>(_device, createInfo);
+        lk.lock();
+
+        // a concurrent request for the same code may have won, its module is kept
+        if (auto existing = FindModule(code, contentHash))
+        {
+            ++_counters.deduplicated;
+            return existing;
+        }
+
+        _modules[contentHash].emplace_back(CachedModule
+            {
+                .code = std::vector<uint8_t>(code.begin(), code.end()),
+                .module = module
+            });
+        ++_counters.modules_created;
+
+        return module;
+    }
+
+    void ShaderCache::ReleaseUnreferencedModules()
+    {
+        // the ids and files hold their current modules, a module only the cache holds was superseded by a reload
+        // and every pipeline built from it is gone - nobody can take a new reference without the lock
+        for (auto itr = _modules.begin(); itr != _modules.end();)
+        {
+            auto& candidates = itr->second;
+            auto unreferenced = std::remove_if(candidates.begin(), candidates.end(),
+                [](const CachedModule& cached)
+                {
+                    return cached.module.use_count() == 1;
+                });
+            _counters.modules_released += static_cast<uint64_t>(std::distance(unreferenced, candidates.end()));
+            candidates.erase(unreferenced, candidates.end());
+
+            itr = candidates.empty() ? _modules.erase(itr) : std::next(itr);
+        }
+    }
+
+    std::filesystem::path ShaderCache::OverridePath(std::string_view name) const
+    {
+        auto path = _config.watch_directory / name;
+        path += ".spv";
+        return path;
+    }
+
+    std::shared_ptr<const ShaderModule> ShaderCache::LoadShaderModule(const ShaderId& id)
+    {
+        {
+            std::scoped_lock lk(_mtx);
+            ++_counters.requests;
+
+            if (auto itr = _byId.find(id); itr != _byId.end())
+            {
+                return itr->second;
+            }
+        }
+
+        dcspan<uint8_t> embeddedCode(id.ptr, id.size);
+        std::optional<std::filesystem::file_time_type> overrideWriteTime;
+        std::vector<uint8_t> overrideCode;
+
+        if (Watching())
+        {
+            auto overridePath = OverridePath(id.name);
+            overrideWriteTime = WriteTime(overridePath);
+            if (overrideWriteTime)
+            {
+                overrideCode = ReadShaderFile(overridePath);
+            }
+        }
+
+        dcspan<uint8_t> code = overrideWriteTime ? dcspan<uint8_t>(overrideCode) : embeddedCode;
+        auto contentHash = HashShaderCode(code);
+
+        std::unique_lock lk(_mtx);
+        if (auto itr = _byId.find(id); itr != _byId.end())
+        {
+            return itr->second;
+        }
+
+        if (Watching())
+        {
+            auto& watched = _watched[id.name];
+            watched.embedded_code = embeddedCode;
+            watched.override_write_time = overrideWriteTime;
+            watched.content_hash = contentHash;
+        }
+
+        auto module = GetOrCreateModule(lk, code, contentHash);
+
+        // the lock was released while the module was created, the first request to finish wins
+        return _byId.emplace(id, std::move(module)).first->second;
     }
 
-    ShaderModule ShaderCache::LoadShaderModule(const std::filesystem::path& filename) const
+    std::shared_ptr<const ShaderModule> ShaderCache::LoadShaderModule(const std::filesystem::path& filename)
     {
-        if (!std::filesystem::exists(filename))
+        auto writeTime = WriteTime(filename);
+        if (!writeTime)
         {
             throw std::invalid_argument("bad path");
         }
 
-        std::ifstream is(filename, std::ios::binary | std::ios::in | std::ios::ate);
+        {
+            std::scoped_lock lk(_mtx);
+            ++_counters.requests;
 
-        uint32_t shaderSize = static_cast<uint32_t>(is.tellg());
-        is.seekg(0, std::ios::beg);
-        // Copy file contents into a buffer
-        std::vector<char> shaderCode(shaderSize);
-        is.read(shaderCode.data(), shaderSize);
-        is.close();
-  
-        VkShaderModuleCreateInfo createInfo
+            if (auto itr = _byFile.find(filename.native()); itr != _byFile.end() && itr->second.write_time == *writeTime)
+            {
+                return itr->second.module;
+            }
+        }
+
+        auto code = ReadShaderFile(filename);
+        auto contentHash = HashShaderCode(code);
+
+        std::unique_lock lk(_mtx);
+        auto module = GetOrCreateModule(lk, code, contentHash);
+        _byFile.insert_or_assign(filename.native(), LoadedFile{ .write_time = *writeTime, .module = module });
+
+        return module;
+    }
+
+    std::vector<std::string_view> ShaderCache::PollChangedShaders()
+    {
+        struct PolledShader
         {
-            .sType = VkStructureType::VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-            .flags = {},
-            .codeSize = shaderSize,
-            .pCode = reinterpret_cast<const uint32_t*>(shaderCode.data())
+            std::string_view                               name;
+            dcspan<uint8_t>                                embedded_code;
+            std::optional<std::filesystem::file_time_type> write_time;
+            ShaderContentHash                              content_hash{ 0 };
         };
 
-        return ShaderModule(_device, createInfo);
+        std::vector<std::string_view> changed;
+
+        if (!Watching())
+        {
+            return changed;
+        }
+
+        std::vector<PolledShader> polled;
+        {
+            std::scoped_lock lk(_mtx);
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - _lastWatchPoll < _config.watch_poll_interval)
+            {
+                return changed;
+            }
+            _lastWatchPoll = now;
+
+            for (const auto& [name, watched] : _watched)
+            {
+                polled.emplace_back(PolledShader{ .name = name, .embedded_code = watched.embedded_code, .write_time = watched.override_write_time });
+            }
+        }
+
+        // the files are stat'ed, read and hashed without holding up the pipeline compilations
+        std::erase_if(polled, [this](PolledShader& shader)
+            {
+                auto overridePath = OverridePath(shader.name);
+
+                auto writeTime = WriteTime(overridePath);
+                if (writeTime == shader.write_time)
+                {
+                    return true;
+                }
+
+                try
+                {
+                    shader.content_hash = writeTime ? HashShaderCode(ReadShaderFile(overridePath)) : HashShaderCode(shader.embedded_code);
+                    shader.write_time = writeTime;
+                    return false;
+                }
+                catch (const std::exception& err)
+                {
+                    // usually caught mid write, retried on the next poll
+                    DEBUGGER_TRACE("failed reading shader override {}: {}", overridePath.string(), err.what());
+                    return true;
+                }
+            });
+
+        std::scoped_lock lk(_mtx);
+
+        for (const auto& shader : polled)
+        {
+            auto& watched = _watched[shader.name];
+            watched.override_write_time = shader.write_time;
+
+            if (shader.content_hash != watched.content_hash)
+            {
+                watched.content_hash = shader.content_hash;
+                std::erase_if(_byId, [&](const auto& entry) { return shader.name == entry.first.name; });
+                changed.emplace_back(shader.name);
+            }
+        }
+
+        ReleaseUnreferencedModules();
+
+        return changed;
+    }
+
+    ShaderCacheCounters ShaderCache::Counters() const
+    {
+        std::scoped_lock lk(_mtx);
+        return _counters;
     }
 
     ShaderCache::~ShaderCache()
@@ -2,7 +2,11 @@
 #include "../Eureka.Vulkan/Device.hpp"
 #include "../Eureka.Vulkan/ShaderModule.hpp"
 #include "ShadersDeclare.hpp"
+#include <chrono>
 #include <filesystem>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 namespace std
 {
@@ -18,19 +22,92 @@ namespace std
 
 namespace eureka::vulkan
 {
+    using ShaderContentHash = uint64_t;
 
+    // FNV-1a over the SPIR-V words
+    ShaderContentHash HashShaderCode(dcspan<uint8_t> code);
+
+    struct ShaderCacheConfig
+    {
+        std::filesystem::path     watch_directory;                                       // when set, <watch_directory>/<shader name>.spv overrides the embedded shader and is watched for changes
+        std::chrono::milliseconds watch_poll_interval{ std::chrono::milliseconds(250) };
+    };
+
+    struct ShaderCacheCounters
+    {
+        uint64_t requests{ 0 };
+        uint64_t modules_created{ 0 };
+        uint64_t deduplicated{ 0 };      // requests for new code whose content matched an existing module
+        uint64_t modules_released{ 0 };  // superseded by a reload and no longer referenced
+    };
+
+    //
+    // ShaderCache
+    // shader modules keyed by the hash of their SPIR-V, a module is created once per distinct content and shared
+    // by every pipeline that uses it, whichever shader id or file it was requested through
+    // thread safe, pipelines are compiled on the pool - files are read and hashed and modules created outside the lock
+    //
     class ShaderCache
     {
-        std::shared_ptr<Device> _device;
+        struct CachedModule
+        {
+            std::vector<uint8_t>                code; // compared on a hash match
+            std::shared_ptr<const ShaderModule> module;
+        };
 
+        struct LoadedFile
+        {
+            std::filesystem::file_time_type     write_time;
+            std::shared_ptr<const ShaderModule> module;
+        };
+
+        struct WatchedShader
+        {
+            dcspan<uint8_t>                                embedded_code;
+            std::optional<std::filesystem::file_time_type> override_write_time; // empty while the embedded shader is used
+            ShaderContentHash                              content_hash;
+        };
+
+        std::shared_ptr<Device>                                                  _device;
+        ShaderCacheConfig                                                        _config;
+
+        mutable std::mutex                                                       _mtx;
+        std::unordered_map<ShaderContentHash, svec2<CachedModule>>               _modules;
+        std::unordered_map<ShaderId, std::shared_ptr<const ShaderModule>>        _byId;
+        std::unordered_map<std::filesystem::path::string_type, LoadedFile>       _byFile;
+        std::unordered_map<std::string_view, WatchedShader>                      _watched;
+        std::chrono::steady_clock::time_point                                    _lastWatchPoll;
+        ShaderCacheCounters                                                      _counters;
+
+        std::shared_ptr<const ShaderModule> FindModule(dcspan<uint8_t> code, ShaderContentHash contentHash) const;
+        std::shared_ptr<const ShaderModule> GetOrCreateModule(std::unique_lock<std::mutex>& lk, dcspan<uint8_t> code, ShaderContentHash contentHash);
+        void ReleaseUnreferencedModules();
+        std::filesystem::path OverridePath(std::string_view name) const;
     public:
-        ShaderCache() = default;
-        ShaderCache(std::shared_ptr<Device> device);
-        ShaderCache(ShaderCache&& that) = default;
-        ShaderCache& operator=(ShaderCache&& rhs) = default;
+        ShaderCache(std::shared_ptr<Device> device, ShaderCacheConfig config = {});
         ~ShaderCache();
-        ShaderModule LoadShaderModule(const ShaderId& id) const;
-        ShaderModule LoadShaderModule(const std::filesystem::path& filename) const;
+        ShaderCache(const ShaderCache&) = delete;
+        ShaderCache& operator=(const ShaderCache&) = delete;
+
+        std::shared_ptr<const ShaderModule> LoadShaderModule(const ShaderId& id);
+
+        // the file is read again only when its write time changed
+        std::shared_ptr<const ShaderModule> LoadShaderModule(const std::filesystem::path& filename);
+
+        bool Watching() const
+        {
+            return !_config.watch_directory.empty();
+        }
+
+        //
+        // watch mode, throttled by the poll interval
+        // returns the names of the loaded shaders whose content changed since the last poll, their next load
+        // returns the new module - touching a file without changing it reports nothing
+        // a superseded module is released by the first poll after the last pipeline built from it is gone
+        //
+        std::vector<std::string_view> PollChangedShaders();
+
+        ShaderCacheCounters Counters() const;
     };
 
 } // namespace eureka::vulkan
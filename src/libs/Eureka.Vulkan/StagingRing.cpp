@@ -0,0 +1,242 @@
+#include "StagingRing.hpp"
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace eureka::vulkan
+{
+    namespace
+    {
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                           StagingRegion
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    StagingRegion::StagingRegion(std::shared_ptr<StagingRing> ring, uint64_t begin, uint64_t end, uint64_t offset, uint64_t byteSize)
+        :
+        _ring(std::move(ring)),
+        _begin(begin),
+        _end(end),
+        _offset(offset),
+        _byteSize(byteSize)
+    {
+    }
+
+    StagingRegion::~StagingRegion()
+    {
+        if (_ring)
+        {
+            _ring->Release(_begin, _end);
+        }
+    }
+
+    StagingRegion::StagingRegion(StagingRegion&& that) noexcept
+        :
+        _ring(std::move(that._ring)),
+        _begin(that._begin),
+        _end(that._end),
+        _offset(that._offset),
+        _byteSize(that._byteSize),
+        _front(std::exchange(that._front, 0))
+    {
+    }
+
+    StagingRegion& StagingRegion::operator=(StagingRegion&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (_ring)
+            {
+                _ring->Release(_begin, _end);
+            }
+            _ring = std::move(rhs._ring);
+            _begin = rhs._begin;
+            _end = rhs._end;
+            _offset = rhs._offset;
+            _byteSize = rhs._byteSize;
+            _front = std::exchange(rhs._front, 0);
+        }
+        return *this;
+    }
+
+    VkBuffer StagingRegion::Buffer() const
+    {
+        assert(_ring);
+        return _ring->Buffer();
+    }
+
+    uint8_t* StagingRegion::Ptr() const
+    {
+        assert(_ring);
+        return static_cast<uint8_t*>(_ring->_allocation.ptr) + _offset;
+    }
+
+    void StagingRegion::Flush()
+    {
+        assert(_ring);
+        if (_front)
+        {
+            _ring->Flush(_offset, _front);
+        }
+    }
+
+    //////////////////////////////////////////////////////////////////////////
+    //
+    //                            StagingRing
+    //
+    //////////////////////////////////////////////////////////////////////////
+
+    StagingRing::StagingRing(std::shared_ptr<ResourceAllocator> allocator, StagingRingConfig config)
+        :
+        _allocator(std::move(allocator)),
+        _allocation(_allocator->AllocateBuffer(config.byte_size, BufferAllocationPreset::eHostWriteCombinedBufferAsTransferSrc)),
+        _capacity(_allocation.byte_size)
+    {
+        assert(_allocation.ptr);
+    }
+
+    StagingRing::~StagingRing()
+    {
+        // every region holds the ring, nothing can be in flight here
+        assert(_head.load() == _tail.load());
+        _allocator->DeallocateBuffer(_allocation);
+    }
+
+    uint64_t StagingRing::MaxAllocationSize(uint64_t alignment) const
+    {
+        // a request that does not fit before the end of the ring starts over at offset 0 and also consumes
+        // the skipped tail bytes, bounding the size by half the ring keeps that possible on an empty ring
+        return (_capacity - alignment) / 2;
+    }
+
+    std::optional<StagingRegion> StagingRing::TryAllocate(uint64_t byteSize, uint64_t alignment)
+    {
+        assert(alignment && (alignment & (alignment - 1)) == 0);
+
+        if (byteSize == 0 || byteSize > MaxAllocationSize(alignment))
+        {
+            throw std::length_error("staging ring allocation size");
+        }
+
+        auto head = _head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            auto physical = head % _capacity;
+            auto offset = AlignUp(physical, alignment);
+            auto start = head + (offset - physical);
+            if (offset + byteSize > _capacity)
+            {
+                // skip the bytes left at the end of the buffer, they are reclaimed with this region
+                offset = 0;
+                start = head + (_capacity - physical);
+            }
+            auto end = start + byteSize;
+
+            if (end - _tail.load(std::memory_order_acquire) > _capacity)
+            {
+                return std::nullopt;
+            }
+
+            if (_head.compare_exchange_weak(head, end, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                return StagingRegion(shared_from_this(), head, end, offset, byteSize);
+            }
+        }
+    }
+
+    StagingRegion StagingRing::Allocate(uint64_t byteSize, uint64_t alignment)
+    {
+        if (auto region = TryAllocate(byteSize, alignment))
+        {
+            return std::move(*region);
+        }
+
+        // the tail only moves under the lock, so a failed attempt under the lock can not miss a release
+        std::unique_lock lock(_reclaimMutex);
+        for (;;)
+        {
+            if (auto region = TryAllocate(byteSize, alignment))
+            {
+                return std::move(*region);
+            }
+            _reclaimed.wait(lock);
+        }
+    }
+
+    future_t<StagingRegion> StagingRing::AllocateAsync(uint64_t byteSize, uint64_t alignment)
+    {
+        std::optional<StagingRegion> region;
+        if (!(region = TryAllocate(byteSize, alignment)))
+        {
+            std::scoped_lock lock(_reclaimMutex);
+            // earlier waiters go first, otherwise a stream of small requests starves a large one
+            if (!_waiters.empty() || !(region = TryAllocate(byteSize, alignment)))
+            {
+                auto& waiter = _waiters.emplace_back();
+                waiter.byte_size = byteSize;
+                waiter.alignment = alignment;
+                return waiter.promise.get_result();
+            }
+        }
+        return concurrencpp::make_ready_result<StagingRegion>(std::move(*region));
+    }
+
+    uint64_t StagingRing::BytesInFlight() const
+    {
+        return _head.load(std::memory_order_relaxed) - _tail.load(std::memory_order_relaxed);
+    }
+
+    void StagingRing::Flush(uint64_t offset, uint64_t byteSize)
+    {
+        _allocator->FlushBufferRange(_allocation, offset, byteSize);
+    }
+
+    void StagingRing::Release(uint64_t begin, uint64_t end)
+    {
+        std::vector<std::pair<promise_t<StagingRegion>, StagingRegion>> ready;
+        {
+            std::scoped_lock lock(_reclaimMutex);
+
+            auto tail = _tail.load(std::memory_order_relaxed);
+            if (begin != tail)
+            {
+                _released.emplace(begin, end);
+                return;
+            }
+
+            tail = end;
+            for (auto it = _released.find(tail); it != _released.end(); it = _released.find(tail))
+            {
+                tail = it->second;
+                _released.erase(it);
+            }
+            _tail.store(tail, std::memory_order_release);
+
+            while (!_waiters.empty())
+            {
+                auto& waiter = _waiters.front();
+                auto region = TryAllocate(waiter.byte_size, waiter.alignment);
+                if (!region)
+                {
+                    break;
+                }
+                ready.emplace_back(std::move(waiter.promise), std::move(*region));
+                _waiters.pop_front();
+            }
+        }
+        _reclaimed.notify_all();
+
+        // resumes the waiting coroutines inline, must happen outside of the lock since they may release regions
+        for (auto& [promise, region] : ready)
+        {
+            promise.set_result(std::move(region));
+        }
+    }
+}
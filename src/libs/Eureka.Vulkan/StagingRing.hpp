@@ -0,0 +1,150 @@
+#pragma once
+#include "ResourceAllocator.hpp"
+#include <containers_aliases.hpp>
+#include <future.hpp>
+#include <assert.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+
+namespace eureka::vulkan
+{
+    class StagingRing;
+
+    // buffer to image copies need at least 4 bytes and a texel block multiple, 16 covers every color and block compressed format we upload
+    inline constexpr uint64_t STAGING_RING_DEFAULT_ALIGNMENT = 16;
+
+    struct StagingRingConfig
+    {
+        uint64_t byte_size{ 32 * 1024 * 1024 };
+    };
+
+    //
+    // StagingRegion
+    // a suballocation of the staging ring, the bytes return to the ring when the region is destroyed
+    // keep it alive until the transfer reading it is known to be complete (timeline semaphore signaled)
+    //
+    class StagingRegion
+    {
+        std::shared_ptr<StagingRing> _ring;
+        uint64_t                     _begin{ 0 };    // ring position, including the alignment / wrap padding
+        uint64_t                     _end{ 0 };
+        uint64_t                     _offset{ 0 };   // byte offset of the first usable byte inside the ring buffer
+        uint64_t                     _byteSize{ 0 };
+        uint64_t                     _front{ 0 };
+
+        friend class StagingRing;
+        StagingRegion(std::shared_ptr<StagingRing> ring, uint64_t begin, uint64_t end, uint64_t offset, uint64_t byteSize);
+    public:
+        StagingRegion() = default;
+        ~StagingRegion();
+        StagingRegion(const StagingRegion&) = delete;
+        StagingRegion& operator=(const StagingRegion&) = delete;
+        StagingRegion(StagingRegion&& that) noexcept;
+        StagingRegion& operator=(StagingRegion&& rhs) noexcept;
+
+        VkBuffer Buffer() const;
+
+        // offset of the region inside Buffer(), add it to every copy region sourcing from the ring
+        uint64_t Offset() const { return _offset; }
+        uint64_t ByteSize() const { return _byteSize; }
+        uint64_t Position() const { return _front; }
+        uint64_t LeftoverBytes() const { return _byteSize - _front; }
+        uint8_t* Ptr() const;
+
+        template<typename T>
+        void Assign(dcspan<T> s)
+        {
+            assert(s.size_bytes() <= LeftoverBytes());
+
+            std::memcpy(
+                Ptr() + _front,
+                (const uint8_t*)s.data(),
+                s.size_bytes()
+            );
+            _front += s.size_bytes();
+        }
+
+        template<typename T>
+        void Assign(dcspan<T> s, uint64_t byteOffset)
+        {
+            assert(s.size_bytes() + byteOffset <= _byteSize);
+
+            std::memcpy(
+                Ptr() + byteOffset,
+                (const uint8_t*)s.data(),
+                s.size_bytes()
+            );
+            _front = std::max(_front, byteOffset + s.size_bytes());
+        }
+
+        // makes the written bytes visible to the device, required before submitting on non coherent memory
+        void Flush();
+
+        explicit operator bool() const { return _ring != nullptr; }
+    };
+
+    //
+    // StagingRing
+    // a single persistently mapped transfer source buffer handed out as aligned bump allocations
+    //
+    // - TryAllocate is lock free (a CAS on the head), the ring never creates vulkan objects after construction
+    // - bytes are reclaimed in ring order as regions are released, an out of order release is parked until
+    //   everything before it has been released as well
+    // - when the ring is full Allocate blocks and AllocateAsync suspends until enough bytes are reclaimed
+    //   never block on the thread that polls the submissions the regions are waiting for
+    //
+    class StagingRing : public std::enable_shared_from_this<StagingRing>
+    {
+        struct Waiter
+        {
+            uint64_t                      byte_size;
+            uint64_t                      alignment;
+            promise_t<StagingRegion>      promise;
+        };
+
+        std::shared_ptr<ResourceAllocator> _allocator;
+        BufferAllocation                   _allocation;
+        uint64_t                           _capacity;
+
+        // monotonic byte positions, physical offset = position % capacity
+        std::atomic_uint64_t               _head{ 0 };
+        std::atomic_uint64_t               _tail{ 0 };
+
+        std::mutex                         _reclaimMutex;
+        std::condition_variable            _reclaimed;
+        std::map<uint64_t, uint64_t>       _released;  // begin -> end, released ahead of the tail
+        std::deque<Waiter>                 _waiters;
+
+        friend class StagingRegion;
+        void Release(uint64_t begin, uint64_t end);
+        void Flush(uint64_t offset, uint64_t byteSize);
+    public:
+        StagingRing(std::shared_ptr<ResourceAllocator> allocator, StagingRingConfig config = {});
+        ~StagingRing();
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        // larger requests throw std::length_error, they could never fit once the head wrapped
+        uint64_t MaxAllocationSize(uint64_t alignment = STAGING_RING_DEFAULT_ALIGNMENT) const;
+
+        // std::nullopt when the ring can not fit the request right now
+        std::optional<StagingRegion> TryAllocate(uint64_t byteSize, uint64_t alignment = STAGING_RING_DEFAULT_ALIGNMENT);
+
+        // blocks the calling thread until the request fits
+        StagingRegion Allocate(uint64_t byteSize, uint64_t alignment = STAGING_RING_DEFAULT_ALIGNMENT);
+
+        // resolves immediately when the request fits, otherwise when enough bytes were released (FIFO)
+        future_t<StagingRegion> AllocateAsync(uint64_t byteSize, uint64_t alignment = STAGING_RING_DEFAULT_ALIGNMENT);
+
+        VkBuffer Buffer() const { return _allocation.buffer; }
+        uint64_t Capacity() const { return _capacity; }
+        uint64_t BytesInFlight() const;
+        const std::shared_ptr<ResourceAllocator>& Allocator() const { return _allocator; }
+    };
+}
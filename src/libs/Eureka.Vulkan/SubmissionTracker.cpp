@@ -0,0 +1,163 @@
+#include "SubmissionTracker.hpp"
+#include <assert.hpp>
+#include <algorithm>
+
+namespace eureka::vulkan
+{
+    SubmissionTracker::SubmissionTracker(std::shared_ptr<Device> device, Queue queue, SubmissionTrackerConfig config)
+        :
+        _device(device),
+        _queue(queue),
+        _config(config),
+        _timeline(std::move(device), 0)
+    {
+        _pending.reserve(_config.flush_pending_submits);
+        _pendingWaits.reserve(_config.flush_pending_submits);
+        _pendingSignals.reserve(_config.flush_pending_submits * 2);
+        _submitInfos.reserve(_config.flush_pending_submits);
+    }
+
+    uint64_t SubmissionTracker::Enqueue(VkCommandBuffer commandBuffer, dcspan<VkSemaphoreSubmitInfo> waits, dcspan<VkSemaphoreSubmitInfo> signals)
+    {
+        if (_pending.empty())
+        {
+            _oldestPending = std::chrono::steady_clock::now();
+        }
+
+        auto value = ++_enqueuedValue;
+
+        auto& pending = _pending.emplace_back();
+        pending.command_buffer = VkCommandBufferSubmitInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO,
+            .commandBuffer = commandBuffer
+        };
+        pending.first_wait = static_cast<uint32_t>(_pendingWaits.size());
+        pending.wait_count = static_cast<uint32_t>(waits.size());
+        pending.first_signal = static_cast<uint32_t>(_pendingSignals.size());
+        pending.signal_count = static_cast<uint32_t>(signals.size() + 1);
+
+        _pendingWaits.insert(_pendingWaits.end(), waits.begin(), waits.end());
+        _pendingSignals.insert(_pendingSignals.end(), signals.begin(), signals.end());
+        _pendingSignals.emplace_back(VkSemaphoreSubmitInfo
+            {
+                .sType = VkStructureType::VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+                .semaphore = _timeline.Get(),
+                .value = value,
+                .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT
+            });
+
+        return value;
+    }
+
+    bool SubmissionTracker::FlushDue() const
+    {
+        if (_pending.empty())
+        {
+            return false;
+        }
+
+        return _pending.size() >= _config.flush_pending_submits ||
+            std::chrono::steady_clock::now() - _oldestPending >= _config.flush_pending_age;
+    }
+
+    void SubmissionTracker::FlushIfDue()
+    {
+        if (FlushDue())
+        {
+            Flush();
+        }
+    }
+
+    void SubmissionTracker::Flush()
+    {
+        if (_pending.empty())
+        {
+            return;
+        }
+
+        // the arrays are stable from here on, resolve the offsets to pointers
+        _submitInfos.clear();
+        for (const auto& pending : _pending)
+        {
+            _submitInfos.emplace_back(VkSubmitInfo2
+                {
+                    .sType = VkStructureType::VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
+                    .waitSemaphoreInfoCount = pending.wait_count,
+                    .pWaitSemaphoreInfos = pending.wait_count ? &_pendingWaits[pending.first_wait] : nullptr,
+                    .commandBufferInfoCount = 1,
+                    .pCommandBufferInfos = &pending.command_buffer,
+                    .signalSemaphoreInfoCount = pending.signal_count,
+                    .pSignalSemaphoreInfos = &_pendingSignals[pending.first_signal]
+                });
+        }
+
+        _queue.Submit2(static_cast<uint32_t>(_submitInfos.size()), _submitInfos.data());
+
+        auto now = std::chrono::steady_clock::now();
+        for (auto value = _flushedValue + 1; value <= _enqueuedValue; ++value)
+        {
+            _inFlight.emplace_back(InFlightSubmit{ .value = value, .flushed_at = now });
+        }
+
+        ++_flushes;
+        _flushedValue = _enqueuedValue;
+        _pending.clear();
+        _pendingWaits.clear();
+        _pendingSignals.clear();
+    }
+
+    uint64_t SubmissionTracker::PollCompleted()
+    {
+        if (_completedValue == _flushedValue)
+        {
+            return _completedValue;
+        }
+
+        _completedValue = _timeline.QueryValue();
+
+        auto now = std::chrono::steady_clock::now();
+        while (!_inFlight.empty() && _inFlight.front().value <= _completedValue)
+        {
+            _lastLatency = std::chrono::duration_cast<std::chrono::nanoseconds>(now - _inFlight.front().flushed_at);
+            _maxLatency = std::max(_maxLatency, _lastLatency);
+            _totalLatency += _lastLatency;
+            ++_retired;
+            _inFlight.pop_front();
+        }
+
+        return _completedValue;
+    }
+
+    void SubmissionTracker::Wait(uint64_t value)
+    {
+        if (value <= _completedValue)
+        {
+            return;
+        }
+
+        assert(value <= _enqueuedValue);
+        if (value > _flushedValue)
+        {
+            Flush();
+        }
+
+        _timeline.Wait(value);
+        PollCompleted();
+    }
+
+    SubmissionTrackerCounters SubmissionTracker::Counters() const
+    {
+        return SubmissionTrackerCounters
+        {
+            .enqueued_value = _enqueuedValue,
+            .completed_value = _completedValue,
+            .queue_depth = _flushedValue - _completedValue,
+            .pending_submits = _pending.size(),
+            .flushes = _flushes,
+            .last_gpu_latency = _lastLatency,
+            .max_gpu_latency = _maxLatency,
+            .avg_gpu_latency = _retired ? _totalLatency / static_cast<int64_t>(_retired) : std::chrono::nanoseconds(0)
+        };
+    }
+}
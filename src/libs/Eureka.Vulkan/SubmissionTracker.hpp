@@ -0,0 +1,112 @@
+#pragma once
+#include "Queue.hpp"
+#include "Synchronization.hpp"
+#include <containers_aliases.hpp>
+#include <chrono>
+#include <deque>
+
+namespace eureka::vulkan
+{
+    struct SubmissionTrackerConfig
+    {
+        std::size_t               flush_pending_submits{ 16 };                     // flush once that many submits are pending
+        std::chrono::microseconds flush_pending_age{ std::chrono::microseconds(500) }; // or once the oldest pending submit waited that long
+    };
+
+    struct SubmissionTrackerCounters
+    {
+        uint64_t                 enqueued_value{ 0 };    // last timeline value handed to a submit
+        uint64_t                 completed_value{ 0 };   // last timeline value observed on the device
+        uint64_t                 queue_depth{ 0 };       // submits handed to the queue and not completed yet
+        uint64_t                 pending_submits{ 0 };   // submits waiting for a flush
+        uint64_t                 flushes{ 0 };           // vkQueueSubmit2 calls
+        std::chrono::nanoseconds last_gpu_latency{ 0 };  // flush to observed completion, bounded below by the polling rate
+        std::chrono::nanoseconds max_gpu_latency{ 0 };
+        std::chrono::nanoseconds avg_gpu_latency{ 0 };
+    };
+
+    //
+    // SubmissionTracker
+    // batches the submits of a queue into vkQueueSubmit2 calls and tracks their completion through a single
+    // timeline semaphore, every submit signals the next value of that timeline
+    // semaphore signal operations cover all earlier work in submission order, so a counter value of N means
+    // every submit with a value <= N has completed - polling is one vkGetSemaphoreCounterValue and retiring
+    // is popping an in order prefix
+    //
+    // not thread safe, owned by the thread recording and submitting the queue's one shot work
+    //
+    class SubmissionTracker
+    {
+        struct PendingSubmit
+        {
+            VkCommandBufferSubmitInfo command_buffer;
+            uint32_t                  first_wait;
+            uint32_t                  wait_count;
+            uint32_t                  first_signal;
+            uint32_t                  signal_count;
+        };
+
+        struct InFlightSubmit
+        {
+            uint64_t                              value;
+            std::chrono::steady_clock::time_point flushed_at;
+        };
+
+        std::shared_ptr<Device>              _device;
+        Queue                                _queue;
+        SubmissionTrackerConfig              _config;
+        TimelineSemaphore                    _timeline;
+
+        uint64_t                             _enqueuedValue{ 0 };
+        uint64_t                             _flushedValue{ 0 };
+        uint64_t                             _completedValue{ 0 };
+
+        std::vector<PendingSubmit>           _pending;
+        std::vector<VkSemaphoreSubmitInfo>   _pendingWaits;
+        std::vector<VkSemaphoreSubmitInfo>   _pendingSignals;
+        std::vector<VkSubmitInfo2>           _submitInfos;
+        std::chrono::steady_clock::time_point _oldestPending;
+
+        std::deque<InFlightSubmit>           _inFlight;
+
+        uint64_t                             _flushes{ 0 };
+        uint64_t                             _retired{ 0 };
+        std::chrono::nanoseconds             _lastLatency{ 0 };
+        std::chrono::nanoseconds             _maxLatency{ 0 };
+        std::chrono::nanoseconds             _totalLatency{ 0 };
+    public:
+        SubmissionTracker(std::shared_ptr<Device> device, Queue queue, SubmissionTrackerConfig config = {});
+        SubmissionTracker(const SubmissionTracker&) = delete;
+        SubmissionTracker& operator=(const SubmissionTracker&) = delete;
+
+        //
+        // queues a command buffer for the next flush and returns the timeline value it signals
+        // waits and signals are copied, the tracker timeline signal is added after the extra signals
+        //
+        uint64_t Enqueue(
+            VkCommandBuffer commandBuffer,
+            dcspan<VkSemaphoreSubmitInfo> waits = {},
+            dcspan<VkSemaphoreSubmitInfo> signals = {}
+        );
+
+        bool FlushDue() const;
+        void FlushIfDue();
+
+        // submits everything pending with a single vkQueueSubmit2
+        void Flush();
+
+        // single vkGetSemaphoreCounterValue, retires the completed prefix and returns the completed value
+        uint64_t PollCompleted();
+
+        bool IsCompleted(uint64_t value) const { return value <= _completedValue; }
+
+        // flushes first when the value is still pending
+        void Wait(uint64_t value);
+
+        VkSemaphore Semaphore() const { return _timeline.Get(); }
+        uint64_t EnqueuedValue() const { return _enqueuedValue; }
+        const Queue& GetQueue() const { return _queue; }
+
+        SubmissionTrackerCounters Counters() const;
+    };
+}
@@ -14,6 +14,7 @@
 #include "../Eureka.Vulkan/FrameContext.hpp" 
 //#include "../Eureka.Vulkan/RenderTarget.hpp"  
 #include "../Eureka.Graphics/TargetPass.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
 #include "../Eureka.Flutter/VulkanCompositor.hpp"
 #include "../Eureka.Flutter/VulkanDesktopEmbedder.hpp"
 
@@ -28,6 +29,7 @@ namespace prof = eureka::profiling;
 class Main
 {
 	eureka::GLFWRuntime glfw;
+    concurrencpp::runtime _runtime; // pipeline compilation and view pass recording pool, outlives the embedder
     std::shared_ptr<fl::VulkanDesktopEmbedder> _embedder;
 public:
 
@@ -50,6 +52,7 @@ public:
         auto shaderCache = std::make_shared<eureka::vulkan::ShaderCache>(device);
         auto layoutCache = std::make_shared<eureka::vulkan::DescriptorSetLayoutCache>(device);
         auto descriptorAllocator = std::make_shared<eureka::vulkan::FreeableDescriptorSetAllocator>(device);
+        auto pipelinePrecompiler = eureka::graphics::MakePersistentPipelinePrecompiler(device, shaderCache, layoutCache, _runtime.thread_pool_executor());
 
         eureka::graphics::GlobalInheritedData globalInheritedData{
             .device = device,
@@ -58,11 +61,12 @@ public:
             .layout_cache = layoutCache,
             .descriptor_allocator = descriptorAllocator,
             .async_data_loader = nullptr,
+            .pipeline_precompiler = pipelinePrecompiler,
         };
 
 
 
-        auto depthColorTarget = std::make_shared<eureka::graphics::SwapChainDepthColorPass>(globalInheritedData, graphicsQueue, swapChain);
+        auto depthColorTarget = std::make_shared<eureka::graphics::SwapChainDepthColorPass>(globalInheritedData, graphicsQueue, swapChain, _runtime.thread_pool_executor());
         auto frameContext = std::make_shared<vk::FrameContext>(device, copyQueue, graphicsQueue);
 
 
@@ -0,0 +1,186 @@
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+#include <catch.hpp>
+#include "benchmark_report.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+
+namespace eureka::benchmarks
+{
+    namespace
+    {
+        constexpr int BENCHMARK_JSON_VERSION = 1;
+
+        std::vector<BenchmarkResult>& MutableResults()
+        {
+            static std::vector<BenchmarkResult> results;
+            return results;
+        }
+    }
+
+    class BenchmarkCollector : public Catch::TestEventListenerBase
+    {
+        std::string _testCaseName;
+    public:
+        using TestEventListenerBase::TestEventListenerBase;
+
+        void testCaseStarting(Catch::TestCaseInfo const& testInfo) override
+        {
+            TestEventListenerBase::testCaseStarting(testInfo);
+            _testCaseName = testInfo.name;
+        }
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const& stats) override
+        {
+            MutableResults().emplace_back(BenchmarkResult{
+                .name = _testCaseName + "/" + stats.info.name,
+                .mean_ns = stats.mean.point.count(),
+                .low_mean_ns = stats.mean.lower_bound.count(),
+                .high_mean_ns = stats.mean.upper_bound.count(),
+                .std_dev_ns = stats.standardDeviation.point.count(),
+                .samples = stats.samples.size(),
+                .iterations = stats.info.iterations
+            });
+        }
+    };
+
+    CATCH_REGISTER_LISTENER(BenchmarkCollector)
+
+    const std::vector<BenchmarkResult>& CollectedResults()
+    {
+        return MutableResults();
+    }
+
+    void WriteResultsJson(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results)
+    {
+        nlohmann::json benchmarks = nlohmann::json::array();
+
+        for (const auto& result : results)
+        {
+            benchmarks.push_back(
+                {
+                    { "name", result.name },
+                    { "mean_ns", result.mean_ns },
+                    { "low_mean_ns", result.low_mean_ns },
+                    { "high_mean_ns", result.high_mean_ns },
+                    { "std_dev_ns", result.std_dev_ns },
+                    { "samples", result.samples },
+                    { "iterations", result.iterations }
+                }
+            );
+        }
+
+        nlohmann::json root
+        {
+            { "version", BENCHMARK_JSON_VERSION },
+            { "benchmarks", std::move(benchmarks) }
+        };
+
+        if (path.has_parent_path())
+        {
+            std::filesystem::create_directories(path.parent_path());
+        }
+
+        std::ofstream file(path);
+        if (!file)
+        {
+            throw std::runtime_error("failed opening " + path.string());
+        }
+        file << std::setw(4) << root << '\n';
+    }
+
+    std::vector<BenchmarkResult> ReadResultsJson(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        if (!file)
+        {
+            throw std::runtime_error("failed opening " + path.string());
+        }
+
+        auto root = nlohmann::json::parse(file);
+
+        if (root.at("version").get<int>() != BENCHMARK_JSON_VERSION)
+        {
+            throw std::runtime_error("unsupported benchmark json version in " + path.string());
+        }
+
+        std::vector<BenchmarkResult> results;
+        for (const auto& entry : root.at("benchmarks"))
+        {
+            results.emplace_back(BenchmarkResult{
+                .name = entry.at("name").get<std::string>(),
+                .mean_ns = entry.at("mean_ns").get<double>(),
+                .low_mean_ns = entry.at("low_mean_ns").get<double>(),
+                .high_mean_ns = entry.at("high_mean_ns").get<double>(),
+                .std_dev_ns = entry.at("std_dev_ns").get<double>(),
+                .samples = entry.at("samples").get<std::size_t>(),
+                .iterations = entry.at("iterations").get<int>()
+            });
+        }
+        return results;
+    }
+
+    std::vector<BenchmarkComparison> CompareToBaseline(
+        const std::vector<BenchmarkResult>& baseline,
+        const std::vector<BenchmarkResult>& current,
+        double tolerance
+    )
+    {
+        std::unordered_map<std::string, const BenchmarkResult*> baselineByName;
+        for (const auto& result : baseline)
+        {
+            baselineByName.emplace(result.name, &result);
+        }
+
+        std::vector<BenchmarkComparison> comparison;
+        for (const auto& result : current)
+        {
+            auto itr = baselineByName.find(result.name);
+            if (itr == baselineByName.end() || itr->second->mean_ns <= 0.0)
+            {
+                continue;
+            }
+            const auto& base = *itr->second;
+            auto ratio = result.mean_ns / base.mean_ns;
+
+            comparison.emplace_back(BenchmarkComparison{
+                .name = result.name,
+                .baseline_mean_ns = base.mean_ns,
+                .current_mean_ns = result.mean_ns,
+                .ratio = ratio,
+                // noisy machines widen the confidence interval, only flag what is clearly outside of it
+                .regression = ratio > 1.0 + tolerance && result.low_mean_ns > base.high_mean_ns
+            });
+        }
+        return comparison;
+    }
+
+    void PrintComparison(const std::vector<BenchmarkComparison>& comparison, const std::vector<BenchmarkResult>& current)
+    {
+        std::cout << "\n" << std::left << std::setw(70) << "benchmark"
+            << std::right << std::setw(16) << "baseline [ns]"
+            << std::setw(16) << "current [ns]"
+            << std::setw(10) << "ratio" << "\n";
+
+        for (const auto& entry : comparison)
+        {
+            std::cout << std::left << std::setw(70) << entry.name
+                << std::right << std::fixed << std::setprecision(1)
+                << std::setw(16) << entry.baseline_mean_ns
+                << std::setw(16) << entry.current_mean_ns
+                << std::setprecision(2) << std::setw(10) << entry.ratio
+                << (entry.regression ? "  REGRESSION" : "") << "\n";
+        }
+
+        for (const auto& result : current)
+        {
+            if (std::ranges::none_of(comparison, [&](const BenchmarkComparison& c) { return c.name == result.name; }))
+            {
+                std::cout << std::left << std::setw(70) << result.name << "  (no baseline)\n";
+            }
+        }
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace eureka::benchmarks
+{
+    struct BenchmarkResult
+    {
+        std::string name;      // "<test case>/<benchmark>"
+        double      mean_ns{ 0.0 };
+        double      low_mean_ns{ 0.0 };
+        double      high_mean_ns{ 0.0 };
+        double      std_dev_ns{ 0.0 };
+        std::size_t samples{ 0 };
+        int         iterations{ 0 };
+    };
+
+    struct BenchmarkComparison
+    {
+        std::string name;
+        double      baseline_mean_ns{ 0.0 };
+        double      current_mean_ns{ 0.0 };
+        double      ratio{ 1.0 };     // current / baseline, above 1 means slower
+        bool        regression{ false };
+    };
+
+    //
+    // results are collected by a catch listener while the session runs
+    //
+    const std::vector<BenchmarkResult>& CollectedResults();
+
+    void WriteResultsJson(const std::filesystem::path& path, const std::vector<BenchmarkResult>& results);
+    std::vector<BenchmarkResult> ReadResultsJson(const std::filesystem::path& path);
+
+    //
+    // a benchmark regresses when its mean is slower than the baseline by more than tolerance (0.25 = 25%)
+    // and the difference is larger than the baseline confidence interval
+    //
+    std::vector<BenchmarkComparison> CompareToBaseline(
+        const std::vector<BenchmarkResult>& baseline,
+        const std::vector<BenchmarkResult>& current,
+        double tolerance
+    );
+
+    void PrintComparison(const std::vector<BenchmarkComparison>& comparison, const std::vector<BenchmarkResult>& current);
+}
@@ -0,0 +1,113 @@
+#include <catch.hpp>
+#include <GrpcContext.hpp>
+#include <fixed_capacity_vector.hpp>
+#include <boost/container/small_vector.hpp>
+
+namespace
+{
+    constexpr std::size_t POOL_SIZE = 512;
+    constexpr std::size_t POOL_ALLOCATIONS = 256;
+
+    constexpr std::size_t VECTOR_ELEMENTS = 16;
+}
+
+TEST_CASE("FixedObjectPool", "[benchmark][containers]")
+{
+    eureka::rpc::FixedObjectPool<eureka::rpc::CompletionPacket> pool(POOL_SIZE);
+
+    std::vector<eureka::rpc::CompletionPacket*> objects;
+    objects.reserve(POOL_ALLOCATIONS);
+
+    BENCHMARK("pool allocate-deallocate 256")
+    {
+        for (auto i = 0u; i < POOL_ALLOCATIONS; ++i)
+        {
+            objects.emplace_back(pool.Allocate());
+        }
+        for (auto ptr : objects)
+        {
+            pool.Deallocate(ptr);
+        }
+        objects.clear();
+    };
+
+    BENCHMARK("new-delete 256")
+    {
+        for (auto i = 0u; i < POOL_ALLOCATIONS; ++i)
+        {
+            objects.emplace_back(new eureka::rpc::CompletionPacket);
+        }
+        for (auto ptr : objects)
+        {
+            delete ptr;
+        }
+        objects.clear();
+    };
+
+    REQUIRE(pool.AllocationsCount() == 0);
+}
+
+TEST_CASE("fixed_capacity_vector", "[benchmark][containers]")
+{
+    BENCHMARK("fixed_capacity_vector emplace 16")
+    {
+        eureka::fixed_capacity_vector<uint64_t, VECTOR_ELEMENTS> vec;
+        for (auto i = 0u; i < VECTOR_ELEMENTS; ++i)
+        {
+            vec.emplace_back(i);
+        }
+        return vec.back();
+    };
+
+    BENCHMARK("small_vector emplace 16")
+    {
+        boost::container::small_vector<uint64_t, VECTOR_ELEMENTS> vec;
+        for (auto i = 0u; i < VECTOR_ELEMENTS; ++i)
+        {
+            vec.emplace_back(i);
+        }
+        return vec.back();
+    };
+
+    BENCHMARK("small_vector spilling to heap emplace 16")
+    {
+        boost::container::small_vector<uint64_t, VECTOR_ELEMENTS / 4> vec;
+        for (auto i = 0u; i < VECTOR_ELEMENTS; ++i)
+        {
+            vec.emplace_back(i);
+        }
+        return vec.back();
+    };
+
+    BENCHMARK("std::vector emplace 16")
+    {
+        std::vector<uint64_t> vec;
+        for (auto i = 0u; i < VECTOR_ELEMENTS; ++i)
+        {
+            vec.emplace_back(i);
+        }
+        return vec.back();
+    };
+
+    eureka::fixed_capacity_vector<std::shared_ptr<int>, VECTOR_ELEMENTS> shared(VECTOR_ELEMENTS / 2, std::make_shared<int>(1));
+    eureka::fixed_capacity_vector<uint64_t, VECTOR_ELEMENTS> trivial(VECTOR_ELEMENTS / 2, 1);
+
+    BENCHMARK("fixed_capacity_vector copy trivial")
+    {
+        auto copy = trivial;
+        return copy.size();
+    };
+
+    BENCHMARK("fixed_capacity_vector copy non trivial")
+    {
+        auto copy = shared;
+        return copy.size();
+    };
+
+    BENCHMARK("fixed_capacity_vector insert-erase front")
+    {
+        trivial.insert(trivial.begin(), 2);
+        trivial.erase(trivial.begin());
+        return trivial.size();
+    };
+}
@@ -0,0 +1,169 @@
+#include <catch.hpp>
+#include <concurrencpp/concurrencpp.h>
+#include <SubmissionThreadExecutor.hpp>
+#include <timed_task_queue.hpp>
+#include <thread>
+
+namespace
+{
+    constexpr std::size_t TASKS = 1000;
+}
+
+TEST_CASE("submission_thread_executor", "[benchmark][executors]")
+{
+    auto executor = std::make_shared<eureka::submission_thread_executor>();
+    std::size_t counter = 0;
+
+    BENCHMARK("enqueue-drain 1000 main")
+    {
+        for (auto i = 0u; i < TASKS; ++i)
+        {
+            executor->post([&counter] { ++counter; });
+        }
+        return executor->loop_all(TASKS);
+    };
+
+    BENCHMARK("enqueue-drain 1000 one shot copy sub executor")
+    {
+        auto& subExecutor = executor->one_shot_copy_submit_executor();
+        for (auto i = 0u; i < TASKS; ++i)
+        {
+            subExecutor.post([&counter] { ++counter; });
+        }
+        return executor->loop_all(TASKS);
+    };
+
+    BENCHMARK("enqueue-drain 1000 interleaved sub executors")
+    {
+        auto& copyExecutor = executor->one_shot_copy_submit_executor();
+        auto& preRenderExecutor = executor->pre_render_executor();
+        for (auto i = 0u; i < TASKS / 2; ++i)
+        {
+            copyExecutor.post([&counter] { ++counter; });
+            preRenderExecutor.post([&counter] { ++counter; });
+        }
+        return executor->loop_all(TASKS);
+    };
+
+    BENCHMARK("enqueue from producer thread, drain on caller 1000")
+    {
+        std::thread producer(
+            [&]
+            {
+                for (auto i = 0u; i < TASKS; ++i)
+                {
+                    executor->post([&counter] { ++counter; });
+                }
+            });
+
+        std::size_t executed = 0;
+        while (executed < TASKS)
+        {
+            executed += executor->loop_all(TASKS - executed);
+        }
+        producer.join();
+        return executed;
+    };
+
+    executor->shutdown();
+    REQUIRE(counter > 0);
+}
+
+TEST_CASE("timed_task_queue", "[benchmark][executors]")
+{
+    eureka::timed_task_queue<uint64_t> queue;
+    uint64_t sum = 0;
+
+    BENCHMARK("post-drain 1000 equal deadlines")
+    {
+        for (auto i = 0u; i < TASKS; ++i)
+        {
+            queue.post(i, 0);
+        }
+        while (auto task = queue.pop_ready(0))
+        {
+            sum += *task;
+        }
+        return sum;
+    };
+
+    BENCHMARK("post-drain 1000 scattered deadlines")
+    {
+        for (auto i = 0u; i < TASKS; ++i)
+        {
+            queue.post(i, (i * 7919u) % TASKS);
+        }
+        while (auto task = queue.pop_ready(TASKS))
+        {
+            sum += *task;
+        }
+        return sum;
+    };
+
+    BENCHMARK("post from producer thread, drain on caller 1000")
+    {
+        std::thread producer(
+            [&]
+            {
+                for (auto i = 0u; i < TASKS; ++i)
+                {
+                    queue.post(i, 0);
+                }
+            });
+
+        std::size_t executed = 0;
+        while (executed < TASKS)
+        {
+            while (auto task = queue.pop_ready(0))
+            {
+                sum += *task;
+                ++executed;
+            }
+            if (executed < TASKS)
+            {
+                queue.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+            }
+        }
+        producer.join();
+        return executed;
+    };
+
+    //
+    // wake latency, a post to a sleeping consumer and back, half of it is one wakeup
+    //
+    eureka::timed_task_queue<uint64_t> ping;
+    eureka::timed_task_queue<uint64_t> pong;
+    std::atomic_bool stop{ false };
+
+    std::thread echo(
+        [&]
+        {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                while (auto task = ping.pop_ready(0))
+                {
+                    pong.post(*task, 0);
+                }
+                ping.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+            }
+        });
+
+    BENCHMARK("wake round trip")
+    {
+        ping.post(1, 0);
+        while (true)
+        {
+            if (auto task = pong.pop_ready(0))
+            {
+                return *task;
+            }
+            pong.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+        }
+    };
+
+    stop = true;
+    ping.post(0, 0);
+    echo.join();
+
+    REQUIRE(sum > 0);
+}
@@ -0,0 +1,85 @@
+#ifndef CATCH_CONFIG_RUNNER
+#define CATCH_CONFIG_RUNNER
+#endif
+#include <catch.hpp>
+#include "benchmark_report.hpp"
+#include <iostream>
+#ifdef WIN32
+#pragma comment(lib, "ws2_32.lib")
+#endif
+/*
+Eureka.Benchmarks
+
+all regular catch arguments are supported, plus:
+--json-out <file>         write the results of this run as json
+--baseline <file>         compare the results against a previous json output, returns non zero on regression
+--tolerance <percent>     allowed slowdown relative to the baseline before reporting a regression (default 25)
+
+results are reproducible as long as the rng seed and the sample counts are fixed, which is the default here.
+
+no baseline is committed, timings only compare against a run on the same machine. to record one:
+    Eureka.Benchmarks --json-out src/tests/Eureka.Benchmarks/baseline.json
+then re-run cmake, the Eureka.Benchmarks.Run target compares against it from then on.
+*/
+int main(int argc, char* argv[])
+{
+    Catch::Session session;
+
+    std::string jsonOut;
+    std::string baseline;
+    double tolerancePercent = 25.0;
+
+    using Catch::clara::Opt;
+    auto cli = session.cli()
+        | Opt(jsonOut, "file")["--json-out"]("write benchmark results as json")
+        | Opt(baseline, "file")["--baseline"]("compare benchmark results against a stored json baseline")
+        | Opt(tolerancePercent, "percent")["--tolerance"]("allowed slowdown relative to the baseline");
+
+    session.cli(cli);
+
+    auto& config = session.configData();
+    config.rngSeed = 1234;
+    config.benchmarkSamples = 50;
+    config.benchmarkWarmupTime = 200;
+
+    int result = session.applyCommandLine(argc, argv);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    result = session.run();
+
+    const auto& results = eureka::benchmarks::CollectedResults();
+
+    try
+    {
+        if (!jsonOut.empty())
+        {
+            eureka::benchmarks::WriteResultsJson(jsonOut, results);
+        }
+
+        if (!baseline.empty())
+        {
+            auto comparison = eureka::benchmarks::CompareToBaseline(
+                eureka::benchmarks::ReadResultsJson(baseline),
+                results,
+                tolerancePercent / 100.0
+            );
+
+            eureka::benchmarks::PrintComparison(comparison, results);
+
+            if (std::ranges::any_of(comparison, [](const auto& c) { return c.regression; }))
+            {
+                result = (result == 0) ? 1 : result;
+            }
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "benchmark report error: " << err.what() << std::endl;
+        result = (result == 0) ? 1 : result;
+    }
+
+    return result;
+}
@@ -0,0 +1,253 @@
+#include <catch.hpp>
+#include <GrpcContext.hpp>
+#include <LiveSlamServer.hpp>
+#include <VisualizationService.hpp>
+#include <RemoteLiveSlamClient.hpp>
+#include <grpcpp/impl/codegen/proto_utils.h>
+#include <random>
+
+namespace
+{
+    constexpr std::size_t ALARM_COMPLETIONS = 256; // must stay below the GrpcContext packets pool size
+    constexpr std::size_t POSE_GRAPH_POSES = 1000;
+    constexpr std::size_t POSE_GRAPH_EDGES_PER_POSE = 4;
+    constexpr auto STREAM_TIMEOUT = 5s;
+    constexpr char LOCALHOST_SERVER_ENDPOINT[] = "127.0.0.1:50051"; // RemoteLiveSlamClient always connects to port 50051
+    constexpr char LOCALHOST_CLIENT_ADDRESS[] = "127.0.0.1";
+
+    rgoproto::PoseGraphStreamingMsg MakePoseGraphMsg(std::size_t poses, std::size_t edgesPerPose)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> location(-5000.0f, 5000.0f);
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        std::uniform_int_distribution<uint32_t> target(0, static_cast<uint32_t>(poses - 1));
+
+        rgoproto::PoseGraphStreamingMsg msg;
+        msg.mutable_poses()->Reserve(static_cast<int>(poses * 7));
+        for (auto i = 0u; i < poses; ++i)
+        {
+            msg.add_poses(static_cast<float>(i));
+            for (auto j = 0; j < 3; ++j) msg.add_poses(location(rng));
+            for (auto j = 0; j < 3; ++j) msg.add_poses(direction(rng));
+        }
+
+        auto edges = poses * edgesPerPose;
+        msg.mutable_edges_meta()->Reserve(static_cast<int>(edges * 4));
+        msg.mutable_edges_data()->Reserve(static_cast<int>(edges * 12));
+        for (auto i = 0u; i < edges; ++i)
+        {
+            msg.add_edges_meta(static_cast<uint32_t>(i / edgesPerPose));
+            msg.add_edges_meta(target(rng));
+            msg.add_edges_meta(i % 3);
+            msg.add_edges_meta(i % 5 != 0);
+            for (auto j = 0; j < 12; ++j) msg.add_edges_data(location(rng));
+        }
+
+        msg.set_timestamp_ns(1);
+        return msg;
+    }
+
+    rgoproto::RealtimePoseStreamingMsg MakeRealtimePoseMsg()
+    {
+        rgoproto::RealtimePoseStreamingMsg msg;
+        for (auto v : { 100.0f, 200.0f, 300.0f, 0.0f, 0.0f, 1.0f })
+        {
+            msg.add_txtytzrxryrz(v);
+        }
+        msg.set_timestamp_ns(1);
+        return msg;
+    }
+
+    class LocalhostStreamingSetup
+    {
+        std::shared_ptr<rgoproto::LiveSlamUIService::AsyncService> _service;
+        std::shared_ptr<eureka::rpc::LiveSlamServer>               _server;
+        std::shared_ptr<eureka::rpc::VisualizationService>         _visualizationService;
+        std::atomic_bool                                           _serverActive{ true };
+        std::thread                                                _serverThread;
+        std::unique_ptr<eureka::rpc::RemoteLiveSlamClient>         _client;
+        std::vector<sigslot::connection>                           _connections;
+    public:
+        std::atomic_uint64_t                                       pose_graphs_received{ 0 };
+        std::atomic_uint64_t                                       realtime_poses_received{ 0 };
+
+        LocalhostStreamingSetup()
+            :
+            _service(std::make_shared<rgoproto::LiveSlamUIService::AsyncService>()),
+            _server(std::make_shared<eureka::rpc::LiveSlamServer>(std::vector<std::shared_ptr<grpc::Service>>{ _service })),
+            _visualizationService(std::make_shared<eureka::rpc::VisualizationService>(_service, _server->GetContext()))
+        {
+            _server->Start(LOCALHOST_SERVER_ENDPOINT);
+            _visualizationService->Start();
+
+            _serverThread = std::thread(
+                [this, grpcContext = _server->GetContext()]
+                {
+                    while (_serverActive)
+                    {
+                        grpcContext->RunFor(1ms);
+                    }
+                });
+
+            _client = std::make_unique<eureka::rpc::RemoteLiveSlamClient>();
+            _connections.emplace_back(_client->ConnectPoseGraphSlot([this](std::shared_ptr<rgoproto::PoseGraphStreamingMsg>) { ++pose_graphs_received; }));
+            _connections.emplace_back(_client->ConnectRealtimePoseSlot([this](std::shared_ptr<rgoproto::RealtimePoseStreamingMsg>) { ++realtime_poses_received; }));
+            _client->ConnectAsync(LOCALHOST_CLIENT_ADDRESS);
+        }
+
+        ~LocalhostStreamingSetup()
+        {
+            for (auto& connection : _connections)
+            {
+                connection.disconnect();
+            }
+            _client.reset();
+            _serverActive = false;
+            _serverThread.join();
+            _visualizationService.reset();
+            _server.reset();
+        }
+
+        eureka::rpc::VisualizationService& Service() { return *_visualizationService; }
+
+        template<typename Predicate>
+        bool PollClientUntil(Predicate&& predicate, std::chrono::nanoseconds timeout = STREAM_TIMEOUT)
+        {
+            // busy polling keeps the measured latency free of polling granularity
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            while (!predicate())
+            {
+                if (std::chrono::steady_clock::now() > deadline)
+                {
+                    return false;
+                }
+                _client->PollCompletions();
+            }
+            return true;
+        }
+
+        bool WaitForStreams()
+        {
+            if (!PollClientUntil([this] { return _client->GetConnectionState() == eureka::rpc::ConnectionState::Connected; }))
+            {
+                return false;
+            }
+            _client->StartStreams();
+
+            // the streams are established once the first message of each arrives
+            auto poseGraph = std::make_shared<rgoproto::PoseGraphStreamingMsg>(MakePoseGraphMsg(1, 1));
+            auto realtimePose = std::make_shared<rgoproto::RealtimePoseStreamingMsg>(MakeRealtimePoseMsg());
+            return PollClientUntil(
+                [&]
+                {
+                    if (pose_graphs_received == 0) _visualizationService->ExchangeData(poseGraph);
+                    if (realtime_poses_received == 0) _visualizationService->ExchangeData(realtimePose);
+                    return pose_graphs_received > 0 && realtime_poses_received > 0;
+                });
+        }
+    };
+
+    template<typename Msg>
+    bool RoundTrip(LocalhostStreamingSetup& setup, std::atomic_uint64_t& receivedCounter, std::shared_ptr<Msg>& spare, const Msg& prototype)
+    {
+        // ExchangeData hands back the previously written message, reuse it to keep allocations out of the measurement
+        if (!spare)
+        {
+            spare = std::make_shared<Msg>(prototype);
+        }
+        auto before = receivedCounter.load();
+        spare = setup.Service().ExchangeData(std::move(spare));
+        return setup.PollClientUntil([&] { return receivedCounter.load() > before; });
+    }
+}
+
+TEST_CASE("GrpcContext", "[benchmark][rpc]")
+{
+    eureka::rpc::LiveSlamServer server({});
+    server.Start("127.0.0.1:0");
+    auto grpcContext = server.GetContext();
+
+    std::vector<grpc::Alarm> alarms(ALARM_COMPLETIONS);
+    std::size_t completed = 0;
+
+    BENCHMARK("alarm completions 256")
+    {
+        completed = 0;
+        for (auto& alarm : alarms)
+        {
+            alarm.Set(
+                grpcContext->Get(),
+                gpr_now(gpr_clock_type::GPR_CLOCK_REALTIME),
+                grpcContext->CreateTag([&completed](bool) { ++completed; })
+            );
+        }
+        while (completed < ALARM_COMPLETIONS)
+        {
+            grpcContext->RunFor(1us);
+        }
+        return completed;
+    };
+}
+
+TEST_CASE("GenericStreamRead decode", "[benchmark][rpc]")
+{
+    auto poseGraph = MakePoseGraphMsg(POSE_GRAPH_POSES, POSE_GRAPH_EDGES_PER_POSE);
+    grpc::ByteBuffer wire;
+    bool ownBuffer = false;
+    REQUIRE(grpc::SerializationTraits<rgoproto::PoseGraphStreamingMsg>::Serialize(poseGraph, &wire, &ownBuffer).ok());
+
+    rgoproto::PoseGraphStreamingMsg reused;
+
+    BENCHMARK("decode pose graph 1000 poses into reused message")
+    {
+        grpc::ByteBuffer buffer(wire);
+        return grpc::SerializationTraits<rgoproto::PoseGraphStreamingMsg>::Deserialize(&buffer, &reused).ok();
+    };
+
+    BENCHMARK("decode pose graph 1000 poses into new message")
+    {
+        grpc::ByteBuffer buffer(wire);
+        auto msg = std::make_shared<rgoproto::PoseGraphStreamingMsg>();
+        return grpc::SerializationTraits<rgoproto::PoseGraphStreamingMsg>::Deserialize(&buffer, msg.get()).ok();
+    };
+
+    BENCHMARK("encode pose graph 1000 poses")
+    {
+        grpc::ByteBuffer buffer;
+        bool own = false;
+        return grpc::SerializationTraits<rgoproto::PoseGraphStreamingMsg>::Serialize(poseGraph, &buffer, &own).ok();
+    };
+
+    REQUIRE(reused.poses_size() == poseGraph.poses_size());
+}
+
+TEST_CASE("localhost streaming", "[benchmark][rpc]")
+{
+    std::unique_ptr<LocalhostStreamingSetup> setup;
+    try
+    {
+        setup = std::make_unique<LocalhostStreamingSetup>();
+    }
+    catch (const std::exception& err)
+    {
+        WARN("skipping localhost streaming, server failed to start: " << err.what());
+        return;
+    }
+
+    REQUIRE(setup->WaitForStreams());
+
+    const auto poseGraph = MakePoseGraphMsg(POSE_GRAPH_POSES, POSE_GRAPH_EDGES_PER_POSE);
+    const auto realtimePose = MakeRealtimePoseMsg();
+    std::shared_ptr<rgoproto::PoseGraphStreamingMsg> spareGraph;
+    std::shared_ptr<rgoproto::RealtimePoseStreamingMsg> sparePose;
+
+    BENCHMARK("GPO stream round trip 1000 poses")
+    {
+        return RoundTrip(*setup, setup->pose_graphs_received, spareGraph, poseGraph);
+    };
+
+    BENCHMARK("RT pose stream round trip")
+    {
+        return RoundTrip(*setup, setup->realtime_poses_received, sparePose, realtimePose);
+    };
+}
@@ -0,0 +1,482 @@
+#include <catch.hpp>
+#include "../Eureka.Vulkan/Instance.hpp"
+#include "../Eureka.Vulkan/Device.hpp"
+#include "../Eureka.Vulkan/Buffer.hpp"
+#include "../Eureka.Vulkan/BufferMemoryPool.hpp"
+#include "../Eureka.Vulkan/Defragmenter.hpp"
+#include "../Eureka.Vulkan/SubmissionTracker.hpp"
+#include "../Eureka.Vulkan/StageZone.hpp"
+#include "../Eureka.Vulkan/StagingRing.hpp"
+#include "../Eureka.Vulkan/DescriptorAllocators.hpp"
+#include "../Eureka.Vulkan/DescriptorSetsLayout.hpp"
+#include "../Eureka.Vulkan/Image.hpp"
+#include "../Eureka.Vulkan/RenderPass.hpp"
+#include "../Eureka.Vulkan/MemoryBudget.hpp"
+#include "../Eureka.Vulkan/FrameContext.hpp"
+#include "../Eureka.Graphics/PipelinePrecompiler.hpp"
+#include "../Eureka.Graphics/AsyncDataLoader.hpp"
+#include "../Eureka.Graphics/OneShotCopySubmission.hpp"
+#include "../Eureka.Graphics/SubmissionThreadExecutionContext.hpp"
+#include "../Eureka.Graphics/ModelLoader.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+
+namespace vk = eureka::vulkan;
+
+//
+// cpu side cost of staging an upload, the part the loaders pay per image
+// runs on any icd, for comparable numbers across machines use lavapipe:
+//   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json Eureka.Benchmarks "[vulkan]"
+//
+
+namespace
+{
+    constexpr uint64_t STAGE_MEMORY = 1024 * 1024 * 8;
+    constexpr uint64_t UPLOAD_BYTES = 64 * 1024;
+    constexpr std::size_t UPLOADS_IN_FLIGHT = 16;
+    constexpr std::size_t SETS_PER_FRAME = 256;
+    constexpr uint64_t CHURN_BLOCK_BYTES = 8 * 1024 * 1024;
+    constexpr std::size_t CHURN_BUFFERS = 256;
+    constexpr uint64_t DEFRAGMENTATION_PASS_BYTES = 4 * 1024 * 1024;
+    constexpr uint32_t GLTF_PRIMITIVES = 300;
+    constexpr uint32_t GLTF_PRIMITIVE_VERTICES = 64 * 1024;
+    constexpr uint32_t GLTF_PRIMITIVE_INDICES = 96 * 1024;
+    constexpr std::size_t MAX_COPY_SUBMITS_PER_POLL = 10;
+
+    //
+    // a glb of GLTF_PRIMITIVES meshes, each a primitive of uint16 indices and interleaved float3 position + normal
+    // ~1.7MB a primitive, ~500MB overall, written a primitive at a time
+    //
+    void WriteSyntheticGlb(const std::filesystem::path& path)
+    {
+        constexpr uint64_t INDEX_BYTES = GLTF_PRIMITIVE_INDICES * sizeof(uint16_t);
+        constexpr uint64_t VERTEX_STRIDE = 6 * sizeof(float);
+        constexpr uint64_t VERTEX_BYTES = GLTF_PRIMITIVE_VERTICES * VERTEX_STRIDE;
+        constexpr uint64_t PRIMITIVE_BYTES = INDEX_BYTES + VERTEX_BYTES;
+        constexpr uint64_t BIN_BYTES = PRIMITIVE_BYTES * GLTF_PRIMITIVES;
+
+        nlohmann::json json
+        {
+            { "asset", { { "version", "2.0" } } },
+            { "scene", 0 },
+            { "buffers", nlohmann::json::array({ { { "byteLength", BIN_BYTES } } }) }
+        };
+        auto& nodes = json["nodes"] = nlohmann::json::array();
+        auto& meshes = json["meshes"] = nlohmann::json::array();
+        auto& views = json["bufferViews"] = nlohmann::json::array();
+        auto& accessors = json["accessors"] = nlohmann::json::array();
+        auto sceneNodes = nlohmann::json::array();
+
+        for (auto i = 0u; i < GLTF_PRIMITIVES; ++i)
+        {
+            auto offset = i * PRIMITIVE_BYTES;
+            auto view = static_cast<uint32_t>(views.size());
+            auto accessor = static_cast<uint32_t>(accessors.size());
+
+            views.push_back({ { "buffer", 0 }, { "byteOffset", offset }, { "byteLength", INDEX_BYTES } });
+            views.push_back({ { "buffer", 0 }, { "byteOffset", offset + INDEX_BYTES }, { "byteLength", VERTEX_BYTES }, { "byteStride", VERTEX_STRIDE } });
+            accessors.push_back({ { "bufferView", view }, { "componentType", 5123 }, { "count", GLTF_PRIMITIVE_INDICES }, { "type", "SCALAR" } });
+            accessors.push_back({ { "bufferView", view + 1 }, { "componentType", 5126 }, { "count", GLTF_PRIMITIVE_VERTICES }, { "type", "VEC3" } });
+            accessors.push_back({ { "bufferView", view + 1 }, { "byteOffset", 12 }, { "componentType", 5126 }, { "count", GLTF_PRIMITIVE_VERTICES }, { "type", "VEC3" } });
+
+            nlohmann::json primitive
+            {
+                { "attributes", { { "POSITION", accessor + 1 }, { "NORMAL", accessor + 2 } } },
+                { "indices", accessor }
+            };
+            meshes.push_back({ { "primitives", nlohmann::json::array({ primitive }) } });
+            nodes.push_back({ { "mesh", i } });
+            sceneNodes.push_back(i);
+        }
+        json["scenes"] = nlohmann::json::array({ { { "nodes", sceneNodes } } });
+
+        auto text = json.dump();
+        text.resize((text.size() + 3) & ~std::size_t(3), ' ');
+
+        std::ofstream file(path, std::ios::binary);
+        auto writeU32 = [&](uint32_t value) { file.write(reinterpret_cast<const char*>(&value), sizeof(value)); };
+        writeU32(0x46546C67); // glTF
+        writeU32(2);
+        writeU32(static_cast<uint32_t>(12 + 8 + text.size() + 8 + BIN_BYTES));
+        writeU32(static_cast<uint32_t>(text.size()));
+        writeU32(0x4E4F534A); // JSON
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        writeU32(static_cast<uint32_t>(BIN_BYTES));
+        writeU32(0x004E4942); // BIN
+
+        std::vector<uint16_t> indices(GLTF_PRIMITIVE_INDICES);
+        for (auto i = 0u; i < GLTF_PRIMITIVE_INDICES; ++i)
+        {
+            indices[i] = static_cast<uint16_t>((i * 7) % GLTF_PRIMITIVE_VERTICES);
+        }
+        std::vector<float> vertices(GLTF_PRIMITIVE_VERTICES * 6);
+        for (auto i = 0u; i < GLTF_PRIMITIVE_VERTICES; ++i)
+        {
+            auto* vertex = vertices.data() + i * 6;
+            vertex[0] = float(i % 256);
+            vertex[1] = float(i / 256);
+            vertex[2] = 0.0f;
+            vertex[3] = 0.0f;
+            vertex[4] = 0.0f;
+            vertex[5] = 1.0f;
+        }
+
+        for (auto i = 0u; i < GLTF_PRIMITIVES; ++i)
+        {
+            file.write(reinterpret_cast<const char*>(indices.data()), INDEX_BYTES);
+            file.write(reinterpret_cast<const char*>(vertices.data()), VERTEX_BYTES);
+        }
+    }
+}
+
+TEST_CASE("staging uploads", "[benchmark][vulkan]")
+{
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    auto allocator = std::make_shared<vk::ResourceAllocator>(instance, device);
+
+    auto uploadPool = std::make_shared<vk::BufferMemoryPool>(
+        allocator,
+        vk::PoolBlocksConfig{ .block_byte_size = STAGE_MEMORY, .max_block_count = 1 },
+        VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+    );
+    auto stagingRing = std::make_shared<vk::StagingRing>(allocator, vk::StagingRingConfig{ .byte_size = STAGE_MEMORY });
+
+    std::vector<uint8_t> payload(UPLOAD_BYTES, 0xAB);
+    eureka::dcspan<uint8_t> src(payload);
+
+    BENCHMARK("pool stage zone 16 x 64KB")
+    {
+        std::vector<vk::PoolSequentialStageZone> zones;
+        zones.reserve(UPLOADS_IN_FLIGHT);
+        for (auto i = 0u; i < UPLOADS_IN_FLIGHT; ++i)
+        {
+            zones.emplace_back(uploadPool, UPLOAD_BYTES).Assign(src);
+        }
+        return zones.size();
+    };
+
+    BENCHMARK("staging ring 16 x 64KB")
+    {
+        std::vector<vk::StagingRegion> regions;
+        regions.reserve(UPLOADS_IN_FLIGHT);
+        for (auto i = 0u; i < UPLOADS_IN_FLIGHT; ++i)
+        {
+            auto& region = regions.emplace_back(stagingRing->Allocate(UPLOAD_BYTES));
+            region.Assign(src);
+            region.Flush();
+        }
+        return regions.size();
+    };
+
+    REQUIRE(stagingRing->BytesInFlight() == 0);
+}
+
+//
+// a frame worth of per draw descriptor sets, sets per ms is SETS_PER_FRAME over the reported mean
+//
+TEST_CASE("descriptor set allocation", "[benchmark][vulkan]")
+{
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings
+    {
+        VkDescriptorSetLayoutBinding
+        {
+            .binding = 0,
+            .descriptorType = VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_VERTEX_BIT
+        },
+        VkDescriptorSetLayoutBinding
+        {
+            .binding = 1,
+            .descriptorType = VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT
+        }
+    };
+    std::array<VkDescriptorPoolSize, 2> layoutDescriptors
+    {
+        VkDescriptorPoolSize{ .type = VkDescriptorType::VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 1 },
+        VkDescriptorPoolSize{ .type = VkDescriptorType::VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1 }
+    };
+
+    vk::DescriptorSetLayout layout(device, VkDescriptorSetLayoutCreateInfo
+        {
+            .sType = VkStructureType::VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+            .bindingCount = static_cast<uint32_t>(bindings.size()),
+            .pBindings = bindings.data()
+        });
+
+    vk::FreeableDescriptorSetAllocator freeableAllocator(device);
+    vk::LinearDescriptorAllocator linearAllocator(device);
+
+    std::vector<vk::DescriptorSetAllocation> allocations;
+    allocations.reserve(SETS_PER_FRAME);
+
+    BENCHMARK("freeable allocator 256 sets")
+    {
+        for (auto i = 0u; i < SETS_PER_FRAME; ++i)
+        {
+            allocations.emplace_back(freeableAllocator.AllocateSet(layout.Get()));
+        }
+        for (const auto& allocation : allocations)
+        {
+            freeableAllocator.DeallocateSet(allocation);
+        }
+        allocations.clear();
+    };
+
+    BENCHMARK("linear allocator 256 sets")
+    {
+        for (auto i = 0u; i < SETS_PER_FRAME; ++i)
+        {
+            linearAllocator.AllocateSet(layout.Get(), layoutDescriptors);
+        }
+        linearAllocator.Reset();
+    };
+
+    // after the first frames the whole frame fits a single pool
+    REQUIRE(linearAllocator.Counters().pools == 1);
+}
+
+//
+// startup cost of the preset pipelines, every iteration is a process start: a new pipeline cache, every preset
+// compiled on the pool and waited for
+// the warm variant seeds the cache from the file written by the previous run
+// drivers keep their own shader caches, disable them for a true cold start:
+//   MESA_SHADER_CACHE_DISABLE=true __GL_SHADER_DISK_CACHE=0 Eureka.Benchmarks "preset pipelines startup"
+//
+TEST_CASE("preset pipelines startup", "[benchmark][vulkan]")
+{
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    concurrencpp::runtime runtime;
+
+    auto shaderCache = std::make_shared<vk::ShaderCache>(device);
+    auto layoutCache = std::make_shared<vk::DescriptorSetLayoutCache>(device);
+    auto renderPass = std::make_shared<vk::DepthColorRenderPass>(device, vk::DepthColorRenderPassConfig
+        {
+            .color_output_format = VkFormat::VK_FORMAT_B8G8R8A8_UNORM,
+            .depth_output_format = vk::GetDefaultDepthBufferFormat(*device)
+        });
+
+    auto cachePath = std::filesystem::temp_directory_path() / "eureka_benchmarks_pipeline_cache.bin";
+    std::filesystem::remove(cachePath);
+
+    {
+        auto pipelineCache = std::make_shared<vk::PipelineCache>(device, cachePath);
+        REQUIRE_FALSE(pipelineCache->LoadedFromDisk());
+
+        eureka::graphics::PipelinePrecompiler precompiler(device, shaderCache, layoutCache, pipelineCache, runtime.thread_pool_executor());
+        precompiler.PrecompileAll(renderPass);
+        precompiler.WaitAll();
+        REQUIRE(precompiler.Counters().compiled == vk::PIPELINE_PRESET_TYPES.size());
+    }
+
+    auto measureStartup = [&](Catch::Benchmark::Chronometer meter, bool warm)
+    {
+        // the pipelines and the cache save are released outside of the measurement
+        std::vector<std::shared_ptr<eureka::graphics::PipelinePrecompiler>> precompilers(meter.runs());
+
+        meter.measure([&](int i)
+            {
+                auto pipelineCache = warm ?
+                    std::make_shared<vk::PipelineCache>(device, cachePath) :
+                    std::make_shared<vk::PipelineCache>(device);
+
+                auto& precompiler = precompilers[i];
+                precompiler = std::make_shared<eureka::graphics::PipelinePrecompiler>(
+                    device, shaderCache, layoutCache, std::move(pipelineCache), runtime.thread_pool_executor());
+                precompiler->PrecompileAll(renderPass);
+                precompiler->WaitAll();
+                return precompiler->Counters().compiled;
+            });
+
+        REQUIRE(precompilers.front()->Counters().warm_cache == warm);
+    };
+
+    BENCHMARK_ADVANCED("preset pipelines cold cache")(Catch::Benchmark::Chronometer meter)
+    {
+        measureStartup(meter, false);
+    };
+
+    BENCHMARK_ADVANCED("preset pipelines warm cache")(Catch::Benchmark::Chronometer meter)
+    {
+        measureStartup(meter, true);
+    };
+
+    std::filesystem::remove(cachePath);
+}
+
+//
+// synthetic allocate / free churn on small default pool blocks, every other buffer freed leaves each block half
+// empty, the defragmenter compacts the survivors into fewer blocks
+// the churn alone is measured as well, the difference is the relocation (recording, copies, rebinding)
+//
+TEST_CASE("defragmentation churn", "[benchmark][vulkan]")
+{
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    auto allocator = std::make_shared<vk::ResourceAllocator>(instance, device, vk::ResourceAllocatorConfig{ .preferred_block_byte_size = CHURN_BLOCK_BYTES });
+    auto queue = device->GetGraphicsQueue();
+
+    vk::LinearCommandPool commandPool(device, queue.Family());
+    vk::SubmissionTracker submissions(device, queue);
+
+    auto churn = [&]()
+    {
+        std::vector<vk::StorageTransferableDeviceBuffer> buffers;
+        buffers.reserve(CHURN_BUFFERS);
+        for (auto i = 0u; i < CHURN_BUFFERS; ++i)
+        {
+            // 64KB to 512KB
+            buffers.emplace_back(allocator, (64 * 1024) << (i % 4));
+        }
+
+        std::vector<vk::StorageTransferableDeviceBuffer> survivors;
+        survivors.reserve(CHURN_BUFFERS / 2);
+        for (auto i = 0u; i < CHURN_BUFFERS; i += 2)
+        {
+            survivors.emplace_back(std::move(buffers[i]));
+        }
+        buffers.clear();
+
+        for (auto& buffer : survivors)
+        {
+            buffer.EnableRelocation();
+        }
+        return survivors;
+    };
+
+    auto defragment = [&]()
+    {
+        vk::Defragmenter defragmenter(device, allocator, vk::DefragmentationLimits{ .max_bytes_per_pass = DEFRAGMENTATION_PASS_BYTES });
+        REQUIRE(defragmenter.Begin());
+
+        // one pass per frame in the application, back to back here
+        while (defragmenter.BeginPass())
+        {
+            commandPool.Reset();
+            auto commandBuffer = commandPool.AllocatePrimaryCommandBuffer();
+            {
+                vk::ScopedCommands commands(commandBuffer);
+                defragmenter.RecordPass(commandBuffer);
+            }
+            submissions.Wait(submissions.Enqueue(commandBuffer.Get()));
+
+            if (defragmenter.EndPass())
+            {
+                break;
+            }
+        }
+        return defragmenter.Counters();
+    };
+
+    {
+        auto survivors = churn();
+        auto counters = defragment();
+        REQUIRE(counters.relocated > 0);
+        REQUIRE(counters.last_run.blocks_freed > 0);
+    }
+
+    BENCHMARK("churn 256 buffers")
+    {
+        return churn().size();
+    };
+
+    BENCHMARK("churn 256 buffers and defragment")
+    {
+        auto survivors = churn();
+        return defragment().last_run.bytes_freed;
+    };
+}
+
+//
+// a ~500MB glb from disk to GPU resident: mapping, conversion on the pool, staging and the copy queue
+// the rendering thread is played by the benchmark thread, pumping the submissions as RenderingSystem does
+// the file is written once and then sits in the page cache, the numbers are for a warm cache
+// every sample loads the whole scene, keep the sample count low:
+//   VK_ICD_FILENAMES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json Eureka.Benchmarks "gltf model loading" --benchmark-samples 5
+//
+TEST_CASE("gltf model loading", "[benchmark][vulkan]")
+{
+    namespace gfx = eureka::graphics;
+
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    auto allocator = std::make_shared<vk::ResourceAllocator>(instance, device);
+    auto copyQueue = device->GetCopyQueue();
+    auto graphicsQueue = device->GetGraphicsQueue();
+    concurrencpp::runtime runtime;
+
+    auto submissionContext = std::make_shared<gfx::SubmissionThreadExecutionContext>(
+        device, copyQueue, graphicsQueue, runtime.make_executor<gfx::submission_thread_executor>());
+    submissionContext->SetCurrentThreadAsRenderingThread();
+
+    auto frameContext = std::make_shared<vk::FrameContext>(device, copyQueue, graphicsQueue);
+    auto submissionHandler = std::make_shared<gfx::OneShotSubmissionHandler>(device, copyQueue, graphicsQueue, frameContext, submissionContext);
+    auto asyncDataLoader = std::make_shared<gfx::AsyncDataLoader>(
+        submissionHandler,
+        std::make_shared<vk::StagingRing>(allocator),
+        std::make_shared<vk::MemoryBudgetTracker>(allocator));
+
+    gfx::ModelLoader loader(device, allocator, asyncDataLoader, runtime.background_executor(), runtime.thread_pool_executor());
+
+    auto path = std::filesystem::temp_directory_path() / "eureka_benchmarks_scene.glb";
+    auto cacheDirectory = std::filesystem::temp_directory_path() / "eureka_benchmarks_model_cache";
+    WriteSyntheticGlb(path);
+    std::filesystem::remove_all(cacheDirectory);
+
+    auto load = [&](gfx::ModelLoadingConfig config = {})
+    {
+        auto future = loader.LoadModel(path, std::move(config));
+        while (future.status() == concurrencpp::result_status::idle)
+        {
+            frameContext->BeginFrame();
+            submissionContext->Executor().loop_all(MAX_COPY_SUBMITS_PER_POLL);
+            submissionHandler->SubmitPendingCopies();
+            submissionHandler->PollCopyCompletions();
+            submissionHandler->SubmitPendingGraphics();
+            submissionHandler->PollGraphicsCompletions();
+            frameContext->EndFrame();
+        }
+        return future.get();
+    };
+
+    {
+        auto model = load();
+        REQUIRE(model.primitives.size() == GLTF_PRIMITIVES);
+        REQUIRE(model.primitives.back().index_count == GLTF_PRIMITIVE_INDICES);
+        REQUIRE(model.stats.upload_batches > 1);
+        REQUIRE(model.stats.mapped_bytes > GLTF_PRIMITIVES * GLTF_PRIMITIVE_VERTICES * 24ull);
+    }
+
+    {
+        auto cold = load(gfx::ModelLoadingConfig{ .cache_directory = cacheDirectory });
+        REQUIRE(cold.stats.cooked);
+        auto warm = load(gfx::ModelLoadingConfig{ .cache_directory = cacheDirectory });
+        REQUIRE(warm.stats.from_cache);
+        REQUIRE_FALSE(warm.stats.cooked);
+        REQUIRE(warm.stats.geometry_bytes == cold.stats.geometry_bytes);
+    }
+
+    BENCHMARK("gltf 500MB glb to GPU resident")
+    {
+        return load().stats.geometry_bytes;
+    };
+
+    BENCHMARK("gltf 500MB glb to GPU resident, warm model cache")
+    {
+        return load(gfx::ModelLoadingConfig{ .cache_directory = cacheDirectory }).stats.geometry_bytes;
+    };
+
+    graphicsQueue.WaitIdle();
+    copyQueue.WaitIdle();
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(cacheDirectory);
+}
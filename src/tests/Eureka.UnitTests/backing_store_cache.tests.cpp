@@ -0,0 +1,145 @@
+#include <catch.hpp>
+#include "../Eureka.Flutter/BackingStoreCache.hpp"
+
+namespace flt = eureka::flutter;
+namespace vk = eureka::vulkan;
+
+namespace
+{
+    constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+    constexpr uint64_t MB = 1024 * 1024;
+
+    //
+    // stands in for the allocator, the heap usage and budget the cache trims against
+    //
+    struct FakeHeap
+    {
+        uint64_t usage{ 0 };
+        uint64_t budget{ 1024 * MB };
+
+        flt::HeapBudgetQuery Query()
+        {
+            return [this] { return vk::HeapBudget{ .usage = usage, .budget = budget }; };
+        }
+    };
+
+    // no image or descriptor set behind it, the cache only looks at the key and the size
+    std::unique_ptr<flt::BackingStoreData> MakeStore(uint32_t width, uint32_t height)
+    {
+        return std::make_unique<flt::BackingStoreData>(flt::BackingStoreData {
+            .self = nullptr,
+            .key = flt::BackingStoreKey{ .width = width, .height = height, .format = VK_FORMAT_R8G8B8A8_UNORM },
+            .byte_size = static_cast<uint64_t>(width) * height * 4,
+            .image = vk::PoolAllocatedImage2D(nullptr, nullptr),
+            .descriptor_set = vk::FreeableDescriptorSet(nullptr, nullptr),
+            .flutter_image = {}
+        });
+    }
+
+    void EndFrames(flt::BackingStoreCache& cache, uint32_t frames)
+    {
+        for (auto i = 0u; i < frames; ++i)
+        {
+            cache.EndFrame();
+        }
+    }
+}
+
+TEST_CASE("backing store cache", "[flutter]")
+{
+    FakeHeap heap;
+
+    SECTION("a released store is reused once no frame in flight samples it")
+    {
+        flt::BackingStoreCache cache(heap.Query(), FRAMES_IN_FLIGHT);
+
+        auto older = MakeStore(64, 64);
+        auto newer = MakeStore(64, 64);
+        auto* olderPtr = older.get();
+        auto* newerPtr = newer.get();
+        cache.Release(std::move(older));
+        cache.Release(std::move(newer));
+
+        auto key = flt::BackingStoreKey{ .width = 64, .height = 64, .format = VK_FORMAT_R8G8B8A8_UNORM };
+        REQUIRE(cache.TryAcquire(key) == nullptr);
+        EndFrames(cache, FRAMES_IN_FLIGHT - 1);
+        REQUIRE(cache.TryAcquire(key) == nullptr);
+        EndFrames(cache, 1);
+
+        REQUIRE(cache.TryAcquire(flt::BackingStoreKey{ .width = 64, .height = 32, .format = VK_FORMAT_R8G8B8A8_UNORM }) == nullptr);
+
+        // newest first
+        REQUIRE(cache.TryAcquire(key).get() == newerPtr);
+        REQUIRE(cache.TryAcquire(key).get() == olderPtr);
+        REQUIRE(cache.TryAcquire(key) == nullptr);
+
+        auto counters = cache.Counters();
+        REQUIRE(counters.reused == 2);
+        REQUIRE(counters.free_stores == 0);
+        REQUIRE(counters.free_bytes == 0);
+    }
+
+    SECTION("idle stores are evicted")
+    {
+        flt::BackingStoreCache cache(heap.Query(), FRAMES_IN_FLIGHT, flt::BackingStoreCacheConfig{ .max_idle_frames = 10 });
+
+        cache.Release(MakeStore(64, 64));
+        EndFrames(cache, 9);
+        REQUIRE(cache.Counters().free_stores == 1);
+
+        EndFrames(cache, 1);
+        auto counters = cache.Counters();
+        REQUIRE(counters.free_stores == 0);
+        REQUIRE(counters.trimmed == 1);
+    }
+
+    SECTION("free bytes past the budget are trimmed oldest first, once fenced")
+    {
+        flt::BackingStoreCache cache(heap.Query(), FRAMES_IN_FLIGHT, flt::BackingStoreCacheConfig{ .max_free_bytes = 3 * MB });
+
+        std::vector<flt::BackingStoreData*> released;
+        for (auto i = 0; i < 5; ++i)
+        {
+            auto store = MakeStore(512, 512); // 1MB
+            released.emplace_back(store.get());
+            cache.Release(std::move(store));
+        }
+        REQUIRE(cache.Counters().free_bytes == 5 * MB);
+
+        // still in flight, nothing is trimmed yet
+        EndFrames(cache, FRAMES_IN_FLIGHT - 1);
+        REQUIRE(cache.Counters().free_stores == 5);
+
+        EndFrames(cache, 1);
+        auto counters = cache.Counters();
+        REQUIRE(counters.trimmed == 2);
+        REQUIRE(counters.free_stores == 3);
+        REQUIRE(counters.free_bytes == 3 * MB);
+
+        auto key = flt::BackingStoreKey{ .width = 512, .height = 512, .format = VK_FORMAT_R8G8B8A8_UNORM };
+        REQUIRE(cache.TryAcquire(key).get() == released[4]);
+        REQUIRE(cache.TryAcquire(key).get() == released[3]);
+        REQUIRE(cache.TryAcquire(key).get() == released[2]);
+    }
+
+    SECTION("heap pressure trims below the byte budget")
+    {
+        flt::BackingStoreCache cache(heap.Query(), FRAMES_IN_FLIGHT, flt::BackingStoreCacheConfig{ .max_free_bytes = 256 * MB, .trim_pressure = 0.85f });
+
+        for (auto i = 0; i < 3; ++i)
+        {
+            cache.Release(MakeStore(4096, 4096)); // 64MB
+        }
+
+        // 100MB past the soft limit, two stores cover it
+        heap.usage = 950 * MB;
+        heap.budget = 1000 * MB;
+        EndFrames(cache, FRAMES_IN_FLIGHT);
+        REQUIRE(cache.Counters().free_stores == 1);
+        REQUIRE(cache.Counters().trimmed == 2);
+
+        heap.usage = 500 * MB;
+        EndFrames(cache, 1);
+        REQUIRE(cache.Counters().free_stores == 1);
+    }
+}
@@ -0,0 +1,70 @@
+#include <catch.hpp>
+#include "../Eureka.RPC/ExponentialBackoff.hpp"
+#include <cmath>
+
+namespace rpc = eureka::rpc;
+
+namespace
+{
+    using ms = std::chrono::milliseconds;
+}
+
+TEST_CASE("exponential backoff", "[rpc]")
+{
+    SECTION("without jitter the delays grow by the multiplier up to the cap")
+    {
+        rpc::ExponentialBackoff backoff(rpc::BackoffConfig{ .initial = ms(100), .max = ms(1000), .multiplier = 2.0, .jitter = 0.0 });
+
+        REQUIRE(backoff.Next() == ms(100));
+        REQUIRE(backoff.Next() == ms(200));
+        REQUIRE(backoff.Next() == ms(400));
+        REQUIRE(backoff.Next() == ms(800));
+        REQUIRE(backoff.Next() == ms(1000));
+        REQUIRE(backoff.Next() == ms(1000));
+    }
+
+    SECTION("reset starts over from the initial delay")
+    {
+        rpc::ExponentialBackoff backoff(rpc::BackoffConfig{ .initial = ms(50), .max = ms(10000), .multiplier = 3.0, .jitter = 0.0 });
+
+        backoff.Next();
+        backoff.Next();
+        REQUIRE(backoff.Next() == ms(450));
+
+        backoff.Reset();
+        REQUIRE(backoff.Next() == ms(50));
+        REQUIRE(backoff.Next() == ms(150));
+    }
+
+    SECTION("jitter stays within its fraction of the delay, the cap included")
+    {
+        constexpr double JITTER = 0.2;
+        rpc::ExponentialBackoff backoff(rpc::BackoffConfig{ .initial = ms(100), .max = ms(2000), .multiplier = 1.6, .jitter = JITTER }, 7);
+
+        auto expected = 100.0;
+        auto jittered = false;
+        for (auto i = 0; i < 32; ++i)
+        {
+            auto delay = static_cast<double>(backoff.Next().count()) / 1e6;
+            REQUIRE(delay >= expected * (1.0 - JITTER) - 1e-6);
+            REQUIRE(delay <= expected * (1.0 + JITTER) + 1e-6);
+            jittered |= std::abs(delay - expected) > 1e-3;
+
+            expected = std::min(expected * 1.6, 2000.0);
+        }
+        REQUIRE(jittered);
+    }
+
+    SECTION("clients with different seeds don't retry in lockstep")
+    {
+        rpc::ExponentialBackoff first(rpc::BackoffConfig{}, 1);
+        rpc::ExponentialBackoff second(rpc::BackoffConfig{}, 2);
+
+        auto same = 0;
+        for (auto i = 0; i < 8; ++i)
+        {
+            same += first.Next() == second.Next();
+        }
+        REQUIRE(same < 8);
+    }
+}
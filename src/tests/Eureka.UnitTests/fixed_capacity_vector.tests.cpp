@@ -1,5 +1,6 @@
 #include <catch.hpp>
 #include <debugger_trace.hpp>
+#include <fixed_capacity_vector.hpp>
 #include <boost/pool/object_pool.hpp>
 #include <boost/lockfree/stack.hpp>
 #include <stack>
@@ -286,4 +287,112 @@ TEST_CASE("FixedObjectPool", "[vulkan]")
         }
     };
 
-}
\ No newline at end of file
+}
+
+
+
+namespace
+{
+    constexpr int ConstexprFixedCapacityVectorSum()
+    {
+        eureka::fixed_capacity_vector<int, 8> vec{ 1, 2, 3 };
+        vec.insert(vec.begin(), 10);
+        vec.erase(vec.begin() + 1);
+        vec.push_back(4);
+        auto copy = vec;
+        int sum = 0;
+        for (auto v : copy)
+        {
+            sum += v;
+        }
+        return sum * 10 + static_cast<int>(copy.size());
+    }
+
+    static_assert(ConstexprFixedCapacityVectorSum() == 194);
+    static_assert(std::is_trivially_destructible_v<eureka::fixed_capacity_vector<int, 8>>);
+    static_assert(!std::is_trivially_destructible_v<eureka::fixed_capacity_vector<std::string, 8>>);
+    static_assert(sizeof(eureka::fixed_capacity_vector<uint64_t, 4>) == sizeof(uint64_t) * 5);
+}
+
+TEST_CASE("fixed_capacity_vector", "[containers]")
+{
+    SECTION("storage is inside the object")
+    {
+        eureka::fixed_capacity_vector<int, 16> vec;
+        auto objectBegin = reinterpret_cast<const std::byte*>(&vec);
+        auto objectEnd = objectBegin + sizeof(vec);
+        auto dataBegin = reinterpret_cast<const std::byte*>(vec.data());
+        REQUIRE(dataBegin >= objectBegin);
+        REQUIRE(dataBegin + sizeof(int) * vec.capacity() <= objectEnd);
+        REQUIRE(vec.empty());
+        REQUIRE(vec.capacity() == 16);
+    }
+
+    SECTION("emplace, insert and erase")
+    {
+        eureka::fixed_capacity_vector<int, 5> vec;
+        vec.emplace_back(1);
+        vec.emplace_back(3);
+        vec.insert(vec.begin() + 1, 2);
+        vec.insert(vec.begin(), 0);
+        vec.push_back(4);
+        REQUIRE(vec.full());
+        REQUIRE(vec.try_emplace_back(5) == nullptr);
+        REQUIRE(std::ranges::equal(vec, std::array{ 0, 1, 2, 3, 4 }));
+
+        vec.erase(vec.begin() + 1, vec.begin() + 3);
+        REQUIRE(std::ranges::equal(vec, std::array{ 0, 3, 4 }));
+
+        vec.erase(vec.begin());
+        vec.pop_back();
+        REQUIRE(vec.size() == 1);
+        REQUIRE(vec.front() == 3);
+        REQUIRE_THROWS_AS(vec.at(1), std::out_of_range);
+    }
+
+    SECTION("non trivial elements are constructed and destroyed exactly once")
+    {
+        auto counter = std::make_shared<int>(0);
+        {
+            eureka::fixed_capacity_vector<std::shared_ptr<int>, 4> vec;
+            vec.emplace_back(counter);
+            vec.emplace_back(counter);
+            vec.insert(vec.begin(), counter);
+            REQUIRE(counter.use_count() == 4);
+
+            auto copy = vec;
+            REQUIRE(counter.use_count() == 7);
+
+            auto moved = std::move(copy);
+            REQUIRE(copy.empty());
+            REQUIRE(counter.use_count() == 7);
+
+            moved.erase(moved.begin(), moved.begin() + 2);
+            REQUIRE(counter.use_count() == 5);
+
+            vec.resize(1);
+            REQUIRE(counter.use_count() == 3);
+        }
+        REQUIRE(counter.use_count() == 1);
+    }
+
+    SECTION("move only elements")
+    {
+        eureka::fixed_capacity_vector<std::unique_ptr<int>, 3> vec;
+        vec.emplace_back(std::make_unique<int>(1));
+        vec.emplace_back(std::make_unique<int>(2));
+        eureka::fixed_capacity_vector<std::unique_ptr<int>, 3> other;
+        other = std::move(vec);
+        REQUIRE(vec.empty());
+        REQUIRE(other.size() == 2);
+        REQUIRE(*other.back() == 2);
+    }
+
+    SECTION("erase_if")
+    {
+        eureka::fixed_capacity_vector<std::string, 6> vec{ "a", "bb", "c", "dd" };
+        auto removed = eureka::erase_if(vec, [](const std::string& str) { return str.size() == 2; });
+        REQUIRE(removed == 2);
+        REQUIRE(vec == eureka::fixed_capacity_vector<std::string, 6>{ "a", "c" });
+    }
+}
@@ -0,0 +1,81 @@
+#include <catch.hpp>
+#include "../Eureka.Graphics/FramePacer.hpp"
+
+namespace gfx = eureka::graphics;
+
+namespace
+{
+    using ns = std::chrono::nanoseconds;
+
+    constexpr ns REFRESH_144HZ = ns(6'944'444);
+}
+
+TEST_CASE("frame pacer", "[graphics]")
+{
+    SECTION("learns the present interval and predicts the next vblank")
+    {
+        gfx::FramePacer pacer;
+
+        auto t = ns(1'000'000'000);
+        for (auto i = 0; i < 400; ++i)
+        {
+            // +-200us of timestamp jitter around a 144Hz cadence
+            auto jitter = ns((i % 3 - 1) * 200'000);
+            REQUIRE(pacer.RecordPresent(t + jitter) == 0);
+            t += REFRESH_144HZ;
+        }
+
+        auto counters = pacer.Counters();
+        REQUIRE(counters.dropped_frames == 0);
+        REQUIRE(std::chrono::abs(counters.interval - REFRESH_144HZ) < ns(50'000));
+
+        // t is the next vblank, a request a bit before it starts there
+        auto prediction = pacer.Predict(t - ns(2'000'000));
+        REQUIRE(std::chrono::abs(prediction.frame_start - t) < ns(300'000));
+        REQUIRE(std::chrono::abs(prediction.frame_target - (t + REFRESH_144HZ)) < ns(300'000));
+    }
+
+    SECTION("a present predicts the vblank after the one it landed on, whatever the sign of its jitter")
+    {
+        gfx::FramePacer pacer(gfx::FramePacerConfig{ .nominal_interval = REFRESH_144HZ });
+
+        auto t = ns(1'000'000'000);
+        for (auto i = 0; i < 400; ++i)
+        {
+            // +-300us, the timestamps land on both sides of the vblank
+            auto jitter = ns((i % 2 ? 1 : -1) * 300'000);
+            auto present = t + jitter;
+            pacer.RecordPresent(present);
+
+            if (i >= 16)
+            {
+                auto prediction = pacer.PredictAfterPresent(present);
+                REQUIRE(std::chrono::abs(prediction.frame_start - t) < ns(300'000));
+                REQUIRE(std::chrono::abs(prediction.frame_target - (t + REFRESH_144HZ)) < ns(300'000));
+            }
+            t += REFRESH_144HZ;
+        }
+    }
+
+    SECTION("missed vblanks are dropped frames, long pauses are not")
+    {
+        gfx::FramePacer pacer(gfx::FramePacerConfig{ .nominal_interval = REFRESH_144HZ });
+
+        auto t = ns(0);
+        pacer.RecordPresent(t);
+        t += REFRESH_144HZ;
+        pacer.RecordPresent(t);
+
+        t += REFRESH_144HZ * 3;
+        REQUIRE(pacer.RecordPresent(t) == 2);
+
+        t += REFRESH_144HZ * 100;
+        REQUIRE(pacer.RecordPresent(t) == 0);
+
+        auto counters = pacer.Counters();
+        REQUIRE(counters.frames == 4);
+        REQUIRE(counters.late_frames == 1);
+        REQUIRE(counters.dropped_frames == 2);
+        REQUIRE(counters.idle_gaps == 1);
+    }
+}
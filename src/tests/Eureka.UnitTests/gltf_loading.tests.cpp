@@ -0,0 +1,485 @@
+#include <catch.hpp>
+#include <basic_errors.hpp>
+#include "../Eureka.Graphics/GltfDocument.hpp"
+#include "../Eureka.Graphics/ModelCache.hpp"
+#include "../Eureka.Graphics/Ktx2Texture.hpp"
+#include <concurrencpp/concurrencpp.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace gfx = eureka::graphics;
+
+namespace
+{
+    template<typename T>
+    eureka::dcspan<uint8_t> AsBytes(const std::vector<T>& values)
+    {
+        return { reinterpret_cast<const uint8_t*>(values.data()), values.size() * sizeof(T) };
+    }
+
+    void AppendU32(std::vector<uint8_t>& bytes, uint32_t value)
+    {
+        auto offset = bytes.size();
+        bytes.resize(offset + sizeof(value));
+        std::memcpy(bytes.data() + offset, &value, sizeof(value));
+    }
+
+    void WriteFile(const std::filesystem::path& path, eureka::dcspan<uint8_t> bytes)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    void WriteGlb(const std::filesystem::path& path, std::string json, std::vector<uint8_t> bin)
+    {
+        json.resize((json.size() + 3) & ~size_t(3), ' ');
+        bin.resize((bin.size() + 3) & ~size_t(3), 0);
+
+        std::vector<uint8_t> glb;
+        AppendU32(glb, 0x46546C67); // glTF
+        AppendU32(glb, 2);
+        AppendU32(glb, static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size()));
+        AppendU32(glb, static_cast<uint32_t>(json.size()));
+        AppendU32(glb, 0x4E4F534A); // JSON
+        glb.insert(glb.end(), json.begin(), json.end());
+        AppendU32(glb, static_cast<uint32_t>(bin.size()));
+        AppendU32(glb, 0x004E4942); // BIN
+        glb.insert(glb.end(), bin.begin(), bin.end());
+        WriteFile(path, glb);
+    }
+
+    //
+    // 6 uint16 indices at 0, 3 vertices of interleaved float3 position + float3 normal at 12
+    // accessor 3 claims a vertex more than its view holds
+    //
+    std::vector<uint8_t> TriangleBin()
+    {
+        std::vector<uint16_t> indices{ 0, 1, 2, 2, 1, 0 };
+        std::vector<float> vertices
+        {
+            0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+            1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+            0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+        };
+
+        std::vector<uint8_t> bin;
+        auto indexBytes = AsBytes(indices);
+        auto vertexBytes = AsBytes(vertices);
+        bin.insert(bin.end(), indexBytes.begin(), indexBytes.end());
+        bin.insert(bin.end(), vertexBytes.begin(), vertexBytes.end());
+        return bin;
+    }
+
+    std::string TriangleJson(const std::string& bufferUri)
+    {
+        return R"({
+            "asset": { "version": "2.0" },
+            "scene": 0,
+            "scenes": [ { "nodes": [ 0, 2 ] } ],
+            "nodes": [ { "children": [ 1 ] }, { "mesh": 0 }, { "mesh": 0 } ],
+            "meshes": [
+                { "primitives": [ { "attributes": { "POSITION": 1, "NORMAL": 2 }, "indices": 0 } ] },
+                { "primitives": [ { "attributes": { "POSITION": 1 } } ] }
+            ],
+            "buffers": [ { "byteLength": 84)" + (bufferUri.empty() ? std::string() : R"(, "uri": ")" + bufferUri + "\"") + R"( } ],
+            "bufferViews": [
+                { "buffer": 0, "byteOffset": 0, "byteLength": 12 },
+                { "buffer": 0, "byteOffset": 12, "byteLength": 72, "byteStride": 24 }
+            ],
+            "accessors": [
+                { "bufferView": 0, "componentType": 5123, "count": 6, "type": "SCALAR" },
+                { "bufferView": 1, "componentType": 5126, "count": 3, "type": "VEC3" },
+                { "bufferView": 1, "byteOffset": 12, "componentType": 5126, "count": 3, "type": "VEC3" },
+                { "bufferView": 1, "componentType": 5126, "count": 4, "type": "VEC3" }
+            ]
+        })";
+    }
+
+    void RequireTriangle(const gfx::GltfDocument& document)
+    {
+        REQUIRE(document.SceneMeshes() == std::vector<uint32_t>{ 0 });
+        REQUIRE(document.Meshes().at(0).primitives.at(0).normal == 2);
+
+        auto indices = document.ResolveAccessor(0);
+        std::vector<uint32_t> widened(indices.count);
+        gfx::ReadGltfAccessorIndices(indices, widened);
+        REQUIRE(widened == std::vector<uint32_t>{ 0, 1, 2, 2, 1, 0 });
+
+        auto normals = document.ResolveAccessor(2);
+        REQUIRE_FALSE(normals.IsPacked());
+        std::vector<float> packed(normals.count * 3);
+        gfx::ReadGltfAccessorFloats(normals, 3, packed);
+        REQUIRE(packed == std::vector<float>{ 0, 0, 1, 0, 0, 1, 0, 0, 1 });
+
+        REQUIRE_THROWS_AS(document.ResolveAccessor(3), eureka::file_load_error);
+        REQUIRE_THROWS_AS(document.ResolveAccessor(4), eureka::file_load_error);
+    }
+}
+
+TEST_CASE("gltf accessors", "[graphics]")
+{
+    SECTION("interleaved float3 is gathered, missing components are zero filled")
+    {
+        // 37 vertices of float3 position + float2 uv, odd count to cover the scalar tail
+        std::vector<float> interleaved;
+        for (auto i = 0; i < 37; ++i)
+        {
+            interleaved.insert(interleaved.end(), { float(i), float(i) + 0.25f, float(i) + 0.5f, -1.0f, -2.0f });
+        }
+
+        gfx::GltfAccessorView view
+        {
+            .data = reinterpret_cast<const uint8_t*>(interleaved.data()),
+            .count = 37,
+            .stride = 5 * sizeof(float),
+            .component_type = gfx::GltfComponentType::eFloat,
+            .components = 3,
+        };
+
+        std::vector<float> positions(37 * 3);
+        gfx::ReadGltfAccessorFloats(view, 3, positions);
+        std::vector<float> widened(37 * 4);
+        gfx::ReadGltfAccessorFloats(view, 4, widened);
+
+        for (auto i = 0; i < 37; ++i)
+        {
+            REQUIRE(positions[i * 3 + 0] == float(i));
+            REQUIRE(positions[i * 3 + 1] == float(i) + 0.25f);
+            REQUIRE(positions[i * 3 + 2] == float(i) + 0.5f);
+            REQUIRE(widened[i * 4 + 2] == float(i) + 0.5f);
+            REQUIRE(widened[i * 4 + 3] == 0.0f);
+        }
+    }
+
+    SECTION("normalized integers are converted to unit range")
+    {
+        std::vector<uint16_t> uvs;
+        std::vector<int8_t> normals;
+        for (auto i = 0; i < 21; ++i)
+        {
+            uvs.insert(uvs.end(), { 0, 65535 });
+            normals.insert(normals.end(), { 127, -127, -128, 0 });
+        }
+
+        gfx::GltfAccessorView uvView
+        {
+            .data = reinterpret_cast<const uint8_t*>(uvs.data()),
+            .count = 21,
+            .stride = 4,
+            .component_type = gfx::GltfComponentType::eUnsignedShort,
+            .components = 2,
+            .normalized = true
+        };
+        std::vector<float> uvFloats(21 * 2);
+        gfx::ReadGltfAccessorFloats(uvView, 2, uvFloats);
+
+        gfx::GltfAccessorView normalView
+        {
+            .data = reinterpret_cast<const uint8_t*>(normals.data()),
+            .count = 21,
+            .stride = 4,
+            .component_type = gfx::GltfComponentType::eByte,
+            .components = 4,
+            .normalized = true
+        };
+        std::vector<float> normalFloats(21 * 4);
+        gfx::ReadGltfAccessorFloats(normalView, 4, normalFloats);
+
+        for (auto i = 0; i < 21; ++i)
+        {
+            REQUIRE(uvFloats[i * 2 + 0] == 0.0f);
+            REQUIRE(uvFloats[i * 2 + 1] == 1.0f);
+            REQUIRE(normalFloats[i * 4 + 0] == 1.0f);
+            REQUIRE(normalFloats[i * 4 + 1] == -1.0f);
+            REQUIRE(normalFloats[i * 4 + 2] == -1.0f); // -128 clamps
+            REQUIRE(normalFloats[i * 4 + 3] == 0.0f);
+        }
+    }
+
+    SECTION("sparse values replace the dense elements")
+    {
+        std::vector<float> dense(10 * 3, 1.0f);
+        std::vector<uint16_t> sparseIndices{ 2, 7 };
+        std::vector<float> sparseValues{ 5, 6, 7, 8, 9, 10 };
+
+        gfx::GltfAccessorView view
+        {
+            .data = reinterpret_cast<const uint8_t*>(dense.data()),
+            .count = 10,
+            .stride = 12,
+            .component_type = gfx::GltfComponentType::eFloat,
+            .components = 3,
+            .sparse_count = 2,
+            .sparse_indices = reinterpret_cast<const uint8_t*>(sparseIndices.data()),
+            .sparse_index_type = gfx::GltfComponentType::eUnsignedShort,
+            .sparse_values = reinterpret_cast<const uint8_t*>(sparseValues.data())
+        };
+        REQUIRE_FALSE(view.IsPacked());
+
+        std::vector<float> values(10 * 3);
+        gfx::ReadGltfAccessorFloats(view, 3, values);
+        REQUIRE(values[2 * 3 + 0] == 5.0f);
+        REQUIRE(values[2 * 3 + 2] == 7.0f);
+        REQUIRE(values[7 * 3 + 1] == 9.0f);
+        REQUIRE(values[3 * 3 + 0] == 1.0f);
+
+        // no buffer view, the dense elements are zeros
+        view.data = nullptr;
+        gfx::ReadGltfAccessorFloats(view, 3, values);
+        REQUIRE(values[0] == 0.0f);
+        REQUIRE(values[7 * 3 + 2] == 10.0f);
+    }
+
+    SECTION("small indices are widened to uint32")
+    {
+        std::vector<uint8_t> small;
+        std::vector<uint16_t> medium;
+        for (auto i = 0; i < 45; ++i)
+        {
+            small.emplace_back(static_cast<uint8_t>(255 - i));
+            medium.emplace_back(static_cast<uint16_t>(65535 - i));
+        }
+
+        std::vector<uint32_t> widened(45);
+        gfx::ReadGltfAccessorIndices(gfx::GltfAccessorView{ .data = small.data(), .count = 45, .stride = 1, .component_type = gfx::GltfComponentType::eUnsignedByte }, widened);
+        for (auto i = 0; i < 45; ++i)
+        {
+            REQUIRE(widened[i] == 255u - i);
+        }
+
+        gfx::ReadGltfAccessorIndices(gfx::GltfAccessorView{ .data = reinterpret_cast<const uint8_t*>(medium.data()), .count = 45, .stride = 2, .component_type = gfx::GltfComponentType::eUnsignedShort }, widened);
+        for (auto i = 0; i < 45; ++i)
+        {
+            REQUIRE(widened[i] == 65535u - i);
+        }
+    }
+}
+
+TEST_CASE("gltf document", "[graphics]")
+{
+    auto directory = std::filesystem::temp_directory_path() / "eureka_gltf_tests";
+    std::filesystem::create_directories(directory);
+
+    SECTION("glb with a bin chunk")
+    {
+        auto path = directory / "triangle.glb";
+        WriteGlb(path, TriangleJson(""), TriangleBin());
+
+        gfx::GltfDocument document(path);
+        RequireTriangle(document);
+
+        auto positions = document.ResolveAccessor(1);
+        REQUIRE(positions.stride == 24);
+        REQUIRE(document.MappedBytes() >= 84);
+    }
+
+    SECTION("gltf with an external buffer")
+    {
+        auto bin = TriangleBin();
+        WriteFile(directory / "triangle data.bin", bin);
+        auto json = TriangleJson("triangle%20data.bin");
+        WriteFile(directory / "triangle.gltf", { reinterpret_cast<const uint8_t*>(json.data()), json.size() });
+
+        gfx::GltfDocument document(directory / "triangle.gltf");
+        RequireTriangle(document);
+    }
+
+    SECTION("missing and malformed files throw")
+    {
+        REQUIRE_THROWS_AS(gfx::GltfDocument(directory / "missing.glb"), eureka::file_not_found_error);
+
+        std::string truncated = "{ \"buffers\": [ ";
+        WriteFile(directory / "truncated.gltf", { reinterpret_cast<const uint8_t*>(truncated.data()), truncated.size() });
+        REQUIRE_THROWS_AS(gfx::GltfDocument(directory / "truncated.gltf"), eureka::file_load_error);
+    }
+
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("model cache", "[graphics]")
+{
+    auto directory = std::filesystem::temp_directory_path() / "eureka_model_cache_tests";
+    std::filesystem::create_directories(directory);
+
+    SECTION("mip chain")
+    {
+        REQUIRE(gfx::MipLevelCount(1, 1) == 1);
+        REQUIRE(gfx::MipLevelCount(256, 64) == 9);
+        REQUIRE(gfx::MipLevelCount(5, 3) == 3);
+
+        // 3x2, the odd column has no pair and is dropped
+        std::vector<uint8_t> src
+        {
+            0, 0, 0, 255,   4, 4, 4, 255,   100, 0, 0, 0,
+            8, 8, 8, 255,  12, 12, 12, 255, 200, 0, 0, 0,
+        };
+        std::vector<uint8_t> dst(4);
+        gfx::DownsampleRGBA8(src, 3, 2, dst);
+        REQUIRE(dst == std::vector<uint8_t>{ 6, 6, 6, 255 });
+
+        // wide enough for the vectorized columns, the single row and the single column clamp their pair to the edge
+        for (auto [width, height] : { std::pair(37u, 11u), std::pair(37u, 1u), std::pair(1u, 11u) })
+        {
+            std::vector<uint8_t> image(width * height * 4);
+            for (auto i = 0u; i < image.size(); ++i)
+            {
+                image[i] = static_cast<uint8_t>(i * 97 + (i >> 3) * 31);
+            }
+
+            auto nextWidth = std::max(width / 2, 1u);
+            auto nextHeight = std::max(height / 2, 1u);
+            std::vector<uint8_t> next(nextWidth * nextHeight * 4);
+            gfx::DownsampleRGBA8(image, width, height, next);
+            for (auto y = 0u; y < nextHeight; ++y)
+            {
+                for (auto x = 0u; x < nextWidth; ++x)
+                {
+                    for (auto c = 0u; c < 4; ++c)
+                    {
+                        auto texel = [&](uint32_t sx, uint32_t sy) { return image[(std::min(sy, height - 1) * width + std::min(sx, width - 1)) * 4 + c]; };
+                        auto sum = texel(x * 2, y * 2) + texel(x * 2 + 1, y * 2) + texel(x * 2, y * 2 + 1) + texel(x * 2 + 1, y * 2 + 1);
+                        REQUIRE(next[(y * nextWidth + x) * 4 + c] == (sum + 2) / 4);
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("content hash")
+    {
+        auto bin = TriangleBin();
+        REQUIRE(gfx::HashBytes(bin) == gfx::HashBytes(bin));
+        REQUIRE(gfx::HashBytes(bin, 1) != gfx::HashBytes(bin));
+
+        auto changed = bin;
+        changed.back() ^= 1;
+        REQUIRE(gfx::HashBytes(changed) != gfx::HashBytes(bin));
+        REQUIRE(gfx::HashBytes(eureka::dcspan<uint8_t>(bin).first(7)) != gfx::HashBytes(eureka::dcspan<uint8_t>(bin).first(8)));
+    }
+
+    SECTION("cooked geometry has the final layout")
+    {
+        auto source = directory / "triangle.glb";
+        WriteGlb(source, TriangleJson(""), TriangleBin());
+
+        auto cachePath = gfx::ModelCachePath(directory / "cache", source);
+        REQUIRE(cachePath.extension() == gfx::MODEL_CACHE_EXTENSION);
+        REQUIRE(cachePath == gfx::ModelCachePath(directory / "cache", source));
+
+        concurrencpp::runtime runtime;
+        uint64_t sourceHash = 0;
+        {
+            gfx::GltfDocument document(source);
+            sourceHash = gfx::GltfSourceHash(document);
+            gfx::CookModelCacheAsync(document, sourceHash, cachePath, runtime.thread_pool_executor()).get();
+        }
+
+        {
+            gfx::ModelCacheFile cache(cachePath);
+            REQUIRE(cache.SourceHash() == sourceHash);
+            REQUIRE(cache.SourcesUnchanged());
+            REQUIRE(cache.Images().empty());
+
+            auto primitives = cache.Primitives();
+            REQUIRE(primitives.size() == 1);
+            REQUIRE(primitives[0].index_count == 6);
+            REQUIRE(primitives[0].vertex_count == 3);
+            REQUIRE(cache.Geometry().size() == gfx::PrimitiveGeometryBytes(primitives[0]));
+
+            std::vector<uint32_t> indices(6);
+            std::memcpy(indices.data(), cache.Geometry().data() + primitives[0].index_offset, indices.size() * sizeof(uint32_t));
+            REQUIRE(indices == std::vector<uint32_t>{ 0, 1, 2, 2, 1, 0 });
+
+            std::vector<float> normals(9);
+            std::memcpy(normals.data(), cache.Geometry().data() + primitives[0].normal_offset, normals.size() * sizeof(float));
+            REQUIRE(normals == std::vector<float>{ 0, 0, 1, 0, 0, 1, 0, 0, 1 });
+        }
+
+        // the temporary file is gone once the cache is in place
+        for (const auto& entry : std::filesystem::directory_iterator(directory / "cache"))
+        {
+            REQUIRE(entry.path() == cachePath);
+        }
+
+        // another write time, same content, the stamps are rewritten
+        std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::hours(1));
+        {
+            gfx::ModelCacheFile cache(cachePath);
+            REQUIRE_FALSE(cache.SourcesUnchanged());
+            REQUIRE(gfx::GltfSourceHash(gfx::GltfDocument(source)) == cache.SourceHash());
+        }
+        gfx::ModelCacheFile::RestampSources(cachePath);
+        REQUIRE(gfx::ModelCacheFile(cachePath).SourcesUnchanged());
+
+        // same size, another write time and content
+        auto bin = TriangleBin();
+        bin[0] = 1;
+        WriteGlb(source, TriangleJson(""), bin);
+        std::filesystem::last_write_time(source, std::filesystem::last_write_time(source) + std::chrono::hours(2));
+
+        gfx::ModelCacheFile cache(cachePath);
+        REQUIRE_FALSE(cache.SourcesUnchanged());
+        REQUIRE(gfx::GltfSourceHash(gfx::GltfDocument(source)) != cache.SourceHash());
+    }
+
+    SECTION("ktx2 images are kept as their container, their plain fallbacks are skipped")
+    {
+        // KTX2 header up to the base extent, 8x4, the rest of the container is never parsed by the cook
+        std::vector<uint8_t> ktx2{ 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+        AppendU32(ktx2, 0);
+        AppendU32(ktx2, 1);
+        AppendU32(ktx2, 8);
+        AppendU32(ktx2, 4);
+        ktx2.resize(80, 0);
+        REQUIRE(gfx::IsKtx2(ktx2));
+        REQUIRE(gfx::Ktx2Extent(ktx2).width == 8);
+        REQUIRE(gfx::Ktx2Extent(ktx2).height == 4);
+        REQUIRE_FALSE(gfx::IsKtx2(TriangleBin()));
+
+        auto bin = TriangleBin();
+        bin.insert(bin.end(), ktx2.begin(), ktx2.end());
+        std::string json = R"({
+            "asset": { "version": "2.0" },
+            "extensionsUsed": [ "KHR_texture_basisu" ],
+            "buffers": [ { "byteLength": 164 } ],
+            "bufferViews": [ { "buffer": 0, "byteOffset": 84, "byteLength": 80 }, { "buffer": 0, "byteOffset": 0, "byteLength": 12 } ],
+            "images": [ { "bufferView": 0, "mimeType": "image/ktx2" }, { "bufferView": 1, "mimeType": "image/png" } ],
+            "textures": [ { "source": 1, "extensions": { "KHR_texture_basisu": { "source": 0 } } } ],
+            "materials": [ { "pbrMetallicRoughness": { "baseColorTexture": { "index": 0 } } } ]
+        })";
+        auto source = directory / "basisu.glb";
+        WriteGlb(source, json, bin);
+
+        gfx::GltfDocument document(source);
+        REQUIRE(document.Materials().at(0).base_color_image == 0);
+        REQUIRE_FALSE(document.Images().at(0).basisu_fallback);
+        REQUIRE(document.Images().at(1).basisu_fallback);
+
+        auto cachePath = gfx::ModelCachePath(directory / "cache", source);
+        concurrencpp::runtime runtime;
+        gfx::CookModelCacheAsync(document, gfx::GltfSourceHash(document), cachePath, runtime.thread_pool_executor()).get();
+
+        gfx::ModelCacheFile cache(cachePath);
+        // the fallback is index bytes, not a png, decoding it would throw
+        REQUIRE(cache.Images().size() == 2);
+        REQUIRE(cache.Images()[0].encoding == gfx::ModelCacheImageEncoding::eKtx2);
+        REQUIRE(cache.Images()[0].width == 8);
+        REQUIRE(cache.Images()[1].encoding == gfx::ModelCacheImageEncoding::eSkipped);
+        REQUIRE(cache.Images()[1].mip_count == 0);
+
+        auto container = cache.Texels(cache.Mips(cache.Images()[0]).front());
+        REQUIRE(std::vector<uint8_t>(container.begin(), container.end()) == ktx2);
+    }
+
+    SECTION("malformed caches throw")
+    {
+        std::vector<uint8_t> garbage(256, 0xAB);
+        WriteFile(directory / "garbage.emc", garbage);
+        REQUIRE_THROWS_AS(gfx::ModelCacheFile(directory / "garbage.emc"), eureka::file_load_error);
+        REQUIRE_THROWS_AS(gfx::ModelCacheFile(directory / "missing.emc"), eureka::file_not_found_error);
+    }
+
+    std::filesystem::remove_all(directory);
+}
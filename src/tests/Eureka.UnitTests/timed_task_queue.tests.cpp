@@ -0,0 +1,206 @@
+#include <catch.hpp>
+#include <timed_task_queue.hpp>
+#include <array>
+#include <thread>
+#include <utility>
+
+namespace
+{
+    template<typename Queue>
+    std::vector<int> DrainReady(Queue& queue, uint64_t now)
+    {
+        std::vector<int> order;
+        while (auto task = queue.pop_ready(now))
+        {
+            order.emplace_back(*task);
+        }
+        return order;
+    }
+
+    //
+    // a task whose move into the inbox slot stalls, holding the producer between claiming the slot and publishing it
+    //
+    struct StallingTask
+    {
+        int  value{ 0 };
+        bool stall{ false };
+
+        StallingTask() = default;
+        StallingTask(int v, bool s) : value(v), stall(s) {}
+        StallingTask(StallingTask&& that) noexcept = default;
+
+        StallingTask& operator=(StallingTask&& that) noexcept
+        {
+            if (std::exchange(that.stall, false))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            value = that.value;
+            stall = false;
+            return *this;
+        }
+    };
+}
+
+TEST_CASE("timed_task_queue", "[containers]")
+{
+    SECTION("tasks run by deadline")
+    {
+        eureka::timed_task_queue<int> queue;
+        queue.post(3, 30);
+        queue.post(1, 10);
+        queue.post(2, 20);
+
+        REQUIRE(queue.next_deadline() == 10u);
+        REQUIRE(DrainReady(queue, 25) == std::vector{ 1, 2 });
+        REQUIRE(queue.scheduled() == 1);
+        REQUIRE(DrainReady(queue, 30) == std::vector{ 3 });
+        REQUIRE(!queue.next_deadline());
+    }
+
+    SECTION("equal deadlines are neither lost nor reordered")
+    {
+        eureka::timed_task_queue<int> queue;
+        for (auto i = 0; i < 8; ++i)
+        {
+            queue.post(i, 100);
+        }
+        queue.post(-1, 50);
+
+        REQUIRE(DrainReady(queue, 99) == std::vector{ -1 });
+        REQUIRE(DrainReady(queue, 100) == std::vector{ 0, 1, 2, 3, 4, 5, 6, 7 });
+    }
+
+    SECTION("overflowing the inbox keeps posting order")
+    {
+        eureka::timed_task_queue<int, 4> queue;
+        std::vector<int> expected;
+        for (auto i = 0; i < 32; ++i)
+        {
+            queue.post(i, 7);
+            expected.emplace_back(i);
+        }
+
+        REQUIRE(DrainReady(queue, 7) == expected);
+        REQUIRE(queue.overflow_posts() == 28);
+    }
+
+    SECTION("tasks posted while running are picked up")
+    {
+        eureka::timed_task_queue<int> queue;
+        queue.post(0, 0);
+
+        std::vector<int> order;
+        while (auto task = queue.pop_ready(0))
+        {
+            order.emplace_back(*task);
+            if (*task < 3)
+            {
+                queue.post(*task + 1, 0);
+            }
+        }
+        REQUIRE(order == std::vector{ 0, 1, 2, 3 });
+    }
+
+    SECTION("every producer's posts arrive in its own order")
+    {
+        constexpr int PRODUCERS = 4;
+        constexpr int POSTS = 10000;
+
+        eureka::timed_task_queue<int, 64> queue;
+        std::vector<std::thread> producers;
+        for (auto p = 0; p < PRODUCERS; ++p)
+        {
+            producers.emplace_back(
+                [&queue, p]
+                {
+                    for (auto i = 0; i < POSTS; ++i)
+                    {
+                        queue.post(p * POSTS + i, 1);
+                    }
+                });
+        }
+
+        std::vector<int> order;
+        while (order.size() < PRODUCERS * POSTS)
+        {
+            while (auto task = queue.pop_ready(1))
+            {
+                order.emplace_back(*task);
+            }
+            queue.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1));
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+
+        std::array<int, PRODUCERS> last;
+        last.fill(-1);
+        for (auto value : order)
+        {
+            auto& producerLast = last[value / POSTS];
+            REQUIRE(value > producerLast);
+            producerLast = value;
+        }
+    }
+
+    SECTION("a post wakes the sleeping consumer")
+    {
+        eureka::timed_task_queue<int> queue;
+        REQUIRE(!queue.wait_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1)));
+
+        std::thread producer(
+            [&queue]
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                queue.post(1, 0);
+            });
+
+        REQUIRE(queue.wait_until(std::chrono::steady_clock::now() + std::chrono::seconds(10)));
+        producer.join();
+        REQUIRE(DrainReady(queue, 0) == std::vector{ 1 });
+    }
+
+    SECTION("a post published behind a later one still wakes the consumer")
+    {
+        // producer A claims a slot and stalls, producer B publishes the next slot and wakes the consumer, which finds
+        // A's slot unpublished and goes back to sleep - A's publish has to wake it again
+        for (auto round = 0; round < 3; ++round)
+        {
+            eureka::timed_task_queue<StallingTask> queue;
+            std::chrono::steady_clock::duration elapsed{};
+
+            std::thread consumer(
+                [&]
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    auto received = 0;
+                    while (true)
+                    {
+                        while (queue.pop_ready(0))
+                        {
+                            ++received;
+                        }
+                        if (received == 2)
+                        {
+                            break;
+                        }
+                        queue.wait_until(std::chrono::steady_clock::now() + std::chrono::seconds(10));
+                    }
+                    elapsed = std::chrono::steady_clock::now() - start;
+                });
+
+            // the consumer is asleep by now
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::thread stalled([&queue] { queue.post(StallingTask(1, true), 0); });
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            std::thread publishing([&queue] { queue.post(StallingTask(2, false), 0); });
+
+            stalled.join();
+            publishing.join();
+            consumer.join();
+            REQUIRE(elapsed < std::chrono::seconds(2));
+        }
+    }
+}
@@ -3,6 +3,8 @@
 #include "../Eureka.Vulkan/Instance.hpp"
 #include "../Eureka.Vulkan/Device.hpp"
 #include "../Eureka.Vulkan/BufferMemoryPool.hpp"
+#include "../Eureka.Vulkan/StagingRing.hpp"
+#include "../Eureka.Vulkan/MemoryBudget.hpp"
 
 namespace vk = eureka::vulkan;
 
@@ -17,7 +19,7 @@ TEST_CASE("pool allocation buffer ", "[vulkan]")
     auto memoryAllocator = std::make_shared<vk::ResourceAllocator>(instance, device);
     auto poolAllocator = std::make_shared<vk::BufferMemoryPool>(
         memoryAllocator, 
-        POOL_SIZE, 
+        vk::PoolBlocksConfig{ .block_byte_size = POOL_SIZE, .max_block_count = 1 },
         VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,
         VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
         VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
@@ -48,9 +50,130 @@ TEST_CASE("pool allocation buffer ", "[vulkan]")
         REQUIRE_THROWS(alloc1 = poolAllocator->AllocateBuffer(POOL_SIZE * 2));
     }
 
+    SECTION("full pool try alloc")
+    {
+        auto alloc1 = poolAllocator->TryAllocateBuffer(POOL_SIZE);
+        REQUIRE(alloc1);
+        REQUIRE_FALSE(poolAllocator->TryAllocateBuffer(CHUNK_SIZE));
+        poolAllocator->DeallocateBuffer(*alloc1);
+    }
+
+}
+
+TEST_CASE("growable pool allocation buffer", "[vulkan]")
+{
+    constexpr uint64_t BLOCK_SIZE = 64 * 1024;
+    constexpr std::size_t MAX_BLOCKS = 3;
+
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    auto memoryAllocator = std::make_shared<vk::ResourceAllocator>(instance, device);
+    auto pool = std::make_shared<vk::BufferMemoryPool>(
+        memoryAllocator,
+        vk::PoolBlocksConfig{ .block_byte_size = BLOCK_SIZE, .max_block_count = MAX_BLOCKS },
+        VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,
+        VkBufferUsageFlagBits::VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT
+    );
+
+    std::vector<vk::BufferAllocation> allocations;
+    for (auto i = 0u; i < MAX_BLOCKS; ++i)
+    {
+        auto allocation = pool->TryAllocateBuffer(BLOCK_SIZE);
+        REQUIRE(allocation);
+        allocations.emplace_back(*allocation);
+    }
+
+    auto statistics = pool->Statistics();
+    REQUIRE(statistics.block_count == MAX_BLOCKS);
+    REQUIRE(statistics.allocation_count == MAX_BLOCKS);
+    REQUIRE(statistics.allocation_bytes == BLOCK_SIZE * MAX_BLOCKS);
+
+    // out of blocks
+    REQUIRE_FALSE(pool->TryAllocateBuffer(BLOCK_SIZE));
+
+    for (const auto& allocation : allocations)
+    {
+        pool->DeallocateBuffer(allocation);
+    }
+    REQUIRE(pool->Statistics().allocation_count == 0);
+}
+
+TEST_CASE("memory budget tracker", "[vulkan]")
+{
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    auto memoryAllocator = std::make_shared<vk::ResourceAllocator>(instance, device);
+    vk::MemoryBudgetTracker budget(memoryAllocator, vk::MemoryBudgetConfig{ .soft_limit = 0.5f });
+
+    budget.BeginFrame();
+
+    auto counters = budget.Counters();
+    REQUIRE_FALSE(counters.heaps.empty());
+    REQUIRE(counters.frames == 1);
+
+    auto heapIndex = memoryAllocator->HeapIndexForPreset(vk::BufferAllocationPreset::eHostWriteCombinedBufferAsTransferSrc);
+    REQUIRE(budget.FitsBudget(heapIndex, 1));
+    REQUIRE_FALSE(budget.FitsBudget(heapIndex, counters.heaps[heapIndex].budget));
+    REQUIRE(budget.Counters().refused == 1);
+
+    auto json = budget.DumpJson();
+    REQUIRE(json.front() == '{');
+    REQUIRE(json.find("\"heaps\"") != std::string::npos);
 }
 
 
+TEST_CASE("staging ring", "[vulkan]")
+{
+    constexpr uint64_t RING_SIZE = 4096;
+
+    auto instance = vk::MakeDefaultInstance();
+    auto device = vk::MakeDefaultDevice(instance);
+    auto memoryAllocator = std::make_shared<vk::ResourceAllocator>(instance, device);
+    auto ring = std::make_shared<vk::StagingRing>(memoryAllocator, vk::StagingRingConfig{ .byte_size = RING_SIZE });
+
+    SECTION("aligned bump allocations")
+    {
+        auto region1 = ring->TryAllocate(100);
+        auto region2 = ring->TryAllocate(100);
+        REQUIRE(region1);
+        REQUIRE(region2);
+        REQUIRE(region1->Offset() == 0);
+        REQUIRE(region2->Offset() == 112);
+        REQUIRE(region1->Buffer() == region2->Buffer());
+    }
+
+    SECTION("full ring reclaims in order")
+    {
+        auto region1 = ring->TryAllocate(ring->MaxAllocationSize());
+        auto region2 = ring->TryAllocate(ring->MaxAllocationSize());
+        REQUIRE(region1);
+        REQUIRE(region2);
+        REQUIRE_FALSE(ring->TryAllocate(ring->MaxAllocationSize()));
+
+        // released out of order, nothing is reclaimed before the oldest region returns
+        region2.reset();
+        REQUIRE_FALSE(ring->TryAllocate(ring->MaxAllocationSize()));
+
+        auto pending = ring->AllocateAsync(ring->MaxAllocationSize());
+        REQUIRE(pending.status() == concurrencpp::result_status::idle);
+
+        region1.reset();
+        REQUIRE(pending.status() == concurrencpp::result_status::value);
+
+        // wrapped around to the start of the buffer
+        auto region3 = pending.get();
+        REQUIRE(region3.Offset() == 0);
+    }
+
+    SECTION("oversized allocation")
+    {
+        REQUIRE_THROWS_AS(ring->TryAllocate(RING_SIZE), std::length_error);
+    }
+
+    REQUIRE(ring->BytesInFlight() == 0);
+}
+
 TEST_CASE("pool allocation image ", "[vulkan]")
 {
 
@@ -10,9 +10,20 @@
 #include <catch.hpp>
 #include <debugger_trace.hpp>
 #include <sigslot/signal.hpp>
+#include <filesystem>
+#include <fstream>
 
 namespace vk = eureka::vulkan;
 
+namespace
+{
+    void WriteShaderCode(const std::filesystem::path& path, const vk::ShaderId& shader)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(shader.ptr), static_cast<std::streamsize>(shader.size));
+    }
+}
+
 TEST_CASE("imgui pipeline creation", "[vulkan]")
 {
     eureka::GLFWRuntime glfw;
@@ -43,4 +54,102 @@ TEST_CASE("imgui pipeline creation", "[vulkan]")
     vk::Pipeline imguiPipeline {};
 
     REQUIRE_NOTHROW(imguiPipeline = vk::Pipeline(device, imguiPipelineLayout, renderPass, imguiPipelinePreset.GetCreateInfo()));
-}
\ No newline at end of file
+}
+
+TEST_CASE("shader cache shares modules", "[vulkan]")
+{
+    eureka::GLFWRuntime glfw;
+    auto                instance = vk::MakeDefaultInstance();
+    auto                window = std::make_shared<eureka::Window>(glfw, instance->Get(), eureka::WindowConfig {});
+    auto                device = vk::MakeDefaultDevice(instance, window->GetSurface());
+
+    auto directory = std::filesystem::temp_directory_path() / "eureka_shader_cache_tests";
+    std::filesystem::create_directories(directory);
+
+    SECTION("a shader id maps to one module")
+    {
+        vk::ShaderCache shaderCache(device);
+
+        auto first = shaderCache.LoadShaderModule(ImGuiVS);
+        auto second = shaderCache.LoadShaderModule(ImGuiVS);
+        auto other = shaderCache.LoadShaderModule(ImGuiFS);
+
+        REQUIRE(first == second);
+        REQUIRE(first != other);
+
+        auto counters = shaderCache.Counters();
+        REQUIRE(counters.requests == 3);
+        REQUIRE(counters.modules_created == 2);
+    }
+
+    SECTION("the same code through another id or file is deduplicated")
+    {
+        vk::ShaderCache shaderCache(device);
+
+        auto copyPath = directory / "copy.spv";
+        WriteShaderCode(copyPath, ImGuiVS);
+
+        auto byId = shaderCache.LoadShaderModule(ImGuiVS);
+        auto byFile = shaderCache.LoadShaderModule(copyPath);
+        REQUIRE(byFile == byId);
+
+        // the file isn't read again while its write time stays
+        REQUIRE(shaderCache.LoadShaderModule(copyPath) == byId);
+
+        auto counters = shaderCache.Counters();
+        REQUIRE(counters.requests == 3);
+        REQUIRE(counters.modules_created == 1);
+        REQUIRE(counters.deduplicated == 1);
+    }
+
+    SECTION("a changed override is reported and reloaded")
+    {
+        vk::ShaderCache shaderCache(device, vk::ShaderCacheConfig { .watch_directory = directory, .watch_poll_interval = std::chrono::milliseconds(0) });
+
+        auto embedded = shaderCache.LoadShaderModule(ImGuiVS);
+        REQUIRE(shaderCache.PollChangedShaders().empty());
+
+        // other code under the shader's name, the module is never bound to a pipeline
+        auto overridePath = directory / (std::string(ImGuiVS.name) + ".spv");
+        WriteShaderCode(overridePath, ImGuiFS);
+        REQUIRE(shaderCache.PollChangedShaders() == std::vector<std::string_view> { ImGuiVS.name });
+
+        auto reloaded = shaderCache.LoadShaderModule(ImGuiVS);
+        REQUIRE(reloaded != embedded);
+        REQUIRE(reloaded == shaderCache.LoadShaderModule(ImGuiFS));
+
+        // touched, not changed
+        std::filesystem::last_write_time(overridePath, std::filesystem::last_write_time(overridePath) + std::chrono::hours(1));
+        REQUIRE(shaderCache.PollChangedShaders().empty());
+        REQUIRE(shaderCache.LoadShaderModule(ImGuiVS) == reloaded);
+
+        // removed, back to the embedded code
+        std::filesystem::remove(overridePath);
+        REQUIRE(shaderCache.PollChangedShaders() == std::vector<std::string_view> { ImGuiVS.name });
+        REQUIRE(shaderCache.LoadShaderModule(ImGuiVS) == embedded);
+    }
+
+    SECTION("a superseded module is released once nothing references it")
+    {
+        vk::ShaderCache shaderCache(device, vk::ShaderCacheConfig { .watch_directory = directory, .watch_poll_interval = std::chrono::milliseconds(0) });
+
+        // the pipelines built from it are gone
+        shaderCache.LoadShaderModule(ImGuiVS);
+
+        auto overridePath = directory / (std::string(ImGuiVS.name) + ".spv");
+        WriteShaderCode(overridePath, ImGuiFS);
+        REQUIRE(shaderCache.PollChangedShaders() == std::vector<std::string_view> { ImGuiVS.name });
+        REQUIRE(shaderCache.Counters().modules_released == 1);
+
+        // still referenced, kept
+        auto reloaded = shaderCache.LoadShaderModule(ImGuiVS);
+        std::filesystem::remove(overridePath);
+        REQUIRE(shaderCache.PollChangedShaders() == std::vector<std::string_view> { ImGuiVS.name });
+        REQUIRE(shaderCache.Counters().modules_released == 1);
+
+        REQUIRE(shaderCache.LoadShaderModule(ImGuiVS) != reloaded);
+        REQUIRE(shaderCache.Counters().modules_created == 3);
+    }
+
+    std::filesystem::remove_all(directory);
+}
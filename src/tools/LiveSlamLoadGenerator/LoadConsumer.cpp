@@ -0,0 +1,135 @@
+#include "LoadConsumer.hpp"
+#include <RemoteLiveSlamClient.hpp>
+#include <thread_name.hpp>
+#include <logging.hpp>
+#include <algorithm>
+
+namespace eureka::loadgen
+{
+    namespace
+    {
+        constexpr std::size_t LATENCY_SAMPLES_RESERVE = 1 << 16;
+
+        double PercentileUs(const std::vector<uint64_t>& sorted, double percentile)
+        {
+            auto index = static_cast<std::size_t>(percentile * static_cast<double>(sorted.size() - 1) + 0.5);
+            return static_cast<double>(sorted[index]) / 1000.0;
+        }
+    }
+
+    LatencyPercentiles ComputePercentiles(std::vector<uint64_t>& latenciesNs)
+    {
+        LatencyPercentiles result;
+        result.samples = latenciesNs.size();
+        if (latenciesNs.empty())
+        {
+            return result;
+        }
+
+        std::ranges::sort(latenciesNs);
+        result.p50_us = PercentileUs(latenciesNs, 0.50);
+        result.p90_us = PercentileUs(latenciesNs, 0.90);
+        result.p99_us = PercentileUs(latenciesNs, 0.99);
+        result.p999_us = PercentileUs(latenciesNs, 0.999);
+        result.max_us = static_cast<double>(latenciesNs.back()) / 1000.0;
+        return result;
+    }
+
+    LoadConsumer::LoadConsumer(std::size_t index, std::string serverIp)
+        :
+        _serverIp(std::move(serverIp))
+    {
+        _poseGraphLatenciesNs.reserve(LATENCY_SAMPLES_RESERVE);
+        _realtimePoseLatenciesNs.reserve(LATENCY_SAMPLES_RESERVE);
+        _thread = std::thread([this, index] { Run(index); });
+    }
+
+    LoadConsumer::~LoadConsumer()
+    {
+        Stop();
+    }
+
+    void LoadConsumer::Stop()
+    {
+        _active = false;
+        if (_thread.joinable())
+        {
+            _thread.join();
+        }
+    }
+
+    void LoadConsumer::Run(std::size_t index)
+    {
+        auto threadName = "LoadConsumer" + std::to_string(index);
+        os::set_current_thread_name(threadName.c_str());
+
+        try
+        {
+            rpc::RemoteLiveSlamClient client;
+
+            auto poseGraphConnection = client.ConnectPoseGraphSlot(
+                [this](std::shared_ptr<rgoproto::PoseGraphStreamingMsg> msg)
+                {
+                    auto now = LoadClockNowNs();
+                    _poseGraphLatenciesNs.emplace_back(now - msg->timestamp_ns());
+                    _poseGraphs.bytes.fetch_add(msg->ByteSizeLong(), std::memory_order_relaxed);
+                    _poseGraphs.messages.fetch_add(1, std::memory_order_relaxed);
+                });
+
+            auto realtimePoseConnection = client.ConnectRealtimePoseSlot(
+                [this](std::shared_ptr<rgoproto::RealtimePoseStreamingMsg> msg)
+                {
+                    auto now = LoadClockNowNs();
+                    _realtimePoseLatenciesNs.emplace_back(now - msg->timestamp_ns());
+                    _realtimePoses.bytes.fetch_add(msg->ByteSizeLong(), std::memory_order_relaxed);
+                    _realtimePoses.messages.fetch_add(1, std::memory_order_relaxed);
+                });
+
+            client.ConnectAsync(_serverIp);
+
+            bool streaming = false;
+            while (_active)
+            {
+                client.PollCompletions(1ms);
+
+                auto connected = client.GetConnectionState() == rpc::ConnectionState::Connected;
+                if (connected && !streaming)
+                {
+                    client.StartStreams();
+                    streaming = true;
+                }
+                else if (!connected && streaming)
+                {
+                    // the stream readers keep retrying by themselves
+                    streaming = false;
+                }
+                else if (client.GetConnectionState() == rpc::ConnectionState::Disconnected)
+                {
+                    client.ConnectAsync(_serverIp);
+                }
+                _connected = connected;
+            }
+
+            poseGraphConnection.disconnect();
+            realtimePoseConnection.disconnect();
+        }
+        catch (const std::exception& err)
+        {
+            EUREKA_LOG_ERROR("{} failed: {}", threadName, err.what());
+        }
+    }
+
+    ConsumerReport LoadConsumer::TakeReport()
+    {
+        assert(!_thread.joinable()); // did you call Stop?
+
+        ConsumerReport report;
+        report.pose_graphs = _poseGraphs.messages;
+        report.pose_graph_bytes = _poseGraphs.bytes;
+        report.realtime_poses = _realtimePoses.messages;
+        report.pose_graph_latency = ComputePercentiles(_poseGraphLatenciesNs);
+        report.realtime_pose_latency = ComputePercentiles(_realtimePoseLatenciesNs);
+        report.connected = _connected;
+        return report;
+    }
+}
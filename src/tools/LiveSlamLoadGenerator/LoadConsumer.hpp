@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace eureka::loadgen
+{
+    struct LatencyPercentiles
+    {
+        std::size_t samples{ 0 };
+        double      p50_us{ 0.0 };
+        double      p90_us{ 0.0 };
+        double      p99_us{ 0.0 };
+        double      p999_us{ 0.0 };
+        double      max_us{ 0.0 };
+    };
+
+    // sorts the samples in place
+    LatencyPercentiles ComputePercentiles(std::vector<uint64_t>& latenciesNs);
+
+    struct StreamCounters
+    {
+        std::atomic_uint64_t messages{ 0 };
+        std::atomic_uint64_t bytes{ 0 };
+    };
+
+    struct ConsumerReport
+    {
+        uint64_t              pose_graphs{ 0 };
+        uint64_t              pose_graph_bytes{ 0 };
+        uint64_t              realtime_poses{ 0 };
+        LatencyPercentiles    pose_graph_latency;
+        LatencyPercentiles    realtime_pose_latency;
+        bool                  connected{ false };
+    };
+
+    //
+    // a headless RemoteLiveSlamClient running on its own thread
+    // latency is measured against the message timestamp, which the load generator stamps with the
+    // steady clock, so consumers have to run in the publishing process
+    //
+    class LoadConsumer
+    {
+        std::string                 _serverIp;
+        std::atomic_bool            _active{ true };
+        std::atomic_bool            _connected{ false };
+        StreamCounters              _poseGraphs;
+        StreamCounters              _realtimePoses;
+        std::vector<uint64_t>       _poseGraphLatenciesNs;
+        std::vector<uint64_t>       _realtimePoseLatenciesNs;
+        std::thread                 _thread;
+
+        void Run(std::size_t index);
+    public:
+        LoadConsumer(std::size_t index, std::string serverIp);
+        ~LoadConsumer();
+
+        LoadConsumer(const LoadConsumer&) = delete;
+        LoadConsumer& operator=(const LoadConsumer&) = delete;
+
+        const StreamCounters& PoseGraphs() const { return _poseGraphs; }
+        const StreamCounters& RealtimePoses() const { return _realtimePoses; }
+        bool Connected() const { return _connected; }
+
+        // stops the client and joins its thread, must be called before the report is taken
+        void Stop();
+        ConsumerReport TakeReport();
+    };
+
+    inline uint64_t LoadClockNowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
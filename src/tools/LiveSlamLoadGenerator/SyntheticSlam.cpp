@@ -0,0 +1,145 @@
+#include "SyntheticSlam.hpp"
+#include <cmath>
+
+namespace eureka::loadgen
+{
+    namespace
+    {
+        constexpr float STEP_CM = 5.0f;
+        constexpr float MAX_TURN_RAD = 0.05f;
+        constexpr float REWRITE_JITTER_CM = 2.0f;
+        constexpr uint32_t EDGE_TYPES = 3;
+        constexpr uint32_t OUTLIER_EVERY = 10;
+    }
+
+    SyntheticSlam::SyntheticSlam(SyntheticSlamConfig config)
+        :
+        _config(config),
+        _rng(config.seed)
+    {
+        if (_config.poses_per_keyframe == 0)
+        {
+            throw std::invalid_argument("poses per keyframe must be positive");
+        }
+        if (_config.max_keyframes)
+        {
+            _keyframes.reserve(_config.max_keyframes);
+            _edges.reserve(std::size_t(_config.max_keyframes) * _config.edges_per_keyframe);
+        }
+    }
+
+    bool SyntheticSlam::Advance()
+    {
+        std::uniform_real_distribution<float> turn(-MAX_TURN_RAD, MAX_TURN_RAD);
+        std::uniform_real_distribution<float> climb(-0.1f, 0.1f);
+
+        _heading += turn(_rng);
+        _current.r[0] = std::cos(_heading);
+        _current.r[1] = std::sin(_heading);
+        _current.r[2] = 0.0f;
+        _current.t[0] += STEP_CM * _current.r[0];
+        _current.t[1] += STEP_CM * _current.r[1];
+        _current.t[2] += climb(_rng);
+
+        if (++_posesCount % _config.poses_per_keyframe == 0)
+        {
+            AddKeyframe();
+            return true;
+        }
+        return false;
+    }
+
+    void SyntheticSlam::AddKeyframe()
+    {
+        if (_config.max_keyframes && _keyframes.size() >= _config.max_keyframes)
+        {
+            // bounded map, the oldest keyframe is recycled (edges keep referring to its slot)
+            _keyframes[_posesCount / _config.poses_per_keyframe % _config.max_keyframes] = _current;
+            _graphDirty = true;
+            return;
+        }
+
+        auto id = static_cast<uint32_t>(_keyframes.size());
+        _keyframes.emplace_back(_current);
+
+        if (id > 0)
+        {
+            std::uniform_int_distribution<uint32_t> anyPrevious(0, id - 1);
+            for (auto i = 0u; i < _config.edges_per_keyframe; ++i)
+            {
+                // the first edge is odometry, the others are loop closures
+                auto target = (i == 0) ? id - 1 : anyPrevious(_rng);
+                _edges.emplace_back(Edge{
+                    .ref_id = id,
+                    .tgt_id = target,
+                    .type = i % EDGE_TYPES,
+                    .is_inlier = (_edges.size() % OUTLIER_EVERY) != 0
+                });
+            }
+        }
+        _graphDirty = true;
+    }
+
+    void SyntheticSlam::Rewrite()
+    {
+        std::normal_distribution<float> jitter(0.0f, REWRITE_JITTER_CM);
+        for (auto& keyframe : _keyframes)
+        {
+            for (auto& t : keyframe.t)
+            {
+                t += jitter(_rng);
+            }
+        }
+        _graphDirty = _graphDirty || !_keyframes.empty();
+    }
+
+    void SyntheticSlam::FillRealtimePose(rgoproto::RealtimePoseStreamingMsg& msg, uint64_t timestampNs) const
+    {
+        auto& values = *msg.mutable_txtytzrxryrz();
+        values.Clear();
+        values.Add(std::begin(_current.t), std::end(_current.t));
+        values.Add(std::begin(_current.r), std::end(_current.r));
+        msg.set_timestamp_ns(timestampNs);
+    }
+
+    void SyntheticSlam::FillPoseGraph(rgoproto::PoseGraphStreamingMsg& msg, uint64_t timestampNs)
+    {
+        auto& poses = *msg.mutable_poses();
+        auto& edgesMeta = *msg.mutable_edges_meta();
+        auto& edgesData = *msg.mutable_edges_data();
+
+        poses.Clear();
+        edgesMeta.Clear();
+        edgesData.Clear();
+
+        poses.Reserve(static_cast<int>(_keyframes.size() * 7));
+        edgesMeta.Reserve(static_cast<int>(_edges.size() * 4));
+        edgesData.Reserve(static_cast<int>(_edges.size() * 12));
+
+        for (auto id = 0u; id < _keyframes.size(); ++id)
+        {
+            const auto& keyframe = _keyframes[id];
+            poses.AddAlreadyReserved(static_cast<float>(id));
+            for (auto t : keyframe.t) poses.AddAlreadyReserved(t);
+            for (auto r : keyframe.r) poses.AddAlreadyReserved(r);
+        }
+
+        for (const auto& edge : _edges)
+        {
+            edgesMeta.AddAlreadyReserved(edge.ref_id);
+            edgesMeta.AddAlreadyReserved(edge.tgt_id);
+            edgesMeta.AddAlreadyReserved(edge.type);
+            edgesMeta.AddAlreadyReserved(edge.is_inlier);
+
+            const auto& ref = _keyframes[edge.ref_id];
+            const auto& tgt = _keyframes[edge.tgt_id];
+            for (auto t : ref.t) edgesData.AddAlreadyReserved(t);
+            for (auto t : tgt.t) edgesData.AddAlreadyReserved(t); // induced
+            for (auto r : tgt.r) edgesData.AddAlreadyReserved(r); // induced
+            for (auto t : tgt.t) edgesData.AddAlreadyReserved(t); // optimized
+        }
+
+        msg.set_timestamp_ns(timestampNs);
+        _graphDirty = false;
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <compiler.hpp>
+EUREKA_MSVC_WARNING_PUSH
+EUREKA_MSVC_WARNING_DISABLE(4127 4702)
+#include <proto/rgorpc.grpc.pb.h>
+EUREKA_MSVC_WARNING_POP
+#include <random>
+#include <vector>
+
+namespace eureka::loadgen
+{
+    struct SyntheticSlamConfig
+    {
+        double   poses_per_second{ 100.0 };
+        uint32_t poses_per_keyframe{ 10 };
+        uint32_t edges_per_keyframe{ 4 };
+        double   gpo_rewrites_per_second{ 0.5 }; // full re-optimization, every keyframe moves
+        uint32_t max_keyframes{ 0 };             // 0 - unbounded growth
+        uint32_t seed{ 1234 };
+    };
+
+    //
+    // produces a random walk trajectory and the pose graph built from its keyframes
+    // the messages follow the layout documented in rgorpc.proto
+    //
+    class SyntheticSlam
+    {
+        struct Pose
+        {
+            float t[3];
+            float r[3];
+        };
+
+        struct Edge
+        {
+            uint32_t ref_id;
+            uint32_t tgt_id;
+            uint32_t type;
+            uint32_t is_inlier;
+        };
+
+        SyntheticSlamConfig   _config;
+        std::mt19937          _rng;
+        Pose                  _current{};
+        float                 _heading{ 0.0f };
+        uint64_t              _posesCount{ 0 };
+        std::vector<Pose>     _keyframes;
+        std::vector<Edge>     _edges;
+        bool                  _graphDirty{ false };
+
+        void AddKeyframe();
+    public:
+        explicit SyntheticSlam(SyntheticSlamConfig config);
+
+        const SyntheticSlamConfig& Config() const { return _config; }
+
+        // advances the trajectory by a single pose, returns true when a keyframe was added
+        bool Advance();
+
+        // moves every keyframe a little, simulating a global optimization result
+        void Rewrite();
+
+        bool GraphDirty() const { return _graphDirty; }
+        std::size_t KeyframesCount() const { return _keyframes.size(); }
+        std::size_t EdgesCount() const { return _edges.size(); }
+
+        // fills the messages in place, reusing the repeated fields capacity
+        void FillRealtimePose(rgoproto::RealtimePoseStreamingMsg& msg, uint64_t timestampNs) const;
+        void FillPoseGraph(rgoproto::PoseGraphStreamingMsg& msg, uint64_t timestampNs);
+    };
+}
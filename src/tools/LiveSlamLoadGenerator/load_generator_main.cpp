@@ -0,0 +1,358 @@
+#include <logging.hpp>
+#include <LiveSlamServer.hpp>
+#include <VisualizationService.hpp>
+#include <GrpcContext.hpp>
+#include <thread_name.hpp>
+#include "SyntheticSlam.hpp"
+#include "LoadConsumer.hpp"
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <span>
+
+/*
+LiveSlamLoadGenerator
+
+runs a LiveSlamServer + VisualizationService in process, publishes a synthetic trajectory and pose graph
+through ExchangeData and measures what M headless RemoteLiveSlamClient consumers receive.
+
+--consumers <n>               number of RemoteLiveSlamClient consumers (default 1)
+--duration <seconds>          run time (default 10)
+--poses-per-second <hz>       realtime pose rate (default 100)
+--poses-per-keyframe <n>      every n-th pose becomes a pose graph keyframe (default 10)
+--edges-per-keyframe <n>      edges added with each keyframe (default 4)
+--gpo-rewrite-hz <hz>         full graph re-optimizations per second, 0 disables (default 0.5)
+--max-keyframes <n>           bounds the graph size, 0 is unbounded (default 0)
+--initial-keyframes <n>       keyframes generated before the run starts, at most max-keyframes (default 0)
+--report-interval <seconds>   progress report period (default 1)
+--listen <ip>                 server listening address (default 127.0.0.1)
+--shared-memory-segment <name> also offer the same host shared memory transport under this name (default off)
+
+drops are messages published but never received by a consumer. the streams carry the latest value,
+so a publisher faster than the stream (or a slow consumer) shows up as drops, not as queueing.
+*/
+
+namespace
+{
+    constexpr auto SERVER_PORT = ":50051"; // RemoteLiveSlamClient always connects to 50051
+
+    struct LoadGeneratorConfig
+    {
+        eureka::loadgen::SyntheticSlamConfig slam;
+        std::size_t                          consumers{ 1 };
+        double                               duration_seconds{ 10.0 };
+        double                               report_interval_seconds{ 1.0 };
+        uint32_t                             initial_keyframes{ 0 };
+        std::string                          listen_ip{ "127.0.0.1" };
+        std::string                          shared_memory_segment;
+    };
+
+    template<typename T>
+    T ParseValue(std::string_view name, std::string_view value)
+    {
+        T result{};
+        auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), result);
+        if (ec != std::errc() || ptr != value.data() + value.size())
+        {
+            throw std::invalid_argument(std::string("invalid value for ") + std::string(name) + ": " + std::string(value));
+        }
+        return result;
+    }
+
+    LoadGeneratorConfig ParseCommandLine(std::span<char*> args)
+    {
+        LoadGeneratorConfig config;
+
+        for (std::size_t i = 0; i < args.size(); ++i)
+        {
+            std::string_view name(args[i]);
+            if (i + 1 >= args.size())
+            {
+                throw std::invalid_argument("missing value for " + std::string(name));
+            }
+            std::string_view value(args[++i]);
+
+            if (name == "--consumers") config.consumers = ParseValue<std::size_t>(name, value);
+            else if (name == "--duration") config.duration_seconds = ParseValue<double>(name, value);
+            else if (name == "--poses-per-second") config.slam.poses_per_second = ParseValue<double>(name, value);
+            else if (name == "--poses-per-keyframe") config.slam.poses_per_keyframe = ParseValue<uint32_t>(name, value);
+            else if (name == "--edges-per-keyframe") config.slam.edges_per_keyframe = ParseValue<uint32_t>(name, value);
+            else if (name == "--gpo-rewrite-hz") config.slam.gpo_rewrites_per_second = ParseValue<double>(name, value);
+            else if (name == "--max-keyframes") config.slam.max_keyframes = ParseValue<uint32_t>(name, value);
+            else if (name == "--initial-keyframes") config.initial_keyframes = ParseValue<uint32_t>(name, value);
+            else if (name == "--report-interval") config.report_interval_seconds = ParseValue<double>(name, value);
+            else if (name == "--listen") config.listen_ip = std::string(value);
+            else if (name == "--shared-memory-segment") config.shared_memory_segment = std::string(value);
+            else throw std::invalid_argument("unknown option " + std::string(name));
+        }
+
+        if (config.slam.poses_per_second <= 0.0 || config.duration_seconds <= 0.0 || config.report_interval_seconds <= 0.0)
+        {
+            throw std::invalid_argument("rates and durations must be positive");
+        }
+        if (config.slam.max_keyframes && config.initial_keyframes > config.slam.max_keyframes)
+        {
+            // the bounded graph never grows past max_keyframes, the prefill would never finish
+            throw std::invalid_argument("--initial-keyframes can't exceed --max-keyframes");
+        }
+        return config;
+    }
+
+    struct PublishCounters
+    {
+        uint64_t pose_graphs{ 0 };
+        uint64_t pose_graph_bytes{ 0 };
+        uint64_t realtime_poses{ 0 };
+        uint64_t rewrites{ 0 };
+    };
+
+    class Publisher
+    {
+        eureka::loadgen::SyntheticSlam                       _slam;
+        eureka::rpc::VisualizationService&                   _service;
+        std::shared_ptr<rgoproto::PoseGraphStreamingMsg>     _spareGraph;
+        std::shared_ptr<rgoproto::RealtimePoseStreamingMsg>  _sparePose;
+        PublishCounters                                      _counters;
+
+        template<typename Msg>
+        static std::shared_ptr<Msg> TakeSpare(std::shared_ptr<Msg>& spare)
+        {
+            // ExchangeData hands back the message written previously, refill it instead of allocating
+            auto msg = std::move(spare);
+            return msg ? msg : std::make_shared<Msg>();
+        }
+
+    public:
+        Publisher(eureka::loadgen::SyntheticSlamConfig config, eureka::rpc::VisualizationService& service)
+            : _slam(config), _service(service)
+        {
+        }
+
+        void Prefill(uint32_t keyframes)
+        {
+            while (_slam.KeyframesCount() < keyframes)
+            {
+                _slam.Advance();
+            }
+        }
+
+        const PublishCounters& Counters() const { return _counters; }
+        const eureka::loadgen::SyntheticSlam& Slam() const { return _slam; }
+
+        void PublishPose()
+        {
+            _slam.Advance();
+
+            auto pose = TakeSpare(_sparePose);
+            _slam.FillRealtimePose(*pose, eureka::loadgen::LoadClockNowNs());
+            _sparePose = _service.ExchangeData(std::move(pose));
+            ++_counters.realtime_poses;
+
+            if (_slam.GraphDirty())
+            {
+                PublishGraph();
+            }
+        }
+
+        void Rewrite()
+        {
+            _slam.Rewrite();
+            ++_counters.rewrites;
+            if (_slam.GraphDirty())
+            {
+                PublishGraph();
+            }
+        }
+
+    private:
+        void PublishGraph()
+        {
+            auto graph = TakeSpare(_spareGraph);
+            _slam.FillPoseGraph(*graph, eureka::loadgen::LoadClockNowNs());
+            _counters.pose_graph_bytes += graph->ByteSizeLong();
+            _spareGraph = _service.ExchangeData(std::move(graph));
+            ++_counters.pose_graphs;
+        }
+    };
+
+    double DropRate(uint64_t published, uint64_t received)
+    {
+        return (published == 0 || received >= published) ? 0.0 : 100.0 * static_cast<double>(published - received) / static_cast<double>(published);
+    }
+
+    void ReportProgress(double elapsedSeconds, const Publisher& publisher, const std::vector<std::unique_ptr<eureka::loadgen::LoadConsumer>>& consumers)
+    {
+        uint64_t graphs = 0;
+        uint64_t poses = 0;
+        std::size_t connected = 0;
+        for (const auto& consumer : consumers)
+        {
+            graphs += consumer->PoseGraphs().messages.load(std::memory_order_relaxed);
+            poses += consumer->RealtimePoses().messages.load(std::memory_order_relaxed);
+            connected += consumer->Connected() ? 1 : 0;
+        }
+
+        const auto& counters = publisher.Counters();
+        EUREKA_LOG_INFO(
+            "{:6.1f}s | published graphs {} poses {} | received graphs {} poses {} | keyframes {} edges {} | consumers connected {}/{}",
+            elapsedSeconds,
+            counters.pose_graphs,
+            counters.realtime_poses,
+            graphs,
+            poses,
+            publisher.Slam().KeyframesCount(),
+            publisher.Slam().EdgesCount(),
+            connected,
+            consumers.size()
+        );
+    }
+
+    void PrintLatency(const char* stream, const eureka::loadgen::LatencyPercentiles& latency)
+    {
+        std::cout << std::format(
+            "    {:<10} latency [us] p50 {:10.1f} p90 {:10.1f} p99 {:10.1f} p99.9 {:10.1f} max {:10.1f} ({} samples)\n",
+            stream, latency.p50_us, latency.p90_us, latency.p99_us, latency.p999_us, latency.max_us, latency.samples
+        );
+    }
+
+    void PrintSummary(double elapsedSeconds, const PublishCounters& published, std::vector<eureka::loadgen::ConsumerReport>& reports)
+    {
+        std::cout << std::format(
+            "\npublished in {:.2f}s: {} pose graphs ({:.2f} MB/s, {} rewrites), {} realtime poses\n",
+            elapsedSeconds,
+            published.pose_graphs,
+            static_cast<double>(published.pose_graph_bytes) / elapsedSeconds / 1e6,
+            published.rewrites,
+            published.realtime_poses
+        );
+
+        for (std::size_t i = 0; i < reports.size(); ++i)
+        {
+            auto& report = reports[i];
+            std::cout << std::format(
+                "consumer {}{}: graphs {:.1f}/s {:.2f} MB/s drop {:.1f}% | poses {:.1f}/s drop {:.1f}%\n",
+                i,
+                report.connected ? "" : " (disconnected)",
+                static_cast<double>(report.pose_graphs) / elapsedSeconds,
+                static_cast<double>(report.pose_graph_bytes) / elapsedSeconds / 1e6,
+                DropRate(published.pose_graphs, report.pose_graphs),
+                static_cast<double>(report.realtime_poses) / elapsedSeconds,
+                DropRate(published.realtime_poses, report.realtime_poses)
+            );
+            PrintLatency("graph", report.pose_graph_latency);
+            PrintLatency("pose", report.realtime_pose_latency);
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    eureka::InitializeDefaultLogger();
+
+    try
+    {
+        auto config = ParseCommandLine(std::span<char*>(argv + 1, argv + argc));
+
+        auto service = std::make_shared<rgoproto::LiveSlamUIService::AsyncService>();
+        auto liveSlamServer = std::make_shared<eureka::rpc::LiveSlamServer>(std::vector<std::shared_ptr<grpc::Service>>{ service });
+        auto grpcContext = liveSlamServer->GetContext();
+        auto visService = std::make_shared<eureka::rpc::VisualizationService>(service, grpcContext);
+        if (!config.shared_memory_segment.empty())
+        {
+            visService->EnableSharedMemoryTransport({ .segment_name = config.shared_memory_segment });
+        }
+        liveSlamServer->Start(config.listen_ip + SERVER_PORT);
+        visService->Start();
+
+        std::atomic_bool serverActive = true;
+        std::thread serverThread(
+            [&]()
+            {
+                eureka::os::set_current_thread_name("LoadGenServer");
+                try
+                {
+                    while (serverActive)
+                    {
+                        grpcContext->RunFor(1ms);
+                    }
+                }
+                catch (const std::exception& err)
+                {
+                    EUREKA_LOG_ERROR("server error {}", err.what());
+                }
+            }
+        );
+
+        Publisher publisher(config.slam, *visService);
+        publisher.Prefill(config.initial_keyframes);
+
+        std::vector<std::unique_ptr<eureka::loadgen::LoadConsumer>> consumers;
+        for (std::size_t i = 0; i < config.consumers; ++i)
+        {
+            consumers.emplace_back(std::make_unique<eureka::loadgen::LoadConsumer>(i, config.listen_ip));
+        }
+
+        EUREKA_LOG_INFO("load generator: {} consumers, {} poses/s, keyframe every {} poses, {} edges per keyframe, {} rewrites/s",
+            config.consumers, config.slam.poses_per_second, config.slam.poses_per_keyframe, config.slam.edges_per_keyframe, config.slam.gpo_rewrites_per_second);
+
+        using steady_clock = std::chrono::steady_clock;
+        const auto posePeriod = std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(1.0 / config.slam.poses_per_second));
+        const auto rewritePeriod = config.slam.gpo_rewrites_per_second > 0.0 ?
+            std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(1.0 / config.slam.gpo_rewrites_per_second)) :
+            steady_clock::duration::max();
+        const auto reportPeriod = std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(config.report_interval_seconds));
+
+        const auto start = steady_clock::now();
+        const auto end = start + std::chrono::duration_cast<steady_clock::duration>(std::chrono::duration<double>(config.duration_seconds));
+        auto nextPose = start;
+        auto nextRewrite = (rewritePeriod == steady_clock::duration::max()) ? steady_clock::time_point::max() : start + rewritePeriod;
+        auto nextReport = start + reportPeriod;
+
+        while (steady_clock::now() < end)
+        {
+            // fixed rate schedule, a late publisher catches up instead of drifting
+            auto next = std::min({ nextPose, nextRewrite, nextReport, end });
+            std::this_thread::sleep_until(next);
+            auto now = steady_clock::now();
+
+            while (nextPose <= now)
+            {
+                publisher.PublishPose();
+                nextPose += posePeriod;
+            }
+            if (nextRewrite <= now)
+            {
+                publisher.Rewrite();
+                nextRewrite += rewritePeriod;
+            }
+            if (nextReport <= now)
+            {
+                ReportProgress(std::chrono::duration<double>(now - start).count(), publisher, consumers);
+                nextReport += reportPeriod;
+            }
+        }
+
+        auto elapsed = std::chrono::duration<double>(steady_clock::now() - start).count();
+
+        std::vector<eureka::loadgen::ConsumerReport> reports;
+        for (auto& consumer : consumers)
+        {
+            consumer->Stop();
+            reports.emplace_back(consumer->TakeReport());
+        }
+        consumers.clear();
+
+        PrintSummary(elapsed, publisher.Counters(), reports);
+
+        serverActive = false;
+        serverThread.join();
+        visService.reset();
+        liveSlamServer.reset();
+    }
+    catch (const std::exception& err)
+    {
+        EUREKA_LOG_ERROR("error {}", err.what());
+        return 1;
+    }
+    return 0;
+}